@@ -0,0 +1,104 @@
+/**
+ @brief      Minimal CommonCrypto cryptor API on top of OpenSSL for benchmarks built on Linux.
+ @discussion Only AES-128 family with PKCS7 padding which is used by \b PNAES is provided. Key size
+             select AES-128/192/256 the same way as CommonCrypto does.
+
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#ifndef PNCompatibilityCommonCryptor_h
+#define PNCompatibilityCommonCryptor_h
+
+#include <openssl/evp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int32_t CCCryptorStatus;
+typedef uint32_t CCOperation;
+typedef uint32_t CCAlgorithm;
+typedef uint32_t CCOptions;
+typedef EVP_CIPHER_CTX *CCCryptorRef;
+
+enum {
+    kCCSuccess = 0,
+    kCCParamError = -4300,
+    kCCBufferTooSmall = -4301,
+    kCCMemoryFailure = -4302,
+    kCCAlignmentError = -4303,
+    kCCDecodeError = -4304,
+    kCCUnimplemented = -4305,
+    kCCOverflow = -4306,
+    kCCRNGFailure = -4307
+};
+enum { kCCEncrypt = 0, kCCDecrypt = 1 };
+enum { kCCAlgorithmAES128 = 0 };
+enum { kCCOptionPKCS7Padding = 0x0001 };
+enum { kCCBlockSizeAES128 = 16 };
+
+static inline CCCryptorStatus CCCryptorCreate(CCOperation op, CCAlgorithm alg, CCOptions options,
+                                              const void *key, size_t keyLength, const void *iv,
+                                              CCCryptorRef *cryptorRef) {
+
+    const EVP_CIPHER *cipher = (keyLength == 16 ? EVP_aes_128_cbc() :
+                                (keyLength == 24 ? EVP_aes_192_cbc() :
+                                 (keyLength == 32 ? EVP_aes_256_cbc() : NULL)));
+    *cryptorRef = NULL;
+    if (alg != kCCAlgorithmAES128 || !cipher) { return kCCParamError; }
+
+    EVP_CIPHER_CTX *context = EVP_CIPHER_CTX_new();
+    if (!context) { return kCCMemoryFailure; }
+    if (EVP_CipherInit_ex(context, cipher, NULL, key, iv, (op == kCCEncrypt)) != 1) {
+
+        EVP_CIPHER_CTX_free(context);
+        return kCCParamError;
+    }
+    EVP_CIPHER_CTX_set_padding(context, ((options & kCCOptionPKCS7Padding) ? 1 : 0));
+    *cryptorRef = context;
+
+    return kCCSuccess;
+}
+
+static inline size_t CCCryptorGetOutputLength(CCCryptorRef cryptorRef, size_t inputLength,
+                                              bool final) {
+
+    (void)cryptorRef;
+
+    return (inputLength + (final ? kCCBlockSizeAES128 : 0));
+}
+
+static inline CCCryptorStatus CCCryptorUpdate(CCCryptorRef cryptorRef, const void *dataIn,
+                                              size_t dataInLength, void *dataOut,
+                                              size_t dataOutAvailable, size_t *dataOutMoved) {
+
+    int length = 0;
+    if (dataOutAvailable < dataInLength) { return kCCBufferTooSmall; }
+    if (EVP_CipherUpdate(cryptorRef, dataOut, &length, dataIn, (int)dataInLength) != 1) {
+
+        return kCCDecodeError;
+    }
+    *dataOutMoved = (size_t)length;
+
+    return kCCSuccess;
+}
+
+static inline CCCryptorStatus CCCryptorFinal(CCCryptorRef cryptorRef, void *dataOut,
+                                             size_t dataOutAvailable, size_t *dataOutMoved) {
+
+    int length = 0;
+    if (dataOutAvailable < kCCBlockSizeAES128) { return kCCBufferTooSmall; }
+    if (EVP_CipherFinal_ex(cryptorRef, dataOut, &length) != 1) { return kCCDecodeError; }
+    *dataOutMoved = (size_t)length;
+
+    return kCCSuccess;
+}
+
+static inline CCCryptorStatus CCCryptorRelease(CCCryptorRef cryptorRef) {
+
+    if (cryptorRef) { EVP_CIPHER_CTX_free(cryptorRef); }
+
+    return kCCSuccess;
+}
+
+#endif // PNCompatibilityCommonCryptor_h
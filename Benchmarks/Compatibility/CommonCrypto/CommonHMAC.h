@@ -0,0 +1,23 @@
+/**
+ @brief  Minimal CommonCrypto digest API on top of OpenSSL for benchmarks built on Linux.
+
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#ifndef PNCompatibilityCommonHMAC_h
+#define PNCompatibilityCommonHMAC_h
+
+#include <openssl/sha.h>
+#include <stdint.h>
+
+typedef uint32_t CC_LONG;
+
+#define CC_SHA256_DIGEST_LENGTH SHA256_DIGEST_LENGTH
+
+static inline unsigned char *CC_SHA256(const void *data, CC_LONG length, unsigned char *md) {
+
+    return SHA256(data, length, md);
+}
+
+#endif // PNCompatibilityCommonHMAC_h
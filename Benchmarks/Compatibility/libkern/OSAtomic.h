@@ -0,0 +1,62 @@
+/**
+ @brief  OSAtomic functions used by client on top of compiler builtins for benchmarks built on
+         Linux.
+
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#ifndef PNCompatibilityOSAtomic_h
+#define PNCompatibilityOSAtomic_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sched.h>
+
+typedef int32_t OSSpinLock;
+
+#define OS_SPINLOCK_INIT 0
+
+static inline void OSSpinLockLock(volatile OSSpinLock *lock) {
+
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+
+        sched_yield();
+    }
+}
+
+static inline void OSSpinLockUnlock(volatile OSSpinLock *lock) {
+
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+static inline void OSMemoryBarrier(void) {
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline int32_t OSAtomicAdd32Barrier(int32_t amount, volatile int32_t *value) {
+
+    return __atomic_add_fetch(value, amount, __ATOMIC_SEQ_CST);
+}
+
+static inline int32_t OSAtomicIncrement32Barrier(volatile int32_t *value) {
+
+    return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline bool OSAtomicCompareAndSwap32Barrier(int32_t oldValue, int32_t newValue,
+                                                   volatile int32_t *value) {
+
+    return __atomic_compare_exchange_n(value, &oldValue, newValue, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+}
+
+static inline bool OSAtomicCompareAndSwapPtrBarrier(void *oldValue, void *newValue,
+                                                    void * volatile *value) {
+
+    return __atomic_compare_exchange_n(value, &oldValue, newValue, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+}
+
+#endif // PNCompatibilityOSAtomic_h
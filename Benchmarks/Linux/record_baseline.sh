@@ -0,0 +1,19 @@
+#!/bin/sh
+# Build offline microbenchmarks on Linux inside Docker and record baseline.json (or compare with
+# existing one).
+#
+# Usage: sh Benchmarks/Linux/record_baseline.sh [baseline|run]
+#
+#   baseline  run benchmarks and store results into Benchmarks/baseline.json (default)
+#   run       run benchmarks and compare with Benchmarks/baseline.json
+#
+# Baseline is machine-specific, so it should be recorded and compared on the same host.
+set -e
+
+TARGET="${1:-baseline}"
+ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+IMAGE="pubnub-benchmarks-linux"
+
+docker build -t "$IMAGE" -f "$ROOT/Benchmarks/Linux/Dockerfile" "$ROOT/Benchmarks/Linux"
+docker run --rm -v "$ROOT:/src" "$IMAGE" /bin/bash -c \
+    ". /usr/local/share/GNUstep/Makefiles/GNUstep.sh && make clean && make $TARGET"
@@ -0,0 +1,58 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Live instances counter for PubNub SDK classes.
+ @discussion Tracker replace \c +allocWithZone: and \c -dealloc of each SDK class (from
+             \b PNClass list) which is inherited directly from system class, so instances of
+             whole SDK class hierarchy counted with exact class of allocated object. Counters
+             grouped by subsystem: \c core, \c network, \c managers, \c results, \c data and
+             \c misc.
+ @warning    Hooks can't be removed and add lock to each SDK object allocation, so tracker should
+             be used only by test tools.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNInstanceTracker : NSObject
+
+
+///------------------------------------------------
+/// @name Tracking
+///------------------------------------------------
+
+/**
+ @brief      Install allocation hooks.
+ @discussion Should be called before any SDK object has been created, otherwise objects created
+             before installation will make counters negative after deallocation.
+ 
+ @since 4.1.0
+ */
++ (void)install;
+
+/**
+ @brief  Retrieve number of live instances.
+ 
+ @return Dictionary where class name is key and number of live instances is value (classes without
+         live instances not included).
+ 
+ @since 4.1.0
+ */
++ (NSDictionary *)liveInstances;
+
+/**
+ @brief  Retrieve number of live instances grouped by subsystem.
+ 
+ @param instances Reference on counters which has been returned by \c +liveInstances.
+ 
+ @return Dictionary where subsystem name is key and number of live instances is value.
+ 
+ @since 4.1.0
+ */
++ (NSDictionary *)subsystemsForInstances:(NSDictionary *)instances;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,215 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNInstanceTracker.h"
+#import <objc/runtime.h>
+#import <pthread.h>
+#import "PNClass.h"
+
+
+#pragma mark Types
+
+/**
+ @brief  Original implementations signatures.
+ @note   \c +allocWithZone: declared as returning raw pointer, so ARC won't try to balance +1
+         reference returned by original implementation.
+ 
+ @since 4.1.0
+ */
+typedef void *(*PNAllocWithZoneIMP)(Class, SEL, NSZone *);
+typedef void (*PNDeallocIMP)(__unsafe_unretained id, SEL);
+
+
+#pragma mark - Static
+
+/**
+ @brief  Stores reference on lock which protect counters table.
+ 
+ @since 4.1.0
+ */
+static pthread_mutex_t _countersLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ @brief  Stores reference on table where class is key and number of live instances is value.
+ 
+ @since 4.1.0
+ */
+static CFMutableDictionaryRef _counters;
+
+
+#pragma mark - Private functions
+
+/**
+ @brief  Update number of live instances for \c class.
+ 
+ @param class  Exact class of allocated or deallocated object.
+ @param change \c 1 for allocation and \c -1 for deallocation.
+ 
+ @since 4.1.0
+ */
+static void PNInstanceTrackerUpdate(__unsafe_unretained Class class, NSInteger change) {
+    
+    pthread_mutex_lock(&_countersLock);
+    const void *key = (__bridge const void *)class;
+    NSInteger count = (NSInteger)(intptr_t)CFDictionaryGetValue(_counters, key) + change;
+    CFDictionarySetValue(_counters, key, (const void *)(intptr_t)count);
+    pthread_mutex_unlock(&_countersLock);
+}
+
+
+#pragma mark - Private interface declaration
+
+@interface PNInstanceTracker ()
+
+
+#pragma mark - Hooks
+
+/**
+ @brief  Replace allocation and deallocation methods of \c class.
+ 
+ @param class Reference on SDK class which is inherited directly from system class.
+ 
+ @since 4.1.0
+ */
++ (void)installHooksForClass:(Class)class;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNInstanceTracker
+
+
+#pragma mark - Tracking
+
++ (void)install {
+    
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        // Class keys and counters stored without retain / release calls.
+        _counters = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+        for (Class class in [PNClass classes]) {
+            
+            // Hooks installed only on hierarchy roots, subclasses inherit them and counted with
+            // exact class of allocated object.
+            NSString *superclassName = NSStringFromClass(class_getSuperclass(class));
+            if (![superclassName hasPrefix:@"PN"] && ![superclassName isEqualToString:@"PubNub"]) {
+                
+                [self installHooksForClass:class];
+            }
+        }
+    });
+}
+
++ (NSDictionary *)liveInstances {
+    
+    // Values stored as plain integers and can't be bridged to Foundation collection.
+    pthread_mutex_lock(&_countersLock);
+    CFIndex count = (_counters ? CFDictionaryGetCount(_counters) : 0);
+    const void **keys = calloc((size_t)MAX(count, 1), sizeof(void *));
+    const void **values = calloc((size_t)MAX(count, 1), sizeof(void *));
+    if (count) { CFDictionaryGetKeysAndValues(_counters, keys, values); }
+    pthread_mutex_unlock(&_countersLock);
+    
+    NSMutableDictionary *instances = [NSMutableDictionary new];
+    for (CFIndex entryIdx = 0; entryIdx < count; entryIdx++) {
+        
+        NSInteger live = (NSInteger)(intptr_t)values[entryIdx];
+        if (live != 0) {
+            
+            instances[NSStringFromClass((__bridge Class)keys[entryIdx])] = @(live);
+        }
+    }
+    free(keys);
+    free(values);
+    
+    return [instances copy];
+}
+
++ (NSDictionary *)subsystemsForInstances:(NSDictionary *)instances {
+    
+    static NSDictionary *_subsystems;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _subsystems = @{
+            @"PubNub": @"core", @"PNConfiguration": @"core", @"PNClientPool": @"core",
+            @"PNNetwork": @"network", @"PNNetworkResponseSerializer": @"network",
+            @"PNRequestParameters": @"network", @"PNRequestTrace": @"network",
+            @"PNURLBuilder": @"network", @"PNCircuitBreaker": @"network",
+            @"PNHedgingPolicy": @"network", @"PNLoopbackBroker": @"network",
+            @"PNOriginSelector": @"network", @"PNReachability": @"network",
+            @"PNTrafficCapture": @"network", @"PNTrafficReplayer": @"network",
+            @"PNSubscriber": @"managers", @"PNClientState": @"managers",
+            @"PNStateListener": @"managers", @"PNHeartbeat": @"managers",
+            @"PNHeartbeatScheduler": @"managers", @"PNTimingWheel": @"managers",
+            @"PNTimingWheelTimer": @"managers"
+        };
+    });
+    Class resultClass = NSClassFromString(@"PNResult");
+    Class dataClass = NSClassFromString(@"PNServiceData");
+    NSMutableDictionary *subsystems = [NSMutableDictionary new];
+    [instances enumerateKeysAndObjectsUsingBlock:^(NSString *className, NSNumber *count,
+                                                   BOOL *stop) {
+        
+        Class class = NSClassFromString(className);
+        NSString *subsystem = _subsystems[className];
+        if (!subsystem && [className hasSuffix:@"Parser"]) { subsystem = @"network"; }
+        else if (!subsystem && [class isSubclassOfClass:resultClass]) { subsystem = @"results"; }
+        else if (!subsystem && [class isSubclassOfClass:dataClass]) { subsystem = @"data"; }
+        subsystem = (subsystem?: @"misc");
+        subsystems[subsystem] = @([subsystems[subsystem] integerValue] + [count integerValue]);
+    }];
+    
+    return [subsystems copy];
+}
+
+
+#pragma mark - Hooks
+
++ (void)installHooksForClass:(Class)class {
+    
+    SEL allocSelector = @selector(allocWithZone:);
+    Class metaClass = object_getClass(class);
+    Method allocMethod = class_getClassMethod(class, allocSelector);
+    PNAllocWithZoneIMP originalAlloc = (PNAllocWithZoneIMP)method_getImplementation(allocMethod);
+    IMP alloc = imp_implementationWithBlock(^void *(__unsafe_unretained Class allocatedClass,
+                                                    NSZone *zone) {
+        
+        void *object = originalAlloc(allocatedClass, allocSelector, zone);
+        if (object) { PNInstanceTrackerUpdate(allocatedClass, 1); }
+        
+        return object;
+    });
+    if (!class_addMethod(metaClass, allocSelector, alloc, method_getTypeEncoding(allocMethod))) {
+        
+        method_setImplementation(allocMethod, alloc);
+    }
+    
+    // Selector created from string, because ARC doesn't allow to reference it directly.
+    SEL deallocSelector = sel_registerName("dealloc");
+    Method deallocMethod = class_getInstanceMethod(class, deallocSelector);
+    PNDeallocIMP originalDealloc = (PNDeallocIMP)method_getImplementation(deallocMethod);
+    IMP dealloc = imp_implementationWithBlock(^(__unsafe_unretained id object) {
+        
+        // Class requested through method, because KVO may replace isa of observed object.
+        PNInstanceTrackerUpdate([object class], -1);
+        originalDealloc(object, deallocSelector);
+    });
+    if (!class_addMethod(class, deallocSelector, dealloc, method_getTypeEncoding(deallocMethod))) {
+        
+        method_setImplementation(deallocMethod, dealloc);
+    }
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,208 @@
+#import <Foundation/Foundation.h>
+#import <PubNub/PubNub.h>
+
+
+/**
+ @brief  Monotonic time which is shared by publishers and subscribers.
+ 
+ @return Current time in nanoseconds.
+ 
+ @since 4.1.0
+ */
+extern uint64_t PNLoadTestNow(void);
+
+/**
+ @brief  Retrieve amount of physical memory which is used by process.
+ 
+ @return Resident set size in bytes.
+ 
+ @since 4.1.0
+ */
+extern uint64_t PNLoadTestResidentSize(void);
+
+/**
+ @brief  Retrieve CPU time which has been consumed by process.
+ 
+ @return User and system time in seconds.
+ 
+ @since 4.1.0
+ */
+extern double PNLoadTestCPUTime(void);
+
+/**
+ @brief  Calculate percentiles for list of samples.
+ 
+ @param samples List of latency values (in nanoseconds).
+ 
+ @return Dictionary with \c p50, \c p90, \c p99, \c p99.9 and \c max values in milliseconds.
+ 
+ @since 4.1.0
+ */
+extern NSDictionary *PNLoadTestPercentiles(NSMutableArray *samples);
+
+
+/**
+ @brief      End-to-end load test which drive multiple client instances against PubNub service (or
+             local stand-in \c pn_mock_server.py).
+ @discussion First \c publishers clients publish messages with configured rate to channels which is
+             assigned round-robin, last \c subscribers clients subscribe to those channels. Each
+             published message carry monotonic time at which it has been sent, so delivery latency
+             measured by subscriber within same process. Measurement window start after
+             \c warmup and last for \c duration, messages which has been sent within window are
+             waited for \c drain seconds after it closed.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNLoadTest : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on host (with port) which should be used by clients.
+ 
+ @default \c 127.0.0.1:8090
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *origin;
+
+/**
+ @brief  Stores whether clients should use secured connection.
+ 
+ @default \c NO
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign, getter = isTLSEnabled) BOOL TLSEnabled;
+
+/**
+ @brief      Stores reference on transport which should be used by clients.
+ @discussion With \c PNLoopbackTransport requests processed by in-process broker, so \c origin and
+             \c TLSEnabled ignored and report show cost of client itself without network stack.
+ 
+ @default \c PNHTTPTransport
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) PNTransport transport;
+
+/**
+ @brief  Stores keys which is used by all clients.
+ 
+ @default \c demo
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *publishKey;
+@property (nonatomic, copy) NSString *subscribeKey;
+
+/**
+ @brief  Stores number of client instances which should be created.
+ 
+ @default \c 10
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger clients;
+
+/**
+ @brief  Stores number of clients (from the beginning of the list) which publish messages.
+ 
+ @default \c 5
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger publishers;
+
+/**
+ @brief  Stores number of clients (from the end of the list) which subscribe on channels.
+ 
+ @default \c 5
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger subscribers;
+
+/**
+ @brief  Stores number of channels between which clients is distributed.
+ 
+ @default \c 1
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger channels;
+
+/**
+ @brief  Stores number of messages which each publisher send per second.
+ 
+ @default \c 10
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double rate;
+
+/**
+ @brief  Stores size of padding (in bytes) which is added to each published message.
+ 
+ @default \c 64
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger messageSize;
+
+/**
+ @brief  Stores whether messages should be published with compression.
+ 
+ @default \c NO
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign, getter = shouldCompress) BOOL compress;
+
+/**
+ @brief  Stores durations (in seconds) of warmup, measurement and drain phases.
+ 
+ @default \c 5, \c 30 and \c 5 seconds.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval warmup;
+@property (nonatomic, assign) NSTimeInterval duration;
+@property (nonatomic, assign) NSTimeInterval drain;
+
+/**
+ @brief      Stores path to file into which clients should capture their traffic.
+ @discussion Captured trace can be replayed with \b PNReplayTest.
+ 
+ @default \c nil (traffic not captured).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *capturePath;
+
+
+///------------------------------------------------
+/// @name Running
+///------------------------------------------------
+
+/**
+ @brief      Create clients, run load and print report.
+ @discussion Method block calling thread till test completion.
+ 
+ @return Report which contain throughput, latency percentiles (in milliseconds), error counters,
+         CPU and RSS usage (in total and per client). \c nil returned in case if subscribers
+         wasn't able to connect.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)run;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,522 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNLoadTest.h"
+#import <sys/resource.h>
+#import <pthread.h>
+#import <time.h>
+#import <PubNub/PubNub.h>
+#if __APPLE__
+    #import <mach/mach.h>
+#endif
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores for how long load test wait for subscribers to connect (in seconds).
+ 
+ @since 4.1.0
+ */
+static NSTimeInterval const kPNLoadTestConnectionTimeout = 30.0f;
+
+
+#pragma mark - Functions
+
+uint64_t PNLoadTestNow(void) {
+    
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    
+    return ((uint64_t)time.tv_sec * NSEC_PER_SEC + (uint64_t)time.tv_nsec);
+}
+
+uint64_t PNLoadTestResidentSize(void) {
+    
+    uint64_t size = 0;
+#if __APPLE__
+    mach_task_basic_info_data_t information;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&information,
+                  &count) == KERN_SUCCESS) {
+        
+        size = information.resident_size;
+    }
+#else
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm) {
+        
+        unsigned long long pages = 0;
+        if (fscanf(statm, "%*llu %llu", &pages) == 1) {
+            
+            size = pages * (uint64_t)sysconf(_SC_PAGESIZE);
+        }
+        fclose(statm);
+    }
+#endif
+    
+    return size;
+}
+
+double PNLoadTestCPUTime(void) {
+    
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    
+    return ((double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+            (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / USEC_PER_SEC);
+}
+
+NSDictionary *PNLoadTestPercentiles(NSMutableArray *samples) {
+    
+    [samples sortUsingSelector:@selector(compare:)];
+    NSMutableDictionary *percentiles = [NSMutableDictionary new];
+    NSDictionary *fractions = @{@"p50": @0.5, @"p90": @0.9, @"p99": @0.99, @"p99.9": @0.999,
+                                @"max": @1.0};
+    [fractions enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSNumber *fraction,
+                                                   BOOL *stop) {
+        
+        double value = 0.0f;
+        if ([samples count]) {
+            
+            NSUInteger sampleIdx = (NSUInteger)ceil([fraction doubleValue] * [samples count]);
+            value = [samples[MAX(sampleIdx, 1) - 1] doubleValue] / NSEC_PER_MSEC;
+        }
+        percentiles[name] = @(value);
+    }];
+    
+    return [percentiles copy];
+}
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNLoadTest () <PNObjectEventListener>
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores reference on list of clients which is used during test.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *clientInstances;
+
+/**
+ @brief  Stores reference on group which is used to wait for subscribers connection.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_group_t connectionGroup;
+
+/**
+ @brief  Stores reference on list of clients which already reported connected state.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSHashTable *connectedClients;
+
+/**
+ @brief  Stores measurement window boundaries (monotonic time in nanoseconds).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) uint64_t windowStart;
+@property (nonatomic, assign) uint64_t windowEnd;
+
+/**
+ @brief  Stores counters and samples which is collected within measurement window.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) uint64_t published;
+@property (nonatomic, assign) uint64_t expected;
+@property (nonatomic, assign) uint64_t delivered;
+@property (nonatomic, assign) uint64_t publishErrors;
+@property (nonatomic, assign) uint64_t disconnects;
+@property (nonatomic, strong) NSMutableArray *deliveryLatencies;
+@property (nonatomic, strong) NSMutableArray *publishLatencies;
+
+
+#pragma mark - Running
+
+/**
+ @brief  Print human-readable report to standard output.
+ 
+ @param report Reference on report which has been composed at the end of test.
+ 
+ @since 4.1.0
+ */
+- (void)printReport:(NSDictionary *)report;
+
+
+#pragma mark - Clients
+
+/**
+ @brief  Create clients, add listener and subscribe.
+ 
+ @param subscribersPerChannel Reference on list which should be filled with number of subscribers
+                              on each channel.
+ 
+ @since 4.1.0
+ */
+- (void)prepareClients:(NSMutableArray *)subscribersPerChannel;
+
+/**
+ @brief  Unsubscribe all clients and release them.
+ 
+ @since 4.1.0
+ */
+- (void)releaseClients;
+
+
+#pragma mark - Publishing
+
+/**
+ @brief  Create publish timers for each publishing client.
+ 
+ @param subscribersPerChannel List with number of subscribers on each channel.
+ 
+ @return List of dispatch sources which should be cancelled at the end of measurement window.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)startPublishersWithSubscribers:(NSArray *)subscribersPerChannel;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Compose name of channel by it's index.
+ 
+ @param channelIdx Index of channel from \c 0 till \c channels.
+ 
+ @return Channel name.
+ 
+ @since 4.1.0
+ */
+- (NSString *)channelWithIndex:(NSUInteger)channelIdx;
+
+/**
+ @brief  Thread-safe access to counters and samples.
+ 
+ @param block Block inside of which counters can be modified.
+ 
+ @since 4.1.0
+ */
+- (void)updateStatistics:(dispatch_block_t)block;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNLoadTest {
+    
+    pthread_mutex_t _statisticsLock;
+}
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _origin = @"127.0.0.1:8090";
+        _publishKey = @"demo";
+        _subscribeKey = @"demo";
+        _clients = 10;
+        _publishers = 5;
+        _subscribers = 5;
+        _channels = 1;
+        _rate = 10.0f;
+        _messageSize = 64;
+        _warmup = 5.0f;
+        _duration = 30.0f;
+        _drain = 5.0f;
+        _clientInstances = [NSMutableArray new];
+        _connectedClients = [NSHashTable weakObjectsHashTable];
+        _deliveryLatencies = [NSMutableArray new];
+        _publishLatencies = [NSMutableArray new];
+        pthread_mutex_init(&_statisticsLock, NULL);
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    pthread_mutex_destroy(&_statisticsLock);
+}
+
+
+#pragma mark - Running
+
+- (NSDictionary *)run {
+    
+    self.publishers = MIN(self.publishers, self.clients);
+    self.subscribers = MIN(self.subscribers, self.clients);
+    self.channels = MAX(self.channels, (NSUInteger)1);
+    BOOL isLoopback = (self.transport == PNLoopbackTransport);
+    NSString *target = (isLoopback ? @"in-process loopback broker" : self.origin);
+    printf("Starting %lu clients (%lu publishers, %lu subscribers) on %lu channels against %s\n",
+           (unsigned long)self.clients, (unsigned long)self.publishers,
+           (unsigned long)self.subscribers, (unsigned long)self.channels, [target UTF8String]);
+    
+    NSMutableArray *subscribersPerChannel = [NSMutableArray new];
+    [self prepareClients:subscribersPerChannel];
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW,
+                                            (int64_t)(kPNLoadTestConnectionTimeout * NSEC_PER_SEC));
+    if (dispatch_group_wait(self.connectionGroup, timeout) != 0) {
+        
+        fprintf(stderr, "Subscribers wasn't able to connect to %s within %.0f seconds\n",
+                [target UTF8String], kPNLoadTestConnectionTimeout);
+        [self releaseClients];
+        
+        return nil;
+    }
+    uint64_t idleResidentSize = PNLoadTestResidentSize();
+    
+    uint64_t start = PNLoadTestNow();
+    self.windowStart = start + (uint64_t)(self.warmup * NSEC_PER_SEC);
+    self.windowEnd = self.windowStart + (uint64_t)(self.duration * NSEC_PER_SEC);
+    NSArray *timers = [self startPublishersWithSubscribers:subscribersPerChannel];
+    
+    [NSThread sleepForTimeInterval:self.warmup];
+    double cpuAtStart = PNLoadTestCPUTime();
+    uint64_t measurementStart = PNLoadTestNow();
+    [NSThread sleepForTimeInterval:self.duration];
+    double cpu = PNLoadTestCPUTime() - cpuAtStart;
+    double elapsed = (double)(PNLoadTestNow() - measurementStart) / NSEC_PER_SEC;
+    uint64_t residentSize = PNLoadTestResidentSize();
+    for (dispatch_source_t timer in timers) { dispatch_source_cancel(timer); }
+    
+    // Give subscribers chance to receive messages which has been sent at the end of window.
+    [NSThread sleepForTimeInterval:self.drain];
+    
+    __block NSDictionary *report = nil;
+    [self updateStatistics:^{
+        
+        double clients = (double)self.clients;
+        report = @{
+            @"clients": @(self.clients), @"publishers": @(self.publishers),
+            @"subscribers": @(self.subscribers), @"channels": @(self.channels),
+            @"transport": (isLoopback ? @"loopback" : @"http"), @"duration": @(elapsed),
+            @"published": @(self.published), @"expected": @(self.expected),
+            @"delivered": @(self.delivered),
+            @"publishedPerSecond": @(self.published / elapsed),
+            @"deliveredPerSecond": @(self.delivered / elapsed),
+            @"publishErrors": @(self.publishErrors), @"disconnects": @(self.disconnects),
+            @"deliveryLatency": PNLoadTestPercentiles(self.deliveryLatencies),
+            @"publishLatency": PNLoadTestPercentiles(self.publishLatencies),
+            @"cpu": @{@"total": @(cpu / elapsed * 100.0f),
+                      @"perClient": @(cpu / elapsed * 100.0f / clients)},
+            @"rss": @{@"idle": @(idleResidentSize), @"total": @(residentSize),
+                      @"perClient": @(residentSize / clients)}
+        };
+    }];
+    [self releaseClients];
+    [self printReport:report];
+    
+    return report;
+}
+
+- (void)printReport:(NSDictionary *)report {
+    
+    printf("\nMeasured %.1f seconds\n", [report[@"duration"] doubleValue]);
+    printf("  published  %10llu  %10.1f msg/s  (%llu errors)\n",
+           [report[@"published"] unsignedLongLongValue],
+           [report[@"publishedPerSecond"] doubleValue],
+           [report[@"publishErrors"] unsignedLongLongValue]);
+    printf("  delivered  %10llu  %10.1f msg/s  (%llu expected, %llu disconnects)\n",
+           [report[@"delivered"] unsignedLongLongValue],
+           [report[@"deliveredPerSecond"] doubleValue],
+           [report[@"expected"] unsignedLongLongValue],
+           [report[@"disconnects"] unsignedLongLongValue]);
+    for (NSString *name in @[@"deliveryLatency", @"publishLatency"]) {
+        
+        NSDictionary *latency = report[name];
+        printf("  %-16s p50 %8.2f  p90 %8.2f  p99 %8.2f  p99.9 %8.2f  max %8.2f ms\n",
+               [name UTF8String], [latency[@"p50"] doubleValue], [latency[@"p90"] doubleValue],
+               [latency[@"p99"] doubleValue], [latency[@"p99.9"] doubleValue],
+               [latency[@"max"] doubleValue]);
+    }
+    printf("  CPU        %10.1f%%  %10.3f%% per client\n",
+           [report[@"cpu"][@"total"] doubleValue], [report[@"cpu"][@"perClient"] doubleValue]);
+    printf("  RSS        %10.1f MB  %10.1f KB per client  (%.1f MB before load)\n",
+           [report[@"rss"][@"total"] doubleValue] / (1024 * 1024),
+           [report[@"rss"][@"perClient"] doubleValue] / 1024,
+           [report[@"rss"][@"idle"] doubleValue] / (1024 * 1024));
+}
+
+
+#pragma mark - Clients
+
+- (void)prepareClients:(NSMutableArray *)subscribersPerChannel {
+    
+    for (NSUInteger channelIdx = 0; channelIdx < self.channels; channelIdx++) {
+        
+        [subscribersPerChannel addObject:@0];
+    }
+    self.connectionGroup = dispatch_group_create();
+    NSUInteger firstSubscriberIdx = self.clients - self.subscribers;
+    for (NSUInteger clientIdx = 0; clientIdx < self.clients; clientIdx++) {
+        
+        PNConfiguration *configuration = nil;
+        configuration = [PNConfiguration configurationWithPublishKey:self.publishKey
+                                                        subscribeKey:self.subscribeKey];
+        configuration.origin = self.origin;
+        configuration.TLSEnabled = self.isTLSEnabled;
+        configuration.transport = self.transport;
+        configuration.uuid = [NSString stringWithFormat:@"pn-load-%lu", (unsigned long)clientIdx];
+        configuration.trafficCapturePath = self.capturePath;
+        NSString *queueName = [NSString stringWithFormat:@"com.pubnub.load-test.%lu",
+                               (unsigned long)clientIdx];
+        dispatch_queue_t queue = dispatch_queue_create([queueName UTF8String],
+                                                       DISPATCH_QUEUE_SERIAL);
+        PubNub *client = [PubNub clientWithConfiguration:configuration callbackQueue:queue];
+        [self.clientInstances addObject:client];
+        
+        if (clientIdx >= firstSubscriberIdx) {
+            
+            NSUInteger channelIdx = clientIdx % self.channels;
+            NSUInteger subscribers = [subscribersPerChannel[channelIdx] unsignedIntegerValue];
+            subscribersPerChannel[channelIdx] = @(subscribers + 1);
+            dispatch_group_enter(self.connectionGroup);
+            [client addListener:self];
+            [client subscribeToChannels:@[[self channelWithIndex:channelIdx]] withPresence:NO];
+        }
+    }
+}
+
+- (void)releaseClients {
+    
+    for (PubNub *client in self.clientInstances) {
+        
+        [client removeListener:self];
+        [client unsubscribeFromChannels:[client channels] withPresence:NO];
+    }
+    [self.clientInstances removeAllObjects];
+}
+
+
+#pragma mark - Publishing
+
+- (NSArray *)startPublishersWithSubscribers:(NSArray *)subscribersPerChannel {
+    
+    NSMutableArray *timers = [NSMutableArray new];
+    NSMutableString *padding = [NSMutableString new];
+    for (NSUInteger characterIdx = 0; characterIdx < self.messageSize; characterIdx++) {
+        
+        [padding appendString:@"x"];
+    }
+    uint64_t interval = (uint64_t)(NSEC_PER_SEC / MAX(self.rate, 0.001f));
+    for (NSUInteger clientIdx = 0; clientIdx < self.publishers; clientIdx++) {
+        
+        PubNub *client = self.clientInstances[clientIdx];
+        NSUInteger channelIdx = clientIdx % self.channels;
+        NSString *channel = [self channelWithIndex:channelIdx];
+        uint64_t receivers = [subscribersPerChannel[channelIdx] unsignedLongLongValue];
+        dispatch_queue_t queue = dispatch_queue_create("com.pubnub.load-test.publisher",
+                                                       DISPATCH_QUEUE_SERIAL);
+        dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+        // Start of publishers is spread over single interval, so requests won't be sent in bursts.
+        dispatch_time_t start = dispatch_time(DISPATCH_TIME_NOW,
+                                              (int64_t)(interval * clientIdx / self.publishers));
+        dispatch_source_set_timer(timer, start, interval, interval / 10);
+        __block uint64_t sequence = 0;
+        dispatch_source_set_event_handler(timer, ^{
+            
+            uint64_t sent = PNLoadTestNow();
+            BOOL measured = (sent >= self.windowStart && sent < self.windowEnd);
+            NSDictionary *message = @{@"sent": @(sent), @"sequence": @(sequence++),
+                                      @"publisher": @(clientIdx), @"payload": padding};
+            [client publish:message toChannel:channel compressed:self.shouldCompress
+             withCompletion:^(PNPublishStatus *status) {
+                
+                uint64_t latency = PNLoadTestNow() - sent;
+                if (!measured) { return; }
+                [self updateStatistics:^{
+                    
+                    if (!status.isError) {
+                        
+                        self.published++;
+                        self.expected += receivers;
+                        [self.publishLatencies addObject:@(latency)];
+                    }
+                    else { self.publishErrors++; }
+                }];
+            }];
+        });
+        dispatch_resume(timer);
+        [timers addObject:timer];
+    }
+    
+    return [timers copy];
+}
+
+
+#pragma mark - Listener
+
+- (void)client:(PubNub *)client didReceiveMessage:(PNMessageResult *)message {
+    
+    uint64_t received = PNLoadTestNow();
+    NSDictionary *payload = message.data.message;
+    if (![payload isKindOfClass:[NSDictionary class]]) { return; }
+    
+    uint64_t sent = [payload[@"sent"] unsignedLongLongValue];
+    if (sent >= self.windowStart && sent < self.windowEnd) {
+        
+        [self updateStatistics:^{
+            
+            self.delivered++;
+            [self.deliveryLatencies addObject:@(received - sent)];
+        }];
+    }
+}
+
+- (void)client:(PubNub *)client didReceiveStatus:(PNSubscribeStatus *)status {
+    
+    if (status.category == PNConnectedCategory) {
+        
+        __block BOOL connected = NO;
+        [self updateStatistics:^{
+            
+            connected = [self.connectedClients containsObject:client];
+            [self.connectedClients addObject:client];
+        }];
+        if (!connected) { dispatch_group_leave(self.connectionGroup); }
+    }
+    else if (status.category == PNUnexpectedDisconnectCategory) {
+        
+        [self updateStatistics:^{ self.disconnects++; }];
+    }
+}
+
+
+#pragma mark - Misc
+
+- (NSString *)channelWithIndex:(NSUInteger)channelIdx {
+    
+    return [NSString stringWithFormat:@"pn-load-%lu", (unsigned long)channelIdx];
+}
+
+- (void)updateStatistics:(dispatch_block_t)block {
+    
+    pthread_mutex_lock(&_statisticsLock);
+    block();
+    pthread_mutex_unlock(&_statisticsLock);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,82 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Replay of captured traffic through client's processing pipeline.
+ @discussion Test load trace (captured with \c trafficCapturePath configuration option) into
+             \b PNTrafficReplayer and create clients with \b PNReplayTransport which subscribe on
+             channels and groups from trace. Recorded responses pass through serialization,
+             parsing, subscriber and listeners same way as responses from \b PubNub network. Test
+             report throughput (replayed records, bytes, messages and presence events per second),
+             pipeline latency (from response delivery till listener callback) and schedule lag
+             (how late client requested responses comparing to recorded pace).
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNReplayTest : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores path to traffic trace which should be replayed.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *tracePath;
+
+/**
+ @brief  Stores replay speed multiplier (\c 0 - as fast as client request responses).
+ 
+ @default \c 1 (recorded pace).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double speed;
+
+/**
+ @brief      Stores number of client instances which replay trace.
+ @discussion Records matched by operation type only, so clients share recorded responses (each
+             response delivered to one of them). Number of clients should be same as number of
+             subscribed clients in captured process.
+ 
+ @default \c 1
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger clients;
+
+/**
+ @brief  Stores for how long (in seconds) test wait for listeners after all subscribe responses
+         has been replayed.
+ 
+ @default \c 2 seconds.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval drain;
+
+
+///------------------------------------------------
+/// @name Running
+///------------------------------------------------
+
+/**
+ @brief      Replay trace and print report.
+ @discussion Method block calling thread till test completion.
+ 
+ @return Report with replay statistics, throughput, CPU usage and \c pipelineLatency percentiles
+         (in milliseconds) or \c nil in case if trace can't be loaded.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)run;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,341 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNReplayTest.h"
+#import <PubNub/PubNub.h>
+#import <libkern/OSAtomic.h>
+#import <pthread.h>
+#import "PNTrafficReplayer.h"
+#import "PNLoadTest.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores interval (in seconds) with which test check replay progress.
+ 
+ @since 4.1.0
+ */
+static NSTimeInterval const kPNReplayTestPollInterval = 0.1f;
+
+/**
+ @brief  Stores for how long (in seconds) test wait for subscribe responses in addition to recorded
+         traffic duration (replay with maximum speed or slow client).
+ 
+ @since 4.1.0
+ */
+static NSTimeInterval const kPNReplayTestGracePeriod = 30.0f;
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNReplayTest () <PNObjectEventListener>
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores reference on list of clients which is used during test.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *clientInstances;
+
+/**
+ @brief  Stores list of pipeline latency samples (in nanoseconds).
+ @note   Access to list should be guarded by \c _samplesLock.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *pipelineLatencies;
+
+/**
+ @brief      Stores time (from \c PNLoadTestNow()) when response has been delivered by replayer.
+ @discussion Trace identifier is key and delivery time is value.
+ @note       Access to dictionary should be guarded by \c _samplesLock.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *deliveryTimes;
+
+
+#pragma mark - Running
+
+/**
+ @brief  Print human-readable report to standard output.
+ 
+ @param report Reference on report which has been composed at the end of test.
+ 
+ @since 4.1.0
+ */
+- (void)printReport:(NSDictionary *)report;
+
+
+#pragma mark - Clients
+
+/**
+ @brief  Create clients, add listener and subscribe on channels and groups from trace.
+ 
+ @param replayer Reference on replayer into which trace has been loaded.
+ 
+ @since 4.1.0
+ */
+- (void)prepareClientsForReplayer:(PNTrafficReplayer *)replayer;
+
+/**
+ @brief  Unsubscribe all clients and release them.
+ 
+ @since 4.1.0
+ */
+- (void)releaseClients;
+
+
+#pragma mark - Misc
+
+/**
+ @brief      Store time which passed from recorded response delivery till listener callback.
+ @discussion Events from same response share trace which record only first callback, so delivery
+             time translated to test clock when first event from response received and used for
+             rest of them.
+ 
+ @param trace Reference on trace of request which delivered event.
+ 
+ @since 4.1.0
+ */
+- (void)addLatencyFromTrace:(PNRequestTrace *)trace;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNReplayTest {
+    
+    pthread_mutex_t _samplesLock;
+    volatile int64_t _messages;
+    volatile int64_t _presenceEvents;
+    volatile int64_t _errors;
+}
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _speed = 1.0f;
+        _clients = 1;
+        _drain = 2.0f;
+        _clientInstances = [NSMutableArray new];
+        _pipelineLatencies = [NSMutableArray new];
+        _deliveryTimes = [NSMutableDictionary new];
+        pthread_mutex_init(&_samplesLock, NULL);
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    pthread_mutex_destroy(&_samplesLock);
+}
+
+
+#pragma mark - Running
+
+- (NSDictionary *)run {
+    
+    NSError *error = nil;
+    PNTrafficReplayer *replayer = [PNTrafficReplayer sharedReplayer];
+    if (![replayer loadTraceAtPath:self.tracePath speed:self.speed error:&error]) {
+        
+        fprintf(stderr, "Unable to load trace from %s: %s\n", [self.tracePath UTF8String],
+                [[error localizedDescription] UTF8String]);
+        
+        return nil;
+    }
+    NSDictionary *statistics = [replayer statistics];
+    NSTimeInterval recordedDuration = [statistics[@"duration"] doubleValue];
+    printf("Replaying %lu records (%.1f seconds of traffic on %lu channels and %lu groups) with "
+           "%lu clients at %s\n", [statistics[@"records"] unsignedLongValue], recordedDuration,
+           (unsigned long)[replayer.channels count], (unsigned long)[replayer.channelGroups count],
+           (unsigned long)self.clients,
+           [(self.speed > 0.0f ? [NSString stringWithFormat:@"%gx", self.speed] : @"max speed")
+            UTF8String]);
+    
+    double cpuAtStart = PNLoadTestCPUTime();
+    uint64_t start = PNLoadTestNow();
+    [self prepareClientsForReplayer:replayer];
+    
+    // Replay completed when all recorded subscribe responses has been delivered.
+    NSTimeInterval timeout = (kPNReplayTestGracePeriod +
+                              (self.speed > 0.0f ? recordedDuration / self.speed : 0.0f));
+    while ((double)(PNLoadTestNow() - start) / NSEC_PER_SEC < timeout &&
+           [[replayer statistics][@"remaining"][@"Subscribe"] unsignedIntegerValue] > 0) {
+        
+        [NSThread sleepForTimeInterval:kPNReplayTestPollInterval];
+    }
+    [NSThread sleepForTimeInterval:self.drain];
+    double elapsed = ((double)(PNLoadTestNow() - start) / NSEC_PER_SEC - self.drain);
+    double cpu = PNLoadTestCPUTime() - cpuAtStart;
+    statistics = [replayer statistics];
+    [self releaseClients];
+    
+    pthread_mutex_lock(&_samplesLock);
+    NSDictionary *pipelineLatency = PNLoadTestPercentiles(self.pipelineLatencies);
+    pthread_mutex_unlock(&_samplesLock);
+    elapsed = MAX(elapsed, 0.001f);
+    NSDictionary *report = @{
+        @"trace": (self.tracePath?: @""), @"speed": @(self.speed), @"clients": @(self.clients),
+        @"recordedDuration": @(recordedDuration), @"duration": @(elapsed),
+        @"records": statistics[@"records"], @"replayed": statistics[@"replayed"],
+        @"missing": statistics[@"missing"], @"remaining": statistics[@"remaining"],
+        @"bytes": statistics[@"bytes"], @"messages": @(_messages),
+        @"presenceEvents": @(_presenceEvents), @"errors": @(_errors),
+        @"recordsPerSecond": @([statistics[@"replayed"] doubleValue] / elapsed),
+        @"bytesPerSecond": @([statistics[@"bytes"] doubleValue] / elapsed),
+        @"messagesPerSecond": @(_messages / elapsed),
+        @"presenceEventsPerSecond": @(_presenceEvents / elapsed),
+        @"pipelineLatency": pipelineLatency, @"scheduleLag": statistics[@"lag"],
+        @"cpu": @(cpu / elapsed * 100.0f)
+    };
+    [self printReport:report];
+    
+    return report;
+}
+
+- (void)printReport:(NSDictionary *)report {
+    
+    printf("\nReplayed %.1f seconds of traffic in %.1f seconds\n",
+           [report[@"recordedDuration"] doubleValue], [report[@"duration"] doubleValue]);
+    printf("  records    %10llu  %10.1f rec/s  (%llu missing)\n",
+           [report[@"replayed"] unsignedLongLongValue], [report[@"recordsPerSecond"] doubleValue],
+           [report[@"missing"] unsignedLongLongValue]);
+    printf("  bytes      %10llu  %10.1f KB/s\n", [report[@"bytes"] unsignedLongLongValue],
+           [report[@"bytesPerSecond"] doubleValue] / 1024);
+    printf("  messages   %10llu  %10.1f msg/s\n", [report[@"messages"] unsignedLongLongValue],
+           [report[@"messagesPerSecond"] doubleValue]);
+    printf("  presence   %10llu  %10.1f evt/s  (%llu errors)\n",
+           [report[@"presenceEvents"] unsignedLongLongValue],
+           [report[@"presenceEventsPerSecond"] doubleValue],
+           [report[@"errors"] unsignedLongLongValue]);
+    NSDictionary *latency = report[@"pipelineLatency"];
+    printf("  pipeline   p50 %8.2f  p90 %8.2f  p99 %8.2f  p99.9 %8.2f  max %8.2f ms\n",
+           [latency[@"p50"] doubleValue], [latency[@"p90"] doubleValue],
+           [latency[@"p99"] doubleValue], [latency[@"p99.9"] doubleValue],
+           [latency[@"max"] doubleValue]);
+    NSDictionary *lag = report[@"scheduleLag"];
+    printf("  lag        p50 %8.2f  p90 %8.2f  p99 %8.2f  max %8.2f ms\n",
+           [lag[@"p50"] doubleValue], [lag[@"p90"] doubleValue], [lag[@"p99"] doubleValue],
+           [lag[@"max"] doubleValue]);
+    printf("  CPU        %10.1f%%\n", [report[@"cpu"] doubleValue]);
+}
+
+
+#pragma mark - Clients
+
+- (void)prepareClientsForReplayer:(PNTrafficReplayer *)replayer {
+    
+    // Presence channels restored through presence flag, because client add them by itself.
+    NSArray *channels = [replayer.channels filteredArrayUsingPredicate:
+                         [NSPredicate predicateWithFormat:@"NOT (SELF ENDSWITH '-pnpres')"]];
+    NSArray *groups = [replayer.channelGroups filteredArrayUsingPredicate:
+                       [NSPredicate predicateWithFormat:@"NOT (SELF ENDSWITH '-pnpres')"]];
+    BOOL withPresence = ([channels count] < [replayer.channels count] ||
+                         [groups count] < [replayer.channelGroups count]);
+    for (NSUInteger clientIdx = 0; clientIdx < self.clients; clientIdx++) {
+        
+        PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                         subscribeKey:@"demo"];
+        configuration.uuid = [NSString stringWithFormat:@"pn-replay-%lu", (unsigned long)clientIdx];
+        configuration.transport = PNReplayTransport;
+        configuration.traceRequests = YES;
+        NSString *queueName = [NSString stringWithFormat:@"com.pubnub.replay-test.%lu",
+                               (unsigned long)clientIdx];
+        dispatch_queue_t queue = dispatch_queue_create([queueName UTF8String],
+                                                       DISPATCH_QUEUE_SERIAL);
+        PubNub *client = [PubNub clientWithConfiguration:configuration callbackQueue:queue];
+        [client addListener:self];
+        [self.clientInstances addObject:client];
+        
+        // Subscribe request which is cancelled by following subscription change return it's
+        // record to replayer, so it will be delivered to next subscribe request.
+        if ([channels count]) {
+            
+            [client subscribeToChannels:channels withPresence:withPresence];
+        }
+        if ([groups count]) {
+            
+            [client subscribeToChannelGroups:groups withPresence:withPresence];
+        }
+    }
+}
+
+- (void)releaseClients {
+    
+    for (PubNub *client in self.clientInstances) {
+        
+        [client removeListener:self];
+        [client unsubscribeFromChannels:[client channels] withPresence:YES];
+        [client unsubscribeFromChannelGroups:[client channelGroups] withPresence:YES];
+    }
+    [self.clientInstances removeAllObjects];
+}
+
+
+#pragma mark - Listeners
+
+- (void)client:(PubNub *)client didReceiveMessage:(PNMessageResult *)message {
+    
+    OSAtomicIncrement64Barrier(&_messages);
+    [self addLatencyFromTrace:message.trace];
+}
+
+- (void)client:(PubNub *)client didReceivePresenceEvent:(PNPresenceEventResult *)event {
+    
+    OSAtomicIncrement64Barrier(&_presenceEvents);
+    [self addLatencyFromTrace:event.trace];
+}
+
+- (void)client:(PubNub *)client didReceiveStatus:(PNSubscribeStatus *)status {
+    
+    if (status.isError && status.category != PNCancelledCategory) {
+        
+        OSAtomicIncrement64Barrier(&_errors);
+    }
+}
+
+
+#pragma mark - Misc
+
+- (void)addLatencyFromTrace:(PNRequestTrace *)trace {
+    
+    uint64_t now = PNLoadTestNow();
+    NSTimeInterval delivered = [trace intervalForStage:PNResponseDeliveredStage];
+    NSTimeInterval invoked = [trace intervalForStage:PNCallbackInvokedStage];
+    if (delivered >= 0.0f && invoked >= delivered) {
+        
+        pthread_mutex_lock(&_samplesLock);
+        NSNumber *identifier = @(trace.identifier);
+        NSNumber *deliveryTime = self.deliveryTimes[identifier];
+        if (!deliveryTime) {
+            
+            deliveryTime = @(now - (uint64_t)((invoked - delivered) * NSEC_PER_SEC));
+            self.deliveryTimes[identifier] = deliveryTime;
+        }
+        [self.pipelineLatencies addObject:@(now - [deliveryTime unsignedLongLongValue])];
+        pthread_mutex_unlock(&_samplesLock);
+    }
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,167 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Long-running soak test which look for resources growth during client's life cycle.
+ @discussion Clients continuously publish to and receive from channels, send heartbeats,
+             re-subscribe and go through reconnection (mock server asked to fail subscribe
+             requests) at pace which is accelerated by short heartbeat interval and cycle length.
+             Periodically test take sample of live instances of each SDK class (grouped by
+             subsystem), shared timers, network queues depth and in-flight requests (from
+             \b PNIntrospection snapshot) and process RSS. Samples taken after \c warmup used as
+             baseline, test fail if final values grew more than allowed.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNSoakTest : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on host (with port) which should be used by clients.
+ 
+ @default \c 127.0.0.1:8090
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *origin;
+
+/**
+ @brief  Stores whether clients should use secured connection.
+ 
+ @default \c NO
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign, getter = isTLSEnabled) BOOL TLSEnabled;
+
+/**
+ @brief  Stores keys which is used by all clients.
+ 
+ @default \c demo
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *publishKey;
+@property (nonatomic, copy) NSString *subscribeKey;
+
+/**
+ @brief  Stores number of client instances (each client publish and subscribe).
+ 
+ @default \c 4
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger clients;
+
+/**
+ @brief  Stores number of channels between which clients is distributed.
+ 
+ @default \c 2
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger channels;
+
+/**
+ @brief  Stores number of messages which each client send per second.
+ 
+ @default \c 5
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double rate;
+
+/**
+ @brief  Stores size of padding (in bytes) which is added to each published message.
+ 
+ @default \c 64
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger messageSize;
+
+/**
+ @brief  Stores interval (in seconds) with which clients send heartbeat.
+ 
+ @default \c 2 seconds (presence timeout set to three intervals).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSInteger heartbeatInterval;
+
+/**
+ @brief      Stores length of re-subscribe / reconnect cycle (in seconds).
+ @discussion On each cycle one of clients unsubscribe and subscribe back, on each second cycle
+             mock server asked to fail next subscribe request of each client.
+ 
+ @default \c 10 seconds.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval cycle;
+
+/**
+ @brief  Stores durations (in seconds) of warmup phase and whole test.
+ 
+ @default \c 60 seconds and \c 1 hour.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval warmup;
+@property (nonatomic, assign) NSTimeInterval duration;
+
+/**
+ @brief  Stores interval (in seconds) between samples.
+ 
+ @default \c 10 seconds.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval sampleInterval;
+
+/**
+ @brief  Stores relative growth (\c 0.2 is 20%) comparing to baseline after which test fail.
+ 
+ @default \c 0.2
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double threshold;
+
+/**
+ @brief      Stores absolute growth of counters which is allowed regardless of \c threshold.
+ @discussion Small counters (timers, in-flight requests, managers) fluctuate with load, so relative
+             change alone can't be used for them.
+ 
+ @default \c 20
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger allowance;
+
+
+///------------------------------------------------
+/// @name Running
+///------------------------------------------------
+
+/**
+ @brief      Create clients, run load cycle and print samples.
+ @discussion Method block calling thread till test completion.
+ 
+ @return Report with \c samples list, \c baseline and \c final samples and \c failures list which
+         describe metrics which grew more than allowed (empty when test passed).
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)run;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,502 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNSoakTest.h"
+#import <libkern/OSAtomic.h>
+#import <PubNub/PubNub.h>
+#import "PNInstanceTracker.h"
+#import "PNLoadTest.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores number of last samples which is averaged to get final values.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNSoakTestFinalSamples = 3;
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNSoakTest () <PNObjectEventListener>
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores reference on list of clients which is used during test.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *clientInstances;
+
+/**
+ @brief  Stores reference on queue on which publish and cycle timers fire.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t timersQueue;
+
+/**
+ @brief  Stores number of cycles which has been completed.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger cycles;
+
+
+#pragma mark - Clients
+
+/**
+ @brief  Create clients, add listener and subscribe.
+ 
+ @since 4.1.0
+ */
+- (void)prepareClients;
+
+/**
+ @brief  Unsubscribe all clients and release them.
+ 
+ @since 4.1.0
+ */
+- (void)releaseClients;
+
+
+#pragma mark - Load
+
+/**
+ @brief  Create timers which publish messages and drive re-subscribe / reconnect cycle.
+ 
+ @return List of dispatch sources which should be cancelled at the end of test.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)startLoad;
+
+/**
+ @brief  Perform single re-subscribe / reconnect cycle.
+ 
+ @since 4.1.0
+ */
+- (void)performCycle;
+
+
+#pragma mark - Sampling
+
+/**
+ @brief  Take sample of instances, timers, queues and memory usage.
+ 
+ @param elapsed Number of seconds since test start.
+ 
+ @return Sample dictionary.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)sampleAtTime:(NSTimeInterval)elapsed;
+
+/**
+ @brief  Compose sample which contain average values of \c samples.
+ 
+ @param samples List of samples which should be averaged.
+ 
+ @return Sample dictionary.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)averageOfSamples:(NSArray *)samples;
+
+/**
+ @brief  Compare \c final sample with \c baseline.
+ 
+ @param baseline Reference on sample which has been taken after warmup.
+ @param final    Reference on sample with average of last samples.
+ 
+ @return List of human-readable descriptions for metrics which grew more than allowed.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)failuresForBaseline:(NSDictionary *)baseline final:(NSDictionary *)final;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Compose name of channel by it's index.
+ 
+ @param channelIdx Index of channel from \c 0 till \c channels.
+ 
+ @return Channel name.
+ 
+ @since 4.1.0
+ */
+- (NSString *)channelWithIndex:(NSUInteger)channelIdx;
+
+/**
+ @brief  Print single sample to standard output.
+ 
+ @param sample Reference on sample which should be printed.
+ 
+ @since 4.1.0
+ */
+- (void)printSample:(NSDictionary *)sample;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNSoakTest {
+    
+    // Counters updated from clients callback queues.
+    volatile int64_t _published;
+    volatile int64_t _delivered;
+    volatile int64_t _disconnects;
+}
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _origin = @"127.0.0.1:8090";
+        _publishKey = @"demo";
+        _subscribeKey = @"demo";
+        _clients = 4;
+        _channels = 2;
+        _rate = 5.0f;
+        _messageSize = 64;
+        _heartbeatInterval = 2;
+        _cycle = 10.0f;
+        _warmup = 60.0f;
+        _duration = 3600.0f;
+        _sampleInterval = 10.0f;
+        _threshold = 0.2f;
+        _allowance = 20;
+        _clientInstances = [NSMutableArray new];
+        _timersQueue = dispatch_queue_create("com.pubnub.soak-test", DISPATCH_QUEUE_SERIAL);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Running
+
+- (NSDictionary *)run {
+    
+    // Hooks should be in place before first SDK object will be created.
+    [PNInstanceTracker install];
+    self.clients = MAX(self.clients, (NSUInteger)1);
+    self.channels = MAX(self.channels, (NSUInteger)1);
+    printf("Soak %lu clients on %lu channels against %s for %.0f seconds\n",
+           (unsigned long)self.clients, (unsigned long)self.channels, [self.origin UTF8String],
+           self.duration);
+    
+    [self prepareClients];
+    NSArray *timers = [self startLoad];
+    NSMutableArray *samples = [NSMutableArray new];
+    NSDictionary *baseline = nil;
+    uint64_t start = PNLoadTestNow();
+    NSTimeInterval elapsed = 0.0f;
+    while (elapsed < self.duration) {
+        
+        [NSThread sleepForTimeInterval:MIN(self.sampleInterval, self.duration - elapsed)];
+        @autoreleasepool {
+            
+            elapsed = (double)(PNLoadTestNow() - start) / NSEC_PER_SEC;
+            NSDictionary *sample = [self sampleAtTime:elapsed];
+            [samples addObject:sample];
+            [self printSample:sample];
+            if (!baseline && elapsed >= self.warmup) { baseline = sample; }
+        }
+    }
+    for (dispatch_source_t timer in timers) { dispatch_source_cancel(timer); }
+    // Wait for cycle which may be in progress, because it use list of clients.
+    dispatch_sync(self.timersQueue, ^{});
+    [self releaseClients];
+    
+    NSUInteger finalCount = MIN([samples count], kPNSoakTestFinalSamples);
+    NSRange finalRange = NSMakeRange([samples count] - finalCount, finalCount);
+    NSDictionary *final = [self averageOfSamples:[samples subarrayWithRange:finalRange]];
+    NSArray *failures = @[];
+    if (baseline && final && ![[samples subarrayWithRange:finalRange] containsObject:baseline]) {
+        
+        failures = [self failuresForBaseline:baseline final:final];
+    }
+    else {
+        
+        fprintf(stderr, "Test too short to compare samples taken after warmup\n");
+    }
+    printf("\n%s\n", ([failures count] ? "Resources growth exceed limits:" : "No growth detected"));
+    for (NSString *failure in failures) { printf("  %s\n", [failure UTF8String]); }
+    
+    NSMutableDictionary *report = [@{@"samples": samples, @"failures": failures} mutableCopy];
+    if (baseline) { report[@"baseline"] = baseline; }
+    if (final) { report[@"final"] = final; }
+    
+    return [report copy];
+}
+
+
+#pragma mark - Clients
+
+- (void)prepareClients {
+    
+    for (NSUInteger clientIdx = 0; clientIdx < self.clients; clientIdx++) {
+        
+        PNConfiguration *configuration = nil;
+        configuration = [PNConfiguration configurationWithPublishKey:self.publishKey
+                                                        subscribeKey:self.subscribeKey];
+        configuration.origin = self.origin;
+        configuration.TLSEnabled = self.isTLSEnabled;
+        configuration.uuid = [NSString stringWithFormat:@"pn-soak-%lu", (unsigned long)clientIdx];
+        configuration.presenceHeartbeatInterval = self.heartbeatInterval;
+        configuration.presenceHeartbeatValue = self.heartbeatInterval * 3;
+        NSString *queueName = [NSString stringWithFormat:@"com.pubnub.soak-test.%lu",
+                               (unsigned long)clientIdx];
+        dispatch_queue_t queue = dispatch_queue_create([queueName UTF8String],
+                                                       DISPATCH_QUEUE_SERIAL);
+        PubNub *client = [PubNub clientWithConfiguration:configuration callbackQueue:queue];
+        [client addListener:self];
+        [client subscribeToChannels:@[[self channelWithIndex:(clientIdx % self.channels)]]
+                       withPresence:YES];
+        [self.clientInstances addObject:client];
+    }
+}
+
+- (void)releaseClients {
+    
+    for (PubNub *client in self.clientInstances) {
+        
+        [client removeListener:self];
+        [client unsubscribeFromChannels:[client channels] withPresence:YES];
+    }
+    [self.clientInstances removeAllObjects];
+}
+
+
+#pragma mark - Load
+
+- (NSArray *)startLoad {
+    
+    NSMutableString *padding = [NSMutableString new];
+    for (NSUInteger characterIdx = 0; characterIdx < self.messageSize; characterIdx++) {
+        
+        [padding appendString:@"x"];
+    }
+    NSArray *clients = [self.clientInstances copy];
+    uint64_t interval = (uint64_t)(NSEC_PER_SEC / MAX(self.rate, 0.001f));
+    dispatch_source_t publishTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0,
+                                                            self.timersQueue);
+    dispatch_source_set_timer(publishTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval),
+                              interval, interval / 10);
+    __block uint64_t sequence = 0;
+    dispatch_source_set_event_handler(publishTimer, ^{
+        
+        [clients enumerateObjectsUsingBlock:^(PubNub *client, NSUInteger clientIdx, BOOL *stop) {
+            
+            NSDictionary *message = @{@"sequence": @(sequence++), @"payload": padding};
+            [client publish:message toChannel:[self channelWithIndex:(clientIdx % self.channels)]
+             withCompletion:^(PNPublishStatus *status) {
+                
+                if (!status.isError) { OSAtomicIncrement64Barrier(&self->_published); }
+            }];
+        }];
+    });
+    
+    uint64_t cycle = (uint64_t)(MAX(self.cycle, 0.1f) * NSEC_PER_SEC);
+    dispatch_source_t cycleTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0,
+                                                          self.timersQueue);
+    dispatch_source_set_timer(cycleTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)cycle), cycle,
+                              cycle / 10);
+    dispatch_source_set_event_handler(cycleTimer, ^{ [self performCycle]; });
+    
+    dispatch_resume(publishTimer);
+    dispatch_resume(cycleTimer);
+    
+    return @[publishTimer, cycleTimer];
+}
+
+- (void)performCycle {
+    
+    // Re-subscribe exercise subscriber state and client state cache clean up.
+    NSUInteger clientIdx = (self.cycles % self.clients);
+    PubNub *client = self.clientInstances[clientIdx];
+    NSArray *channels = @[[self channelWithIndex:(clientIdx % self.channels)]];
+    [client unsubscribeFromChannels:channels withPresence:YES];
+    [client subscribeToChannels:channels withPresence:YES];
+    
+    // Failed subscribe requests exercise unexpected disconnect, retry timers and reconnection.
+    if (self.cycles % 2 == 1) {
+        
+        NSString *scheme = (self.isTLSEnabled ? @"https" : @"http");
+        NSString *failURL = [NSString stringWithFormat:@"%@://%@/control/fail?count=%lu", scheme,
+                             self.origin, (unsigned long)self.clients];
+        [[[NSURLSession sharedSession] dataTaskWithURL:[NSURL URLWithString:failURL]] resume];
+    }
+    self.cycles++;
+}
+
+
+#pragma mark - Listener
+
+- (void)client:(PubNub *)client didReceiveMessage:(PNMessageResult *)message {
+    
+    OSAtomicIncrement64Barrier(&_delivered);
+}
+
+- (void)client:(PubNub *)client didReceiveStatus:(PNSubscribeStatus *)status {
+    
+    if (status.category == PNUnexpectedDisconnectCategory) {
+        
+        OSAtomicIncrement64Barrier(&_disconnects);
+    }
+}
+
+
+#pragma mark - Sampling
+
+- (NSDictionary *)sampleAtTime:(NSTimeInterval)elapsed {
+    
+    NSDictionary *instances = [PNInstanceTracker liveInstances];
+    NSDictionary *snapshot = [NSJSONSerialization JSONObjectWithData:[PNIntrospection snapshotData]
+                                                             options:(NSJSONReadingOptions)0
+                                                               error:NULL];
+    NSUInteger queued = 0;
+    NSUInteger loopback = 0;
+    NSUInteger requests = 0;
+    for (NSDictionary *clientSnapshot in snapshot[@"clients"]) {
+        
+        for (NSString *network in @[@"subscriptionNetwork", @"serviceNetwork"]) {
+            
+            queued += [clientSnapshot[network][@"queuedOperations"] unsignedIntegerValue];
+            loopback += [clientSnapshot[network][@"loopbackRequests"] unsignedIntegerValue];
+            requests += [clientSnapshot[network][@"requests"] count];
+        }
+    }
+    
+    return @{@"time": @(elapsed), @"rss": @(PNLoadTestResidentSize()),
+             @"timers": (snapshot[@"timers"][@"timers"]?: @0), @"queuedOperations": @(queued),
+             @"loopbackRequests": @(loopback), @"requests": @(requests),
+             @"clients": @([snapshot[@"clients"] count]),
+             @"published": @(_published), @"delivered": @(_delivered),
+             @"disconnects": @(_disconnects), @"instances": instances,
+             @"subsystems": [PNInstanceTracker subsystemsForInstances:instances]};
+}
+
+- (NSDictionary *)averageOfSamples:(NSArray *)samples {
+    
+    if (![samples count]) { return nil; }
+    
+    NSMutableDictionary *average = [NSMutableDictionary new];
+    NSMutableDictionary *instances = [NSMutableDictionary new];
+    NSMutableDictionary *subsystems = [NSMutableDictionary new];
+    double count = (double)[samples count];
+    for (NSDictionary *sample in samples) {
+        
+        [sample enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+            
+            if ([value isKindOfClass:[NSNumber class]]) {
+                
+                average[key] = @([average[key] doubleValue] + [value doubleValue] / count);
+            }
+        }];
+        for (NSString *key in @[@"instances", @"subsystems"]) {
+            
+            BOOL isInstances = [key isEqualToString:@"instances"];
+            NSMutableDictionary *target = (isInstances ? instances : subsystems);
+            [sample[key] enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSNumber *value,
+                                                             BOOL *stop) {
+                
+                target[name] = @([target[name] doubleValue] + [value doubleValue] / count);
+            }];
+        }
+    }
+    average[@"instances"] = instances;
+    average[@"subsystems"] = subsystems;
+    
+    return [average copy];
+}
+
+- (NSArray *)failuresForBaseline:(NSDictionary *)baseline final:(NSDictionary *)final {
+    
+    NSMutableArray *failures = [NSMutableArray new];
+    double baselineRSS = [baseline[@"rss"] doubleValue];
+    double finalRSS = [final[@"rss"] doubleValue];
+    if (baselineRSS > 0.0f && (finalRSS - baselineRSS) / baselineRSS > self.threshold) {
+        
+        [failures addObject:[NSString stringWithFormat:@"RSS %.1f MB -> %.1f MB",
+                             baselineRSS / (1024 * 1024), finalRSS / (1024 * 1024)]];
+    }
+    
+    BOOL(^exceeded)(double, double) = ^BOOL(double initial, double current) {
+        
+        return ((current - initial) > MAX((double)self.allowance, initial * self.threshold));
+    };
+    for (NSString *name in @[@"timers", @"queuedOperations", @"loopbackRequests", @"requests"]) {
+        
+        double initial = [baseline[name] doubleValue];
+        double current = [final[name] doubleValue];
+        if (exceeded(initial, current)) {
+            
+            [failures addObject:[NSString stringWithFormat:@"%@ %.0f -> %.1f", name, initial,
+                                 current]];
+        }
+    }
+    NSMutableSet *classes = [NSMutableSet setWithArray:[baseline[@"instances"] allKeys]];
+    [classes addObjectsFromArray:[final[@"instances"] allKeys]];
+    NSArray *classNames = [[classes allObjects] sortedArrayUsingSelector:@selector(compare:)];
+    for (NSString *className in classNames) {
+        
+        double initial = [baseline[@"instances"][className] doubleValue];
+        double current = [final[@"instances"][className] doubleValue];
+        if (exceeded(initial, current)) {
+            
+            [failures addObject:[NSString stringWithFormat:@"%@ instances %.0f -> %.1f",
+                                 className, initial, current]];
+        }
+    }
+    
+    return [failures copy];
+}
+
+
+#pragma mark - Misc
+
+- (NSString *)channelWithIndex:(NSUInteger)channelIdx {
+    
+    return [NSString stringWithFormat:@"pn-soak-%lu", (unsigned long)channelIdx];
+}
+
+- (void)printSample:(NSDictionary *)sample {
+    
+    NSMutableString *subsystems = [NSMutableString new];
+    NSDictionary *counts = sample[@"subsystems"];
+    for (NSString *name in [[counts allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        
+        [subsystems appendFormat:@" %@ %@", name, counts[name]];
+    }
+    printf("[%7.0fs] rss %7.1f MB  timers %4lu  queued %4lu  in-flight %4lu  msgs %llu/%llu  "
+           "disconnects %llu |%s\n", [sample[@"time"] doubleValue],
+           [sample[@"rss"] doubleValue] / (1024 * 1024), [sample[@"timers"] unsignedLongValue],
+           [sample[@"queuedOperations"] unsignedLongValue],
+           [sample[@"requests"] unsignedLongValue], [sample[@"published"] unsignedLongLongValue],
+           [sample[@"delivered"] unsignedLongLongValue],
+           [sample[@"disconnects"] unsignedLongLongValue], [subsystems UTF8String]);
+    fflush(stdout);
+}
+
+#pragma mark -
+
+
+@end
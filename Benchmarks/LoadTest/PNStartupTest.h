@@ -0,0 +1,73 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Client construction (cold start) benchmark.
+ @discussion Test construct \c clients client instances one after another and measure time which
+             has been spent on each of them and resident memory which is held by constructed
+             clients. First client reported separately, because it pay for process-wide state
+             (logger, shared headers and schedulers). Optionally each client can access all
+             subsystems right after construction to show cost of clients which start to use them.
+             Clients can be retrieved from \b PNClientPool (one per user identity) to measure
+             per-identity memory.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNStartupTest : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores number of client instances which should be constructed.
+ 
+ @default \c 1000
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger clients;
+
+/**
+ @brief  Stores whether each client should create all managers, network managers and reachability
+         helper right after construction.
+ 
+ @default \c NO
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) BOOL useSubsystems;
+
+/**
+ @brief  Stores whether clients should be retrieved from \b PNClientPool (each with own \c uuid
+         and \c authKey) or constructed as standalone clients.
+ 
+ @default \c NO
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) BOOL usePool;
+
+
+///------------------------------------------------
+/// @name Running
+///------------------------------------------------
+
+/**
+ @brief      Construct clients and print report.
+ @discussion Method block calling thread till test completion.
+ 
+ @return Report with first client construction time, total and per-client construction time,
+         \c construction percentiles (in milliseconds) and resident memory per client.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)run;
+
+#pragma mark -
+
+
+@end
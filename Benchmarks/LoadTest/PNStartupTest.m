@@ -0,0 +1,209 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNStartupTest.h"
+#import <PubNub/PubNub.h>
+#import "PubNub+CorePrivate.h"
+#import "PNRequestParameters.h"
+#import "PNLoadTest.h"
+
+
+#pragma mark Protected interface declaration
+
+@interface PNStartupTest ()
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores reference on list of clients which has been constructed during test.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *clientInstances;
+
+/**
+ @brief  Stores reference on pool from which clients retrieved (if \c usePool is set).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNClientPool *pool;
+
+
+#pragma mark - Clients
+
+/**
+ @brief  Construct client with configuration which is unique for passed index.
+ 
+ @param clientIdx Index of client which is used to compose client identifier.
+ 
+ @return Constructed client instance.
+ 
+ @since 4.1.0
+ */
+- (PubNub *)clientWithIndex:(NSUInteger)clientIdx;
+
+/**
+ @brief  Force client to create all it's managers, network managers and helpers.
+ 
+ @param client Reference on client which should create subsystems.
+ 
+ @since 4.1.0
+ */
+- (void)useSubsystemsOfClient:(PubNub *)client;
+
+
+#pragma mark - Running
+
+/**
+ @brief  Print human-readable report to standard output.
+ 
+ @param report Reference on report which has been composed at the end of test.
+ 
+ @since 4.1.0
+ */
+- (void)printReport:(NSDictionary *)report;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNStartupTest
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _clients = 1000;
+        _clientInstances = [NSMutableArray new];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Running
+
+- (NSDictionary *)run {
+    
+    printf("Constructing %lu %s%s\n", (unsigned long)self.clients,
+           (self.usePool ? "pooled clients" : "clients"),
+           (self.useSubsystems ? " with subsystems" : ""));
+    
+    // First client pay for process-wide state (and pool), so it excluded from per-client values.
+    uint64_t start = PNLoadTestNow();
+    if (self.usePool) {
+        
+        PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                         subscribeKey:@"demo"];
+        self.pool = [PNClientPool poolWithConfiguration:configuration];
+    }
+    [self.clientInstances addObject:[self clientWithIndex:0]];
+    uint64_t firstClient = PNLoadTestNow() - start;
+    
+    NSMutableArray *samples = [NSMutableArray new];
+    uint64_t residentAtStart = PNLoadTestResidentSize();
+    double cpuAtStart = PNLoadTestCPUTime();
+    start = PNLoadTestNow();
+    for (NSUInteger clientIdx = 1; clientIdx < self.clients; clientIdx++) {
+        
+        @autoreleasepool {
+            
+            uint64_t clientStart = PNLoadTestNow();
+            [self.clientInstances addObject:[self clientWithIndex:clientIdx]];
+            [samples addObject:@(PNLoadTestNow() - clientStart)];
+        }
+    }
+    double elapsed = (double)(PNLoadTestNow() - start) / NSEC_PER_SEC;
+    double cpu = PNLoadTestCPUTime() - cpuAtStart;
+    uint64_t resident = PNLoadTestResidentSize();
+    uint64_t residentGrowth = (resident > residentAtStart ? resident - residentAtStart : 0);
+    NSUInteger measuredClients = MAX([samples count], (NSUInteger)1);
+    [self.clientInstances removeAllObjects];
+    self.pool = nil;
+    
+    NSDictionary *report = @{
+        @"clients": @(self.clients), @"useSubsystems": @(self.useSubsystems),
+        @"usePool": @(self.usePool),
+        @"firstClient": @((double)firstClient / NSEC_PER_MSEC), @"duration": @(elapsed),
+        @"perClient": @(elapsed * 1000000.0f / measuredClients),
+        @"construction": PNLoadTestPercentiles(samples), @"cpu": @(cpu),
+        @"residentGrowth": @(residentGrowth),
+        @"residentPerClient": @(residentGrowth / measuredClients)
+    };
+    [self printReport:report];
+    
+    return report;
+}
+
+- (void)printReport:(NSDictionary *)report {
+    
+    printf("\nConstructed %lu clients in %.3f seconds (%.3f seconds CPU)\n",
+           [report[@"clients"] unsignedLongValue], [report[@"duration"] doubleValue],
+           [report[@"cpu"] doubleValue]);
+    printf("  first      %10.3f ms\n", [report[@"firstClient"] doubleValue]);
+    printf("  per client %10.1f us\n", [report[@"perClient"] doubleValue]);
+    NSDictionary *construction = report[@"construction"];
+    printf("  construct  p50 %8.3f  p90 %8.3f  p99 %8.3f  p99.9 %8.3f  max %8.3f ms\n",
+           [construction[@"p50"] doubleValue], [construction[@"p90"] doubleValue],
+           [construction[@"p99"] doubleValue], [construction[@"p99.9"] doubleValue],
+           [construction[@"max"] doubleValue]);
+    printf("  memory     %10.1f KB  %10.1f KB/client\n",
+           [report[@"residentGrowth"] doubleValue] / 1024,
+           [report[@"residentPerClient"] doubleValue] / 1024);
+}
+
+
+#pragma mark - Clients
+
+- (PubNub *)clientWithIndex:(NSUInteger)clientIdx {
+    
+    NSString *uuid = [NSString stringWithFormat:@"pn-startup-%lu", (unsigned long)clientIdx];
+    PubNub *client = nil;
+    if (self.pool) {
+        
+        client = [self.pool clientWithUUID:uuid
+                                   authKey:[@"auth-" stringByAppendingString:uuid]];
+    }
+    else {
+        
+        PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                         subscribeKey:@"demo"];
+        configuration.uuid = uuid;
+        client = [PubNub clientWithConfiguration:configuration];
+    }
+    if (self.useSubsystems) {
+        
+        [self useSubsystemsOfClient:client];
+    }
+    
+    return client;
+}
+
+- (void)useSubsystemsOfClient:(PubNub *)client {
+    
+    [client subscriberManager];
+    [client clientStateManager];
+    [client listenersManager];
+    [client heartbeatManager];
+    [client reachability];
+    [client packetSizeForOperation:PNSubscribeOperation withParameters:[PNRequestParameters new]
+                              data:nil];
+    [client packetSizeForOperation:PNTimeOperation withParameters:[PNRequestParameters new]
+                              data:nil];
+}
+
+#pragma mark -
+
+
+@end
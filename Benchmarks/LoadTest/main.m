@@ -0,0 +1,209 @@
+/**
+ @brief  End-to-end load, soak, traffic replay and client construction tests for PubNub client.
+ @discussion Usage: pubnub-load-test [--mode <load|soak>] [--origin <host:port>] [--tls <0|1>]
+                                     [--transport <http|loopback>]
+                                     [--clients <count>] [--publishers <count>]
+                                     [--subscribers <count>] [--channels <count>]
+                                     [--rate <messages/s>] [--size <bytes>] [--compress <0|1>]
+                                     [--warmup <seconds>] [--duration <seconds>]
+                                     [--drain <seconds>] [--capture <file>] [--report <file>]
+             Soak mode options: [--heartbeat <seconds>] [--cycle <seconds>] [--sample <seconds>]
+                                [--threshold <fraction>] [--allowance <count>]
+             Replay mode: pubnub-load-test --mode replay --trace <file> [--speed <multiplier|0>]
+                                           [--clients <count>] [--drain <seconds>]
+                                           [--report <file>]
+             Startup mode: pubnub-load-test --mode startup [--clients <count>]
+                                           [--subsystems <0|1>] [--pool <0|1>]
+                                           [--report <file>]
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <Foundation/Foundation.h>
+#import "PNLoadTest.h"
+#import "PNStartupTest.h"
+#import "PNReplayTest.h"
+#import "PNSoakTest.h"
+
+
+#pragma mark Private functions
+
+/**
+ @brief  Configure and run soak test.
+ 
+ @param options Reference on command-line options.
+ 
+ @return Soak test report.
+ 
+ @since 4.1.0
+ */
+static NSDictionary *PNRunSoakTest(NSDictionary *options) {
+    
+    PNSoakTest *test = [PNSoakTest new];
+    if (options[@"--origin"]) { test.origin = options[@"--origin"]; }
+    if (options[@"--tls"]) { test.TLSEnabled = [options[@"--tls"] boolValue]; }
+    if (options[@"--publish-key"]) { test.publishKey = options[@"--publish-key"]; }
+    if (options[@"--subscribe-key"]) { test.subscribeKey = options[@"--subscribe-key"]; }
+    if (options[@"--clients"]) {
+        
+        test.clients = (NSUInteger)MAX([options[@"--clients"] integerValue], 1);
+    }
+    if (options[@"--channels"]) {
+        
+        test.channels = (NSUInteger)MAX([options[@"--channels"] integerValue], 1);
+    }
+    if (options[@"--rate"]) { test.rate = [options[@"--rate"] doubleValue]; }
+    if (options[@"--size"]) {
+        
+        test.messageSize = (NSUInteger)MAX([options[@"--size"] integerValue], 0);
+    }
+    if (options[@"--heartbeat"]) {
+        
+        test.heartbeatInterval = MAX([options[@"--heartbeat"] integerValue], 1);
+    }
+    if (options[@"--cycle"]) { test.cycle = [options[@"--cycle"] doubleValue]; }
+    if (options[@"--warmup"]) { test.warmup = [options[@"--warmup"] doubleValue]; }
+    if (options[@"--duration"]) { test.duration = [options[@"--duration"] doubleValue]; }
+    if (options[@"--sample"]) { test.sampleInterval = [options[@"--sample"] doubleValue]; }
+    if (options[@"--threshold"]) { test.threshold = [options[@"--threshold"] doubleValue]; }
+    if (options[@"--allowance"]) {
+        
+        test.allowance = (NSUInteger)MAX([options[@"--allowance"] integerValue], 0);
+    }
+    
+    return [test run];
+}
+
+/**
+ @brief  Configure and run load test.
+ 
+ @param options Reference on command-line options.
+ 
+ @return Load test report or \c nil in case if subscribers wasn't able to connect.
+ 
+ @since 4.1.0
+ */
+static NSDictionary *PNRunLoadTest(NSDictionary *options) {
+    
+    PNLoadTest *test = [PNLoadTest new];
+    if (options[@"--origin"]) { test.origin = options[@"--origin"]; }
+    if (options[@"--tls"]) { test.TLSEnabled = [options[@"--tls"] boolValue]; }
+    if ([options[@"--transport"] isEqualToString:@"loopback"]) {
+        
+        test.transport = PNLoopbackTransport;
+    }
+    if (options[@"--publish-key"]) { test.publishKey = options[@"--publish-key"]; }
+    if (options[@"--subscribe-key"]) { test.subscribeKey = options[@"--subscribe-key"]; }
+    if (options[@"--clients"]) {
+        
+        test.clients = (NSUInteger)MAX([options[@"--clients"] integerValue], 1);
+    }
+    if (options[@"--publishers"]) {
+        
+        test.publishers = (NSUInteger)MAX([options[@"--publishers"] integerValue], 0);
+    }
+    if (options[@"--subscribers"]) {
+        
+        test.subscribers = (NSUInteger)MAX([options[@"--subscribers"] integerValue], 0);
+    }
+    if (options[@"--channels"]) {
+        
+        test.channels = (NSUInteger)MAX([options[@"--channels"] integerValue], 1);
+    }
+    if (options[@"--rate"]) { test.rate = [options[@"--rate"] doubleValue]; }
+    if (options[@"--size"]) {
+        
+        test.messageSize = (NSUInteger)MAX([options[@"--size"] integerValue], 0);
+    }
+    if (options[@"--compress"]) { test.compress = [options[@"--compress"] boolValue]; }
+    if (options[@"--warmup"]) { test.warmup = [options[@"--warmup"] doubleValue]; }
+    if (options[@"--duration"]) { test.duration = [options[@"--duration"] doubleValue]; }
+    if (options[@"--drain"]) { test.drain = [options[@"--drain"] doubleValue]; }
+    if (options[@"--capture"]) { test.capturePath = options[@"--capture"]; }
+    
+    return [test run];
+}
+
+/**
+ @brief  Configure and run traffic replay.
+ 
+ @param options Reference on command-line options.
+ 
+ @return Replay report or \c nil in case if trace can't be loaded.
+ 
+ @since 4.1.0
+ */
+static NSDictionary *PNRunReplayTest(NSDictionary *options) {
+    
+    PNReplayTest *test = [PNReplayTest new];
+    test.tracePath = options[@"--trace"];
+    if (options[@"--speed"]) { test.speed = MAX([options[@"--speed"] doubleValue], 0.0f); }
+    if (options[@"--clients"]) {
+        
+        test.clients = (NSUInteger)MAX([options[@"--clients"] integerValue], 1);
+    }
+    if (options[@"--drain"]) { test.drain = [options[@"--drain"] doubleValue]; }
+    
+    return [test run];
+}
+
+/**
+ @brief  Configure and run client construction benchmark.
+ 
+ @param options Reference on command-line options.
+ 
+ @return Construction benchmark report.
+ 
+ @since 4.1.0
+ */
+static NSDictionary *PNRunStartupTest(NSDictionary *options) {
+    
+    PNStartupTest *test = [PNStartupTest new];
+    if (options[@"--clients"]) {
+        
+        test.clients = (NSUInteger)MAX([options[@"--clients"] integerValue], 1);
+    }
+    if (options[@"--subsystems"]) { test.useSubsystems = [options[@"--subsystems"] boolValue]; }
+    if (options[@"--pool"]) { test.usePool = [options[@"--pool"] boolValue]; }
+    
+    return [test run];
+}
+
+
+int main(int argc, const char * argv[]) {
+    
+    int status = 0;
+    @autoreleasepool {
+        
+        NSMutableDictionary *options = [NSMutableDictionary new];
+        for (int argumentIdx = 1; argumentIdx + 1 < argc; argumentIdx += 2) {
+            
+            options[@(argv[argumentIdx])] = @(argv[argumentIdx + 1]);
+        }
+        
+        NSDictionary *report = nil;
+        if ([options[@"--mode"] isEqualToString:@"soak"]) { report = PNRunSoakTest(options); }
+        else if ([options[@"--mode"] isEqualToString:@"replay"]) {
+            
+            report = PNRunReplayTest(options);
+        }
+        else if ([options[@"--mode"] isEqualToString:@"startup"]) {
+            
+            report = PNRunStartupTest(options);
+        }
+        else { report = PNRunLoadTest(options); }
+        if (report && options[@"--report"]) {
+            
+            NSData *data = [NSJSONSerialization dataWithJSONObject:report
+                                                           options:NSJSONWritingPrettyPrinted
+                                                             error:NULL];
+            [data writeToFile:options[@"--report"] atomically:YES];
+        }
+        // Soak test report resources growth with same status as benchmarks report regression.
+        if (!report) { status = 1; }
+        else if ([report[@"failures"] count]) { status = 2; }
+    }
+    
+    return status;
+}
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+"""Local stand-in for PubNub service used by load tests.
+
+Implements endpoints which is built by PNURLBuilder for time, subscribe long-poll, publish
+(GET and compressed POST), history, presence (heartbeat, leave, here now, where now, state) and
+channel groups. All data stored in memory, keys are not validated.
+
+GET /control/fail?count=N make next N subscribe requests fail with 503, so clients go through
+reconnection.
+"""
+import argparse
+import gzip
+import json
+import threading
+import time
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, unquote, urlsplit
+
+
+class Storage(object):
+	"""Messages, presence and channel groups shared by all connections."""
+
+	def __init__(self, history_size, presence_timeout):
+		self.history_size = history_size
+		self.presence_timeout = presence_timeout
+		self.condition = threading.Condition()
+		self.last_timetoken = 0
+		self.messages = {}
+		self.presence = {}
+		self.groups = {}
+		self.published = 0
+		self.delivered = 0
+		self.failures = 0
+
+	def timetoken(self):
+		# Time tokens should be unique and increasing even when requests arrive within same tick.
+		timetoken = max(int(time.time() * 10000000), self.last_timetoken + 1)
+		self.last_timetoken = timetoken
+		return timetoken
+
+	def publish(self, channel, message):
+		with self.condition:
+			timetoken = self.timetoken()
+			history = self.messages.setdefault(channel, [])
+			history.append((timetoken, message))
+			del history[:-self.history_size]
+			self.published += 1
+			self.condition.notify_all()
+			return timetoken
+
+	def should_fail(self):
+		with self.condition:
+			if self.failures > 0:
+				self.failures -= 1
+				return True
+			return False
+
+	def channels_for(self, channels, groups):
+		names = set(channel for channel in channels if channel)
+		with self.condition:
+			for group in groups:
+				names.update(self.groups.get(group, ()))
+		return names
+
+	def wait_for_messages(self, channels, since, timeout, limit):
+		deadline = time.time() + timeout
+		with self.condition:
+			while True:
+				events = []
+				for channel in channels:
+					events.extend((timetoken, channel, message)
+								  for timetoken, message in self.messages.get(channel, ())
+								  if timetoken > since)
+				remaining = deadline - time.time()
+				if events or remaining <= 0:
+					break
+				self.condition.wait(remaining)
+			events.sort(key=lambda event: event[0])
+			events = events[:limit]
+			self.delivered += len(events)
+			timetoken = events[-1][0] if events else max(since, self.last_timetoken)
+			return events, timetoken
+
+	def touch(self, channels, uuid, state=None):
+		now = time.time()
+		with self.condition:
+			for channel in channels:
+				entry = self.presence.setdefault(channel, {}).setdefault(uuid, {'state': {}})
+				entry['seen'] = now
+				if state is not None:
+					entry['state'] = state
+
+	def leave(self, channels, uuid):
+		with self.condition:
+			for channel in channels:
+				self.presence.get(channel, {}).pop(uuid, None)
+
+	def occupants(self, channel):
+		expired = time.time() - self.presence_timeout
+		with self.condition:
+			return dict((uuid, entry) for uuid, entry in self.presence.get(channel, {}).items()
+						if entry['seen'] >= expired)
+
+
+class Handler(BaseHTTPRequestHandler):
+	protocol_version = 'HTTP/1.1'
+	storage = None
+	options = None
+
+	def log_message(self, format, *args):
+		if self.options.verbose:
+			BaseHTTPRequestHandler.log_message(self, format, *args)
+
+	def do_GET(self):
+		self.route(None)
+
+	def do_POST(self):
+		length = int(self.headers.get('Content-Length') or 0)
+		self.route(self.rfile.read(length) if length else b'')
+
+	def respond(self, payload, status=200):
+		body = json.dumps(payload, separators=(',', ':')).encode('utf-8')
+		if self.options.latency:
+			time.sleep(self.options.latency / 1000.0)
+		self.send_response(status)
+		self.send_header('Content-Type', 'text/javascript; charset="UTF-8"')
+		self.send_header('Content-Length', str(len(body)))
+		self.send_header('Connection', 'keep-alive')
+		self.end_headers()
+		self.wfile.write(body)
+
+	def route(self, body):
+		url = urlsplit(self.path)
+		self.query = dict((key, values[-1]) for key, values in parse_qs(url.query).items())
+		components = [unquote(component) for component in url.path.split('/')[1:]]
+		routes = (
+			(['time', '0'], self.time),
+			(['control', 'fail'], self.fail),
+			(['subscribe', None, None, '0', None], self.subscribe),
+			(['publish', None, None, '0', None, '0', None], self.publish),
+			(['publish', None, None, '0', None, '0'], self.publish),
+			(['v2', 'history', 'sub-key', None, 'channel', None], self.history),
+			(['v2', 'presence', 'sub_key', None, 'channel', None, 'leave'], self.leave),
+			(['v2', 'presence', 'sub-key', None, 'channel', None, 'heartbeat'], self.heartbeat),
+			(['v2', 'presence', 'sub-key', None, 'channel', None, 'uuid', None, 'data'], self.set_state),
+			(['v2', 'presence', 'sub-key', None, 'channel', None, 'uuid', None], self.state),
+			(['v2', 'presence', 'sub-key', None, 'channel', None], self.here_now),
+			(['v2', 'presence', 'sub-key', None, 'uuid', None], self.where_now),
+			(['v2', 'presence', 'sub-key', None], self.global_here_now),
+			(['v1', 'channel-registration', 'sub-key', None, 'channel-group', None, 'remove'],
+			 self.remove_group),
+			(['v1', 'channel-registration', 'sub-key', None, 'channel-group', None], self.group),
+			(['v1', 'channel-registration', 'sub-key', None, 'channel-group'], self.groups),
+		)
+		for pattern, handler in routes:
+			if len(pattern) == len(components) and all(expected is None or expected == actual
+														for expected, actual in zip(pattern, components)):
+				arguments = [actual for expected, actual in zip(pattern, components) if expected is None]
+				try:
+					return handler(body, *arguments)
+				except ValueError as error:
+					return self.respond({'status': 400, 'error': True, 'message': str(error)}, 400)
+		self.respond({'status': 404, 'error': True, 'message': 'Not Found'}, 404)
+
+	def list_from(self, value):
+		return [item for item in (value or '').split(',') if item and item != ',']
+
+	def time(self, body):
+		with self.storage.condition:
+			timetoken = self.storage.timetoken()
+		self.respond([timetoken])
+
+	def fail(self, body):
+		with self.storage.condition:
+			self.storage.failures += int(self.query.get('count', 1))
+		self.respond({'status': 200, 'message': 'OK'})
+
+	def subscribe(self, body, sub_key, channels, timetoken):
+		if self.storage.should_fail():
+			return self.respond({'status': 503, 'error': True, 'message': 'Service Unavailable'}, 503)
+		names = self.list_from(channels)
+		groups = self.list_from(self.query.get('channel-group'))
+		uuid = self.query.get('uuid', '')
+		names = [name for name in names if not name.endswith('-pnpres')]
+		data_channels = self.storage.channels_for(names, groups)
+		self.storage.touch(data_channels, uuid)
+		since = int(timetoken or 0)
+		if since == 0:
+			with self.storage.condition:
+				timetoken = self.storage.timetoken()
+			return self.respond([[], str(timetoken)])
+		events, next_timetoken = self.storage.wait_for_messages(data_channels, since,
+																self.options.long_poll,
+																self.options.max_events)
+		payload = [[event[2] for event in events], str(next_timetoken)]
+		if events:
+			payload.append(','.join(event[1] for event in events))
+		self.respond(payload)
+
+	def publish(self, body, pub_key, sub_key, channel, message=None):
+		if message is None:
+			try:
+				message = gzip.decompress(body)
+			except (IOError, OSError):
+				message = zlib.decompress(body)
+			message = message.decode('utf-8')
+		timetoken = self.storage.publish(channel, json.loads(message))
+		self.respond([1, 'Sent', str(timetoken)])
+
+	def history(self, body, sub_key, channel):
+		count = min(int(self.query.get('count', 100)), 100)
+		start = int(self.query.get('start', 0) or 0)
+		end = int(self.query.get('end', 0) or 0)
+		with self.storage.condition:
+			entries = [entry for entry in self.storage.messages.get(channel, ())
+					   if (not start or entry[0] < start) and (not end or entry[0] >= end)]
+		entries = entries[:count] if self.query.get('reverse') == 'true' else entries[-count:]
+		if self.query.get('include_token') == 'true':
+			messages = [{'message': message, 'timetoken': timetoken} for timetoken, message in entries]
+		else:
+			messages = [message for timetoken, message in entries]
+		first = entries[0][0] if entries else 0
+		last = entries[-1][0] if entries else 0
+		self.respond([messages, first, last])
+
+	def heartbeat(self, body, sub_key, channels):
+		names = self.storage.channels_for(self.list_from(channels),
+										  self.list_from(self.query.get('channel-group')))
+		state = json.loads(self.query['state']) if self.query.get('state') else None
+		self.storage.touch(names, self.query.get('uuid', ''), state)
+		self.respond({'status': 200, 'message': 'OK', 'service': 'Presence'})
+
+	def leave(self, body, sub_key, channels):
+		names = self.storage.channels_for(self.list_from(channels),
+										  self.list_from(self.query.get('channel-group')))
+		self.storage.leave(names, self.query.get('uuid', ''))
+		self.respond({'status': 200, 'action': 'leave', 'message': 'OK', 'service': 'Presence'})
+
+	def here_now_entry(self, channel):
+		occupants = self.storage.occupants(channel)
+		entry = {'occupancy': len(occupants)}
+		if self.query.get('disable_uuids') != '1':
+			if self.query.get('state') == '1':
+				entry['uuids'] = [{'uuid': uuid, 'state': occupant['state']}
+								  for uuid, occupant in occupants.items()]
+			else:
+				entry['uuids'] = list(occupants.keys())
+		return entry
+
+	def here_now(self, body, sub_key, channels):
+		groups = self.list_from(self.query.get('channel-group'))
+		names = sorted(self.storage.channels_for(self.list_from(channels), groups))
+		if len(names) == 1 and not groups:
+			payload = self.here_now_entry(names[0])
+			payload.update({'status': 200, 'message': 'OK', 'service': 'Presence'})
+			return self.respond(payload)
+		self.respond_channels(names)
+
+	def global_here_now(self, body, sub_key):
+		with self.storage.condition:
+			names = sorted(self.storage.presence.keys())
+		self.respond_channels(names)
+
+	def respond_channels(self, names):
+		channels = dict((name, self.here_now_entry(name)) for name in names)
+		channels = dict((name, entry) for name, entry in channels.items() if entry['occupancy'])
+		self.respond({'status': 200, 'message': 'OK', 'service': 'Presence',
+					  'payload': {'channels': channels, 'total_channels': len(channels),
+								  'total_occupancy': sum(entry['occupancy'] for entry in channels.values())}})
+
+	def where_now(self, body, sub_key, uuid):
+		with self.storage.condition:
+			names = sorted(self.storage.presence.keys())
+		channels = [name for name in names if uuid in self.storage.occupants(name)]
+		self.respond({'status': 200, 'message': 'OK', 'service': 'Presence',
+					  'payload': {'channels': channels}})
+
+	def set_state(self, body, sub_key, channels, uuid):
+		state = json.loads(self.query.get('state') or '{}')
+		names = self.storage.channels_for(self.list_from(channels),
+										  self.list_from(self.query.get('channel-group')))
+		self.storage.touch(names, uuid, state)
+		self.respond({'status': 200, 'message': 'OK', 'service': 'Presence', 'payload': state})
+
+	def state(self, body, sub_key, channels, uuid):
+		groups = self.list_from(self.query.get('channel-group'))
+		names = sorted(self.storage.channels_for(self.list_from(channels), groups))
+		states = dict((name, self.storage.occupants(name).get(uuid, {}).get('state', {}))
+					  for name in names)
+		if len(names) == 1 and not groups:
+			return self.respond({'status': 200, 'message': 'OK', 'service': 'Presence',
+								 'uuid': uuid, 'channel': names[0], 'payload': states[names[0]]})
+		self.respond({'status': 200, 'message': 'OK', 'service': 'Presence', 'uuid': uuid,
+					  'payload': {'channels': states}})
+
+	def group(self, body, sub_key, group):
+		with self.storage.condition:
+			channels = self.storage.groups.setdefault(group, set())
+			if 'add' in self.query:
+				channels.update(self.list_from(self.query['add']))
+			elif 'remove' in self.query:
+				channels.difference_update(self.list_from(self.query['remove']))
+			else:
+				return self.respond({'status': 200, 'service': 'channel-registry', 'error': False,
+									 'payload': {'group': group, 'channels': sorted(channels)}})
+		self.respond({'status': 200, 'message': 'OK', 'service': 'channel-registry', 'error': False})
+
+	def remove_group(self, body, sub_key, group):
+		with self.storage.condition:
+			self.storage.groups.pop(group, None)
+		self.respond({'status': 200, 'message': 'OK', 'service': 'channel-registry', 'error': False})
+
+	def groups(self, body, sub_key):
+		with self.storage.condition:
+			groups = sorted(self.storage.groups.keys())
+		self.respond({'status': 200, 'service': 'channel-registry', 'error': False,
+					  'payload': {'namespace': '', 'groups': groups}})
+
+
+def report(storage, interval):
+	published, delivered = 0, 0
+	while True:
+		time.sleep(interval)
+		print('published %.1f/s, delivered %.1f/s' % ((storage.published - published) / interval,
+													  (storage.delivered - delivered) / interval))
+		published, delivered = storage.published, storage.delivered
+
+
+if __name__ == '__main__':
+	parser = argparse.ArgumentParser(description=__doc__,
+									 formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument('--host', default='127.0.0.1')
+	parser.add_argument('--port', type=int, default=8090)
+	parser.add_argument('--long-poll', type=float, default=20.0,
+						help='seconds before idle subscribe request returns empty response')
+	parser.add_argument('--max-events', type=int, default=100, help='events per subscribe response')
+	parser.add_argument('--history-size', type=int, default=100, help='messages stored per channel')
+	parser.add_argument('--presence-timeout', type=float, default=300.0,
+						help='seconds after last heartbeat when uuid leaves channel')
+	parser.add_argument('--latency', type=float, default=0.0,
+						help='artificial delay (ms) added to each response')
+	parser.add_argument('--report', type=float, default=0.0,
+						help='print throughput every N seconds')
+	parser.add_argument('--verbose', action='store_true', help='log each request')
+	arguments = parser.parse_args()
+
+	Handler.storage = Storage(arguments.history_size, arguments.presence_timeout)
+	Handler.options = arguments
+	server = ThreadingHTTPServer((arguments.host, arguments.port), Handler)
+	server.daemon_threads = True
+	if arguments.report > 0:
+		thread = threading.Thread(target=report, args=(Handler.storage, arguments.report))
+		thread.daemon = True
+		thread.start()
+	print('PubNub mock server listening on http://%s:%d' % (arguments.host, arguments.port))
+	try:
+		server.serve_forever()
+	except KeyboardInterrupt:
+		pass
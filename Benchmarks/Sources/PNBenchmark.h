@@ -0,0 +1,105 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief  Block which perform single benchmarked operation.
+ 
+ @since 4.1.0
+ */
+typedef void(^PNBenchmarkBlock)(void);
+
+
+/**
+ @brief      Offline microbenchmarks runner.
+ @discussion Each registered benchmark is calibrated to run for at least \c minimumDuration, after
+             that it is measured \c samples times and median of nanoseconds per operation and
+             bytes allocated per operation is reported. Results can be compared with stored
+             baseline and written as new baseline.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNBenchmark : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores minimum duration of single measurement sample (in seconds).
+ 
+ @default \c 0.2 seconds.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval minimumDuration;
+
+/**
+ @brief  Stores number of measurement samples from which median is taken.
+ 
+ @default \c 5 samples.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger samples;
+
+/**
+ @brief  Stores reference on regular expression which is used to filter benchmarks by name.
+ 
+ @default \c nil (all benchmarks run).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *filter;
+
+/**
+ @brief  Stores relative change (\c 0.1 is 10%) starting from which result is reported as
+         regression.
+ 
+ @default \c 0.1
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double regressionThreshold;
+
+
+///------------------------------------------------
+/// @name Registration
+///------------------------------------------------
+
+/**
+ @brief      Add benchmark to the list of benchmarks which should be run.
+ @discussion Names should be unique and stable, because they used as keys in baseline file.
+ 
+ @param name  Benchmark name in \c <component>/<case> format.
+ @param block Reference on block which perform single operation.
+ 
+ @since 4.1.0
+ */
+- (void)addBenchmark:(NSString *)name withBlock:(PNBenchmarkBlock)block;
+
+
+///------------------------------------------------
+/// @name Running
+///------------------------------------------------
+
+/**
+ @brief      Run all registered benchmarks and print results.
+ @discussion If \c baselinePath point to existing file, results will be compared with it.
+ 
+ @param baselinePath Full path to baseline file (can be \c nil).
+ @param recordPath   Full path to file into which results should be stored as new baseline
+                     (can be \c nil).
+ 
+ @return \c YES in case if there is no regressions comparing to baseline.
+ 
+ @since 4.1.0
+ */
+- (BOOL)runWithBaseline:(NSString *)baselinePath recordTo:(NSString *)recordPath;
+
+#pragma mark -
+
+
+@end
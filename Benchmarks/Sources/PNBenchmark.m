@@ -0,0 +1,287 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNBenchmark.h"
+#import "PNBenchmarkAllocations.h"
+#import <time.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores version of baseline file format.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNBenchmarkBaselineVersion = 1;
+
+
+#pragma mark - Externs
+
+/**
+ @brief  Retrieve monotonic time.
+ 
+ @return Number of nanoseconds since arbitrary point in the past.
+ 
+ @since 4.1.0
+ */
+static uint64_t pn_benchmark_time(void) {
+    
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    
+    return ((uint64_t)time.tv_sec * NSEC_PER_SEC + (uint64_t)time.tv_nsec);
+}
+
+
+#pragma mark - Private interface declaration
+
+@interface PNBenchmark ()
+
+
+#pragma mark - Properties
+
+/**
+ @brief  Stores reference on benchmark names in order in which they has been registered.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *names;
+
+/**
+ @brief  Stores reference on benchmark blocks stored under benchmark names.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *blocks;
+
+/**
+ @brief  Stores whether allocations can be counted on current platform.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) BOOL countAllocations;
+
+
+#pragma mark - Measurement
+
+/**
+ @brief  Find number of iterations which take at least \c minimumDuration.
+ 
+ @param block Reference on block which perform single operation.
+ 
+ @return Number of iterations which should be used for each sample.
+ 
+ @since 4.1.0
+ */
+- (NSUInteger)iterationsForBlock:(PNBenchmarkBlock)block;
+
+/**
+ @brief  Measure \c block.
+ 
+ @param block Reference on block which perform single operation.
+ 
+ @return Dictionary with \c nsPerOp and \c bytesPerOp keys (medians of all samples).
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)measureBlock:(PNBenchmarkBlock)block;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Calculate relative change of \c value comparing to \c baseline.
+ 
+ @return Relative change or \c 0 in case if there is no baseline value.
+ 
+ @since 4.1.0
+ */
+- (double)changeOf:(NSNumber *)value comparingTo:(NSNumber *)baseline;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNBenchmark
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _minimumDuration = 0.2f;
+        _samples = 5;
+        _regressionThreshold = 0.1f;
+        _names = [NSMutableArray new];
+        _blocks = [NSMutableDictionary new];
+        _countAllocations = [PNBenchmarkAllocations install];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Registration
+
+- (void)addBenchmark:(NSString *)name withBlock:(PNBenchmarkBlock)block {
+    
+    if (!self.blocks[name]) {
+        
+        [self.names addObject:name];
+    }
+    self.blocks[name] = [block copy];
+}
+
+
+#pragma mark - Running
+
+- (BOOL)runWithBaseline:(NSString *)baselinePath recordTo:(NSString *)recordPath {
+    
+    NSDictionary *baseline = nil;
+    NSData *baselineData = (baselinePath ? [NSData dataWithContentsOfFile:baselinePath] : nil);
+    if (baselineData) {
+        
+        baseline = [NSJSONSerialization JSONObjectWithData:baselineData options:(NSJSONReadingOptions)0
+                                                     error:nil][@"benchmarks"];
+    }
+    else if (baselinePath) {
+        
+        printf("Baseline file not found at %s\n", [baselinePath UTF8String]);
+    }
+    NSRegularExpression *filter = nil;
+    if (self.filter) {
+        
+        filter = [NSRegularExpression regularExpressionWithPattern:self.filter options:0 error:nil];
+    }
+    
+    printf("%-58s %14s %12s %9s %9s\n", "benchmark", "ns/op", "bytes/op", "Δns", "Δbytes");
+    NSMutableDictionary *results = [NSMutableDictionary new];
+    NSUInteger regressions = 0;
+    for (NSString *name in self.names) {
+        
+        if (filter && ![filter firstMatchInString:name options:0
+                                             range:NSMakeRange(0, [name length])]) {
+            
+            continue;
+        }
+        NSDictionary *result = [self measureBlock:self.blocks[name]];
+        results[name] = result;
+        
+        double timeChange = [self changeOf:result[@"nsPerOp"]
+                               comparingTo:baseline[name][@"nsPerOp"]];
+        double bytesChange = [self changeOf:result[@"bytesPerOp"]
+                                comparingTo:baseline[name][@"bytesPerOp"]];
+        BOOL regressed = (timeChange > self.regressionThreshold ||
+                          bytesChange > self.regressionThreshold);
+        regressions += (regressed ? 1 : 0);
+        NSString *bytes = (self.countAllocations ?
+                           [NSString stringWithFormat:@"%.0f", [result[@"bytesPerOp"] doubleValue]] :
+                           @"n/a");
+        NSString *timeDelta = (baseline[name] ?
+                               [NSString stringWithFormat:@"%+.1f%%", (timeChange * 100.0f)] : @"-");
+        NSString *bytesDelta = (baseline[name] ?
+                                [NSString stringWithFormat:@"%+.1f%%", (bytesChange * 100.0f)] : @"-");
+        printf("%-58s %14.1f %12s %9s %9s%s\n", [name UTF8String],
+               [result[@"nsPerOp"] doubleValue], [bytes UTF8String], [timeDelta UTF8String],
+               [bytesDelta UTF8String], (regressed ? "  REGRESSION" : ""));
+        fflush(stdout);
+    }
+    
+    if (recordPath) {
+        
+        NSDictionary *record = @{@"version": @(kPNBenchmarkBaselineVersion), @"benchmarks": results};
+        NSData *data = [NSJSONSerialization dataWithJSONObject:record
+                                                       options:NSJSONWritingPrettyPrinted error:nil];
+        if (![data writeToFile:recordPath atomically:YES]) {
+            
+            printf("Unable to write baseline to %s\n", [recordPath UTF8String]);
+        }
+    }
+    if (regressions) {
+        
+        printf("%lu benchmark(s) regressed by more than %.0f%%\n", (unsigned long)regressions,
+               (self.regressionThreshold * 100.0f));
+    }
+    
+    return (regressions == 0);
+}
+
+
+#pragma mark - Measurement
+
+- (NSUInteger)iterationsForBlock:(PNBenchmarkBlock)block {
+    
+    uint64_t minimumDuration = (uint64_t)(self.minimumDuration * NSEC_PER_SEC);
+    NSUInteger iterations = 1;
+    while (YES) {
+        
+        uint64_t start = pn_benchmark_time();
+        for (NSUInteger iteration = 0; iteration < iterations; iteration++) {
+            
+            @autoreleasepool { block(); }
+        }
+        uint64_t duration = (pn_benchmark_time() - start);
+        if (duration >= minimumDuration || iterations >= (NSUIntegerMax / 10)) {
+            
+            break;
+        }
+        
+        // Grow towards target duration, but not more than 10x at once, because first runs may
+        // be slow while caches warm up.
+        double scale = (duration > 0 ? ((double)minimumDuration / (double)duration) * 1.2f : 10.0f);
+        iterations = MAX(iterations + 1, (NSUInteger)(iterations * MIN(scale, 10.0f)));
+    }
+    
+    return iterations;
+}
+
+- (NSDictionary *)measureBlock:(PNBenchmarkBlock)block {
+    
+    NSUInteger iterations = [self iterationsForBlock:block];
+    NSMutableArray *times = [NSMutableArray new];
+    NSMutableArray *allocations = [NSMutableArray new];
+    for (NSUInteger sample = 0; sample < self.samples; sample++) {
+        
+        [PNBenchmarkAllocations start];
+        uint64_t start = pn_benchmark_time();
+        for (NSUInteger iteration = 0; iteration < iterations; iteration++) {
+            
+            @autoreleasepool { block(); }
+        }
+        uint64_t duration = (pn_benchmark_time() - start);
+        uint64_t bytes = [PNBenchmarkAllocations stop];
+        [times addObject:@((double)duration / (double)iterations)];
+        [allocations addObject:@((double)bytes / (double)iterations)];
+    }
+    [times sortUsingSelector:@selector(compare:)];
+    [allocations sortUsingSelector:@selector(compare:)];
+    
+    return @{@"nsPerOp": times[([times count] / 2)],
+             @"bytesPerOp": allocations[([allocations count] / 2)],
+             @"iterations": @(iterations)};
+}
+
+
+#pragma mark - Misc
+
+- (double)changeOf:(NSNumber *)value comparingTo:(NSNumber *)baseline {
+    
+    double baselineValue = [baseline doubleValue];
+    
+    return (baselineValue > 0.0f ? (([value doubleValue] - baselineValue) / baselineValue) : 0.0f);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,49 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Process-wide counter of heap allocations.
+ @discussion On Linux \c malloc, \c calloc and \c realloc are interposed in benchmark binary and
+             forwarded to glibc. On OS X default malloc zone functions are replaced. Counter is
+             updated only while counting enabled, so benchmark harness itself doesn't pay for it.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNBenchmarkAllocations : NSObject
+
+
+///------------------------------------------------
+/// @name Counting
+///------------------------------------------------
+
+/**
+ @brief  Install allocation hooks (if required on current platform).
+ 
+ @return \c NO in case if allocations can't be counted on current platform.
+ 
+ @since 4.1.0
+ */
++ (BOOL)install;
+
+/**
+ @brief  Reset counters and start counting allocations.
+ 
+ @since 4.1.0
+ */
++ (void)start;
+
+/**
+ @brief  Stop counting allocations.
+ 
+ @return Number of bytes which has been requested since last \c +start call.
+ 
+ @since 4.1.0
+ */
++ (uint64_t)stop;
+
+#pragma mark -
+
+
+@end
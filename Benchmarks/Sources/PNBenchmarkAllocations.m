@@ -0,0 +1,162 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNBenchmarkAllocations.h"
+#import <stdatomic.h>
+#if __APPLE__
+    #import <malloc/malloc.h>
+    #import <mach/mach.h>
+#endif // __APPLE__
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores whether allocations should be counted at this moment or not.
+ 
+ @since 4.1.0
+ */
+static atomic_bool _counting;
+
+/**
+ @brief  Stores number of bytes which has been requested since counting started.
+ 
+ @since 4.1.0
+ */
+static atomic_uint_fast64_t _allocatedBytes;
+
+
+#pragma mark - Externs
+
+/**
+ @brief  Add \c size to allocated bytes counter if counting is enabled.
+ 
+ @param size Number of bytes which has been requested by allocation function.
+ 
+ @since 4.1.0
+ */
+static inline void pn_benchmark_count(size_t size) {
+    
+    if (atomic_load_explicit(&_counting, memory_order_relaxed)) {
+        
+        atomic_fetch_add_explicit(&_allocatedBytes, size, memory_order_relaxed);
+    }
+}
+
+#if defined(__linux__) && defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size) {
+    
+    pn_benchmark_count(size);
+    
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    
+    pn_benchmark_count(count * size);
+    
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    
+    pn_benchmark_count(size);
+    
+    return __libc_realloc(pointer, size);
+}
+#elif __APPLE__
+/**
+ @brief  Stores references on original default zone functions.
+ 
+ @since 4.1.0
+ */
+static void *(*pn_zone_malloc)(malloc_zone_t *zone, size_t size);
+static void *(*pn_zone_calloc)(malloc_zone_t *zone, size_t count, size_t size);
+static void *(*pn_zone_realloc)(malloc_zone_t *zone, void *pointer, size_t size);
+
+static void *pn_benchmark_zone_malloc(malloc_zone_t *zone, size_t size) {
+    
+    pn_benchmark_count(size);
+    
+    return pn_zone_malloc(zone, size);
+}
+
+static void *pn_benchmark_zone_calloc(malloc_zone_t *zone, size_t count, size_t size) {
+    
+    pn_benchmark_count(count * size);
+    
+    return pn_zone_calloc(zone, count, size);
+}
+
+static void *pn_benchmark_zone_realloc(malloc_zone_t *zone, void *pointer, size_t size) {
+    
+    pn_benchmark_count(size);
+    
+    return pn_zone_realloc(zone, pointer, size);
+}
+#endif // __APPLE__
+
+
+#pragma mark - Interface implementation
+
+@implementation PNBenchmarkAllocations
+
+
+#pragma mark - Counting
+
++ (BOOL)install {
+    
+#if defined(__linux__) && defined(__GLIBC__)
+    return YES;
+#elif __APPLE__
+    static BOOL installed;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        // Default zone structure is read-only after initialization, so it should be unlocked
+        // before functions can be replaced.
+        malloc_zone_t *zone = malloc_default_zone();
+        vm_address_t address = (vm_address_t)zone;
+        if (vm_protect(mach_task_self(), address, sizeof(malloc_zone_t), 0,
+                       (VM_PROT_READ | VM_PROT_WRITE)) == KERN_SUCCESS) {
+            
+            pn_zone_malloc = zone->malloc;
+            pn_zone_calloc = zone->calloc;
+            pn_zone_realloc = zone->realloc;
+            zone->malloc = pn_benchmark_zone_malloc;
+            zone->calloc = pn_benchmark_zone_calloc;
+            zone->realloc = pn_benchmark_zone_realloc;
+            vm_protect(mach_task_self(), address, sizeof(malloc_zone_t), 0, VM_PROT_READ);
+            installed = YES;
+        }
+    });
+    
+    return installed;
+#else
+    return NO;
+#endif
+}
+
++ (void)start {
+    
+    atomic_store(&_allocatedBytes, 0);
+    atomic_store(&_counting, true);
+}
+
++ (uint64_t)stop {
+    
+    atomic_store(&_counting, false);
+    
+    return atomic_load(&_allocatedBytes);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,105 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+#pragma mark Class forward
+
+@class PNRequestParameters;
+
+
+/**
+ @brief      Single recorded request / response pair from JSZVCR fixtures.
+ @discussion Operation is resolved by matching recorded URL path against operation request
+             templates, so fixtures can be used without test case which recorded them.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNBenchmarkFixture : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores fixture name in \c <bundle>/<plist> format.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSString *name;
+
+/**
+ @brief  Stores one of \b PNOperationType enum fields which has been resolved from request URL.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) PNOperationType operation;
+
+/**
+ @brief  Stores reference on recorded request URL.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSURL *URL;
+
+/**
+ @brief  Stores reference on request parameters restored from recorded URL (path placeholders
+         values and query fields).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) PNRequestParameters *parameters;
+
+/**
+ @brief  Stores reference on HTTP response which has been restored from recorded metadata.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSHTTPURLResponse *response;
+
+/**
+ @brief  Stores reference on recorded response body.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSData *data;
+
+#pragma mark -
+
+
+@end
+
+
+/**
+ @brief  Loader for recorded fixtures.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNBenchmarkFixtures : NSObject
+
+
+///------------------------------------------------
+/// @name Loading
+///------------------------------------------------
+
+/**
+ @brief      Load all fixtures from \c *.bundle directories at \c path.
+ @discussion Fixtures which has been recorded for cancelled or failed requests, as well as
+             fixtures for which operation can't be resolved are skipped.
+ 
+ @param path Full path to directory which contains fixture bundles.
+ 
+ @return List of \b PNBenchmarkFixture instances.
+ 
+ @since 4.1.0
+ */
++ (NSArray *)fixturesAtPath:(NSString *)path;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,298 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNBenchmarkFixtures.h"
+#import "PNRequestParameters.h"
+#import "PNPrivateStructures.h"
+
+
+#pragma mark Private interface declaration
+
+@interface PNBenchmarkFixture ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) PNOperationType operation;
+@property (nonatomic, copy) NSURL *URL;
+@property (nonatomic, strong) PNRequestParameters *parameters;
+@property (nonatomic, strong) NSHTTPURLResponse *response;
+@property (nonatomic, copy) NSData *data;
+
+#pragma mark -
+
+
+@end
+
+
+@interface PNBenchmarkFixtures ()
+
+
+#pragma mark - Operation resolution
+
+/**
+ @brief  Compile regular expressions from operation request templates.
+ 
+ @return Dictionary where template regular expressions stored under \b PNOperationType values.
+         Each expression capture placeholders values in order in which they appear in template.
+ 
+ @since 4.1.0
+ */
++ (NSDictionary *)templateExpressions;
+
+/**
+ @brief      Resolve operation and request parameters for recorded \c URL.
+ @discussion Some operations share same request template (for example channel group audit and
+             modification), in this case query fields is used to tell them apart.
+ 
+ @param URL        Reference on recorded request URL.
+ @param parameters Reference on parameters instance which should be filled with path placeholders
+                   values and query fields.
+ 
+ @return One of \b PNOperationType enum fields or \c -1 in case if operation can't be resolved.
+ 
+ @since 4.1.0
+ */
++ (PNOperationType)operationForURL:(NSURL *)URL withParameters:(PNRequestParameters *)parameters;
+
+/**
+ @brief  Check whether \c query fields allow to use \c operation for request with shared template.
+ 
+ @since 4.1.0
+ */
++ (BOOL)operation:(PNOperationType)operation matchesQuery:(NSDictionary *)query;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Create fixture from single recorded JSZVCR entry.
+ 
+ @return Fixture instance or \c nil in case if entry doesn't contain response or operation can't
+         be resolved.
+ 
+ @since 4.1.0
+ */
++ (PNBenchmarkFixture *)fixtureFromEntry:(NSDictionary *)entry withName:(NSString *)name;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNBenchmarkFixture
+@end
+
+
+@implementation PNBenchmarkFixtures
+
+
+#pragma mark - Loading
+
++ (NSArray *)fixturesAtPath:(NSString *)path {
+    
+    NSMutableArray *fixtures = [NSMutableArray new];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSArray *bundles = [[fileManager contentsOfDirectoryAtPath:path error:nil]
+                        sortedArrayUsingSelector:@selector(compare:)];
+    for (NSString *bundle in bundles) {
+        
+        if (![[bundle pathExtension] isEqualToString:@"bundle"]) { continue; }
+        
+        NSString *bundlePath = [path stringByAppendingPathComponent:bundle];
+        NSArray *plists = [[fileManager contentsOfDirectoryAtPath:bundlePath error:nil]
+                           sortedArrayUsingSelector:@selector(compare:)];
+        for (NSString *plist in plists) {
+            
+            if (![[plist pathExtension] isEqualToString:@"plist"]) { continue; }
+            
+            NSData *data = [NSData dataWithContentsOfFile:[bundlePath stringByAppendingPathComponent:plist]];
+            NSArray *entries = (data ? [NSPropertyListSerialization propertyListWithData:data
+                                                                                  options:NSPropertyListImmutable
+                                                                                   format:NULL error:nil] : nil);
+            NSString *baseName = [NSString stringWithFormat:@"%@/%@",
+                                  [bundle stringByDeletingPathExtension],
+                                  [plist stringByDeletingPathExtension]];
+            [entries enumerateObjectsUsingBlock:^(NSDictionary *entry, NSUInteger entryIdx,
+                                                  __unused BOOL *entriesEnumeratorStop) {
+                
+                NSString *name = ([entries count] > 1 ?
+                                  [NSString stringWithFormat:@"%@#%lu", baseName, (unsigned long)entryIdx] :
+                                  baseName);
+                PNBenchmarkFixture *fixture = [self fixtureFromEntry:entry withName:name];
+                if (fixture) {
+                    
+                    [fixtures addObject:fixture];
+                }
+            }];
+        }
+    }
+    
+    return [fixtures copy];
+}
+
+
+#pragma mark - Operation resolution
+
++ (NSDictionary *)templateExpressions {
+    
+    static NSDictionary *_templateExpressions;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        NSMutableDictionary *expressions = [NSMutableDictionary new];
+        NSRegularExpression *placeholder = [NSRegularExpression regularExpressionWithPattern:@"\\{[^}]+\\}"
+                                                                                     options:0 error:nil];
+        NSUInteger count = (sizeof(PNOperationDescriptors) / sizeof(PNOperationDescriptor));
+        for (NSUInteger operation = 0; operation < count; operation++) {
+            
+            NSString *template = PNOperationDescriptors[operation].requestTemplate;
+            if (!template) { continue; }
+            
+            NSString *pattern = [NSRegularExpression escapedPatternForString:template];
+            pattern = [pattern stringByReplacingOccurrencesOfString:@"\\{" withString:@"{"];
+            pattern = [pattern stringByReplacingOccurrencesOfString:@"\\}" withString:@"}"];
+            pattern = [placeholder stringByReplacingMatchesInString:pattern options:0
+                                                              range:NSMakeRange(0, [pattern length])
+                                                       withTemplate:@"([^/]*)"];
+            NSMutableArray *placeholders = [NSMutableArray new];
+            for (NSTextCheckingResult *match in [placeholder matchesInString:template options:0
+                                                                       range:NSMakeRange(0, [template length])]) {
+                
+                [placeholders addObject:[template substringWithRange:match.range]];
+            }
+            NSString *anchoredPattern = [NSString stringWithFormat:@"^%@/?$", pattern];
+            expressions[@(operation)] = @{
+                @"expression": [NSRegularExpression regularExpressionWithPattern:anchoredPattern
+                                                                         options:0 error:nil],
+                @"placeholders": placeholders
+            };
+        }
+        _templateExpressions = [expressions copy];
+    });
+    
+    return _templateExpressions;
+}
+
++ (PNOperationType)operationForURL:(NSURL *)URL withParameters:(PNRequestParameters *)parameters {
+    
+    NSURLComponents *components = [NSURLComponents componentsWithURL:URL resolvingAgainstBaseURL:NO];
+    NSString *path = components.percentEncodedPath;
+    NSMutableDictionary *query = [NSMutableDictionary new];
+    for (NSString *field in [components.percentEncodedQuery componentsSeparatedByString:@"&"]) {
+        
+        NSRange separatorRange = [field rangeOfString:@"="];
+        if (separatorRange.location != NSNotFound) {
+            
+            query[[field substringToIndex:separatorRange.location]] =
+                [field substringFromIndex:(separatorRange.location + 1)];
+        }
+        else if ([field length]) {
+            
+            query[field] = @"";
+        }
+    }
+    
+    NSDictionary *expressions = [self templateExpressions];
+    for (NSNumber *operation in [[expressions allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        
+        // Builder drop trailing slash when last placeholder is empty (compressed publish), so it
+        // should be restored to match template.
+        NSRegularExpression *expression = expressions[operation][@"expression"];
+        NSString *matchedPath = path;
+        NSTextCheckingResult *match = [expression firstMatchInString:matchedPath options:0
+                                                               range:NSMakeRange(0, [matchedPath length])];
+        if (!match) {
+            
+            matchedPath = [path stringByAppendingString:@"/"];
+            match = [expression firstMatchInString:matchedPath options:0
+                                             range:NSMakeRange(0, [matchedPath length])];
+        }
+        if (!match || ![self operation:(PNOperationType)[operation integerValue] matchesQuery:query]) {
+            
+            continue;
+        }
+        NSArray *placeholders = expressions[operation][@"placeholders"];
+        for (NSUInteger placeholderIdx = 0; placeholderIdx < [placeholders count]; placeholderIdx++) {
+            
+            [parameters addPathComponent:[matchedPath substringWithRange:[match rangeAtIndex:(placeholderIdx + 1)]]
+                          forPlaceholder:placeholders[placeholderIdx]];
+        }
+        [parameters addQueryParameters:query];
+        
+        return (PNOperationType)[operation integerValue];
+    }
+    
+    return (PNOperationType)-1;
+}
+
++ (BOOL)operation:(PNOperationType)operation matchesQuery:(NSDictionary *)query {
+    
+    BOOL modification = (query[@"add"] != nil || query[@"remove"] != nil);
+    BOOL forGroup = (query[@"channel-group"] != nil);
+    switch (operation) {
+        case PNAddChannelsToGroupOperation:
+        case PNAddPushNotificationsOnChannelsOperation:
+            return (query[@"add"] != nil);
+        case PNRemoveChannelsFromGroupOperation:
+        case PNRemovePushNotificationsFromChannelsOperation:
+            return (query[@"remove"] != nil);
+        case PNChannelsForGroupOperation:
+        case PNPushNotificationEnabledChannelsOperation:
+            return !modification;
+        case PNHereNowForChannelOperation:
+        case PNStateForChannelOperation:
+            return !forGroup;
+        case PNHereNowForChannelGroupOperation:
+        case PNStateForChannelGroupOperation:
+            return forGroup;
+        default:
+            return YES;
+    }
+}
+
+
+#pragma mark - Misc
+
++ (PNBenchmarkFixture *)fixtureFromEntry:(NSDictionary *)entry withName:(NSString *)name {
+    
+    NSDictionary *responseInformation = entry[@"response"][@"response"];
+    NSData *data = entry[@"data"][@"data"];
+    NSString *URLString = entry[@"request"][@"currentRequest"][@"URL"];
+    if ([entry[@"cancelled"] boolValue] || !responseInformation || !data || !URLString) {
+        
+        return nil;
+    }
+    
+    NSURL *URL = [NSURL URLWithString:URLString];
+    PNRequestParameters *parameters = [PNRequestParameters new];
+    PNOperationType operation = [self operationForURL:URL withParameters:parameters];
+    if ((NSInteger)operation < 0) {
+        
+        return nil;
+    }
+    
+    PNBenchmarkFixture *fixture = [PNBenchmarkFixture new];
+    fixture.name = name;
+    fixture.operation = operation;
+    fixture.URL = URL;
+    fixture.parameters = parameters;
+    fixture.data = data;
+    fixture.response = [[NSHTTPURLResponse alloc] initWithURL:URL
+                                                   statusCode:[responseInformation[@"statusCode"] integerValue]
+                                                  HTTPVersion:@"HTTP/1.1"
+                                                 headerFields:responseInformation[@"allHeaderFields"]];
+    
+    return fixture;
+}
+
+#pragma mark -
+
+
+@end
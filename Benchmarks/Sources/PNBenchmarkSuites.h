@@ -0,0 +1,39 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class PNBenchmark;
+
+
+/**
+ @brief      Benchmarks for client components which can be measured offline.
+ @discussion Inputs taken from recorded fixtures where possible: responses for serializer and
+             parsers, request URLs for URL builder and published messages for publish encode path,
+             escaping, encryption and compression.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNBenchmarkSuites : NSObject
+
+
+///------------------------------------------------
+/// @name Registration
+///------------------------------------------------
+
+/**
+ @brief  Register all component benchmarks.
+ 
+ @param benchmark Reference on runner which should be used to run benchmarks.
+ @param fixtures  List of \b PNBenchmarkFixture instances which should be used as input.
+ 
+ @since 4.1.0
+ */
++ (void)registerInBenchmark:(PNBenchmark *)benchmark withFixtures:(NSArray *)fixtures;
+
+#pragma mark -
+
+
+@end
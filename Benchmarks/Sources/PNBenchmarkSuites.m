@@ -0,0 +1,455 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNBenchmarkSuites.h"
+#import "PNNetworkResponseSerializer.h"
+#import "PNBenchmarkFixtures.h"
+#import "PNRequestParameters.h"
+#import "PNPrivateStructures.h"
+#import "PNURLBuilder.h"
+#import "PNBenchmark.h"
+#import "PNParser.h"
+#import "PNHelpers.h"
+#import "PNAES.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores cipher key which is used by encryption benchmarks.
+ 
+ @since 4.1.0
+ */
+static NSString * const kPNBenchmarkCipherKey = @"enigma";
+
+/**
+ @brief  Stores name of parser which is used for responses with error status codes.
+ 
+ @since 4.1.0
+ */
+static NSString * const kPNBenchmarkErrorParser = @"PNErrorParser";
+
+
+#pragma mark - Private interface declaration
+
+@interface PNBenchmarkSuites ()
+
+
+#pragma mark - Suites
+
+/**
+ @brief  Register \b PNNetworkResponseSerializer benchmarks (one per operation).
+ 
+ @since 4.1.0
+ */
++ (void)registerSerializerInBenchmark:(PNBenchmark *)benchmark
+                         withFixtures:(NSDictionary *)fixturesByOperation;
+
+/**
+ @brief      Register parsers benchmarks (one per parser class).
+ @discussion Parsers receive same de-serialized objects which is passed to them by network manager.
+             Parsers which never receive service responses in recorded fixtures use synthetic
+             payload.
+ 
+ @since 4.1.0
+ */
++ (void)registerParsersInBenchmark:(PNBenchmark *)benchmark withFixtures:(NSArray *)fixtures;
+
+/**
+ @brief  Register \b PNURLBuilder benchmarks (one per operation).
+ 
+ @since 4.1.0
+ */
++ (void)registerURLBuilderInBenchmark:(PNBenchmark *)benchmark
+                         withFixtures:(NSDictionary *)fixturesByOperation;
+
+/**
+ @brief  Register \b PNString escaping benchmarks.
+ 
+ @since 4.1.0
+ */
++ (void)registerEscapingInBenchmark:(PNBenchmark *)benchmark withMessages:(NSArray *)messages;
+
+/**
+ @brief  Register \b PNAES benchmarks.
+ 
+ @since 4.1.0
+ */
++ (void)registerAESInBenchmark:(PNBenchmark *)benchmark withMessages:(NSArray *)messages;
+
+/**
+ @brief  Register \b PNGZIP benchmarks.
+ 
+ @since 4.1.0
+ */
++ (void)registerGZIPInBenchmark:(PNBenchmark *)benchmark withFixtures:(NSArray *)fixtures;
+
+/**
+ @brief      Register publish encode path benchmarks.
+ @discussion Steps repeat \b PubNub+Publish: JSON serialization, optional encryption, escaping or
+             compression, request parameters and URL composition.
+ 
+ @since 4.1.0
+ */
++ (void)registerPublishInBenchmark:(PNBenchmark *)benchmark withMessages:(NSArray *)messages;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Group fixtures by operation.
+ 
+ @return Dictionary where list of fixtures stored under \b PNOperationType values.
+ 
+ @since 4.1.0
+ */
++ (NSDictionary *)fixturesByOperation:(NSArray *)fixtures;
+
+/**
+ @brief  Extract messages which has been published in recorded fixtures.
+ 
+ @return List of de-serialized messages or synthetic messages if fixtures doesn't have publish
+         requests.
+ 
+ @since 4.1.0
+ */
++ (NSArray *)publishedMessagesFrom:(NSArray *)fixtures;
+
+/**
+ @brief  Build synthetic JSON payload of approximately \c length bytes.
+ 
+ @since 4.1.0
+ */
++ (NSData *)JSONDataWithLength:(NSUInteger)length;
+
+/**
+ @brief      Compose block which pass objects from \c inputs to \c block one by one.
+ @discussion Benchmark operation process one input, so results can be compared between
+             components regardless of fixtures count.
+ 
+ @since 4.1.0
+ */
++ (PNBenchmarkBlock)roundRobinOver:(NSArray *)inputs withBlock:(void(^)(id input))block;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNBenchmarkSuites
+
+
+#pragma mark - Registration
+
++ (void)registerInBenchmark:(PNBenchmark *)benchmark withFixtures:(NSArray *)fixtures {
+    
+    NSDictionary *fixturesByOperation = [self fixturesByOperation:fixtures];
+    NSArray *messages = [self publishedMessagesFrom:fixtures];
+    [self registerSerializerInBenchmark:benchmark withFixtures:fixturesByOperation];
+    [self registerParsersInBenchmark:benchmark withFixtures:fixtures];
+    [self registerURLBuilderInBenchmark:benchmark withFixtures:fixturesByOperation];
+    [self registerEscapingInBenchmark:benchmark withMessages:messages];
+    [self registerAESInBenchmark:benchmark withMessages:messages];
+    [self registerGZIPInBenchmark:benchmark withFixtures:fixtures];
+    [self registerPublishInBenchmark:benchmark withMessages:messages];
+}
+
+
+#pragma mark - Suites
+
++ (void)registerSerializerInBenchmark:(PNBenchmark *)benchmark
+                         withFixtures:(NSDictionary *)fixturesByOperation {
+    
+    PNNetworkResponseSerializer *serializer = [PNNetworkResponseSerializer new];
+    for (NSNumber *operation in [[fixturesByOperation allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        
+        NSString *name = [NSString stringWithFormat:@"serializer/%@",
+                          PNOperationDescriptors[[operation integerValue]].name];
+        [benchmark addBenchmark:name withBlock:[self roundRobinOver:fixturesByOperation[operation]
+                                                         withBlock:^(PNBenchmarkFixture *fixture) {
+            
+            NSError *error = nil;
+            [serializer serializedResponse:fixture.response withData:fixture.data error:&error];
+        }]];
+    }
+}
+
++ (void)registerParsersInBenchmark:(PNBenchmark *)benchmark withFixtures:(NSArray *)fixtures {
+    
+    // Pre-serialize responses, so parser benchmarks measure only parsing.
+    PNNetworkResponseSerializer *serializer = [PNNetworkResponseSerializer new];
+    NSMutableDictionary *inputs = [NSMutableDictionary new];
+    for (PNBenchmarkFixture *fixture in fixtures) {
+        
+        id response = [serializer serializedResponse:fixture.response withData:fixture.data
+                                               error:nil];
+        if (!response) { continue; }
+        
+        NSString *parser = (fixture.response.statusCode >= 400 ? kPNBenchmarkErrorParser :
+                            PNOperationDescriptors[fixture.operation].parser);
+        if (!inputs[parser]) {
+            
+            inputs[parser] = [NSMutableArray new];
+        }
+        [inputs[parser] addObject:response];
+    }
+    
+    NSMutableSet *parsers = [NSMutableSet setWithObject:kPNBenchmarkErrorParser];
+    NSUInteger count = (sizeof(PNOperationDescriptors) / sizeof(PNOperationDescriptor));
+    for (NSUInteger operation = 0; operation < count; operation++) {
+        
+        if (PNOperationDescriptors[operation].parser) {
+            
+            [parsers addObject:PNOperationDescriptors[operation].parser];
+        }
+    }
+    NSDictionary *syntheticInputs = @{
+        kPNBenchmarkErrorParser: @{@"status": @403, @"error": @YES, @"message": @"Forbidden",
+                                   @"payload": @{@"channels": @[@"a", @"b"]}},
+        @"PNHeartbeatParser": @{@"status": @200, @"message": @"OK", @"service": @"Presence"}
+    };
+    NSDictionary *additionalData = @{@"cipherKey": kPNBenchmarkCipherKey};
+    for (NSString *parserName in [[parsers allObjects] sortedArrayUsingSelector:@selector(compare:)]) {
+        
+        Class<PNParser> parser = NSClassFromString(parserName);
+        NSArray *parserInputs = ([inputs[parserName] count] ? inputs[parserName] :
+                                 (syntheticInputs[parserName] ? @[syntheticInputs[parserName]] : nil));
+        if (!parser || !parserInputs) {
+            
+            printf("parser/%s: skipped, no recorded responses\n", [parserName UTF8String]);
+            continue;
+        }
+        BOOL requireAdditionalData = [parser requireAdditionalData];
+        NSString *name = [NSString stringWithFormat:@"parser/%@", parserName];
+        [benchmark addBenchmark:name withBlock:[self roundRobinOver:parserInputs
+                                                         withBlock:^(id response) {
+            
+            if (!requireAdditionalData) {
+                
+                [parser parsedServiceResponse:response];
+            }
+            else {
+                
+                [parser parsedServiceResponse:response withData:additionalData];
+            }
+        }]];
+    }
+}
+
++ (void)registerURLBuilderInBenchmark:(PNBenchmark *)benchmark
+                         withFixtures:(NSDictionary *)fixturesByOperation {
+    
+    for (NSNumber *operation in [[fixturesByOperation allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        
+        NSString *name = [NSString stringWithFormat:@"url-builder/%@",
+                          PNOperationDescriptors[[operation integerValue]].name];
+        [benchmark addBenchmark:name withBlock:[self roundRobinOver:fixturesByOperation[operation]
+                                                         withBlock:^(PNBenchmarkFixture *fixture) {
+            
+            [PNURLBuilder URLForOperation:fixture.operation withParameters:fixture.parameters];
+        }]];
+    }
+}
+
++ (void)registerEscapingInBenchmark:(PNBenchmark *)benchmark withMessages:(NSArray *)messages {
+    
+    NSMutableArray *messageStrings = [NSMutableArray new];
+    for (id message in messages) {
+        
+        [messageStrings addObject:[PNJSON JSONStringFrom:message withError:nil]];
+    }
+    [benchmark addBenchmark:@"string/percent-escape-channel"
+                  withBlock:[self roundRobinOver:@[@"a", @"PNChannelGroupTestsName", @"demo-channel,b-pnpres"]
+                                       withBlock:^(NSString *string) {
+        
+        [PNString percentEscapedString:string];
+    }]];
+    [benchmark addBenchmark:@"string/percent-escape-message"
+                  withBlock:[self roundRobinOver:messageStrings withBlock:^(NSString *string) {
+        
+        [PNString percentEscapedString:string];
+    }]];
+    [benchmark addBenchmark:@"string/percent-escape-unicode"
+                  withBlock:[self roundRobinOver:@[@"\"Привет, мир! こんにちは 世界 🌍\""]
+                                       withBlock:^(NSString *string) {
+        
+        [PNString percentEscapedString:string];
+    }]];
+}
+
++ (void)registerAESInBenchmark:(PNBenchmark *)benchmark withMessages:(NSArray *)messages {
+    
+    NSMutableArray *messageData = [NSMutableArray new];
+    NSMutableArray *encryptedMessages = [NSMutableArray new];
+    for (id message in messages) {
+        
+        NSData *data = [[PNJSON JSONStringFrom:message withError:nil]
+                        dataUsingEncoding:NSUTF8StringEncoding];
+        [messageData addObject:data];
+        [encryptedMessages addObject:[PNAES encrypt:data withKey:kPNBenchmarkCipherKey]];
+    }
+    NSData *largeData = [self JSONDataWithLength:(16 * 1024)];
+    NSString *largeEncrypted = [PNAES encrypt:largeData withKey:kPNBenchmarkCipherKey];
+    
+    [benchmark addBenchmark:@"aes/encrypt-message"
+                  withBlock:[self roundRobinOver:messageData withBlock:^(NSData *data) {
+        
+        [PNAES encrypt:data withKey:kPNBenchmarkCipherKey];
+    }]];
+    [benchmark addBenchmark:@"aes/decrypt-message"
+                  withBlock:[self roundRobinOver:encryptedMessages withBlock:^(NSString *message) {
+        
+        [PNAES decrypt:message withKey:kPNBenchmarkCipherKey];
+    }]];
+    [benchmark addBenchmark:@"aes/encrypt-16KB" withBlock:^{
+        
+        [PNAES encrypt:largeData withKey:kPNBenchmarkCipherKey];
+    }];
+    [benchmark addBenchmark:@"aes/decrypt-16KB" withBlock:^{
+        
+        [PNAES decrypt:largeEncrypted withKey:kPNBenchmarkCipherKey];
+    }];
+}
+
++ (void)registerGZIPInBenchmark:(PNBenchmark *)benchmark withFixtures:(NSArray *)fixtures {
+    
+    // Largest recorded response is used as realistic payload along with synthetic big one.
+    NSData *responseData = [NSData data];
+    for (PNBenchmarkFixture *fixture in fixtures) {
+        
+        responseData = ([fixture.data length] > [responseData length] ? fixture.data : responseData);
+    }
+    NSDictionary *payloads = @{@"response": responseData,
+                               @"16KB": [self JSONDataWithLength:(16 * 1024)]};
+    for (NSString *payloadName in [[payloads allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        
+        NSData *data = payloads[payloadName];
+        NSData *compressedData = [PNGZIP GZIPDeflatedData:data];
+        [benchmark addBenchmark:[NSString stringWithFormat:@"gzip/deflate-%@", payloadName]
+                      withBlock:^{
+            
+            [PNGZIP GZIPDeflatedData:data];
+        }];
+        [benchmark addBenchmark:[NSString stringWithFormat:@"gzip/inflate-%@", payloadName]
+                      withBlock:^{
+            
+            [PNGZIP GZIPInflatedData:compressedData];
+        }];
+    }
+}
+
++ (void)registerPublishInBenchmark:(PNBenchmark *)benchmark withMessages:(NSArray *)messages {
+    
+    NSArray *variants = @[@"plain", @"encrypted", @"compressed"];
+    for (NSString *variant in variants) {
+        
+        BOOL encrypt = [variant isEqualToString:@"encrypted"];
+        BOOL compress = [variant isEqualToString:@"compressed"];
+        NSString *name = [NSString stringWithFormat:@"publish/encode-%@", variant];
+        [benchmark addBenchmark:name withBlock:[self roundRobinOver:messages withBlock:^(id message) {
+            
+            NSString *messageForPublish = [PNJSON JSONStringFrom:message withError:nil];
+            if (encrypt) {
+                
+                NSData *JSONData = [messageForPublish dataUsingEncoding:NSUTF8StringEncoding];
+                messageForPublish = [PNJSON JSONStringFrom:[PNAES encrypt:JSONData
+                                                                  withKey:kPNBenchmarkCipherKey]
+                                                 withError:nil];
+            }
+            PNRequestParameters *parameters = [PNRequestParameters new];
+            [parameters addPathComponents:@{@"{pub-key}": @"demo-36", @"{sub-key}": @"demo-36"}];
+            [parameters addPathComponent:[PNString percentEscapedString:@"benchmark"]
+                          forPlaceholder:@"{channel}"];
+            [parameters addPathComponent:(!compress ? [PNString percentEscapedString:messageForPublish] :
+                                          @"")
+                          forPlaceholder:@"{message}"];
+            if (compress) {
+                
+                [PNGZIP GZIPDeflatedData:[messageForPublish dataUsingEncoding:NSUTF8StringEncoding]];
+            }
+            [PNURLBuilder URLForOperation:PNPublishOperation withParameters:parameters];
+        }]];
+    }
+}
+
+
+#pragma mark - Misc
+
++ (NSDictionary *)fixturesByOperation:(NSArray *)fixtures {
+    
+    NSMutableDictionary *fixturesByOperation = [NSMutableDictionary new];
+    for (PNBenchmarkFixture *fixture in fixtures) {
+        
+        NSNumber *operation = @(fixture.operation);
+        if (!fixturesByOperation[operation]) {
+            
+            fixturesByOperation[operation] = [NSMutableArray new];
+        }
+        [fixturesByOperation[operation] addObject:fixture];
+    }
+    
+    return [fixturesByOperation copy];
+}
+
++ (NSArray *)publishedMessagesFrom:(NSArray *)fixtures {
+    
+    NSMutableArray *messages = [NSMutableArray new];
+    for (PNBenchmarkFixture *fixture in fixtures) {
+        
+        NSString *message = fixture.parameters.pathComponents[@"{message}"];
+        if (fixture.operation == PNPublishOperation && [message length]) {
+            
+            id object = [PNJSON JSONObjectFrom:[message stringByRemovingPercentEncoding]
+                                     withError:nil];
+            if (object) {
+                
+                [messages addObject:object];
+            }
+        }
+    }
+    if (![messages count]) {
+        
+        [messages addObjectsFromArray:@[@"Hello world", @{@"text": @"Hello", @"sender": @"bench"},
+                                        @[@1, @2, @3]]];
+    }
+    
+    return [messages copy];
+}
+
++ (NSData *)JSONDataWithLength:(NSUInteger)length {
+    
+    NSMutableArray *entries = [NSMutableArray new];
+    NSUInteger entriesLength = 2;
+    while (entriesLength < length) {
+        
+        NSString *entry = [NSString stringWithFormat:@"entry %lu with some text",
+                           (unsigned long)[entries count]];
+        [entries addObject:@{@"id": @([entries count]), @"text": entry}];
+        entriesLength += ([entry length] + 24);
+    }
+    
+    return [NSJSONSerialization dataWithJSONObject:entries options:(NSJSONWritingOptions)0
+                                             error:nil];
+}
+
++ (PNBenchmarkBlock)roundRobinOver:(NSArray *)inputs withBlock:(void(^)(id input))block {
+    
+    __block NSUInteger inputIdx = 0;
+    NSUInteger count = [inputs count];
+    
+    return ^{
+        
+        block(inputs[inputIdx]);
+        inputIdx = ((inputIdx + 1) % count);
+    };
+}
+
+#pragma mark -
+
+
+@end
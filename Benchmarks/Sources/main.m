@@ -0,0 +1,57 @@
+/**
+ @brief  Offline microbenchmarks for client components.
+ @discussion Usage: pubnub-benchmarks [--fixtures <path>] [--baseline <file>] [--record <file>]
+                                      [--filter <regex>] [--samples <count>]
+                                      [--duration <seconds>] [--threshold <fraction>]
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <Foundation/Foundation.h>
+#import "PNBenchmarkFixtures.h"
+#import "PNBenchmarkSuites.h"
+#import "PNBenchmark.h"
+
+
+int main(int argc, const char * argv[]) {
+    
+    int status = 0;
+    @autoreleasepool {
+        
+        NSMutableDictionary *options = [@{@"--fixtures": @"../Tests/iOS Tests/Fixtures",
+                                          @"--baseline": @"baseline.json"} mutableCopy];
+        for (int argumentIdx = 1; argumentIdx + 1 < argc; argumentIdx += 2) {
+            
+            options[@(argv[argumentIdx])] = @(argv[argumentIdx + 1]);
+        }
+        
+        NSArray *fixtures = [PNBenchmarkFixtures fixturesAtPath:options[@"--fixtures"]];
+        if (![fixtures count]) {
+            
+            fprintf(stderr, "No fixtures found at %s\n", [options[@"--fixtures"] UTF8String]);
+            return 1;
+        }
+        printf("Loaded %lu recorded responses\n", (unsigned long)[fixtures count]);
+        
+        PNBenchmark *benchmark = [PNBenchmark new];
+        benchmark.filter = options[@"--filter"];
+        if (options[@"--samples"]) {
+            
+            benchmark.samples = (NSUInteger)MAX([options[@"--samples"] integerValue], 1);
+        }
+        if (options[@"--duration"]) {
+            
+            benchmark.minimumDuration = [options[@"--duration"] doubleValue];
+        }
+        if (options[@"--threshold"]) {
+            
+            benchmark.regressionThreshold = [options[@"--threshold"] doubleValue];
+        }
+        [PNBenchmarkSuites registerInBenchmark:benchmark withFixtures:fixtures];
+        status = ([benchmark runWithBaseline:options[@"--baseline"]
+                                    recordTo:options[@"--record"]] ? 0 : 2);
+    }
+    
+    return status;
+}
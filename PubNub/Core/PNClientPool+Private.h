@@ -0,0 +1,38 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNClientPool.h"
+
+
+#pragma mark Private interface declaration
+
+@interface PNClientPool (Private)
+
+
+///------------------------------------------------
+/// @name Shared resources
+///------------------------------------------------
+
+/**
+ @brief      Stores reference on client which own network manager and origin selector which is
+             shared by clients from pool.
+ @discussion Client configured with pool configuration and never used to subscribe.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PubNub *sharedClient;
+
+/**
+ @brief  Stores reference on queue which is used by network managers of clients from pool to
+         process service responses.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t processingQueue;
+
+#pragma mark -
+
+
+@end
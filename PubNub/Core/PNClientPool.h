@@ -0,0 +1,137 @@
+#import <Foundation/Foundation.h>
+#import "PNObjectEventListener.h"
+
+
+#pragma mark Class forward
+
+@class PNConfiguration, PubNub;
+
+
+/**
+ @brief      Pool of lightweight \b PubNub clients which act on behalf of different users.
+ @discussion Server-side applications which hold client per end user can use pool to get client for
+             each \c uuid / \c authKey pair. Clients from pool share 'non-subscription' API network
+             manager (with it's connections, delegate queue, hedging and circuit breaker state),
+             origin selector and responses parsing queue. User identity added to each request by
+             shared network manager, so client itself store only configuration and managers which
+             it really used (subscription network manager created only for clients which subscribe,
+             because each long-poll require own connection).
+ @note       All clients from pool use same keys, origins and timeouts which has been passed with
+             pool configuration.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNClientPool : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on configuration which is used as template for clients from pool.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) PNConfiguration *configuration;
+
+/**
+ @brief  Stores number of clients from pool which still in use.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) NSUInteger count;
+
+
+///------------------------------------------------
+/// @name Initialization
+///------------------------------------------------
+
+/**
+ @brief  Construct clients pool.
+ @note   All completion block and delegate callbacks will be called on main queue.
+ 
+ @code
+ @endcode
+ \b Example:
+ @code
+ PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                  subscribeKey:@"demo"];
+ self.pool = [PNClientPool poolWithConfiguration:configuration];
+ PubNub *client = [self.pool clientWithUUID:@"user-1" authKey:@"user-1-token"];
+ @endcode
+ 
+ @param configuration Reference on instance which store all user-provided information about how
+                      clients should operate (\c uuid and \c authKey replaced for each client).
+ 
+ @return Configured and ready to use clients pool.
+ 
+ @since 4.1.0
+ */
++ (instancetype)poolWithConfiguration:(PNConfiguration *)configuration;
+
+/**
+ @brief  Construct clients pool.
+ 
+ @param configuration Reference on instance which store all user-provided information about how
+                      clients should operate (\c uuid and \c authKey replaced for each client).
+ @param callbackQueue Reference on queue which should be used by clients for completion block and
+                      delegate calls.
+ 
+ @return Configured and ready to use clients pool.
+ 
+ @since 4.1.0
+ */
++ (instancetype)poolWithConfiguration:(PNConfiguration *)configuration
+                        callbackQueue:(dispatch_queue_t)callbackQueue;
+
+
+///------------------------------------------------
+/// @name Clients
+///------------------------------------------------
+
+/**
+ @brief      Retrieve client which act on behalf of specified user.
+ @discussion Pool keep weak references on clients, so same client returned for same \c uuid and
+             \c authKey while it is used by application.
+ 
+ @param uuid    Unique identifier of user on behalf of which client should send requests.
+ @param authKey Authorization key which should be used by client (can be \c nil).
+ 
+ @return Configured and ready to use \b PubNub client.
+ 
+ @since 4.1.0
+ */
+- (PubNub *)clientWithUUID:(NSString *)uuid authKey:(NSString *)authKey;
+
+
+///------------------------------------------------
+/// @name Listeners
+///------------------------------------------------
+
+/**
+ @brief      Add observer for shared network manager events.
+ @discussion Listener receive statuses which is related to all clients from pool (like circuit
+             breaker state change).
+ 
+ @param listener Reference on object which conforms to \b PNObjectEventListener protocol.
+ 
+ @since 4.1.0
+ */
+- (void)addListener:(id <PNObjectEventListener>)listener;
+
+/**
+ @brief  Remove observer from list of shared network manager events listeners.
+ 
+ @param listener Reference on object which has been added with \c -addListener:.
+ 
+ @since 4.1.0
+ */
+- (void)removeListener:(id <PNObjectEventListener>)listener;
+
+#pragma mark -
+
+
+@end
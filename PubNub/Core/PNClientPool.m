@@ -0,0 +1,190 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNClientPool+Private.h"
+#import "PubNub+CorePrivate.h"
+#import "PubNub+Subscribe.h"
+#import "PNConfiguration.h"
+
+
+#pragma mark Protected interface declaration
+
+@interface PNClientPool ()
+
+
+#pragma mark - Information
+
+@property (nonatomic, copy) PNConfiguration *configuration;
+@property (nonatomic, strong) PubNub *sharedClient;
+@property (nonatomic, strong) dispatch_queue_t processingQueue;
+
+/**
+ @brief  Stores reference on queue which should be used by clients for completion block and
+         delegate calls.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t callbackQueue;
+
+/**
+ @brief      Stores reference on clients which has been created by pool.
+ @discussion Identity composed from \c uuid and \c authKey is key and weak reference on client is
+             value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMapTable *clients;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to clients map.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize clients pool.
+ 
+ @param configuration Reference on instance which store all user-provided information about how
+                      clients should operate.
+ @param callbackQueue Reference on queue which should be used by clients for completion block and
+                      delegate calls.
+ 
+ @return Initialized and ready to use clients pool.
+ 
+ @since 4.1.0
+ */
+- (instancetype)initWithConfiguration:(PNConfiguration *)configuration
+                        callbackQueue:(dispatch_queue_t)callbackQueue NS_DESIGNATED_INITIALIZER;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Compose key under which client for specified user identity stored.
+ 
+ @param uuid    Unique identifier of user on behalf of which client send requests.
+ @param authKey Authorization key which is used by client.
+ 
+ @return Identity key.
+ 
+ @since 4.1.0
+ */
+- (NSString *)identityForUUID:(NSString *)uuid authKey:(NSString *)authKey;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNClientPool
+
+
+#pragma mark - Information
+
+- (NSUInteger)count {
+    
+    __block NSUInteger count = 0;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        // Map table may still hold keys for clients which already has been deallocated.
+        count = [[[self.clients objectEnumerator] allObjects] count];
+    });
+    
+    return count;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)poolWithConfiguration:(PNConfiguration *)configuration {
+    
+    return [self poolWithConfiguration:configuration callbackQueue:dispatch_get_main_queue()];
+}
+
++ (instancetype)poolWithConfiguration:(PNConfiguration *)configuration
+                        callbackQueue:(dispatch_queue_t)callbackQueue {
+    
+    return [[self alloc] initWithConfiguration:configuration callbackQueue:callbackQueue];
+}
+
+- (instancetype)initWithConfiguration:(PNConfiguration *)configuration
+                        callbackQueue:(dispatch_queue_t)callbackQueue {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _configuration = [configuration copy];
+        _callbackQueue = (callbackQueue?: dispatch_get_main_queue());
+        _sharedClient = [PubNub clientWithConfiguration:_configuration
+                                          callbackQueue:_callbackQueue];
+        _processingQueue = dispatch_queue_create("com.pubnub.client-pool.network",
+                                                 DISPATCH_QUEUE_CONCURRENT);
+        _clients = [NSMapTable strongToWeakObjectsMapTable];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.client-pool",
+                                                     DISPATCH_QUEUE_CONCURRENT);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Clients
+
+- (PubNub *)clientWithUUID:(NSString *)uuid authKey:(NSString *)authKey {
+    
+    NSString *identity = [self identityForUUID:uuid authKey:authKey];
+    __block PubNub *client = nil;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        client = [self.clients objectForKey:identity];
+        if (!client) {
+            
+            PNConfiguration *configuration = [self.configuration copy];
+            if ([uuid length]) {
+                
+                configuration.uuid = uuid;
+            }
+            configuration.authKey = authKey;
+            client = [PubNub clientWithConfiguration:configuration
+                                       callbackQueue:self.callbackQueue pool:self];
+            [self.clients setObject:client forKey:identity];
+        }
+    });
+    
+    return client;
+}
+
+
+#pragma mark - Listeners
+
+- (void)addListener:(id <PNObjectEventListener>)listener {
+    
+    [self.sharedClient addListener:listener];
+}
+
+- (void)removeListener:(id <PNObjectEventListener>)listener {
+    
+    [self.sharedClient removeListener:listener];
+}
+
+
+#pragma mark - Misc
+
+- (NSString *)identityForUUID:(NSString *)uuid authKey:(NSString *)authKey {
+    
+    return [NSString stringWithFormat:@"%@\n%@", (uuid?: @""), (authKey?: @"")];
+}
+
+#pragma mark -
+
+
+@end
@@ -189,6 +189,121 @@
                 callbackQueue:(dispatch_queue_t)callbackQueue
                    completion:(void(^)(PubNub *client))block;
 
+/**
+ @brief      Construct new \b PubNub client instance which should be driven by host application.
+ @discussion Client won't use GCD to deliver completion blocks and delegate callbacks or to
+             process service responses. Instead all this work will wait till host application
+             call \c -pumpWithTimeout: on it's own thread. This allow to embed client into
+             existing single-threaded reactor and avoid cross-thread handoffs for callbacks.
+ @note       Network I/O and timers still handled by system and client threads, but they only
+             schedule work which will be done inside of \c -pumpWithTimeout:.
+ @note       Client copies made with \c -copyWithConfiguration:completion: also will be driven by
+             host application.
+ 
+ @code
+ @endcode
+ \b Example:
+ @code
+ PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                  subscribeKey:@"demo"];
+ self.client = [PubNub manuallyDrivenClientWithConfiguration:configuration];
+ 
+ // Register self.client.eventsFileDescriptor with reactor and call from reactor's thread when
+ // descriptor become readable:
+ [self.client pumpWithTimeout:0.0f];
+ @endcode
+ 
+ @param configuration Reference on instance which store all user-provided information about how
+                      client should operate and handle events.
+ 
+ @return Configured and ready to use \b PubNub client.
+ 
+ @since 4.1.0
+ */
++ (instancetype)manuallyDrivenClientWithConfiguration:(PNConfiguration *)configuration;
+
+
+///------------------------------------------------
+/// @name Manual drive
+///------------------------------------------------
+
+/**
+ @brief  Retrieve file descriptor which become readable when client has pending work.
+ 
+ @return File descriptor or \b -1 in case if client hasn't been created with
+         \c +manuallyDrivenClientWithConfiguration:.
+ 
+ @since 4.1.0
+ */
+- (int)eventsFileDescriptor;
+
+/**
+ @brief      Process pending service responses and call completion blocks and delegate callbacks on
+             calling thread.
+ @discussion Work scheduled by callbacks (for example by API calls from completion blocks) will be
+             done during next call.
+ @warning    Method should be called from single thread and only for client which has been created
+             with \c +manuallyDrivenClientWithConfiguration:.
+ 
+ @param timeout Maximum number of seconds which should be spent waiting for pending work. \b 0 can
+                be passed to process only already pending work and negative value to wait till
+                there will be something to process.
+ 
+ @return Number of processed work items.
+ 
+ @since 4.1.0
+ */
+- (NSUInteger)pumpWithTimeout:(NSTimeInterval)timeout;
+
+
+///------------------------------------------------
+/// @name Deadlines
+///------------------------------------------------
+
+/**
+ @brief      Perform API calls from \c block with absolute \c deadline.
+ @discussion All 'non-subscription' API calls which has been done by receiver from \c block will be
+             completed with \b PNTimeoutCategory status if there won't be response before
+             \c deadline. Requests with expired deadline won't be sent at all and requests which
+             already sent will be cancelled, so they won't occupy connections.
+ @note       Nested calls can only shorten deadline.
+ 
+ @code
+ @endcode
+ \b Example:
+ @code
+ NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:2.0f];
+ [self.client performWithDeadline:deadline block:^{
+    
+    [self.client historyForChannel:@"storage" withCompletion:^(PNHistoryResult *result,
+                                                                PNErrorStatus *status) {
+        
+        if (status.category == PNTimeoutCategory) {
+            
+            // Response on request hasn't been received before deadline.
+        }
+    }];
+ }];
+ @endcode
+ 
+ @param deadline Reference on date before which response on API calls should be received.
+ @param block    Reference on block inside of which API calls should be done (synchronously).
+ 
+ @since 4.1.0
+ */
+- (void)performWithDeadline:(NSDate *)deadline block:(dispatch_block_t)block;
+
+/**
+ @brief  Perform API calls from \c block with relative deadline.
+ 
+ @param timeout Number of seconds (from now) during which response on API calls should be
+                received.
+ @param block   Reference on block inside of which API calls should be done (synchronously).
+ 
+ @since 4.1.0
+ */
+- (void)performWithTimeout:(NSTimeInterval)timeout block:(dispatch_block_t)block;
+
 #pragma mark -
 
 
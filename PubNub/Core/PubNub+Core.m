@@ -6,15 +6,24 @@
 #import "PubNub+CorePrivate.h"
 #import "PubNub+SubscribePrivate.h"
 #import "PNObjectEventListener.h"
+#import "PNRequestTrace+Private.h"
 #import "PNRequestParameters.h"
+#import "PNStructuredLogger.h"
+#import "PNIntrospection+Private.h"
+#import "PNClientPool+Private.h"
+#import "PNPrivateStructures.h"
 #import "PNSubscribeStatus.h"
 #import "PNResult+Private.h"
 #import "PNStatus+Private.h"
 #import "PNConfiguration.h"
+#import "PNOriginSelector.h"
 #import "PNReachability.h"
+#import "PNTimingWheel.h"
+#import "PNEventLoop.h"
 #import "PNConstants.h"
 #import "PNNetwork.h"
 #import "PNHelpers.h"
+#import <libkern/OSAtomic.h>
 
 
 #pragma mark Static
@@ -34,7 +43,15 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
     
     if (queue && block) {
         
-        dispatch_async(queue, block);
+        PNEventLoop *eventLoop = [PNEventLoop eventLoopForQueue:queue];
+        if (eventLoop) {
+            
+            [eventLoop enqueueBlock:block];
+        }
+        else {
+            
+            dispatch_async(queue, block);
+        }
     }
 }
 
@@ -79,6 +96,31 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
  */
 @property (nonatomic, strong) PNReachability *reachability;
 
+/**
+ @brief  Stores reference on helper which choose origin for each request.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNOriginSelector *originSelector;
+@property (nonatomic, strong) PNClientPool *clientPool;
+
+/**
+ @brief      Stores reference on spin-lock which is used to protect client subsystems creation.
+ @discussion Managers, network managers and helpers created with first access to them, so client
+             construction doesn't pay for subsystems (with their queues and sessions) which may be
+             never used.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) OSSpinLock subsystemsLock;
+
+/**
+ @brief  Stores whether client already observe execution context transitions or not.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) BOOL observingContextTransitions;
+
 
 #pragma mark - Initialization
 
@@ -97,13 +139,32 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
  @since 4.0
 */
 - (instancetype)initWithConfiguration:(PNConfiguration *)configuration
-                        callbackQueue:(dispatch_queue_t)callbackQueue NS_DESIGNATED_INITIALIZER;
+                        callbackQueue:(dispatch_queue_t)callbackQueue;
+
+/**
+ @brief  Initialize \b PubNub client instance with pre-defined configuration.
+ 
+ @param configuration Reference on instance which store all user-provided information about how
+                      client should operate and handle events.
+ @param callbackQueue Reference on queue which should be used by client fot comletion block and
+                      delegate calls.
+ @param pool          Reference on pool which provide shared network manager (\c nil for
+                      standalone client).
+ 
+ @return Initialized and ready to use \b PubNub client.
+ 
+ @since 4.1.0
+ */
+- (instancetype)initWithConfiguration:(PNConfiguration *)configuration
+                        callbackQueue:(dispatch_queue_t)callbackQueue
+                                 pool:(PNClientPool *)pool NS_DESIGNATED_INITIALIZER;
 
 
 #pragma mark - Reachability
 
 /**
- @brief      Complete reachability helper configuration.
+ @brief  Complete reachability helper configuration.
+ @note   Method should be called while \c subsystemsLock is held.
  
  @since 4.0
  */
@@ -113,15 +174,29 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
 #pragma mark - PubNub Network managers
 
 /**
- @brief  Initialize and configure required \b PubNub network managers.
+ @brief  Initialize and configure \b PubNub network manager for specified operations lane.
  
- @since 4.0
+ @param lane One of \b PNOperationLane enum fields which describe for which group of API network
+             manager should be created.
+ 
+ @return Configured and ready to use network manager.
+ 
+ @since 4.1.0
  */
-- (void)prepareNetworkManagers;
+- (PNNetwork *)networkManagerForLane:(PNOperationLane)lane;
 
 
 #pragma mark - Handlers
 
+/**
+ @brief      Start application execution context transitions observation.
+ @discussion Client start observation when first network manager created (context transitions
+             doesn't affect client which never used network).
+ 
+ @since 4.1.0
+ */
+- (void)startContextTransitionsObservationIfRequired;
+
 /**
  @brief  Handle application with active client transition between foreground and background 
          execution contexts.
@@ -131,6 +206,19 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
  */
 - (void)handleContextTransition:(NSNotification *)notification;
 
+
+#pragma mark - Misc
+
+/**
+ @brief  Compose name of the key under which API calls deadline for receiver stored in thread
+         dictionary.
+ 
+ @return Deadline key name.
+ 
+ @since 4.1.0
+ */
+- (NSString *)deadlineKey;
+
 #pragma mark -
 
 
@@ -182,47 +270,55 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
     return [[self alloc] initWithConfiguration:configuration callbackQueue:callbackQueue];
 }
 
++ (instancetype)manuallyDrivenClientWithConfiguration:(PNConfiguration *)configuration {
+    
+    return [[self alloc] initWithConfiguration:configuration
+                                 callbackQueue:[PNEventLoop queueWithEventLoop]];
+}
+
++ (instancetype)clientWithConfiguration:(PNConfiguration *)configuration
+                          callbackQueue:(dispatch_queue_t)callbackQueue
+                                   pool:(PNClientPool *)pool {
+    
+    return [[self alloc] initWithConfiguration:configuration callbackQueue:callbackQueue
+                                          pool:pool];
+}
+
 - (instancetype)initWithConfiguration:(PNConfiguration *)configuration
                         callbackQueue:(dispatch_queue_t)callbackQueue {
     
+    return [self initWithConfiguration:configuration callbackQueue:callbackQueue pool:nil];
+}
+
+- (instancetype)initWithConfiguration:(PNConfiguration *)configuration
+                        callbackQueue:(dispatch_queue_t)callbackQueue
+                                 pool:(PNClientPool *)pool {
+    
     // Check whether initialization has been successful or not
     if ((self = [super init])) {
+        
+        // File logger state is process-wide, so it configured only by first client.
+        static dispatch_once_t onceToken;
+        dispatch_once(&onceToken, ^{
+            
 #if DEBUG
-        [PNLog dumpToFile:YES];
+            [PNLog dumpToFile:YES];
 #else
-        [PNLog dumpToFile:NO];
+            [PNLog dumpToFile:NO];
 #endif
-        
-        DDLogClientInfo([[self class] ddLogLevel], @"<PubNub> PubNub SDK %@ (%@ %@)",
-                        kPNLibraryVersion, kPNBranchName, kPNCommit);
+            DDLogClientInfo([[self class] ddLogLevel], @"<PubNub> PubNub SDK %@ (%@ %@)",
+                            kPNLibraryVersion, kPNBranchName, kPNCommit);
+        });
         
         _configuration = [configuration copy];
         _callbackQueue = callbackQueue;
-        [self prepareNetworkManagers];
-        
-        _subscriberManager = [PNSubscriber subscriberForClient:self];
-        _clientStateManager = [PNClientState stateForClient:self];
-        _listenersManager = [PNStateListener stateListenerForClient:self];
-        _heartbeatManager = [PNHeartbeat heartbeatForClient:self];
-        [self addListener:self];
-        [self prepareReachability];
-#if __IPHONE_OS_VERSION_MIN_REQUIRED
-        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
-        [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
-                                   name:UIApplicationWillEnterForegroundNotification object:nil];
-        [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
-                                   name:UIApplicationDidEnterBackgroundNotification object:nil];
-#elif __MAC_OS_X_VERSION_MIN_REQUIRED
-        NSNotificationCenter *notificationCenter = [[NSWorkspace sharedWorkspace] notificationCenter];
-        [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
-                                   name:NSWorkspaceWillSleepNotification object:nil];
-        [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
-                                   name:NSWorkspaceSessionDidResignActiveNotification object:nil];
-        [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
-                                   name:NSWorkspaceDidWakeNotification object:nil];
-        [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
-                                   name:NSWorkspaceSessionDidBecomeActiveNotification object:nil];
-#endif
+        _clientPool = pool;
+        _subsystemsLock = OS_SPINLOCK_INIT;
+        [PNIntrospection registerClient:self];
+        if (!pool && _configuration.shouldWarmUpConnections) {
+            
+            [self.serviceNetwork warmUpConnections];
+        }
     }
     
     return self;
@@ -314,9 +410,8 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
             // Dispatching check block with small delay, which will allow to fire reachability
             // change event.
             __weak __typeof(self) weakSelf = self;
-            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1.0 * NSEC_PER_SEC)),
-                           dispatch_get_main_queue(), ^{
-                               
+            [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:1.0f interval:0.0f block:^{
+                
                 // Silence static analyzer warnings.
                 // Code is aware about this case and at the end will simply call on 'nil' object
                 // method. In most cases if referenced object become 'nil' it mean what there is no
@@ -325,12 +420,101 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
                 #pragma clang diagnostic ignored "-Wreceiver-is-weak"
                 [weakSelf.reachability startServicePing];
                 #pragma clang diagnostic pop
-            });
+            }];
         }
     }
 }
 
 
+#pragma mark - Subsystems
+
+- (PNSubscriber *)subscriberManager {
+    
+    OSSpinLockLock(&_subsystemsLock);
+    if (!_subscriberManager) {
+        
+        _subscriberManager = [PNSubscriber subscriberForClient:self];
+    }
+    PNSubscriber *subscriberManager = _subscriberManager;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return subscriberManager;
+}
+
+- (PNClientState *)clientStateManager {
+    
+    OSSpinLockLock(&_subsystemsLock);
+    if (!_clientStateManager) {
+        
+        _clientStateManager = [PNClientState stateForClient:self];
+    }
+    PNClientState *clientStateManager = _clientStateManager;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return clientStateManager;
+}
+
+- (PNStateListener *)listenersManager {
+    
+    OSSpinLockLock(&_subsystemsLock);
+    if (!_listenersManager) {
+        
+        // Client itself track connection state changes using status events.
+        _listenersManager = [PNStateListener stateListenerForClient:self];
+        [_listenersManager addListener:self];
+    }
+    PNStateListener *listenersManager = _listenersManager;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return listenersManager;
+}
+
+- (PNHeartbeat *)heartbeatManager {
+    
+    OSSpinLockLock(&_subsystemsLock);
+    if (!_heartbeatManager) {
+        
+        _heartbeatManager = [PNHeartbeat heartbeatForClient:self];
+    }
+    PNHeartbeat *heartbeatManager = _heartbeatManager;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return heartbeatManager;
+}
+
+- (PNOriginSelector *)originSelector {
+    
+    // Pooled clients share origins health information.
+    if (self.clientPool) {
+        
+        return self.clientPool.sharedClient.originSelector;
+    }
+    
+    OSSpinLockLock(&_subsystemsLock);
+    if (!_originSelector) {
+        
+        _originSelector = [PNOriginSelector selectorForConfiguration:_configuration];
+    }
+    PNOriginSelector *originSelector = _originSelector;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return originSelector;
+}
+
+- (PNReachability *)reachability {
+    
+    OSSpinLockLock(&_subsystemsLock);
+    if (!_reachability) {
+        
+        [self prepareReachability];
+    }
+    PNReachability *reachability = _reachability;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return reachability;
+}
+
+
 #pragma mark - Reachability
 
 - (void)prepareReachability {
@@ -358,14 +542,50 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
 
 #pragma mark - PubNub Network managers
 
-- (void)prepareNetworkManagers {
+- (PNNetwork *)subscriptionNetwork {
     
-    _subscriptionNetwork = [PNNetwork networkForClient:self
-                                        requestTimeout:_configuration.subscribeMaximumIdleTime
-                                    maximumConnections:1 longPoll:YES];
-    _serviceNetwork = [PNNetwork networkForClient:self
-                                   requestTimeout:_configuration.nonSubscribeRequestTimeout
-                               maximumConnections:3 longPoll:NO];
+    OSSpinLockLock(&_subsystemsLock);
+    PNNetwork *subscriptionNetwork = _subscriptionNetwork;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return (subscriptionNetwork ?: [self networkManagerForLane:PNSubscriptionOperationLane]);
+}
+
+- (PNNetwork *)serviceNetwork {
+    
+    if (self.clientPool) {
+        
+        return self.clientPool.sharedClient.serviceNetwork;
+    }
+    
+    OSSpinLockLock(&_subsystemsLock);
+    PNNetwork *serviceNetwork = _serviceNetwork;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return (serviceNetwork ?: [self networkManagerForLane:PNServiceOperationLane]);
+}
+
+- (PNNetwork *)networkManagerForLane:(PNOperationLane)lane {
+    
+    // Network manager use origin selector and client queue during initialization, so it created
+    // outside of lock and only first created instance is stored.
+    BOOL longPoll = (lane == PNSubscriptionOperationLane);
+    NSTimeInterval timeout = (longPoll ? _configuration.subscribeMaximumIdleTime :
+                              _configuration.nonSubscribeRequestTimeout);
+    PNNetwork *network = [PNNetwork networkForClient:self requestTimeout:timeout
+                                  maximumConnections:(longPoll ? 1 : 3) longPoll:longPoll];
+    
+    OSSpinLockLock(&_subsystemsLock);
+    PNNetwork * __strong *storage = (longPoll ? &_subscriptionNetwork : &_serviceNetwork);
+    if (!*storage) {
+        
+        *storage = network;
+    }
+    network = *storage;
+    OSSpinLockUnlock(&_subsystemsLock);
+    [self startContextTransitionsObservationIfRequired];
+    
+    return network;
 }
 
 
@@ -382,24 +602,97 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
           withParameters:(PNRequestParameters *)parameters data:(NSData *)data
          completionBlock:(id)block {
     
-    if (operationType == PNSubscribeOperation || operationType == PNUnsubscribeOperation) {
+    if (PNOperationDescriptors[operationType].lane == PNSubscriptionOperationLane) {
 
         [self.subscriptionNetwork processOperation:operationType withParameters:parameters
                                               data:data completionBlock:block];
     }
     else {
-
+        
+        if (!parameters.deadline) {
+            
+            parameters.deadline = [self requestDeadline];
+        }
+        if (self.clientPool) {
+            
+            // Shared network manager use identity of client which issued request.
+            parameters.client = self;
+        }
         [self.serviceNetwork processOperation:operationType withParameters:parameters
                                          data:data completionBlock:block];
     }
 }
 
+- (NSDate *)requestDeadline {
+    
+    return [[NSThread currentThread] threadDictionary][[self deadlineKey]];
+}
+
 - (void)cancelAllLongPollingOperations {
     
     [self.subscriptionNetwork cancelAllRequests];
 }
 
 
+#pragma mark - Deadlines
+
+- (void)performWithDeadline:(NSDate *)deadline block:(dispatch_block_t)block {
+    
+    if (block) {
+        
+        NSMutableDictionary *threadDictionary = [[NSThread currentThread] threadDictionary];
+        NSString *deadlineKey = [self deadlineKey];
+        NSDate *previousDeadline = threadDictionary[deadlineKey];
+        if (previousDeadline && [previousDeadline compare:deadline] == NSOrderedAscending) {
+            
+            deadline = previousDeadline;
+        }
+        if (deadline) {
+            
+            threadDictionary[deadlineKey] = deadline;
+        }
+        
+        // Deadline should be restored even if block throw, otherwise unrelated calls on this
+        // thread will inherit it.
+        @try {
+            
+            block();
+        }
+        @finally {
+            
+            if (previousDeadline) {
+                
+                threadDictionary[deadlineKey] = previousDeadline;
+            }
+            else {
+                
+                [threadDictionary removeObjectForKey:deadlineKey];
+            }
+        }
+    }
+}
+
+- (void)performWithTimeout:(NSTimeInterval)timeout block:(dispatch_block_t)block {
+    
+    [self performWithDeadline:[NSDate dateWithTimeIntervalSinceNow:timeout] block:block];
+}
+
+
+#pragma mark - Manual drive
+
+- (int)eventsFileDescriptor {
+    
+    PNEventLoop *eventLoop = [PNEventLoop eventLoopForQueue:self.callbackQueue];
+    
+    return (eventLoop ? eventLoop.fileDescriptor : -1);
+}
+
+- (NSUInteger)pumpWithTimeout:(NSTimeInterval)timeout {
+    
+    return [[PNEventLoop eventLoopForQueue:self.callbackQueue] pumpWithTimeout:timeout];
+}
+
+
 #pragma mark - Operation information
 
 - (NSInteger)packetSizeForOperation:(PNOperationType)operationType
@@ -409,6 +702,10 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
     if (operationType != PNSubscribeOperation && operationType != PNUnsubscribeOperation) {
         
         network = self.serviceNetwork;
+        if (self.clientPool) {
+            
+            parameters.client = self;
+        }
     }
     
     return [network packetSizeForOperation:operationType withParameters:parameters data:data];
@@ -423,6 +720,30 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
 }
 
 
+#pragma mark - Introspection
+
+- (NSDictionary *)introspectionSnapshot {
+    
+    // Snapshot doesn't create subsystems which hasn't been used by client yet.
+    OSSpinLockLock(&_subsystemsLock);
+    PNSubscriber *subscriberManager = _subscriberManager;
+    PNClientState *clientStateManager = _clientStateManager;
+    PNStateListener *listenersManager = _listenersManager;
+    PNHeartbeat *heartbeatManager = _heartbeatManager;
+    PNNetwork *subscriptionNetwork = _subscriptionNetwork;
+    PNNetwork *serviceNetwork = _serviceNetwork;
+    OSSpinLockUnlock(&_subsystemsLock);
+    
+    return @{@"uuid": self.configuration.uuid, @"subscribeKey": self.configuration.subscribeKey,
+             @"subscriber": ([subscriberManager introspectionSnapshot]?: @{}),
+             @"state": ([clientStateManager introspectionSnapshot]?: @{}),
+             @"listeners": ([listenersManager introspectionSnapshot]?: @{}),
+             @"heartbeat": ([heartbeatManager introspectionSnapshot]?: @{}),
+             @"subscriptionNetwork": (subscriptionNetwork.introspectionSnapshot?: @{}),
+             @"serviceNetwork": (serviceNetwork.introspectionSnapshot?: @{})};
+}
+
+
 #pragma mark - Events notification
 
 - (void)callBlock:(id)block status:(BOOL)callingStatusBlock withResult:(PNResult *)result
@@ -430,25 +751,26 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
     
     if (result) {
 
-        DDLogResult([[self class] ddLogLevel], @"<PubNub> %@", [result stringifiedRepresentation]);
+        DDLogResultObject([[self class] ddLogLevel], result);
     }
     
     if (status) {
         
         if (status.isError) {
             
-            DDLogFailureStatus([[self class] ddLogLevel], @"<PubNub> %@", [status stringifiedRepresentation]);
+            DDLogFailureStatusObject([[self class] ddLogLevel], status);
         }
         else {
             
-            DDLogStatus([[self class] ddLogLevel], @"<PubNub> %@", [status stringifiedRepresentation]);
+            DDLogStatusObject([[self class] ddLogLevel], status);
         }
     }
 
     if (block) {
 
         pn_dispatch_async(self.callbackQueue, ^{
-
+            
+            [(result.trace ?: status.trace) markStage:PNCallbackInvokedStage];
             if (!callingStatusBlock) {
                 
                 ((PNCompletionBlock)block)(result, status);
@@ -473,6 +795,36 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
 
 #pragma mark - Handlers
 
+- (void)startContextTransitionsObservationIfRequired {
+    
+    OSSpinLockLock(&_subsystemsLock);
+    BOOL shouldObserve = !self.observingContextTransitions;
+    self.observingContextTransitions = YES;
+    OSSpinLockUnlock(&_subsystemsLock);
+    if (!shouldObserve) {
+        
+        return;
+    }
+    
+#if __IPHONE_OS_VERSION_MIN_REQUIRED
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
+                               name:UIApplicationWillEnterForegroundNotification object:nil];
+    [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
+                               name:UIApplicationDidEnterBackgroundNotification object:nil];
+#elif __MAC_OS_X_VERSION_MIN_REQUIRED
+    NSNotificationCenter *notificationCenter = [[NSWorkspace sharedWorkspace] notificationCenter];
+    [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
+                               name:NSWorkspaceWillSleepNotification object:nil];
+    [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
+                               name:NSWorkspaceSessionDidResignActiveNotification object:nil];
+    [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
+                               name:NSWorkspaceDidWakeNotification object:nil];
+    [notificationCenter addObserver:self selector:@selector(handleContextTransition:)
+                               name:NSWorkspaceSessionDidBecomeActiveNotification object:nil];
+#endif
+}
+
 - (void)handleContextTransition:(NSNotification *)notification {
     
 #if __IPHONE_OS_VERSION_MIN_REQUIRED
@@ -501,8 +853,17 @@ void pn_dispatch_async(dispatch_queue_t queue, dispatch_block_t block) {
 
 #pragma mark - Misc
 
+- (NSString *)deadlineKey {
+    
+    return [NSString stringWithFormat:@"com.pubnub.deadline.%p", self];
+}
+
 - (void)dealloc {
     
+    if (!_observingContextTransitions) {
+        
+        return;
+    }
 #if __IPHONE_OS_VERSION_MIN_REQUIRED
     NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
     [notificationCenter removeObserver:self name:UIApplicationWillEnterForegroundNotification
@@ -9,7 +9,7 @@
 #pragma mark Class forward
 
 @class PNRequestParameters, PNConfiguration, PNClientState, PNStateListener, PNSubscriber,
-       PNHeartbeat, PNResult, PNStatus;
+       PNReachability, PNOriginSelector, PNHeartbeat, PNClientPool, PNResult, PNStatus;
 
 
 /**
@@ -65,6 +65,20 @@
  */
 @property (nonatomic, readonly, strong) PNHeartbeat *heartbeatManager;
 
+/**
+ @brief  Stores reference on helper which track connection health using requests completion.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) PNReachability *reachability;
+
+/**
+ @brief  Stores reference on helper which choose origin for each request.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) PNOriginSelector *originSelector;
+
 /**
  @brief  Stores reference about recent client state (whether it was connected or not).
  
@@ -84,6 +98,37 @@
  */
 @property (nonatomic, readonly, strong) dispatch_queue_t callbackQueue;
 
+/**
+ @brief      Stores reference on pool from which client has been retrieved.
+ @discussion Pooled client send 'non-subscription' API requests through network manager of pool's
+             shared client and use it's origin selector.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) PNClientPool *clientPool;
+
+
+///------------------------------------------------
+/// @name Initialization
+///------------------------------------------------
+
+/**
+ @brief  Construct client which share network stack with other clients from \c pool.
+ 
+ @param configuration Reference on configuration with identity of user on behalf of which client
+                      should send requests.
+ @param callbackQueue Reference on queue which should be used by client for completion block and
+                      delegate calls.
+ @param pool          Reference on pool which provide shared network manager.
+ 
+ @return Configured and ready to use \b PubNub client.
+ 
+ @since 4.1.0
+ */
++ (instancetype)clientWithConfiguration:(PNConfiguration *)configuration
+                          callbackQueue:(dispatch_queue_t)callbackQueue
+                                   pool:(PNClientPool *)pool;
+
 
 ///------------------------------------------------
 /// @name Logger
@@ -141,6 +186,16 @@
           withParameters:(PNRequestParameters *)parameters data:(NSData *)data
          completionBlock:(id)block;
 
+/**
+ @brief  Retrieve deadline which has been set with \c -performWithDeadline:block: for API calls
+         which is done on current thread.
+ 
+ @return Reference on deadline date or \c nil if there is no deadline.
+ 
+ @since 4.1.0
+ */
+- (NSDate *)requestDeadline;
+
 /**
  @brief  Cancel any active long-polling operations scheduled for processing.
  
@@ -180,6 +235,23 @@
 - (void)appendClientInformation:(PNResult *)result;
 
 
+///------------------------------------------------
+/// @name Introspection
+///------------------------------------------------
+
+/**
+ @brief      Collect snapshot of client's internal state.
+ @discussion Each component's snapshot taken on it's own resources access queue, so client continue
+             to process events while snapshot is collected.
+ 
+ @return Dictionary with \c uuid, \c subscribeKey, \c subscriber, \c state, \c listeners,
+         \c heartbeat, \c subscriptionNetwork and \c serviceNetwork keys.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)introspectionSnapshot;
+
+
 ///------------------------------------------------
 /// @name Events notification
 ///------------------------------------------------
@@ -4,8 +4,9 @@
 
 #pragma mark Class forward
 
-@class PNPresenceChannelGroupHereNowResult, PNPresenceChannelHereNowResult,
-       PNPresenceGlobalHereNowResult, PNPresenceWhereNowResult, PNErrorStatus;
+@class PNPresenceChannelGroupHereNowResult, PNPresenceChannelHereNowChangesResult,
+       PNPresenceChannelHereNowResult, PNPresenceGlobalHereNowResult, PNPresenceWhereNowResult,
+       PNErrorStatus;
 
 
 #pragma mark - Types
@@ -21,6 +22,18 @@
 typedef void(^PNHereNowCompletionBlock)(PNPresenceChannelHereNowResult *result,
                                         PNErrorStatus *status);
 
+/**
+ @brief  Here now changes completion block.
+ 
+ @param result Reference on result object which describe changes in channel presence since previous
+               snapshot.
+ @param status Reference on status instance which hold information about processing results.
+ 
+ @since 4.1.0
+ */
+typedef void(^PNHereNowChangesCompletionBlock)(PNPresenceChannelHereNowChangesResult *result,
+                                               PNErrorStatus *status);
+
 /**
  @brief  Global here now completion block.
  
@@ -278,6 +291,62 @@ typedef void(^PNWhereNowCompletionBlock)(PNPresenceWhereNowResult *result, PNErr
 - (void)hereNowForChannel:(NSString *)channel withVerbosity:(PNHereNowVerbosityLevel)level
                completion:(PNHereNowCompletionBlock)block;
 
+/**
+ @brief      Request changes in list of subscribers on specific channel live feeds since previous
+             snapshot.
+ @discussion Client keep few recently received channel presence snapshots in compact sorted form
+             and calculate changes against one which has been passed in single pass, so only
+             joined / left subscribers and their state changes will be passed to completion block.
+ @note       \b PubNub service doesn't provide presence changes, so full list of subscribers with
+             their state will be requested each time.
+ 
+ @code
+ @endcode
+ \b Example:
+ 
+ @code
+ // Client configuration.
+ PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo" 
+                                                                  subscribeKey:@"demo"];
+ self.client = [PubNub clientWithConfiguration:configuration];
+ [self.client hereNowChangesForChannel:@"pubnub" since:self.lastPresenceSnapshot
+                            completion:^(PNPresenceChannelHereNowChangesResult *result,
+                                         PNErrorStatus *status) {
+     
+     // Check whether request successfully completed or not.
+     if (!status.isError) {
+        
+        // Handle presence changes using:
+        //   result.data.join - list of subscribers which joined channel since snapshot.
+        //   result.data.leave - list of subscribers which left channel since snapshot.
+        //   result.data.stateChanges - dictionary with subscribers state changes.
+        //   result.data.reset - whether 'join' contain full list of subscribers or not.
+        //   result.data.occupancy - total number of active subscribers.
+        self.lastPresenceSnapshot = result.data.snapshot;
+     }
+     // Request processing failed.
+     else {
+        
+        // Handle presence audit error. Check 'category' property to find out possible issue because
+        // of which request did fail.
+        //
+        // Request can be resent using: [status retry];
+     }
+ }];
+ @endcode
+ 
+ @param channel  Reference on channel for which here now changes should be received.
+ @param snapshot Identifier of snapshot from previous changes request result. In case if \c nil or
+                 unknown identifier passed, changes will be calculated against empty snapshot.
+ @param block    Here now changes processing completion block which pass two arguments: \c result
+                 - in case of successful request processing \c data field will contain changes in
+                 channel presence; \c status - in case if error occurred during request processing.
+ 
+ @since 4.1.0
+ */
+- (void)hereNowChangesForChannel:(NSString *)channel since:(NSNumber *)snapshot
+                      completion:(PNHereNowChangesCompletionBlock)block;
+
 
 ///------------------------------------------------
 /// @name Channel group here now
@@ -4,11 +4,16 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "PubNub+PresencePrivate.h"
+#import "PNPresenceChannelHereNowChangesResult.h"
+#import "PNPresenceHereNowParser.h"
 #import "PNPrivateStructures.h"
 #import "PNRequestParameters.h"
 #import "PubNub+CorePrivate.h"
+#import "PNResult+Private.h"
 #import "PNConfiguration.h"
+#import "PNClientState.h"
 #import "PNHelpers.h"
+#import <objc/runtime.h>
 
 
 #pragma mark Protected interface declaration
@@ -75,6 +80,63 @@
     [self hereNowWithVerbosity:level forChannel:YES withName:channel withCompletion:block];
 }
 
+- (void)hereNowChangesForChannel:(NSString *)channel since:(NSNumber *)snapshot
+                      completion:(PNHereNowChangesCompletionBlock)block {
+    
+    PNRequestParameters *parameters = [PNRequestParameters new];
+    [parameters addQueryParameter:@"0" forFieldName:@"disable_uuids"];
+    [parameters addQueryParameter:@"1" forFieldName:@"state"];
+    if ([channel length]) {
+        
+        [parameters addPathComponent:[PNString percentEscapedString:channel]
+                      forPlaceholder:@"{channel}"];
+    }
+    DDLogAPICall([[self class] ddLogLevel], @"<PubNub> Channel 'here now' changes for %@ since %@.",
+                 (channel?: @"<error>"), (snapshot?: @"<none>"));
+    
+    // Silence static analyzer warnings.
+    // Code is aware about this case and at the end will simply call on 'nil' object method.
+    // In most cases if referenced object become 'nil' it mean what there is no more need in
+    // it and probably whole client instance has been deallocated.
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+    #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
+    __weak __typeof(self) weakSelf = self;
+    [self processOperation:PNHereNowForChannelOperation withParameters:parameters
+           completionBlock:^(PNResult *result, PNStatus *status) {
+               
+               __strong __typeof(self) strongSelf = weakSelf;
+               PNResult *changesResult = nil;
+               if (result) {
+                   
+                   PNClientState *stateManager = strongSelf.clientStateManager;
+                   NSDictionary *newSnapshot = [PNPresenceHereNowParser snapshotFromParsedResponse:
+                                                result.serviceData];
+                   // Snapshots looked up by identifier, so overlapping requests for same channel
+                   // calculate changes against snapshot which has been passed by their caller.
+                   NSDictionary *base = [stateManager hereNowSnapshotWithIdentifier:snapshot
+                                                                         forChannel:channel];
+                   BOOL reset = (base == nil);
+                   NSDictionary *changes = [PNPresenceHereNowParser changesFromSnapshot:base
+                                                                             toSnapshot:newSnapshot];
+                   
+                   // Store received presence information as base for next changes request.
+                   NSNumber *identifier = [stateManager storeHereNowSnapshot:newSnapshot
+                                                                  forChannel:channel];
+                   
+                   NSMutableDictionary *data = [changes mutableCopy];
+                   data[@"occupancy"] = (result.serviceData[@"occupancy"]?:
+                                         @([newSnapshot[@"uuids"] count]));
+                   data[@"snapshot"] = identifier;
+                   data[@"reset"] = @(reset);
+                   changesResult = [result copyWithMutatedData:data];
+                   object_setClass(changesResult, [PNPresenceChannelHereNowChangesResult class]);
+               }
+               [strongSelf callBlock:block status:NO withResult:changesResult andStatus:status];
+           }];
+    #pragma clang diagnostic pop
+}
+
 
 #pragma mark - Channel group here now
 
@@ -178,51 +240,58 @@
 
 - (void)heartbeatWithCompletion:(PNStatusBlock)block {
     
-    __weak __typeof(self) weakSelf = self;
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
         
         NSArray *channels = [self.subscriberManager channels];
         NSArray *groups = [PNChannel objectsWithOutPresenceFrom:[self.subscriberManager channelGroups]];
-        if (self.configuration.presenceHeartbeatValue > 0 && ([channels count] || [groups count])) {
+        [self heartbeatForChannels:channels groups:groups
+                         withState:[self.clientStateManager state]
+                    heartbeatValue:self.configuration.presenceHeartbeatValue completion:block];
+    });
+}
+
+- (void)heartbeatForChannels:(NSArray *)channels groups:(NSArray *)groups
+                   withState:(NSDictionary *)state heartbeatValue:(NSInteger)heartbeatValue
+                  completion:(PNStatusBlock)block {
+    
+    if (heartbeatValue > 0 && ([channels count] || [groups count])) {
+        
+        PNRequestParameters *parameters = [PNRequestParameters new];
+        [parameters addPathComponent:[PNChannel namesForRequest:channels defaultString:@","]
+                      forPlaceholder:@"{channels}"];
+        if ([groups count]) {
             
-            PNRequestParameters *parameters = [PNRequestParameters new];
-            [parameters addPathComponent:[PNChannel namesForRequest:channels defaultString:@","]
-                          forPlaceholder:@"{channels}"];
-            if ([groups count]) {
-                
-                [parameters addQueryParameter:[PNChannel namesForRequest:groups]
-                                 forFieldName:@"channel-group"];
-            }
-            [parameters addQueryParameter:[@(self.configuration.presenceHeartbeatValue) stringValue]
-                             forFieldName:@"heartbeat"];
-            NSDictionary *state = [self.clientStateManager state];
-            if ([state count]) {
+            [parameters addQueryParameter:[PNChannel namesForRequest:groups]
+                             forFieldName:@"channel-group"];
+        }
+        [parameters addQueryParameter:[@(heartbeatValue) stringValue] forFieldName:@"heartbeat"];
+        if ([state count]) {
+            
+            NSString *stateString = [PNJSON JSONStringFrom:state withError:nil];
+            if ([stateString length]) {
                 
-                NSString *stateString = [PNJSON JSONStringFrom:state withError:nil];
-                if ([stateString length]) {
-                    
-                    [parameters addQueryParameter:[PNString percentEscapedString:stateString]
-                                     forFieldName:@"state"];
-                }
+                [parameters addQueryParameter:[PNString percentEscapedString:stateString]
+                                 forFieldName:@"state"];
             }
-            DDLogAPICall([[self class] ddLogLevel], @"<PubNub> Heartbeat for channels %@ and groups %@.",
-                         [channels componentsJoinedByString:@", "],
-                         [groups componentsJoinedByString:@", "]);
-            
-            [self processOperation:PNHeartbeatOperation withParameters:parameters
-                   completionBlock:^(PNStatus *status) {
-                       
-               // Silence static analyzer warnings.
-               // Code is aware about this case and at the end will simply call on 'nil' object
-               // method. In most cases if referenced object become 'nil' it mean what there is no
-               // more need in it and probably whole client instance has been deallocated.
-               #pragma clang diagnostic push
-               #pragma clang diagnostic ignored "-Wreceiver-is-weak"
-               [weakSelf callBlock:block status:YES withResult:nil andStatus:status];
-               #pragma clang diagnostic pop
-           }];
         }
-    });
+        DDLogAPICall([[self class] ddLogLevel], @"<PubNub> Heartbeat for channels %@ and groups %@.",
+                     [channels componentsJoinedByString:@", "],
+                     [groups componentsJoinedByString:@", "]);
+        
+        __weak __typeof(self) weakSelf = self;
+        [self processOperation:PNHeartbeatOperation withParameters:parameters
+               completionBlock:^(PNStatus *status) {
+           
+           // Silence static analyzer warnings.
+           // Code is aware about this case and at the end will simply call on 'nil' object
+           // method. In most cases if referenced object become 'nil' it mean what there is no
+           // more need in it and probably whole client instance has been deallocated.
+           #pragma clang diagnostic push
+           #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+           [weakSelf callBlock:block status:YES withResult:nil andStatus:status];
+           #pragma clang diagnostic pop
+       }];
+    }
 }
 
 #pragma mark -
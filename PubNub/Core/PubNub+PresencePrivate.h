@@ -20,6 +20,24 @@
  */
 - (void)heartbeatWithCompletion:(PNStatusBlock)block;
 
+/**
+ @brief      Issue heartbeat request for specified channels and groups to \b PubNub network.
+ @discussion Used by shared heartbeat scheduler to send single heartbeat request on behalf of few
+             clients which share same configuration.
+ 
+ @param channels       List of channel names for which presence should be refreshed.
+ @param groups         List of channel group names for which presence should be refreshed.
+ @param state          Reference on merged client state which should be sent along with request.
+ @param heartbeatValue Number of seconds during which \b PubNub service will wait for next
+                       heartbeat.
+ @param block          Reference on block which should be called with service information.
+ 
+ @since 4.1.0
+ */
+- (void)heartbeatForChannels:(NSArray *)channels groups:(NSArray *)groups
+                   withState:(NSDictionary *)state heartbeatValue:(NSInteger)heartbeatValue
+                  completion:(PNStatusBlock)block;
+
 #pragma mark -
 
 
@@ -138,8 +138,9 @@
          compressed:(BOOL)compressed withCompletion:(PNPublishCompletionBlock)block {
 
     // Push further code execution on secondary queue to make service queue responsive during
-    // JSON serialization and encryption process.
+    // JSON serialization and encryption process. Deadline should be taken from calling thread.
     __weak __typeof(self) weakSelf = self;
+    NSDate *deadline = [self requestDeadline];
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
 
         BOOL encrypted = NO;
@@ -168,6 +169,7 @@
                                                                   toChannel:channel
                                                                  compressed:compressed
                                                              storeInHistory:shouldStore];
+        parameters.deadline = deadline;
         NSData *publishData = nil;
         if (compressed) {
 
@@ -120,9 +120,11 @@
         withName:(NSString *)object withCompletion:(PNSetStateCompletionBlock)block {
     
     __weak __typeof(self) weakSelf = self;
+    NSDate *deadline = [self requestDeadline];
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
         
         PNRequestParameters *parameters = [PNRequestParameters new];
+        parameters.deadline = deadline;
         [parameters addPathComponent:(onChannel ? [PNString percentEscapedString:object] : @",")
                       forPlaceholder:@"{channel}"];
         NSString *stateString = ([PNJSON JSONStringFrom:state withError:NULL]?: @"{}");
@@ -61,6 +61,16 @@
  */
 - (NSDictionary *)state;
 
+/**
+ @brief  Retrieve consistent snapshot of cached state and here now snapshots for introspection.
+ 
+ @return Dictionary with \c state (cached state for all objects) and \c hereNowSnapshots (names of
+         channels for which presence snapshot has been stored) keys.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)introspectionSnapshot;
+
 /**
  @brief  Provide merged client state using new \c state information which should be bound to remote
          data \c object.
@@ -103,6 +113,41 @@
  */
 - (void)removeStateForObjects:(NSArray *)objects;
 
+
+///------------------------------------------------
+/// @name Here now snapshots
+///------------------------------------------------
+
+/**
+ @brief      Retrieve channel presence snapshot which has been created by here now changes API.
+ @discussion Few recent snapshots stored for each channel, so callers which request changes
+             concurrently receive changes against snapshot which they passed.
+ 
+ @param identifier Identifier which has been assigned to snapshot when it has been stored.
+ @param channel    Name of the channel for which snapshot should be retrieved.
+ 
+ @return Snapshot dictionary with \c identifier, \c uuids and \c states keys or \c nil in case if
+         snapshot with \c identifier not stored (or already evicted) for \c channel.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)hereNowSnapshotWithIdentifier:(NSNumber *)identifier
+                                     forChannel:(NSString *)channel;
+
+/**
+ @brief      Store channel presence snapshot which will be used to calculate next changes.
+ @discussion Snapshot receive unique identifier and replace least recently used snapshot in case if
+             too many snapshots stored for \c channel.
+ 
+ @param snapshot Snapshot dictionary with \c uuids and \c states keys.
+ @param channel  Name of the channel for which snapshot should be stored.
+ 
+ @return Identifier which has been assigned to stored snapshot.
+ 
+ @since 4.1.0
+ */
+- (NSNumber *)storeHereNowSnapshot:(NSDictionary *)snapshot forChannel:(NSString *)channel;
+
 #pragma mark - 
 
 
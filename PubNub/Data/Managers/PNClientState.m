@@ -7,6 +7,16 @@
 #import "PubNub+CorePrivate.h"
 
 
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of here now snapshots which is stored for each channel.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNHereNowSnapshotsLimit = 10;
+
+
 #pragma mark Protected interface declaration
 
 @interface  PNClientState ()
@@ -29,6 +39,22 @@
  */
 @property (nonatomic, strong) NSMutableDictionary *stateCache;
 
+/**
+ @brief      Stores reference on channel presence snapshots created by here now changes API.
+ @discussion Channel name is key and list of snapshots ordered from least to most recently used is
+             value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *hereNowSnapshots;
+
+/**
+ @brief  Stores identifier which has been assigned to last stored here now snapshot.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) unsigned long long hereNowSnapshotIdentifier;
+
 /**
  @brief  Stores reference on queue which is used to serialize access to shared client state
          information.
@@ -76,6 +102,7 @@
         
         _client = client;
         _stateCache = [NSMutableDictionary new];
+        _hereNowSnapshots = [NSMutableDictionary new];
         _resourceAccessQueue = dispatch_queue_create("com.pubnub.client-state",
                                                      DISPATCH_QUEUE_CONCURRENT);
     }
@@ -86,6 +113,14 @@
 - (void)inheritStateFromState:(PNClientState *)state {
     
     _stateCache = [state.stateCache mutableCopy];
+    _hereNowSnapshots = [NSMutableDictionary new];
+    [state.hereNowSnapshots enumerateKeysAndObjectsUsingBlock:^(NSString *channel,
+                                                                NSArray *snapshots,
+                                                                __unused BOOL *stop) {
+        
+        self->_hereNowSnapshots[channel] = [snapshots mutableCopy];
+    }];
+    _hereNowSnapshotIdentifier = state.hereNowSnapshotIdentifier;
 }
 
 
@@ -102,6 +137,18 @@
     return state;
 }
 
+- (NSDictionary *)introspectionSnapshot {
+    
+    __block NSDictionary *snapshot = nil;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        snapshot = @{@"state": [self->_stateCache copy],
+                     @"hereNowSnapshots": [self->_hereNowSnapshots allKeys]};
+    });
+    
+    return snapshot;
+}
+
 - (NSDictionary *)stateMergedWith:(NSDictionary *)state forObjects:(NSArray *)objects {
     
     NSMutableDictionary *mutableState = [([self state]?: @{}) mutableCopy];
@@ -177,6 +224,73 @@
     });
 }
 
+
+#pragma mark - Here now snapshots
+
+- (NSDictionary *)hereNowSnapshotWithIdentifier:(NSNumber *)identifier
+                                     forChannel:(NSString *)channel {
+    
+    __block NSDictionary *snapshot = nil;
+    if (identifier && channel) {
+        
+        // Barrier used because found snapshot moved to the end of list as most recently used.
+        dispatch_barrier_sync(self.resourceAccessQueue, ^{
+            
+            NSMutableArray *snapshots = self.hereNowSnapshots[channel];
+            NSUInteger snapshotIdx = NSNotFound;
+            for (NSUInteger entryIdx = 0; entryIdx < [snapshots count]; entryIdx++) {
+                
+                if ([snapshots[entryIdx][@"identifier"] isEqual:identifier]) {
+                    
+                    snapshotIdx = entryIdx;
+                    break;
+                }
+            }
+            if (snapshotIdx != NSNotFound) {
+                
+                snapshot = snapshots[snapshotIdx];
+                [snapshots removeObjectAtIndex:snapshotIdx];
+                [snapshots addObject:snapshot];
+            }
+        });
+    }
+    
+    return snapshot;
+}
+
+- (NSNumber *)storeHereNowSnapshot:(NSDictionary *)snapshot forChannel:(NSString *)channel {
+    
+    __block NSNumber *identifier = nil;
+    if (snapshot && channel) {
+        
+        dispatch_barrier_sync(self.resourceAccessQueue, ^{
+            
+            // Identifier based on time (in 10^-7 seconds), but strictly increase to stay unique for
+            // snapshots stored at same moment.
+            NSTimeInterval timestamp = [[NSDate date] timeIntervalSince1970];
+            self.hereNowSnapshotIdentifier = MAX((unsigned long long)(timestamp * 10000000),
+                                                 self.hereNowSnapshotIdentifier + 1);
+            identifier = @(self.hereNowSnapshotIdentifier);
+            
+            NSMutableArray *snapshots = self.hereNowSnapshots[channel];
+            if (!snapshots) {
+                
+                snapshots = [NSMutableArray new];
+                self.hereNowSnapshots[channel] = snapshots;
+            }
+            if ([snapshots count] >= kPNHereNowSnapshotsLimit) {
+                
+                [snapshots removeObjectAtIndex:0];
+            }
+            NSMutableDictionary *snapshotForStore = [snapshot mutableCopy];
+            snapshotForStore[@"identifier"] = identifier;
+            [snapshots addObject:[snapshotForStore copy]];
+        });
+    }
+    
+    return identifier;
+}
+
 #pragma mark -
 
 
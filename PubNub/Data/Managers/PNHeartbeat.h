@@ -41,6 +41,8 @@
 /**
  @brief  If client configured with heartbeat value and interval client will send "heartbeat" 
          notification to \b PubNub service.
+ @note   Heartbeat requests scheduled by process-wide \b PNHeartbeatScheduler, so clients with same
+         origin, keys and identifier will share single heartbeat request.
  
  @since 4.0
  */
@@ -53,6 +55,21 @@
  */
 - (void)stopHeartbeatIfPossible;
 
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Retrieve heartbeat schedule information for introspection.
+ 
+ @return Dictionary with \c scheduled key and (if heartbeat is scheduled) \c interval,
+         \c sinceRefresh, \c tillHeartbeat and \c groupSize keys.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)introspectionSnapshot;
+
 #pragma mark -
 
 
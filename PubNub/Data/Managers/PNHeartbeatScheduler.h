@@ -0,0 +1,83 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class PubNub;
+
+
+/**
+ @brief      Process-wide presence heartbeat scheduler.
+ @discussion Scheduler group registered clients by origin, subscribe key, authorization key and
+             unique identifier and use single timer to trigger heartbeat requests for all of them.
+             Clients from same group share heartbeat interval (shortest from group members) and
+             their channels / groups merged into single heartbeat request. Clients which recently
+             refreshed their presence with subscribe request (which also carry \c heartbeat value)
+             not included into group heartbeat.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNHeartbeatScheduler : NSObject
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Retrieve reference on scheduler which is shared by all clients in process.
+ 
+ @return Shared heartbeat scheduler.
+ 
+ @since 4.1.0
+ */
++ (instancetype)sharedScheduler;
+
+
+///------------------------------------------------
+/// @name State manipulation
+///------------------------------------------------
+
+/**
+ @brief      Add \c client to heartbeat schedule (or update it's group if configuration changed).
+ @discussion Call to this method also mean what client's presence has been refreshed (subscribe
+             request with \c heartbeat value issued) and next heartbeat for it can be delayed.
+ 
+ @param client Reference on client for which heartbeat requests should be scheduled.
+ 
+ @since 4.1.0
+ */
+- (void)scheduleHeartbeatForClient:(PubNub *)client;
+
+/**
+ @brief  Remove \c client from heartbeat schedule.
+ 
+ @param client Reference on client for which heartbeat requests should be stopped.
+ 
+ @since 4.1.0
+ */
+- (void)unscheduleHeartbeatForClient:(PubNub *)client;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Retrieve heartbeat schedule information for \c client.
+ 
+ @param client Reference on client for which schedule information should be retrieved.
+ 
+ @return Dictionary with \c scheduled key and (if client is scheduled) \c interval,
+         \c sinceRefresh, \c tillHeartbeat (seconds) and \c groupSize keys.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)scheduleInformationForClient:(PubNub *)client;
+
+#pragma mark -
+
+
+@end
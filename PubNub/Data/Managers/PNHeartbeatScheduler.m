@@ -0,0 +1,420 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNHeartbeatScheduler.h"
+#import "PubNub+PresencePrivate.h"
+#import "PubNub+CorePrivate.h"
+#import "PNConfiguration.h"
+#import "PNTimingWheel.h"
+#import "PNHelpers.h"
+
+
+#pragma mark Protected interface declaration
+
+@interface PNHeartbeatScheduler ()
+
+
+#pragma mark - Information
+
+/**
+ @brief      Stores reference on scheduled clients information.
+ @discussion Client is a weak key and mutable dictionary with \c group, \c interval and
+             \c refreshDate keys is a value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMapTable *clients;
+
+/**
+ @brief  Stores reference on dates when heartbeat for each group of clients should be sent.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *groupFireDates;
+
+/**
+ @brief  Stores reference on timer which is used to trigger heartbeat for all groups.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNTimingWheelTimer *heartbeatTimer;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to shared scheduler
+         information.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Compose name of the group into which \c client should be placed.
+ 
+ @param configuration Reference on configuration of client for which group should be composed.
+ 
+ @return Group name.
+ 
+ @since 4.1.0
+ */
+- (NSString *)groupForConfiguration:(PNConfiguration *)configuration;
+
+/**
+ @brief  Compose list of clients for each group.
+ @note   This method should be called only from resource access queue.
+ 
+ @return Dictionary where group name is a key and list of clients is a value.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)clientsByGroup;
+
+/**
+ @brief      Compose single heartbeat request information for all channels and groups of passed
+             \c clients.
+ @discussion Clients' subscriber and state managers use own queues, so this method should be
+             called outside of resource access queue.
+ 
+ @param clients List of clients from same group for which heartbeat should be sent.
+ 
+ @return Dictionary with merged \c channels, \c groups, \c state, largest \c heartbeat value,
+         \c client which should send request (if any) and list of \c idleClients which doesn't
+         have any objects on which heartbeat can be sent.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)heartbeatPayloadForClients:(NSArray *)clients;
+
+/**
+ @brief      Send single heartbeat request for all channels and groups of passed \c clients.
+ @discussion Clients which doesn't have any objects on which heartbeat can be sent will be removed
+             from schedule.
+ @note       This method should be called outside of resource access queue.
+ 
+ @param clients List of clients from same group for which heartbeat should be sent.
+ 
+ @since 4.1.0
+ */
+- (void)sendHeartbeatForClients:(NSArray *)clients;
+
+/**
+ @brief  Re-arm heartbeat timer to fire at closest group fire date.
+ @note   This method should be called only from resource access queue.
+ 
+ @since 4.1.0
+ */
+- (void)updateTimer;
+
+
+#pragma mark - Handlers
+
+/**
+ @brief  Process heartbeat timer fire event and send heartbeat requests for all groups which is
+         due.
+ 
+ @since 4.1.0
+ */
+- (void)handleHeartbeatTimer;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNHeartbeatScheduler
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sharedScheduler {
+    
+    static PNHeartbeatScheduler *_sharedScheduler;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _sharedScheduler = [self new];
+    });
+    
+    return _sharedScheduler;
+}
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _clients = [NSMapTable weakToStrongObjectsMapTable];
+        _groupFireDates = [NSMutableDictionary new];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.heartbeat-scheduler",
+                                                     DISPATCH_QUEUE_CONCURRENT);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - State manipulation
+
+- (void)scheduleHeartbeatForClient:(PubNub *)client {
+    
+    PNConfiguration *configuration = client.configuration;
+    if (configuration.presenceHeartbeatInterval > 0) {
+        
+        NSString *group = [self groupForConfiguration:configuration];
+        NSTimeInterval interval = configuration.presenceHeartbeatInterval;
+        dispatch_barrier_async(self.resourceAccessQueue, ^{
+            
+            NSDate *refreshDate = [NSDate date];
+            [self.clients setObject:[@{@"group":group, @"interval":@(interval),
+                                       @"refreshDate":refreshDate} mutableCopy]
+                             forKey:client];
+            
+            // Align client with heartbeat schedule of the group (if group already scheduled).
+            NSDate *fireDate = [refreshDate dateByAddingTimeInterval:interval];
+            NSDate *groupFireDate = self.groupFireDates[group];
+            if (!groupFireDate || [fireDate compare:groupFireDate] == NSOrderedAscending) {
+                
+                self.groupFireDates[group] = fireDate;
+            }
+            [self updateTimer];
+        });
+    }
+    else {
+        
+        [self unscheduleHeartbeatForClient:client];
+    }
+}
+
+- (void)unscheduleHeartbeatForClient:(PubNub *)client {
+    
+    dispatch_barrier_async(self.resourceAccessQueue, ^{
+        
+        if ([self.clients objectForKey:client]) {
+            
+            [self.clients removeObjectForKey:client];
+            [self updateTimer];
+        }
+    });
+}
+
+
+#pragma mark - Information
+
+- (NSDictionary *)scheduleInformationForClient:(PubNub *)client {
+    
+    __block NSDictionary *information = nil;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        NSDictionary *clientInformation = [self.clients objectForKey:client];
+        if (clientInformation) {
+            
+            NSString *group = clientInformation[@"group"];
+            NSDate *refreshDate = clientInformation[@"refreshDate"];
+            NSTimeInterval tillHeartbeat = [self.groupFireDates[group] timeIntervalSinceNow];
+            information = @{@"scheduled": @YES, @"interval": clientInformation[@"interval"],
+                            @"sinceRefresh": @(-[refreshDate timeIntervalSinceNow]),
+                            @"tillHeartbeat": @(MAX(tillHeartbeat, 0.0f)),
+                            @"groupSize": @([[self clientsByGroup][group] count])};
+        }
+    });
+    
+    return (information?: @{@"scheduled": @NO});
+}
+
+
+#pragma mark - Misc
+
+- (NSString *)groupForConfiguration:(PNConfiguration *)configuration {
+    
+    return [NSString stringWithFormat:@"%@|%@|%@|%@", configuration.origin,
+            configuration.subscribeKey, (configuration.authKey?: @""), configuration.uuid];
+}
+
+- (NSDictionary *)clientsByGroup {
+    
+    NSMutableDictionary *clientsByGroup = [NSMutableDictionary new];
+    for (PubNub *client in self.clients) {
+        
+        NSString *group = [self.clients objectForKey:client][@"group"];
+        if (!clientsByGroup[group]) {
+            
+            clientsByGroup[group] = [NSMutableArray new];
+        }
+        [clientsByGroup[group] addObject:client];
+    }
+    
+    return [clientsByGroup copy];
+}
+
+- (NSDictionary *)heartbeatPayloadForClients:(NSArray *)clients {
+    
+    NSMutableOrderedSet *channels = [NSMutableOrderedSet new];
+    NSMutableOrderedSet *groups = [NSMutableOrderedSet new];
+    NSMutableDictionary *state = [NSMutableDictionary new];
+    NSMutableArray *idleClients = [NSMutableArray new];
+    NSInteger heartbeatValue = 0;
+    PubNub *heartbeatClient = nil;
+    for (PubNub *client in clients) {
+        
+        NSArray *clientChannels = [client.subscriberManager channels];
+        NSArray *clientGroups = [PNChannel objectsWithOutPresenceFrom:
+                                 [client.subscriberManager channelGroups]];
+        if ([clientChannels count] || [clientGroups count]) {
+            
+            [channels addObjectsFromArray:clientChannels];
+            [groups addObjectsFromArray:clientGroups];
+            [state addEntriesFromDictionary:([client.clientStateManager state]?: @{})];
+            heartbeatValue = MAX(heartbeatValue, client.configuration.presenceHeartbeatValue);
+            heartbeatClient = (heartbeatClient?: client);
+        }
+        else {
+            
+            // There is no objects for which presence should be supported.
+            [idleClients addObject:client];
+        }
+    }
+    NSMutableDictionary *payload = [@{@"channels": [channels array], @"groups": [groups array],
+                                      @"state": [state copy], @"heartbeat": @(heartbeatValue),
+                                      @"idleClients": [idleClients copy]} mutableCopy];
+    if (heartbeatClient) {
+        
+        payload[@"client"] = heartbeatClient;
+    }
+    
+    return [payload copy];
+}
+
+- (void)sendHeartbeatForClients:(NSArray *)clients {
+    
+    NSDictionary *payload = [self heartbeatPayloadForClients:clients];
+    NSInteger heartbeatValue = [payload[@"heartbeat"] integerValue];
+    if (payload[@"client"] && heartbeatValue > 0) {
+        
+        [payload[@"client"] heartbeatForChannels:payload[@"channels"] groups:payload[@"groups"]
+                                       withState:payload[@"state"] heartbeatValue:heartbeatValue
+                                      completion:NULL];
+    }
+    
+    NSArray *idleClients = payload[@"idleClients"];
+    if ([idleClients count]) {
+        
+        dispatch_barrier_async(self.resourceAccessQueue, ^{
+            
+            for (PubNub *client in idleClients) {
+                
+                [self.clients removeObjectForKey:client];
+            }
+            [self updateTimer];
+        });
+    }
+}
+
+- (void)updateTimer {
+    
+    // Clean up groups which doesn't have any clients anymore and find closest fire date.
+    NSDictionary *clientsByGroup = [self clientsByGroup];
+    NSMutableArray *groupsForRemoval = [NSMutableArray new];
+    __block NSDate *closestFireDate = nil;
+    [self.groupFireDates enumerateKeysAndObjectsUsingBlock:^(NSString *group, NSDate *fireDate,
+                                                             __unused BOOL *groupsEnumeratorStop) {
+        
+        if (!clientsByGroup[group]) {
+            
+            [groupsForRemoval addObject:group];
+        }
+        else if (!closestFireDate || [fireDate compare:closestFireDate] == NSOrderedAscending) {
+            
+            closestFireDate = fireDate;
+        }
+    }];
+    [self.groupFireDates removeObjectsForKeys:groupsForRemoval];
+    
+    // Re-arm one-shot timer for closest group fire date.
+    [[PNTimingWheel sharedWheel] cancelTimer:self.heartbeatTimer];
+    self.heartbeatTimer = nil;
+    if (closestFireDate) {
+        
+        // Silence static analyzer warnings.
+        // Code is aware about this case and at the end will simply call on 'nil' object method.
+        // In most cases if referenced object become 'nil' it mean what there is no more need in
+        // it and probably whole client instance has been deallocated.
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+        __weak __typeof(self) weakSelf = self;
+        NSTimeInterval delay = MAX([closestFireDate timeIntervalSinceNow], 0.0f);
+        PNTimingWheel *wheel = [PNTimingWheel sharedWheel];
+        self.heartbeatTimer = [wheel scheduleTimerWithDelay:delay interval:0.0f block:^{
+            
+            [weakSelf handleHeartbeatTimer];
+        }];
+        #pragma clang diagnostic pop
+    }
+}
+
+
+#pragma mark - Handlers
+
+- (void)handleHeartbeatTimer {
+    
+    // Only schedule modified inside of barrier. Heartbeat information gathered from clients'
+    // managers (which use own queues) after barrier completion.
+    NSMutableArray *heartbeatGroups = [NSMutableArray new];
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        NSDate *date = [NSDate date];
+        NSDictionary *clientsByGroup = [self clientsByGroup];
+        [clientsByGroup enumerateKeysAndObjectsUsingBlock:^(NSString *group, NSArray *clients,
+                                                            __unused BOOL *groupsEnumeratorStop) {
+            
+            NSDate *groupFireDate = self.groupFireDates[group];
+            if (groupFireDate && [groupFireDate timeIntervalSinceDate:date] <= 0.0f) {
+                
+                NSMutableArray *heartbeatClients = [NSMutableArray new];
+                NSDate *nextFireDate = nil;
+                for (PubNub *client in clients) {
+                    
+                    NSMutableDictionary *entry = [self.clients objectForKey:client];
+                    NSTimeInterval interval = [entry[@"interval"] doubleValue];
+                    NSDate *dueDate = [entry[@"refreshDate"] dateByAddingTimeInterval:interval];
+                    
+                    // Skip clients which presence has been refreshed by subscribe request less than
+                    // heartbeat interval ago (with one second tolerance, same as timer leeway).
+                    if ([dueDate timeIntervalSinceDate:date] <= 1.0f) {
+                        
+                        [heartbeatClients addObject:client];
+                        entry[@"refreshDate"] = date;
+                        dueDate = [date dateByAddingTimeInterval:interval];
+                    }
+                    if (!nextFireDate || [dueDate compare:nextFireDate] == NSOrderedAscending) {
+                        
+                        nextFireDate = dueDate;
+                    }
+                }
+                self.groupFireDates[group] = nextFireDate;
+                
+                if ([heartbeatClients count]) {
+                    
+                    [heartbeatGroups addObject:heartbeatClients];
+                }
+            }
+        }];
+        [self updateTimer];
+    });
+    
+    for (NSArray *clients in heartbeatGroups) {
+        
+        [self sendHeartbeatForClients:clients];
+    }
+}
+
+#pragma mark -
+
+
+@end
@@ -4,7 +4,7 @@
 
 #pragma mark Class forward
 
-@class PNPresenceEventResult, PNMessageResult, PNErrorStatus, PubNub;
+@class PNPresenceEventResult, PNPresenceDeltaResult, PNMessageResult, PNErrorStatus, PubNub;
 
 
 /**
@@ -82,6 +82,45 @@
  */
 - (void)removeAllListeners;
 
+///------------------------------------------------
+/// @name Listeners information
+///------------------------------------------------
+
+/**
+ @brief   Check whether there is listeners which would like to receive separate presence events.
+ @warning Method should be called within \b -notifyWithBlock: block to shift execution to private 
+          protected queue.
+ 
+ @return \c YES in case if at least one listener registered for \c -client:didReceivePresenceEvent:
+         callback.
+ 
+ @since 4.1.0
+ */
+- (BOOL)hasPresenceEventListeners;
+
+/**
+ @brief   Check whether there is listeners which would like to receive aggregated presence events.
+ @warning Method should be called within \b -notifyWithBlock: block to shift execution to private 
+          protected queue.
+ 
+ @return \c YES in case if at least one listener registered for \c -client:didReceivePresenceDelta:
+         callback.
+ 
+ @since 4.1.0
+ */
+- (BOOL)hasPresenceDeltaListeners;
+
+/**
+ @brief      Retrieve number of registered listeners for each kind of events.
+ @discussion Counts read on private protected queue after all pending listeners list modifications.
+ 
+ @return Dictionary with \c message, \c presence, \c presenceDelta and \c status keys.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)introspectionSnapshot;
+
+
 ///------------------------------------------------
 /// @name Listeners notification
 ///------------------------------------------------
@@ -120,6 +159,18 @@
  */
 - (void)notifyPresenceEvent:(PNPresenceEventResult *)event;
 
+/**
+ @brief   Notify all aggregated presence listeners about presence events collapsed for channel.
+ @warning Method should be called within \b -notifyWithBlock: block to shift execution to private 
+          protected queue.
+ 
+ @param delta Reference on object which provide information about presence events which has been
+              received during aggregation window.
+ 
+ @since 4.1.0
+ */
+- (void)notifyPresenceDelta:(PNPresenceDeltaResult *)delta;
+
 /**
  @brief   Notify all state change listeners about changes in subscriber state.
  @warning Method should be called within \b -notifyWithBlock: block to shift execution to private 
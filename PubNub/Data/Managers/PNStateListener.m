@@ -5,8 +5,10 @@
  */
 #import "PNStateListener.h"
 #import "PNObjectEventListener.h"
+#import "PNRequestTrace+Private.h"
 #import "PubNub+CorePrivate.h"
 #import "PNHelpers.h"
+#import "PNTrace.h"
 
 
 #pragma mark Protected interface declaration
@@ -43,6 +45,18 @@
  */
 @property (nonatomic, strong) NSHashTable *presenceEventListeners;
 
+/**
+ @brief      Stores list of listeners which would like to be notified with presence events collapsed
+             during aggregation window.
+ @discussion Listeners from this list also added to \c presenceEventListeners if they implement
+             \c -client:didReceivePresenceEvent: callback.
+ 
+ @return Hash table with list of aggregated presence event listeners.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSHashTable *presenceDeltaListeners;
+
 
 /**
  @brief  Stores list of listeners which would like to be notified when on subscription state 
@@ -99,6 +113,7 @@
         _client = client;
         _messageListeners = [NSHashTable weakObjectsHashTable];
         _presenceEventListeners = [NSHashTable weakObjectsHashTable];
+        _presenceDeltaListeners = [NSHashTable weakObjectsHashTable];
         _stateListeners = [NSHashTable weakObjectsHashTable];
         _resourceAccessQueue = dispatch_queue_create("com.pubnub.listener", DISPATCH_QUEUE_SERIAL);
     }
@@ -110,6 +125,7 @@
     
     _messageListeners = [listener.messageListeners mutableCopy];
     _presenceEventListeners = [listener.presenceEventListeners mutableCopy];
+    _presenceDeltaListeners = [listener.presenceDeltaListeners mutableCopy];
     _stateListeners = [listener.stateListeners mutableCopy];
 }
 
@@ -124,6 +140,12 @@
             
             [self.messageListeners addObject:listener];
         }
+        // Listener receive aggregated presence events in addition to separate events (if it
+        // implement both callbacks).
+        if ([listener respondsToSelector:@selector(client:didReceivePresenceDelta:)]) {
+            
+            [self.presenceDeltaListeners addObject:listener];
+        }
         if ([listener respondsToSelector:@selector(client:didReceivePresenceEvent:)]) {
             
             [self.presenceEventListeners addObject:listener];
@@ -142,6 +164,7 @@
         
         [self.messageListeners removeObject:listener];
         [self.presenceEventListeners removeObject:listener];
+        [self.presenceDeltaListeners removeObject:listener];
         [self.stateListeners removeObject:listener];
     });
 }
@@ -152,11 +175,39 @@
             
         [self.messageListeners removeAllObjects];
         [self.presenceEventListeners removeAllObjects];
+        [self.presenceDeltaListeners removeAllObjects];
         [self.stateListeners removeAllObjects];
     });
 }
 
 
+#pragma mark - Listeners information
+
+- (BOOL)hasPresenceEventListeners {
+    
+    return ([self.presenceEventListeners count] > 0);
+}
+
+- (BOOL)hasPresenceDeltaListeners {
+    
+    return ([self.presenceDeltaListeners count] > 0);
+}
+
+- (NSDictionary *)introspectionSnapshot {
+    
+    __block NSDictionary *snapshot = nil;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        snapshot = @{@"message": @([[self.messageListeners allObjects] count]),
+                     @"presence": @([[self.presenceEventListeners allObjects] count]),
+                     @"presenceDelta": @([[self.presenceDeltaListeners allObjects] count]),
+                     @"status": @([[self.stateListeners allObjects] count])};
+    });
+    
+    return snapshot;
+}
+
+
 #pragma mark - Listeners notification
 
 - (void)notifyWithBlock:(dispatch_block_t)block {
@@ -176,10 +227,13 @@
     #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
     pn_dispatch_async(self.client.callbackQueue, ^{
         
+        PNTrace2(listener__start, "message", (int)[listeners count]);
+        [message.trace markStage:PNCallbackInvokedStage];
         for (id <PNObjectEventListener> listener in listeners) {
             
             [listener client:self.client didReceiveMessage:message];
         }
+        PNTrace2(listener__end, "message", (int)[listeners count]);
     });
     #pragma clang diagnostic pop
 }
@@ -196,10 +250,36 @@
     #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
     pn_dispatch_async(self.client.callbackQueue, ^{
         
+        PNTrace2(listener__start, "presence", (int)[listeners count]);
+        [event.trace markStage:PNCallbackInvokedStage];
         for (id <PNObjectEventListener> listener in listeners) {
             
             [listener client:self.client didReceivePresenceEvent:event];
         }
+        PNTrace2(listener__end, "presence", (int)[listeners count]);
+    });
+    #pragma clang diagnostic pop
+}
+
+- (void)notifyPresenceDelta:(PNPresenceDeltaResult *)delta {
+    
+    NSArray *listeners = [self.presenceDeltaListeners allObjects];
+    // Silence static analyzer warnings.
+    // Code is aware about this case and at the end will simply call on 'nil' object method.
+    // In most cases if referenced object become 'nil' it mean what there is no more need in
+    // it and probably whole client instance has been deallocated.
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+    #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
+    pn_dispatch_async(self.client.callbackQueue, ^{
+        
+        PNTrace2(listener__start, "presence-delta", (int)[listeners count]);
+        [delta.trace markStage:PNCallbackInvokedStage];
+        for (id <PNObjectEventListener> listener in listeners) {
+            
+            [listener client:self.client didReceivePresenceDelta:delta];
+        }
+        PNTrace2(listener__end, "presence-delta", (int)[listeners count]);
     });
     #pragma clang diagnostic pop
 }
@@ -216,10 +296,13 @@
     #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
     pn_dispatch_async(self.client.callbackQueue, ^{
         
+        PNTrace2(listener__start, "status", (int)[listeners count]);
+        [status.trace markStage:PNCallbackInvokedStage];
         for (id <PNObjectEventListener> listener in listeners) {
             
             [listener client:self.client didReceiveStatus:status];
         }
+        PNTrace2(listener__end, "status", (int)[listeners count]);
     });
     #pragma clang diagnostic pop
 }
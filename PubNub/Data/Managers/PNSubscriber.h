@@ -71,6 +71,18 @@ typedef void(^PNSubscriberCompletionBlock)(PNSubscribeStatus *status);
  */
 - (NSArray *)presenceChannels;
 
+/**
+ @brief      Retrieve consistent snapshot of subscriber state for introspection.
+ @discussion Snapshot taken on resources access queue, so it doesn't stop subscription loop and
+             reflect state between two modifications.
+ 
+ @return Dictionary with \c state, \c channels, \c groups, \c presenceChannels,
+         \c timetoken, \c lastTimetoken and \c retryScheduled keys.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)introspectionSnapshot;
+
 
 ///------------------------------------------------
 /// @name Initialization and Configuration
@@ -7,11 +7,16 @@
 #import "PNServiceData+Private.h"
 #import "PNErrorStatus+Private.h"
 #import "PNSubscriberResults.h"
+#import "PNRequestTrace+Private.h"
 #import "PNRequestParameters.h"
+#import "PNStructuredLogger.h"
 #import "PubNub+CorePrivate.h"
 #import "PNStatus+Private.h"
 #import "PNResult+Private.h"
 #import "PNConfiguration.h"
+#import "PNOriginSelector.h"
+#import "PNTimingWheel.h"
+#import "PNTrace.h"
 #import <objc/runtime.h>
 #import "PNHelpers.h"
 
@@ -78,6 +83,19 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
     PNAccessRightsErrorSubscriberState
 };
 
+/**
+ @brief  Stores names which is used for subscriber states in introspection snapshot.
+ 
+ @since 4.1.0
+ */
+static NSString * const PNSubscriberStateNames[5] = {
+    [PNInitializedSubscriberState] = @"initialized",
+    [PNDisconnectedSubscriberState] = @"disconnected",
+    [PNDisconnectedUnexpectedlySubscriberState] = @"disconnected-unexpectedly",
+    [PNConnectedSubscriberState] = @"connected",
+    [PNAccessRightsErrorSubscriberState] = @"access-denied"
+};
+
 
 #pragma mark - Protected interface declaration
 
@@ -158,13 +176,34 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
 @property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
 
 /**
- @brief      Stores reference on GCD timer used to re-issue subscribe request.
+ @brief      Stores reference on timer used to re-issue subscribe request.
  @discussion Timer activated in cases if previous subscribe loop failed with category type which
              can be temporary.
  
  @since 4.0
  */
-@property (nonatomic, strong) dispatch_source_t retryTimer;
+@property (nonatomic, strong) PNTimingWheelTimer *retryTimer;
+
+/**
+ @brief      Stores reference on presence events which has been collapsed during current aggregation
+             window.
+ @discussion Channel names used as keys and mutable dictionaries with joined / left UUIDs sets, state
+             and occupancy information as values.
+ @warning    Should be accessed only from within state listener's \b -notifyWithBlock: block.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *aggregatedPresenceEvents;
+
+/**
+ @brief      Stores reference on timer used to deliver aggregated presence events.
+ @discussion Timer created with first presence event from new aggregation window and cancelled as
+             soon as collapsed events will be delivered to listeners.
+ @warning    Should be accessed only from within state listener's \b -notifyWithBlock: block.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNTimingWheelTimer *presenceAggregationTimer;
 
 
 #pragma mark - Initialization and Configuration
@@ -295,6 +334,54 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
 - (void)handleNewPresenceEvent:(PNPresenceEventResult *)data;
 
 
+#pragma mark - Presence events aggregation
+
+/**
+ @brief   Collapse presence event with events which has been received for same channel during
+          current aggregation window.
+ @warning Method should be called within state listener's \b -notifyWithBlock: block.
+ 
+ @param event  Reference on parsed presence event (with de-presenced channel names).
+ @param status Reference on status object which has been received from \b PubNub network along
+               with presence event.
+ 
+ @since 4.1.0
+ */
+- (void)aggregatePresenceEvent:(NSDictionary *)event fromStatus:(PNSubscribeStatus *)status;
+
+/**
+ @brief  Apply single UUID presence change to channel's aggregated delta (join and leave / timeout
+         for same UUID cancel each other).
+ 
+ @param presenceEvent Name of presence event which should be applied (\c join, \c leave or
+                      \c timeout).
+ @param uuid          Unique identifier of user which changed presence.
+ @param delta         Reference on mutable channel's delta which should be updated.
+ 
+ @since 4.1.0
+ */
+- (void)applyPresenceEvent:(NSString *)presenceEvent forUUID:(NSString *)uuid
+                   toDelta:(NSMutableDictionary *)delta;
+
+/**
+ @brief   Launch timer which will deliver aggregated presence events at the end of aggregation
+          window.
+ @warning Method should be called within state listener's \b -notifyWithBlock: block.
+ 
+ @since 4.1.0
+ */
+- (void)startPresenceAggregationTimer;
+
+/**
+ @brief   Deliver presence events collapsed during aggregation window to the listeners and start new
+          window.
+ @warning Method should be called within state listener's \b -notifyWithBlock: block.
+ 
+ @since 4.1.0
+ */
+- (void)flushAggregatedPresenceEvents;
+
+
 #pragma mark - Misc
 
 /**
@@ -361,9 +448,9 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
 
 #pragma mark - Information
 
-- (dispatch_source_t)retryTimer {
+- (PNTimingWheelTimer *)retryTimer {
     
-    __block dispatch_source_t retryTimer = nil;
+    __block PNTimingWheelTimer *retryTimer = nil;
     dispatch_sync(self.resourceAccessQueue, ^{
         
         retryTimer = self->_retryTimer;
@@ -372,7 +459,7 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
     return retryTimer;
 }
 
-- (void)setRetryTimer:(dispatch_source_t)retryTimer {
+- (void)setRetryTimer:(PNTimingWheelTimer *)retryTimer {
     
     dispatch_barrier_async(self.resourceAccessQueue, ^{
         
@@ -609,6 +696,23 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
     });
 }
 
+- (NSDictionary *)introspectionSnapshot {
+    
+    __block NSDictionary *snapshot = nil;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        snapshot = @{@"state": PNSubscriberStateNames[self->_currentState],
+                     @"channels": [self.channelsSet allObjects],
+                     @"groups": [self.channelGroupsSet allObjects],
+                     @"presenceChannels": [self.presenceChannelsSet allObjects],
+                     @"timetoken": (self->_currentTimeToken?: @0),
+                     @"lastTimetoken": (self->_lastTimeToken?: @0),
+                     @"retryScheduled": @(self->_retryTimer != nil)};
+    });
+    
+    return snapshot;
+}
+
 
 #pragma mark - Initialization and Configuration
 
@@ -626,6 +730,7 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
         _channelsSet = [NSMutableSet new];
         _channelGroupsSet = [NSMutableSet new];
         _presenceChannelsSet = [NSMutableSet new];
+        _aggregatedPresenceEvents = [NSMutableDictionary new];
         _resourceAccessQueue = dispatch_queue_create("com.pubnub.subscriber",
                                                      DISPATCH_QUEUE_CONCURRENT);
     }
@@ -677,6 +782,8 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
         }
         
         PNRequestParameters *parameters = [self subscribeRequestParametersWithState:state];
+        PNTrace3(subscribe__start, (int)initialSubscribe,
+                 [self.currentTimeToken unsignedLongLongValue], (int)[[self allObjects] count]);
         __weak __typeof(self) weakSelf = self;
         [self.client processOperation:PNSubscribeOperation withParameters:parameters
                       completionBlock:^(PNStatus *status){
@@ -815,9 +922,9 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
     [self stopRetryTimer];
     
     __weak __typeof(self) weakSelf = self;
-    dispatch_queue_t timerQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
-    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, timerQueue);
-    dispatch_source_set_event_handler(timer, ^{
+    NSTimeInterval interval = kPubNubSubscriptionRetryInterval;
+    self.retryTimer = [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:interval interval:interval
+                                                                    block:^{
         
         // Silence static analyzer warnings.
         // Code is aware about this case and at the end will simply call on 'nil' object method.
@@ -827,20 +934,12 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
         #pragma clang diagnostic ignored "-Wreceiver-is-weak"
         [weakSelf continueSubscriptionCycleIfRequiredWithCompletion:nil];
         #pragma clang diagnostic pop
-    });
-    dispatch_time_t start = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kPubNubSubscriptionRetryInterval * NSEC_PER_SEC));
-    dispatch_source_set_timer(timer, start, (uint64_t)(kPubNubSubscriptionRetryInterval * NSEC_PER_SEC), NSEC_PER_SEC);
-    self.retryTimer = timer;
-    dispatch_resume(timer);
+    }];
 }
 
 - (void)stopRetryTimer {
     
-    dispatch_source_t timer = [self retryTimer];
-    if (timer != NULL && dispatch_source_testcancel(timer) == 0) {
-        
-        dispatch_source_cancel(timer);
-    }
+    [[PNTimingWheel sharedWheel] cancelTimer:[self retryTimer]];
     self.retryTimer = nil;
 }
 
@@ -849,6 +948,8 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
 
 - (void)handleSubscriptionStatus:(PNSubscribeStatus *)status {
 
+    PNTrace3(subscribe__end, (int)status.category, (int)status.isError,
+             (int)[(NSArray *)(status.serviceData)[@"events"] count]);
     [self stopRetryTimer];
     if (!status.isError && status.category != PNCancelledCategory) {
         
@@ -902,6 +1003,7 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
     #pragma clang diagnostic push
     #pragma clang diagnostic ignored "-Wreceiver-is-weak"
     #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
+    BOOL failedOver = NO;
     // Looks like subscription request has been cancelled.
     // Cancelling can happen because of: user changed subscriber sensitive configuration or
     // another subscribe/unsubscribe request has been issued.
@@ -910,6 +1012,18 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
         // Stop heartbeat for now and wait further actions.
         [self.client.heartbeatManager stopHeartbeatIfPossible];
     }
+    // Looks like origin which has been used for subscription stopped responding. If there is
+    // other healthy origins, subscription request will be re-issued (with same time token) right
+    // away to another origin.
+    else if (status.category != PNAccessDeniedCategory &&
+             status.category != PNMalformedResponseCategory &&
+             [self.client.originSelector canFailOver]) {
+        
+        DDLogAPICall([[self class] ddLogLevel], @"<PubNub> Subscription failed. Fail over to "
+                     "another origin.");
+        failedOver = YES;
+        [self continueSubscriptionCycleIfRequiredWithCompletion:nil];
+    }
     // Looks like processing failed because of another error.
     // If there is another subscription/unsubscription operations is waiting client shouldn't
     // handle this status yet.
@@ -980,7 +1094,11 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
             [self updateStateTo:PNDisconnectedUnexpectedlySubscriberState withStatus:status];
         }
     }
-    [self.client callBlock:nil status:YES withResult:nil andStatus:(PNStatus *)status];
+    
+    if (!failedOver) {
+        
+        [self.client callBlock:nil status:YES withResult:nil andStatus:(PNStatus *)status];
+    }
     #pragma clang diagnostic pop
 }
 
@@ -1037,6 +1155,8 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
             self.lastTimeToken = currentTimeToken;
         }
         self.currentTimeToken = timeToken;
+        PNTrace2(timetoken__advance, [currentTimeToken unsignedLongLongValue],
+                 [timeToken unsignedLongLongValue]);
     }
 }
 
@@ -1051,8 +1171,14 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
         // it and probably whole client instance has been deallocated.
         #pragma clang diagnostic push
         #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+        [status.trace markStage:PNListenerEnqueuedStage];
         [self.client.listenersManager notifyWithBlock:^{
             
+            // Separate presence event objects required only by listeners which doesn't use
+            // aggregated presence events delivery.
+            BOOL shouldAggregatePresence = [self.client.listenersManager hasPresenceDeltaListeners];
+            BOOL shouldNotifyPresence = [self.client.listenersManager hasPresenceEventListeners];
+            
             // Iterate through array with notifications and report back using callback blocks to the
             // user.
             for (NSMutableDictionary *event in events) {
@@ -1076,6 +1202,18 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
                         
                         event[@"actualChannel"] = [PNChannel channelForPresence:event[@"actualChannel"]];
                     }
+                    if (shouldAggregatePresence) {
+                        
+                        [self aggregatePresenceEvent:event fromStatus:status];
+                    }
+                    
+                    // State change events always should be processed to keep client state cache
+                    // up-to-date.
+                    if (!shouldNotifyPresence &&
+                        ![event[@"presenceEvent"] isEqualToString:@"state-change"]) {
+                        
+                        continue;
+                    }
                 }
                 
                 id eventResultObject = [status copyWithMutatedData:event];
@@ -1090,6 +1228,12 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
                     [self handleNewMessage:(PNMessageResult *)eventResultObject];
                 }
             }
+            
+            // Without aggregation window presence events collapsed only within single response.
+            if (self.client.configuration.presenceEventsAggregationWindow <= 0.0f) {
+                
+                [self flushAggregatedPresenceEvents];
+            }
         }];
         #pragma clang diagnostic pop
     }
@@ -1101,7 +1245,7 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
     PNErrorStatus *status = nil;
     if (data) {
         
-        DDLogResult([[self class] ddLogLevel], @"<PubNub> %@", [(PNResult *)data stringifiedRepresentation]);
+        DDLogResultObject([[self class] ddLogLevel], data);
         if ([(data.serviceData)[@"decryptError"] boolValue]) {
             
             status = [PNErrorStatus statusForOperation:PNSubscribeOperation
@@ -1157,6 +1301,168 @@ typedef NS_OPTIONS(NSUInteger, PNSubscriberState) {
 }
 
 
+#pragma mark - Presence events aggregation
+
+- (void)aggregatePresenceEvent:(NSDictionary *)event fromStatus:(PNSubscribeStatus *)status {
+    
+    NSString *channel = (event[@"actualChannel"]?: event[@"subscribedChannel"]);
+    NSDictionary *presence = event[@"presence"];
+    NSString *uuid = presence[@"uuid"];
+    if (!channel) {
+        
+        return;
+    }
+    
+    NSMutableDictionary *delta = self.aggregatedPresenceEvents[channel];
+    if (!delta) {
+        
+        delta = [@{@"join": [NSMutableSet new], @"leave": [NSMutableSet new],
+                   @"state": [NSMutableDictionary new], @"eventsCount": @0} mutableCopy];
+        self.aggregatedPresenceEvents[channel] = delta;
+    }
+    
+    NSString *presenceEvent = event[@"presenceEvent"];
+    if ([presenceEvent isEqualToString:@"interval"]) {
+        
+        // Interval event replace separate events when channel occupancy exceed announce max.
+        for (NSString *field in @[@"join", @"leave", @"timeout"]) {
+            
+            for (NSString *intervalUUID in presence[field]) {
+                
+                [self applyPresenceEvent:field forUUID:intervalUUID toDelta:delta];
+            }
+        }
+    }
+    else if (uuid) {
+        
+        [self applyPresenceEvent:presenceEvent forUUID:uuid toDelta:delta];
+        if (presence[@"state"]) {
+            
+            delta[@"state"][uuid] = presence[@"state"];
+        }
+    }
+    if (presence[@"occupancy"]) {
+        
+        delta[@"occupancy"] = presence[@"occupancy"];
+    }
+    if (event[@"subscribedChannel"]) {
+        
+        delta[@"subscribedChannel"] = event[@"subscribedChannel"];
+    }
+    if (event[@"actualChannel"]) {
+        
+        delta[@"actualChannel"] = event[@"actualChannel"];
+    }
+    delta[@"timetoken"] = (presence[@"timetoken"]?: event[@"timetoken"]);
+    delta[@"eventsCount"] = @([delta[@"eventsCount"] unsignedIntegerValue] + 1);
+    delta[@"status"] = status;
+    
+    // Silence static analyzer warnings.
+    // Code is aware about this case and at the end will simply call on 'nil' object method.
+    // In most cases if referenced object become 'nil' it mean what there is no more need in
+    // it and probably whole client instance has been deallocated.
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+    if (self.client.configuration.presenceEventsAggregationWindow > 0.0f &&
+        !self.presenceAggregationTimer) {
+        
+        [self startPresenceAggregationTimer];
+    }
+    #pragma clang diagnostic pop
+}
+
+- (void)applyPresenceEvent:(NSString *)presenceEvent forUUID:(NSString *)uuid
+                   toDelta:(NSMutableDictionary *)delta {
+    
+    // Collapse join / leave events to net change. UUID which left and joined back (or joined and
+    // left) during same window doesn't change channel participants list.
+    NSMutableSet *joined = delta[@"join"];
+    NSMutableSet *left = delta[@"leave"];
+    if ([presenceEvent isEqualToString:@"join"]) {
+        
+        if ([left containsObject:uuid]) {
+            
+            [left removeObject:uuid];
+        }
+        else {
+            
+            [joined addObject:uuid];
+        }
+    }
+    else if ([presenceEvent isEqualToString:@"leave"] ||
+             [presenceEvent isEqualToString:@"timeout"]) {
+        
+        if ([joined containsObject:uuid]) {
+            
+            [joined removeObject:uuid];
+        }
+        else {
+            
+            [left addObject:uuid];
+        }
+        [delta[@"state"] removeObjectForKey:uuid];
+    }
+}
+
+- (void)startPresenceAggregationTimer {
+    
+    __weak __typeof(self) weakSelf = self;
+    NSTimeInterval window = self.client.configuration.presenceEventsAggregationWindow;
+    self.presenceAggregationTimer = [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:window
+                                                                               interval:0.0f
+                                                                                  block:^{
+        
+        // Silence static analyzer warnings.
+        // Code is aware about this case and at the end will simply call on 'nil' object method.
+        // In most cases if referenced object become 'nil' it mean what there is no more need in
+        // it and probably whole client instance has been deallocated.
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+        #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
+        [weakSelf.client.listenersManager notifyWithBlock:^{
+            
+            [weakSelf flushAggregatedPresenceEvents];
+        }];
+        #pragma clang diagnostic pop
+    }];
+}
+
+- (void)flushAggregatedPresenceEvents {
+    
+    [[PNTimingWheel sharedWheel] cancelTimer:self.presenceAggregationTimer];
+    self.presenceAggregationTimer = nil;
+    
+    if ([self.aggregatedPresenceEvents count]) {
+        
+        NSDictionary *aggregatedEvents = self.aggregatedPresenceEvents;
+        self.aggregatedPresenceEvents = [NSMutableDictionary new];
+        [aggregatedEvents enumerateKeysAndObjectsUsingBlock:^(__unused NSString *channel,
+                                                              NSDictionary *delta,
+                                                              __unused BOOL *stop) {
+            
+            NSMutableDictionary *data = [delta mutableCopy];
+            [data removeObjectForKey:@"status"];
+            data[@"join"] = [delta[@"join"] allObjects];
+            data[@"leave"] = [delta[@"leave"] allObjects];
+            data[@"state"] = [delta[@"state"] copy];
+            
+            id deltaResultObject = [delta[@"status"] copyWithMutatedData:data];
+            object_setClass(deltaResultObject, [PNPresenceDeltaResult class]);
+            DDLogResultObject([[self class] ddLogLevel], deltaResultObject);
+            
+            // Silence static analyzer warnings.
+            // Code is aware about this case and at the end will simply call on 'nil' object method.
+            // In most cases if referenced object become 'nil' it mean what there is no more need in
+            // it and probably whole client instance has been deallocated.
+            #pragma clang diagnostic push
+            #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+            [self.client.listenersManager notifyPresenceDelta:deltaResultObject];
+            #pragma clang diagnostic pop
+        }];
+    }
+}
+
+
 #pragma mark - Misc
 
 - (PNRequestParameters *)subscribeRequestParametersWithState:(NSDictionary *)state {
@@ -10,6 +10,7 @@
 #import <libkern/OSAtomic.h>
 #import "PNErrorCodes.h"
 #import "PNHelpers.h"
+#import "PNTrace.h"
 
 
 #pragma mark CocoaLumberjack logging support
@@ -275,6 +276,7 @@ static const void * kPNAESInitializationVector = "0123456789012345";
 + (NSData *)processedDataFrom:(NSData *)data withKey:(NSString *)cipherKey
                  forOperation:(CCOperation)operation andStatus:(CCCryptorStatus *)status {
     
+    PNTrace2(aes__start, (int)operation, (int64_t)[data length]);
     NSData *cryptorKeyData = [self SHA256HexFromKey:cipherKey];
     NSMutableData *processedData = nil;
     CCCryptorStatus processingStatus = kCCParamError;
@@ -325,6 +327,7 @@ static const void * kPNAESInitializationVector = "0123456789012345";
         }
     }
     CCCryptorRelease(cryptor);
+    PNTrace3(aes__end, (int)operation, (int64_t)[processedData length], (int)processingStatus);
     
     if (status) {
         
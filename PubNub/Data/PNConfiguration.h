@@ -1,4 +1,5 @@
 #import <Foundation/Foundation.h>
+#import "PNStructures.h"
 
 
 /**
@@ -28,6 +29,20 @@
  */
 @property (nonatomic, copy) NSString *origin;
 
+/**
+ @brief      Reference on ordered list of host names or IP addresses which can be used by client to
+             get access to \b PubNub services.
+ @discussion Client measure latency and errors of requests sent to each origin and route new
+             requests to the fastest healthy origin. If origin stop responding, subscribe request
+             re-issued (with same time token) to next healthy origin.
+ @note       Origin can include port (like \c localhost:8080).
+ 
+ @default    By default client use only \c origin.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSArray *origins;
+
 /**
  @brief   Reference on key which is used to push data/state to \b PubNub service.
  @note    This key can be obtained on PubNub's administration portal after free registration
@@ -111,6 +126,85 @@
  */
 @property (nonatomic, assign) NSTimeInterval nonSubscribeRequestTimeout;
 
+/**
+ @brief      Reference on number of seconds without any response from \b PubNub service after which
+             client will check whether active long-poll subscribe request stalled or not.
+ @discussion Client track completion of all requests to learn about connection state. If during
+             this time there was no traffic while client subscribed on remote data objects, single
+             probe request will be sent and in case of failure subscribe request will be
+             re-issued (with same time token) instead of waiting for \c subscribeMaximumIdleTime.
+ 
+ @default    By default client use \b 0 and stalled subscribe requests detected only by
+             \c subscribeMaximumIdleTime timeout.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval connectionIdleDeadline;
+
+/**
+ @brief      Stores whether client should open connections for 'non-subscription' API group right
+             after client instance creation or not.
+ @discussion If enabled, client send lightweight requests (in parallel with first subscribe
+             request) to establish all service connections, so first API call (like publish) won't
+             spend time on DNS, TCP and TLS set up.
+ 
+ @default    By default client use \b NO and open connections with first API calls.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign, getter = shouldWarmUpConnections) BOOL warmUpConnections;
+
+/**
+ @brief      Reference on number of seconds of 'non-subscription' API group inactivity after which
+             client will send lightweight requests to keep service connections open.
+ @note       Value should be smaller than time after which server close idle keep-alive
+             connections.
+ 
+ @default    By default client use \b 0 and don't keep idle service connections open.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval keepWarmInterval;
+
+/**
+ @brief      Reference on maximum percentage of additional requests which can be sent by client to
+             hedge slow idempotent read requests (like history, here now or state fetch).
+ @discussion If there is no response on read request during 95th percentile of recent requests
+             latency, client send duplicate request and use response from request which completed
+             first (other one is cancelled).
+ 
+ @default    By default client use \b 0 and don't send duplicate requests.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSInteger hedgeBudget;
+
+/**
+ @brief      Reference on number of consecutive failed requests (timeout, network issues or server
+             error) to same origin after which client stop sending requests of same kind to it.
+ @discussion While circuit breaker is open, requests fail right away with
+             \b PNServiceUnavailableCategory status. After \c circuitBreakerOpenInterval single
+             trial request is sent and it's result decide whether breaker should be closed or
+             remain open. Each state change reported to listeners with
+             \b PNCircuitBreakerStateChangedCategory status.
+ @note       Subscribe requests not affected by circuit breaker, because they use own retry logic.
+ 
+ @default    By default client use \b 0 and circuit breaker is disabled.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger circuitBreakerThreshold;
+
+/**
+ @brief  Reference on number of seconds during which circuit breaker stay open before trial request
+         will be allowed.
+ 
+ @default By default client use \b 10 seconds.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval circuitBreakerOpenInterval;
+
 /**
  @brief      Reference on number of seconds which is used by server to track whether client still
              subscribed on remote data objects live feed or not.
@@ -138,6 +232,23 @@
  */
 @property (nonatomic, assign) NSInteger presenceHeartbeatInterval;
 
+/**
+ @brief      Stores reference on transport which should be used by client to deliver requests.
+ @discussion \b PNLoopbackTransport allow to run client against in-process broker which implement
+             publish, subscribe, history, presence, state, channel groups and push notifications
+             API for clients with same subscribe key. It doesn't require network and can be used to
+             test and benchmark application logic built on top of client deterministically.
+ @note       Broker shared by all client instances in process, so messages published by one client
+             will be received by another if they use same subscribe key.
+ @note       \b PNReplayTransport answer requests with responses from trace which has been loaded
+             into \b PNTrafficReplayer (see \c trafficCapturePath).
+ 
+ @default    By default client use \b PNHTTPTransport and send requests to \b PubNub network.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) PNTransport transport;
+
 /**
  @brief   Stores whether client should communicate with \b PubNub services using secured
           connection or not.
@@ -187,6 +298,53 @@
  */
 @property (nonatomic, assign, getter = shouldTryCatchUpOnSubscriptionRestore) BOOL catchUpOnSubscriptionRestore;
 
+/**
+ @brief      Stores reference on number of seconds during which presence events received for same
+             channel should be collapsed into single delta event.
+ @discussion Listeners which implement \c -client:didReceivePresenceDelta: will receive one
+             \b PNPresenceDeltaResult per channel for each window with list of joined and left
+             UUIDs, latest occupancy and latest state for each UUID. Listeners which implement
+             \c -client:didReceivePresenceEvent: still receive events as they arrive.
+ @note       In case if value set to \b 0 presence events will be collapsed only within single
+             subscribe response.
+ 
+ @default    By default aggregation window set to \b 0 seconds.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval presenceEventsAggregationWindow;
+
+/**
+ @brief      Stores whether client should record processing stages for each request or not.
+ @discussion Recorded \b PNRequestTrace available through \c trace property of result and status
+             objects and describe how much time spent in network, parsing, decryption, listeners
+             and callback queues.
+ 
+ @default    By default client use \b NO and doesn't trace requests.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign, getter = shouldTraceRequests) BOOL traceRequests;
+
+/**
+ @brief      Stores path to file into which client should write every request and response which
+             has been sent over \b PNHTTPTransport.
+ @discussion Each record store operation type, request path with query, request body, response
+             status code, content type and body along with time when request has been sent and
+             how long it took to receive response. Clients which use same path share file, so
+             trace reflect traffic of whole process. Trace can be replayed with
+             \b PNTrafficReplayer.
+ @note       Cancelled requests (for example subscribe requests which has been replaced by new
+             one) not recorded.
+ @warning    Trace contain requests with keys and messages as they has been sent, so it should be
+             stored same way as other sensitive application data.
+ 
+ @default    By default client use \c nil and doesn't capture traffic.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *trafficCapturePath;
+
 /**
  @brief  Construct configuration instance using minimal required data.
  
@@ -112,10 +112,19 @@
         _uuid = [[[NSUUID UUID] UUIDString] copy];
         _subscribeMaximumIdleTime = kPNDefaultSubscribeMaximumIdleTime;
         _nonSubscribeRequestTimeout = kPNDefaultNonSubscribeRequestTimeout;
+        _connectionIdleDeadline = kPNDefaultConnectionIdleDeadline;
+        _warmUpConnections = kPNDefaultShouldWarmUpConnections;
+        _keepWarmInterval = kPNDefaultKeepWarmInterval;
+        _hedgeBudget = kPNDefaultHedgeBudget;
+        _circuitBreakerThreshold = kPNDefaultCircuitBreakerThreshold;
+        _circuitBreakerOpenInterval = kPNDefaultCircuitBreakerOpenInterval;
+        _transport = kPNDefaultTransport;
         _TLSEnabled = kPNDefaultIsTLSEnabled;
         _keepTimeTokenOnListChange = kPNDefaultShouldKeepTimeTokenOnListChange;
         _restoreSubscription = kPNDefaultShouldRestoreSubscription;
         _catchUpOnSubscriptionRestore = kPNDefaultShouldTryCatchUpOnSubscriptionRestore;
+        _presenceEventsAggregationWindow = kPNDefaultPresenceEventsAggregationWindow;
+        _traceRequests = kPNDefaultShouldTraceRequests;
     }
     
     return self;
@@ -126,6 +135,7 @@
     PNConfiguration *configuration = [[PNConfiguration allocWithZone:zone] init];
     configuration.deviceID = self.deviceID;
     configuration.origin = self.origin;
+    configuration.origins = self.origins;
     configuration.publishKey = self.publishKey;
     configuration.subscribeKey = self.subscribeKey;
     configuration.authKey = self.authKey;
@@ -133,12 +143,22 @@
     configuration.cipherKey = self.cipherKey;
     configuration.subscribeMaximumIdleTime = self.subscribeMaximumIdleTime;
     configuration.nonSubscribeRequestTimeout = self.nonSubscribeRequestTimeout;
+    configuration.connectionIdleDeadline = self.connectionIdleDeadline;
+    configuration.warmUpConnections = self.shouldWarmUpConnections;
+    configuration.keepWarmInterval = self.keepWarmInterval;
+    configuration.hedgeBudget = self.hedgeBudget;
+    configuration.circuitBreakerThreshold = self.circuitBreakerThreshold;
+    configuration.circuitBreakerOpenInterval = self.circuitBreakerOpenInterval;
     configuration.presenceHeartbeatValue = self.presenceHeartbeatValue;
     configuration.presenceHeartbeatInterval = self.presenceHeartbeatInterval;
+    configuration.transport = self.transport;
     configuration.TLSEnabled = self.isTLSEnabled;
     configuration.keepTimeTokenOnListChange = self.shouldKeepTimeTokenOnListChange;
     configuration.restoreSubscription = self.shouldRestoreSubscription;
     configuration.catchUpOnSubscriptionRestore = self.shouldTryCatchUpOnSubscriptionRestore;
+    configuration.presenceEventsAggregationWindow = self.presenceEventsAggregationWindow;
+    configuration.traceRequests = self.shouldTraceRequests;
+    configuration.trafficCapturePath = self.trafficCapturePath;
     
     return configuration;
 }
@@ -0,0 +1,99 @@
+#import "PNResult.h"
+#import "PNServiceData.h"
+
+
+/**
+ @brief  Class which allow to get access to channel presence changes processed result.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNPresenceChannelHereNowChangesData : PNServiceData
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  List of unique identifiers of subscribers which joined channel since previous snapshot.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSArray *join;
+
+/**
+ @brief  List of unique identifiers of subscribers which left channel since previous snapshot.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSArray *leave;
+
+/**
+ @brief  Subscribers state changes since previous snapshot.
+ @note   Dictionary where subscriber unique identifier is a key and new state is a value. If state
+         has been removed \c NSNull will be stored as value. Subscribers which just joined channel
+         with state also listed here.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSDictionary *stateChanges;
+
+/**
+ @brief  Active subscribers count.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSNumber *occupancy;
+
+/**
+ @brief  Identifier of snapshot which has been created from this response.
+ @note   Identifier should be passed as \c since value to next changes request to receive changes
+         relative to this response.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSNumber *snapshot;
+
+/**
+ @brief      Whether changes has been calculated against empty snapshot or not.
+ @discussion \c YES will be returned in case if \c since value doesn't match to snapshot which is
+             stored by client (or \c nil has been passed). In this case \c join will contain full
+             list of active subscribers.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign, getter = isReset) BOOL reset;
+
+#pragma mark -
+
+
+@end
+
+
+/**
+ @brief  Class which is used to provide access to request processing results.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNPresenceChannelHereNowChangesResult : PNResult
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on channel presence changes processing information.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) PNPresenceChannelHereNowChangesData *data;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,70 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNPresenceChannelHereNowChangesResult.h"
+#import "PNServiceData+Private.h"
+#import "PNResult+Private.h"
+
+
+#pragma mark Interface implementation
+
+@implementation PNPresenceChannelHereNowChangesData
+
+
+#pragma mark - Information
+
+- (NSArray *)join {
+    
+    return self.serviceData[@"join"];
+}
+
+- (NSArray *)leave {
+    
+    return self.serviceData[@"leave"];
+}
+
+- (NSDictionary *)stateChanges {
+    
+    return self.serviceData[@"stateChanges"];
+}
+
+- (NSNumber *)occupancy {
+    
+    return self.serviceData[@"occupancy"];
+}
+
+- (NSNumber *)snapshot {
+    
+    return self.serviceData[@"snapshot"];
+}
+
+- (BOOL)isReset {
+    
+    return ((NSNumber *)self.serviceData[@"reset"]).boolValue;
+}
+
+#pragma mark -
+
+
+@end
+
+
+
+#pragma mark - Interface implementation
+
+@implementation PNPresenceChannelHereNowChangesResult
+
+
+#pragma mark - Information
+
+- (PNPresenceChannelHereNowChangesData *)data {
+    
+    return [PNPresenceChannelHereNowChangesData dataWithServiceResponse:self.serviceData];
+}
+
+#pragma mark -
+
+
+@end
@@ -23,6 +23,7 @@
 @property (nonatomic, copy) NSString *authKey;
 @property (nonatomic, copy) NSString *origin;
 @property (nonatomic, copy) NSURLRequest *clientRequest;
+@property (nonatomic, strong) PNRequestTrace *trace;
 
 /**
  @brief      Stores reference on processed \c response which is ready to use by user.
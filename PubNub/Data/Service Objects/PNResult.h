@@ -2,6 +2,11 @@
 #import "PNStructures.h"
 
 
+#pragma mark Class forward
+
+@class PNRequestTrace;
+
+
 /**
  @brief      Class which is used to describe server response.
  @discussion This object contains response itself and also set of data which has been used to 
@@ -73,6 +78,14 @@
  */
 @property (nonatomic, readonly, copy) NSURLRequest *clientRequest;
 
+/**
+ @brief  Stores reference on request processing stages.
+ @note   Trace recorded only if \c traceRequests enabled in client configuration.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) PNRequestTrace *trace;
+
 #pragma mark -
 
 
@@ -25,6 +25,7 @@
 @property (nonatomic, copy) NSString *authKey;
 @property (nonatomic, copy) NSString *origin;
 @property (nonatomic, copy) NSURLRequest *clientRequest;
+@property (nonatomic, strong) PNRequestTrace *trace;
 @property (nonatomic, copy) NSDictionary *serviceData;
 
 #pragma mark -
@@ -83,6 +84,7 @@
     result.authKey = self.authKey;
     result.origin = self.origin;
     result.clientRequest = self.clientRequest;
+    result.trace = self.trace;
     result.serviceData = self.serviceData;
     
     return result;
@@ -119,7 +121,7 @@
 
 - (NSDictionary *)dictionaryRepresentation {
     
-    return @{@"Operation": PNOperationTypeStrings[[self operation]],
+    return @{@"Operation": PNOperationDescriptors[[self operation]].name,
              @"Request": @{@"Method": (self.clientRequest.HTTPMethod?: @"GET"),
                            @"URL": ([self.clientRequest.URL absoluteString]?: @"null"),
                            @"POST Body size": @([self.clientRequest.HTTPBody length]),
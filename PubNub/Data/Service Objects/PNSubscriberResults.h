@@ -100,6 +100,75 @@
 @end
 
 
+/**
+ @brief      Class which allow to get access to presence events which has been collapsed for single
+             channel during presence events aggregation window.
+ @discussion Delta represent net change: UUID which joined and left (or left and joined back) 
+             within same window won't be listed.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNPresenceDeltaData : PNSubscriberData
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  List of unique user identifiers which joined channel during aggregation window.
+ 
+ @return List of UUID strings.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSArray *join;
+
+/**
+ @brief  List of unique user identifiers which left channel (or timed out) during aggregation
+         window.
+ 
+ @return List of UUID strings.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSArray *leave;
+
+/**
+ @brief  Channel presence information.
+ 
+ @return Number of subscribers reported by most recent presence event from aggregation window.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSNumber *occupancy;
+
+/**
+ @brief  Latest client state for users which changed it during aggregation window.
+ 
+ @return Dictionary where UUIDs used as keys and state dictionaries as values.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSDictionary *state;
+
+/**
+ @brief  Number of presence events which has been collapsed into this delta.
+ 
+ @return Number with unsigned integer value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) NSNumber *eventsCount;
+
+#pragma mark -
+
+
+@end
+
+
 /**
  @brief  Class which allow to get access to message body received from remote object live feed.
  
@@ -180,4 +249,31 @@
 #pragma mark - 
 
 
+@end
+
+
+/**
+ @brief  Class which is used to provide access to aggregated presence events.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNPresenceDeltaResult : PNResult
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on aggregated presence events object from live feed.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) PNPresenceDeltaData *data;
+
+#pragma mark - 
+
+
 @end
@@ -64,6 +64,44 @@
 @end
 
 
+#pragma mark - Interface implementation
+
+@implementation PNPresenceDeltaData
+
+
+#pragma mark - Information
+
+- (NSArray *)join {
+    
+    return self.serviceData[@"join"];
+}
+
+- (NSArray *)leave {
+    
+    return self.serviceData[@"leave"];
+}
+
+- (NSNumber *)occupancy {
+    
+    return self.serviceData[@"occupancy"];
+}
+
+- (NSDictionary *)state {
+    
+    return self.serviceData[@"state"];
+}
+
+- (NSNumber *)eventsCount {
+    
+    return self.serviceData[@"eventsCount"];
+}
+
+#pragma mark -
+
+
+@end
+
+
 #pragma mark - Interface implementation
 
 @implementation PNMessageData
@@ -115,4 +153,22 @@
 #pragma mark -
 
 
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNPresenceDeltaResult
+
+
+#pragma mark - Information
+
+- (PNPresenceDeltaData *)data {
+    
+    return [PNPresenceDeltaData dataWithServiceResponse:self.serviceData];
+}
+
+#pragma mark -
+
+
 @end
@@ -15,6 +15,15 @@
 /// @name Class filtering
 ///------------------------------------------------
 
+/**
+ @brief  Registered classes.
+ 
+ @return List of PubNub SDK classes which has been loaded to the memory.
+ 
+ @since 4.0
+ */
++ (NSArray *)classes;
+
 /**
  @brief  Gather list of classes which conform to specified \c protocol.
  
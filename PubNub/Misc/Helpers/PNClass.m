@@ -7,29 +7,7 @@
 #import <objc/runtime.h>
 
 
-#pragma mark Private interface declaration
-
-@interface PNClass ()
-
-
-#pragma mark - Misc
-
-/**
- @brief  Registered classes.
- 
- @return List of PubNub SDK classes which has been loaded to the memory.
- 
- @since 4.0
- */
-+ (NSArray *)classes;
-
-#pragma mark -
-
-
-@end
-
-
-#pragma mark - Interface implementation
+#pragma mark Interface implementation
 
 @implementation PNClass
 
@@ -65,8 +43,6 @@
 }
 
 
-#pragma mark - Misc
-
 + (NSArray *)classes {
     
     NSMutableArray *classesList = [NSMutableArray new];
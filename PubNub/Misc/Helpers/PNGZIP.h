@@ -26,6 +26,22 @@
  */
 + (NSData *)GZIPDeflatedData:(NSData *)data;
 
+
+///------------------------------------------------
+/// @name Decompression
+///------------------------------------------------
+
+/**
+ @brief  Allow to uncompress passed \c data.
+ 
+ @param data Data which has been compressed with GZIP deflate algorithm.
+ 
+ @return Uncompressed \a NSData instance or \c nil in case if uncompression error occurred.
+ 
+ @since 4.1.0
+ */
++ (NSData *)GZIPInflatedData:(NSData *)data;
+
 #pragma mark -
 
 
@@ -71,6 +71,51 @@
 }
 
 
+#pragma mark - Decompression
+
++ (NSData *)GZIPInflatedData:(NSData *)data {
+    
+    NSMutableData *processedDataStorage = nil;
+    int window = 31;
+    if ([data length] > 0) {
+        
+        int status;
+        z_stream stream;
+        bzero(&stream, sizeof(stream));
+        stream.zalloc = Z_NULL;
+        stream.zfree = Z_NULL;
+        stream.opaque = Z_NULL;
+        stream.next_in = (Bytef *)[data bytes];
+        stream.avail_in = (uint)[data length];
+        stream.total_out = 0;
+        status = inflateInit2(&stream, window);
+        
+        if (status == Z_OK) {
+            
+            processedDataStorage = [[NSMutableData alloc] initWithLength:([data length] * 2)];
+            while (status == Z_OK) {
+                
+                // Make sure we have enough room for next chunk.
+                if (stream.total_out >= [processedDataStorage length]) {
+                    
+                    [processedDataStorage increaseLengthBy:([data length] / 2 + 1024)];
+                }
+                stream.next_out = (Bytef*)[processedDataStorage mutableBytes] + stream.total_out;
+                stream.avail_out = (uInt)([processedDataStorage length] - stream.total_out);
+                
+                // Inflate another chunk
+                status = inflate(&stream, Z_SYNC_FLUSH);
+            }
+            
+            [processedDataStorage setLength:(status == Z_STREAM_END ? stream.total_out : 0)];
+            inflateEnd(&stream);
+        }
+    }
+    
+    return ([processedDataStorage length] ? processedDataStorage : nil);
+}
+
+
 #pragma mark -
 
 
@@ -0,0 +1,64 @@
+#import <CocoaLumberjack/CocoaLumberjack.h>
+
+
+/**
+ @brief      Logger which store messages in memory-mapped log files.
+ @discussion Logger write messages into pre-allocated file segment which is mapped into memory, so
+             each write is a copy of message bytes without system calls. When active segment full,
+             logger swap it with spare segment (prepared in background) and pass finished segment
+             to background queue where it unmapped, truncated to written length and passed to log
+             file manager (for compression and old files removal).
+ @note       If spare segment not ready yet when active segment is full, messages dropped and their
+             number written into next segment. Disk blocks for each segment reserved before it will
+             be mapped, so if there is no free space, segment won't be created and messages will
+             be dropped till logger will be able to prepare next one.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNFileLogger : DDAbstractLogger
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Reference on manager which is used to create, compress and remove log files.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, strong) id <DDLogFileManager> logFileManager;
+
+/**
+ @brief      Size of each memory-mapped log file segment.
+ @discussion Changes applied to segments which will be prepared after this value change.
+ 
+ @default 5 Mb
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) unsigned long long maximumFileSize;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Construct and configure file logger.
+ 
+ @param logFileManager Reference on manager which should be used to create, compress and remove log
+                       files.
+ 
+ @return Configured and ready to use file logger.
+ 
+ @since 4.1.0
+ */
+- (instancetype)initWithLogFileManager:(id <DDLogFileManager>)logFileManager;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,458 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNFileLogger.h"
+#import <libkern/OSAtomic.h>
+#import <sys/mman.h>
+#import <unistd.h>
+#import <fcntl.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores default size of memory-mapped log file segment.
+ 
+ @since 4.1.0
+ */
+static unsigned long long const kPNLogDefaultFileSize = (5 * 1024 * 1024);
+
+
+#pragma mark - Types
+
+/**
+ @brief  Memory-mapped log file segment.
+ 
+ @since 4.1.0
+ */
+typedef struct PNLogSegment {
+    
+    /**
+     @brief  Stores descriptor of opened log file.
+     */
+    int fileDescriptor;
+    
+    /**
+     @brief  Stores reference on memory to which log file has been mapped.
+     */
+    char *bytes;
+    
+    /**
+     @brief  Stores size of pre-allocated log file.
+     */
+    size_t capacity;
+    
+    /**
+     @brief  Stores number of bytes which has been written into segment.
+     */
+    size_t length;
+    
+    /**
+     @brief  Stores retained reference on full path to log file.
+     */
+    CFTypeRef path;
+} PNLogSegment;
+
+
+#pragma mark - Externs
+
+/**
+ @brief      Reserve disk blocks for whole log file.
+ @discussion \c ftruncate alone create sparse file and blocks allocated only when mapped page
+             written for the first time. If there is no free space at that moment, write into mapped
+             memory raise \c SIGBUS and terminate application, so blocks should be reserved before
+             file will be mapped.
+ 
+ @param fileDescriptor Descriptor of opened log file.
+ @param capacity       Number of bytes which should be reserved for log file.
+ 
+ @return \c YES in case if storage has been reserved and file has required size.
+ 
+ @since 4.1.0
+ */
+static BOOL PNLogSegmentPreallocate(int fileDescriptor, size_t capacity) {
+    
+#if __APPLE__
+    fstore_t store = {(F_ALLOCATECONTIG | F_ALLOCATEALL), F_PEOFPOSMODE, 0, (off_t)capacity, 0};
+    if (fcntl(fileDescriptor, F_PREALLOCATE, &store) == -1) {
+        
+        // Contiguous space not available, try to reserve blocks in fragments.
+        store.fst_flags = F_ALLOCATEALL;
+        if (fcntl(fileDescriptor, F_PREALLOCATE, &store) == -1) {
+            
+            return NO;
+        }
+    }
+    
+    // F_PREALLOCATE doesn't change file size, so it should be set separately.
+    return (ftruncate(fileDescriptor, (off_t)capacity) == 0);
+#else
+    return (posix_fallocate(fileDescriptor, 0, (off_t)capacity) == 0);
+#endif
+}
+
+/**
+ @brief  Create log file, pre-allocate it's storage and map it into memory.
+ 
+ @param path     Full path to log file which should be used for segment.
+ @param capacity Size to which log file should be pre-allocated.
+ 
+ @return Mapped segment or \c NULL in case if file can't be opened, pre-allocated (for example
+         because there is no free space) or mapped.
+ 
+ @since 4.1.0
+ */
+static PNLogSegment *PNLogSegmentCreate(NSString *path, size_t capacity) {
+    
+    PNLogSegment *segment = NULL;
+    const char *filePath = [path fileSystemRepresentation];
+    int fileDescriptor = (filePath ? open(filePath, (O_RDWR | O_CREAT), 0644) : -1);
+    if (fileDescriptor >= 0) {
+        
+        void *bytes = MAP_FAILED;
+        if (PNLogSegmentPreallocate(fileDescriptor, capacity)) {
+            
+            bytes = mmap(NULL, capacity, (PROT_READ | PROT_WRITE), MAP_SHARED, fileDescriptor, 0);
+        }
+        
+        if (bytes != MAP_FAILED) {
+            
+            madvise(bytes, capacity, MADV_SEQUENTIAL);
+            segment = calloc(1, sizeof(PNLogSegment));
+            segment->fileDescriptor = fileDescriptor;
+            segment->bytes = bytes;
+            segment->capacity = capacity;
+            segment->path = CFBridgingRetain(path);
+        }
+        else {
+            
+            // Empty log file shouldn't be left in logs directory and passed to log file manager.
+            close(fileDescriptor);
+            unlink(filePath);
+        }
+    }
+    
+    return segment;
+}
+
+/**
+ @brief  Unmap segment, truncate log file to written length and release segment.
+ 
+ @param segment Reference on segment which should be finalized.
+ 
+ @return Full path to log file which has been used by segment.
+ 
+ @since 4.1.0
+ */
+static NSString *PNLogSegmentFinalize(PNLogSegment *segment) {
+    
+    munmap(segment->bytes, segment->capacity);
+    ftruncate(segment->fileDescriptor, (off_t)segment->length);
+    close(segment->fileDescriptor);
+    NSString *path = CFBridgingRelease(segment->path);
+    free(segment);
+    
+    return path;
+}
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNFileLogger ()
+
+
+#pragma mark - Information
+
+@property (nonatomic, strong) id <DDLogFileManager> logFileManager;
+
+/**
+ @brief      Stores reference on segment which is used for messages at this moment.
+ @discussion Segment accessed only from logger's queue.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) PNLogSegment *activeSegment;
+
+/**
+ @brief  Stores reference on segment which will be used when active segment will be full.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) PNLogSegment * volatile spareSegment;
+
+/**
+ @brief  Stores whether spare segment preparation already scheduled or not.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) volatile int32_t spareSegmentScheduled;
+
+/**
+ @brief  Stores whether files from previous session has been passed to log file manager or not.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) BOOL processedPreviousSessionFiles;
+
+/**
+ @brief  Stores number of messages which has been dropped because there was no room for them.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger droppedMessagesCount;
+
+/**
+ @brief      Stores reference on queue which is used to prepare and finalize segments.
+ @discussion All file system calls performed on this queue, so logger's queue (and threads which
+             log synchronously) never wait for them.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t segmentsQueue;
+
+
+#pragma mark - Segments management
+
+/**
+ @brief      Schedule spare segment preparation on segments queue.
+ @discussion Nothing will happen if spare segment already prepared or scheduled.
+ 
+ @since 4.1.0
+ */
+- (void)scheduleSpareSegment;
+
+/**
+ @brief  Create new log file and map it into memory.
+ 
+ @return Mapped segment or \c NULL in case if log file can't be created.
+ 
+ @since 4.1.0
+ */
+- (PNLogSegment *)newSegment;
+
+/**
+ @brief  Finalize segment on segments queue and pass it's file to log file manager.
+ 
+ @param segment Reference on segment which won't be used for messages anymore.
+ 
+ @since 4.1.0
+ */
+- (void)retireSegment:(PNLogSegment *)segment;
+
+
+#pragma mark - Message processing
+
+/**
+ @brief      Write bytes into active segment.
+ @discussion If there is not enough room in active segment, it will be swapped with spare one.
+ @note       This method should be called only from logger's queue.
+ 
+ @param bytes  Reference on bytes which should be written.
+ @param length Number of bytes which should be written.
+ 
+ @return \c YES in case if bytes has been written.
+ 
+ @since 4.1.0
+ */
+- (BOOL)writeBytes:(const char *)bytes length:(size_t)length;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNFileLogger
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)initWithLogFileManager:(id <DDLogFileManager>)logFileManager {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _logFileManager = logFileManager;
+        _maximumFileSize = kPNLogDefaultFileSize;
+        _segmentsQueue = dispatch_queue_create("com.pubnub.logger.segments", DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(_segmentsQueue,
+                                  dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    if (_activeSegment) {
+        
+        PNLogSegmentFinalize(_activeSegment);
+    }
+    if (_spareSegment) {
+        
+        PNLogSegmentFinalize(_spareSegment);
+    }
+}
+
+
+#pragma mark - Logger state
+
+- (void)didAddLogger {
+    
+    // Files which has been left by previous session (for example if application has been
+    // terminated) should be compressed as well. List retrieved before any segment will be created.
+    if (!self.processedPreviousSessionFiles) {
+        
+        self.processedPreviousSessionFiles = YES;
+        id <DDLogFileManager> logFileManager = self.logFileManager;
+        NSArray *fileInfos = [logFileManager unsortedLogFileInfos];
+        dispatch_async(self.segmentsQueue, ^{
+            
+            for (DDLogFileInfo *fileInfo in fileInfos) {
+                
+                if (![[fileInfo.filePath pathExtension] isEqualToString:@"gz"] &&
+                    [logFileManager respondsToSelector:@selector(didRollAndArchiveLogFile:)]) {
+                    
+                    [logFileManager didRollAndArchiveLogFile:fileInfo.filePath];
+                }
+            }
+        });
+    }
+    
+    // Logger activation is the only moment when segment is prepared on logger's queue, so messages
+    // which is sent right after activation won't be dropped.
+    if (!self.activeSegment) {
+        
+        self.activeSegment = [self newSegment];
+    }
+    [self scheduleSpareSegment];
+}
+
+- (void)willRemoveFromLogger {
+    
+    if (self.activeSegment) {
+        
+        [self retireSegment:self.activeSegment];
+        self.activeSegment = NULL;
+    }
+}
+
+- (void)flush {
+    
+    PNLogSegment *segment = self.activeSegment;
+    if (segment) {
+        
+        msync(segment->bytes, segment->length, MS_ASYNC);
+    }
+}
+
+
+#pragma mark - Segments management
+
+- (void)scheduleSpareSegment {
+    
+    if (OSAtomicCompareAndSwap32Barrier(0, 1, &_spareSegmentScheduled)) {
+        
+        dispatch_async(self.segmentsQueue, ^{
+            
+            // Logger's queue only take spare segment, so it can be placed without compare.
+            if (!self.spareSegment) {
+                
+                PNLogSegment *segment = [self newSegment];
+                OSMemoryBarrier();
+                self.spareSegment = segment;
+            }
+            OSAtomicCompareAndSwap32Barrier(1, 0, &_spareSegmentScheduled);
+        });
+    }
+}
+
+- (PNLogSegment *)newSegment {
+    
+    unsigned long long capacity = (self.maximumFileSize ?: kPNLogDefaultFileSize);
+    
+    return PNLogSegmentCreate([self.logFileManager createNewLogFile], (size_t)capacity);
+}
+
+- (void)retireSegment:(PNLogSegment *)segment {
+    
+    id <DDLogFileManager> logFileManager = self.logFileManager;
+    dispatch_async(self.segmentsQueue, ^{
+        
+        NSString *path = PNLogSegmentFinalize(segment);
+        if ([logFileManager respondsToSelector:@selector(didRollAndArchiveLogFile:)]) {
+            
+            [logFileManager didRollAndArchiveLogFile:path];
+        }
+    });
+}
+
+
+#pragma mark - Message processing
+
+- (void)logMessage:(DDLogMessage *)logMessage {
+    
+    NSString *message = (_logFormatter ? [_logFormatter formatLogMessage:logMessage] :
+                         logMessage->_message);
+    if (message) {
+        
+        if (self.droppedMessagesCount > 0) {
+            
+            NSString *notice = [NSString stringWithFormat:@"<PubNub> %@ log messages dropped "
+                                "while log file has been rotated.\n", @(self.droppedMessagesCount)];
+            if ([self writeBytes:[notice UTF8String] length:strlen([notice UTF8String])]) {
+                
+                self.droppedMessagesCount = 0;
+            }
+        }
+        
+        NSData *data = [[message stringByAppendingString:@"\n"]
+                        dataUsingEncoding:NSUTF8StringEncoding];
+        if (![self writeBytes:[data bytes] length:[data length]]) {
+            
+            self.droppedMessagesCount++;
+        }
+    }
+}
+
+- (BOOL)writeBytes:(const char *)bytes length:(size_t)length {
+    
+    PNLogSegment *segment = self.activeSegment;
+    if (!segment || (segment->capacity - segment->length) < length) {
+        
+        // Take spare segment without waiting for it. If it's not ready yet, message can't be
+        // stored, because file system calls on this queue would stall threads which log
+        // synchronously.
+        PNLogSegment *spareSegment = self.spareSegment;
+        if (!spareSegment || !OSAtomicCompareAndSwapPtrBarrier(spareSegment, NULL,
+                                                               (void * volatile *)&_spareSegment)) {
+            
+            [self scheduleSpareSegment];
+            
+            return NO;
+        }
+        if (segment) {
+            
+            [self retireSegment:segment];
+        }
+        segment = spareSegment;
+        self.activeSegment = segment;
+        [self scheduleSpareSegment];
+    }
+    
+    // Message which is larger than whole segment truncated to segment size.
+    length = MIN(length, (segment->capacity - segment->length));
+    memcpy(segment->bytes + segment->length, bytes, length);
+    segment->length += length;
+    
+    return YES;
+}
+
+#pragma mark -
+
+
+@end
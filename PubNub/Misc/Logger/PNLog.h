@@ -2,24 +2,46 @@
 #import "PNStructures.h"
 
 
-#pragma mark Log macro declaration
-
-#define DDLogClientInfo(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNInfoLogLevel, 0, nil, \
-                                                   __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
-#define DDLogReachability(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNReachabilityLogLevel, 0, \
-                                                     nil, __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
-#define DDLogRequest(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNRequestLogLevel, 0, nil, \
-                                                __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
-#define DDLogResult(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNResultLogLevel, 0, nil, \
-                                               __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
-#define DDLogStatus(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNStatusLogLevel, 0, nil, \
-                                               __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
+#pragma mark Static
+
+/**
+ @brief  Stores Cocoa Lumberjack context which is used by all \b PubNub client log messages.
+ 
+ @since 4.1.0
+ */
+static NSInteger const kPNLogContext = 0x504E;
+
+
+#pragma mark - Log macro declaration
+
+#define DDLogClientInfo(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNInfoLogLevel, \
+                                                   kPNLogContext, nil, __PRETTY_FUNCTION__, frmt, \
+                                                   ##__VA_ARGS__)
+#define DDLogReachability(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNReachabilityLogLevel, \
+                                                     kPNLogContext, nil, __PRETTY_FUNCTION__, \
+                                                     frmt, ##__VA_ARGS__)
+#define DDLogRequest(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNRequestLogLevel, \
+                                                kPNLogContext, nil, __PRETTY_FUNCTION__, frmt, \
+                                                ##__VA_ARGS__)
+#define DDLogResult(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNResultLogLevel, \
+                                               kPNLogContext, nil, __PRETTY_FUNCTION__, frmt, \
+                                               ##__VA_ARGS__)
+#define DDLogStatus(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNStatusLogLevel, \
+                                               kPNLogContext, nil, __PRETTY_FUNCTION__, frmt, \
+                                               ##__VA_ARGS__)
 #define DDLogFailureStatus(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNFailureStatusLogLevel, \
-                                                      0, nil, __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
-#define DDLogAESError(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNAESErrorLogLevel, 0, nil, \
-                                                 __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
-#define DDLogAPICall(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNAPICallLogLevel, 0, nil, \
-                                                __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
+                                                      kPNLogContext, nil, __PRETTY_FUNCTION__, \
+                                                      frmt, ##__VA_ARGS__)
+#define DDLogAESError(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNAESErrorLogLevel, \
+                                                 kPNLogContext, nil, __PRETTY_FUNCTION__, frmt, \
+                                                 ##__VA_ARGS__)
+#define DDLogAPICall(pnll, frmt, ...) LOG_MAYBE(NO, pnll, (DDLogFlag)PNAPICallLogLevel, \
+                                                kPNLogContext, nil, __PRETTY_FUNCTION__, frmt, \
+                                                ##__VA_ARGS__)
+#define DDLogCircuitBreaker(pnll, frmt, ...) LOG_MAYBE(NO, pnll, \
+                                                       (DDLogFlag)PNCircuitBreakerLogLevel, \
+                                                       kPNLogContext, nil, __PRETTY_FUNCTION__, \
+                                                       frmt, ##__VA_ARGS__)
 
 
 
@@ -76,6 +98,18 @@
  */
 + (void)setLogLevel:(PNLogLevel)logLevel;
 
+/**
+ @brief      Specify which part of results and statuses should be logged for \c logLevel.
+ @discussion Useful to keep result logging enabled on hot paths (for example for each received
+             message) with bounded overhead.
+ 
+ @param rate     Part of records which should be logged (between \b 0.0 and \b 1.0).
+ @param logLevel Bit field with logging levels for which sampling rate should be applied.
+ 
+ @since 4.1.0
+ */
++ (void)setSamplingRate:(double)rate forLogLevel:(PNLogLevel)logLevel;
+
 
 ///------------------------------------------------
 /// @name File logging
@@ -85,6 +119,7 @@
  @brief      Specify maximum file size for single log dup file.
  @discussion As soon as file will exceed specified \c size it will be reotated and depending on 
              configuration can be removed.
+ @note       Since 4.1.0 log files pre-allocated with this \c size and rotated files compressed.
  
  @param size Maximum single log dump file size in bytes.
  
@@ -4,7 +4,9 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "PNLog.h"
+#import "PNStructuredLogger.h"
 #import "PNLogFileManager.h"
+#import "PNFileLogger.h"
 #import "PNHelpers.h"
 #import "PNLogger.h"
 
@@ -36,7 +38,7 @@ static DDLogLevel ddLogLevel = DDLogLevelInfo;
  
  @since 4.0
  */
-@property (nonatomic, strong) DDFileLogger *fileLogger;
+@property (nonatomic, strong) PNFileLogger *fileLogger;
 
 
 #pragma mark - Initialization and configuration
@@ -137,8 +139,9 @@ static DDLogLevel ddLogLevel = DDLogLevelInfo;
     
     [DDLog addLogger:[PNLogger new] withLevel:(DDLogLevel)PNVerboseLogLevel];
     
-    // Adding file logger for messages sent by PubNub client.
-    self.fileLogger = [[DDFileLogger alloc] initWithLogFileManager:[PNLogFileManager new]];
+    // Adding file logger for messages sent by PubNub client. Logger write into memory-mapped files
+    // and rolled files compressed by file manager.
+    self.fileLogger = [[PNFileLogger alloc] initWithLogFileManager:[PNLogFileManager new]];
     self.fileLogger.maximumFileSize = (5 * 1024 * 1024);
     self.fileLogger.logFileManager.maximumNumberOfLogFiles = 5;
     self.fileLogger.logFileManager.logFilesDiskQuota = (50 * 1024 * 1024);
@@ -184,6 +187,11 @@ static DDLogLevel ddLogLevel = DDLogLevelInfo;
     }
 }
 
++ (void)setSamplingRate:(double)rate forLogLevel:(PNLogLevel)logLevel {
+    
+    [PNStructuredLogger setSamplingRate:rate forFlag:(DDLogFlag)logLevel];
+}
+
 
 #pragma mark - File logging
 
@@ -5,6 +5,8 @@
 /**
  @brief      Manager which work with log files (rotation, compression, archiving).
  @discussion This class used by \a DDFileLogger to define how log files should be handeled.
+             Since 4.1.0 rolled log files compressed on background queue (\c .gz extension added
+             to file name) and then old files removed to fit into disk quota.
  
  @author Sergey Mamontov
  @since 4.0
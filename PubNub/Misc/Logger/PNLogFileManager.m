@@ -4,12 +4,50 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "PNLogFileManager.h"
+#import "PNGZIP.h"
 
 
-#pragma mark Interface implementation
+#pragma mark Protected interface declaration
+
+@interface PNLogFileManager ()
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores reference on queue which is used to compress rolled log files.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t compressionQueue;
+
+
+#pragma mark - Compression
+
+/**
+ @brief      Compress log file and remove original one.
+ @discussion Trailing zero bytes (which can be left in pre-allocated file if application has been
+             terminated) removed before compression.
+ 
+ @param logFilePath Full path to rolled log file which should be compressed.
+ 
+ @since 4.1.0
+ */
+- (void)compressLogFileAtPath:(NSString *)logFilePath;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
 
 @implementation PNLogFileManager
 
+
+#pragma mark - Initialization and Configuration
+
 - (instancetype)init {
     
     // Configure file manager with default storage in application's Documents folder.
@@ -18,6 +56,23 @@
     return [self initWithLogsDirectory:[documents lastObject]];
 }
 
+- (instancetype)initWithLogsDirectory:(NSString *)logsDirectory {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super initWithLogsDirectory:logsDirectory])) {
+        
+        _compressionQueue = dispatch_queue_create("com.pubnub.logger.compression",
+                                                  DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(_compressionQueue,
+                                  dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Files management
+
 - (NSString *)newLogFileName {
     
     return [[super newLogFileName] stringByReplacingOccurrencesOfString:@".log"
@@ -26,12 +81,52 @@
 
 - (BOOL)isLogFile:(NSString *)fileName {
     
-    NSString *originalName = [fileName stringByReplacingOccurrencesOfString:@".txt"
+    // Compressed files should be counted for disk quota as well.
+    NSString *originalName = [fileName stringByReplacingOccurrencesOfString:@".txt.gz"
                                                                  withString:@".log"];
+    originalName = [originalName stringByReplacingOccurrencesOfString:@".txt" withString:@".log"];
     
     return [super isLogFile:originalName];
 }
 
+- (void)didRollAndArchiveLogFile:(NSString *)logFilePath {
+    
+    dispatch_async(self.compressionQueue, ^{
+        
+        [self compressLogFileAtPath:logFilePath];
+        [super didRollAndArchiveLogFile:logFilePath];
+    });
+}
+
+
+#pragma mark - Compression
+
+- (void)compressLogFileAtPath:(NSString *)logFilePath {
+    
+    NSData *data = [NSData dataWithContentsOfFile:logFilePath options:NSDataReadingMappedIfSafe
+                                            error:NULL];
+    NSUInteger length = [data length];
+    const char *bytes = [data bytes];
+    while (length > 0 && bytes[length - 1] == 0) {
+        
+        length--;
+    }
+    
+    BOOL canRemoveOriginal = (data != nil);
+    if (length > 0) {
+        
+        NSData *logData = [data subdataWithRange:NSMakeRange(0, length)];
+        NSString *compressedFilePath = [logFilePath stringByAppendingPathExtension:@"gz"];
+        canRemoveOriginal = [[PNGZIP GZIPDeflatedData:logData] writeToFile:compressedFilePath
+                                                                atomically:YES];
+    }
+    
+    if (canRemoveOriginal) {
+        
+        [[NSFileManager defaultManager] removeItemAtPath:logFilePath error:NULL];
+    }
+}
+
 #pragma mark -
 
 
@@ -4,6 +4,7 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "PNLogger.h"
+#import "PNLog.h"
 
 
 #pragma mark Interface implementation
@@ -15,7 +16,8 @@
 
 - (void)logMessage:(DDLogMessage *)logMessage {
     
-    if ([logMessage->_fileName hasPrefix:@"PN"] || [logMessage->_fileName hasPrefix:@"PubNub"]) {
+    // All PubNub client log macro use own context, so there is no need to check file names.
+    if (logMessage->_context == kPNLogContext) {
         
         [[DDTTYLogger sharedInstance] logMessage:logMessage];
     }
@@ -0,0 +1,88 @@
+#import <CocoaLumberjack/CocoaLumberjack.h>
+#import "PNStructures.h"
+
+
+#pragma mark Log macro declaration
+
+/**
+ @brief  Deferred logging of objects (results and statuses) which is expensive to stringify.
+ @discussion Object stringified on background writer queue (see \b PNStructuredLogger).
+ 
+ @since 4.1.0
+ */
+#define DDLogObject(pnll, flg, object) do { if ((pnll) & (DDLogFlag)(flg)) { \
+            [PNStructuredLogger logObject:(object) withFlag:(DDLogFlag)(flg) file:__FILE__ \
+                                 function:__PRETTY_FUNCTION__]; \
+        } } while(0)
+#define DDLogResultObject(pnll, object) DDLogObject(pnll, PNResultLogLevel, object)
+#define DDLogStatusObject(pnll, object) DDLogObject(pnll, PNStatusLogLevel, object)
+#define DDLogFailureStatusObject(pnll, object) DDLogObject(pnll, PNFailureStatusLogLevel, object)
+
+
+/**
+ @brief      Asynchronous logger for objects which is expensive to stringify.
+ @discussion Call sites enqueue small records (log flag, reference on object, source file and
+             function) into ring buffer of calling thread without locks and object formatting.
+             Records from all threads drained on dedicated background queue, where objects
+             stringified and passed to Cocoa Lumberjack loggers. Each log flag can be sampled to
+             limit number of records on hot paths (for example for every received message).
+ @note       If thread's ring buffer is full (writer can't keep up), new records dropped and number
+             of dropped records reported by writer.
+ @note       Because objects stringified later, logged representation reflect object state at
+             moment of formatting.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNStructuredLogger : NSObject
+
+
+///------------------------------------------------
+/// @name Sampling
+///------------------------------------------------
+
+/**
+ @brief      Specify which part of records should be logged for specified log flag.
+ @discussion Records sampled deterministically for each thread (for example with \b 0.1 rate every
+             10th record will be logged).
+ 
+ @param rate Part of records which should be logged (between \b 0.0 and \b 1.0). \b 0.0 disable
+             records for \c flag and \b 1.0 (default) log all of them.
+ @param flag One of log flags (\b PNLogLevel fields) for which sampling rate should be applied.
+ 
+ @since 4.1.0
+ */
++ (void)setSamplingRate:(double)rate forFlag:(DDLogFlag)flag;
+
+
+///------------------------------------------------
+/// @name Logging
+///------------------------------------------------
+
+/**
+ @brief  Enqueue \c object for deferred logging.
+ @note   Method shouldn't be used directly, use \c DDLog*Object macro instead.
+ 
+ @param object   Reference on object which should be logged (it's \c -stringifiedRepresentation or
+                 \c -description will be used).
+ @param flag     Log flag which should be used for record.
+ @param file     Name of source file from which record has been logged.
+ @param function Name of function from which record has been logged.
+ 
+ @since 4.1.0
+ */
++ (void)logObject:(id)object withFlag:(DDLogFlag)flag file:(const char *)file
+         function:(const char *)function;
+
+/**
+ @brief  Wait till all records which has been enqueued before this call will be passed to loggers.
+ 
+ @since 4.1.0
+ */
++ (void)flush;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,403 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNStructuredLogger.h"
+#import <libkern/OSAtomic.h>
+#import <pthread.h>
+#import "PNResult+Private.h"
+#import "PNLog.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of records which can wait for writer in single thread's ring buffer.
+ 
+ @since 4.1.0
+ */
+static int64_t const kPNLogRingBufferCapacity = 1024;
+
+/**
+ @brief  Stores number of sampling slots (one for each bit of log flag).
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNLogSamplingSlotsCount = (sizeof(DDLogFlag) * 8);
+
+/**
+ @brief  Stores prefix which is added to each stringified object.
+ 
+ @since 4.1.0
+ */
+static NSString * const kPNLogMessagePrefix = @"<PubNub> ";
+
+
+#pragma mark - Types
+
+/**
+ @brief  Log record which is stored by call site.
+ 
+ @since 4.1.0
+ */
+typedef struct PNLogRecord {
+    
+    /**
+     @brief  Stores log flag which should be used for record.
+     */
+    DDLogFlag flag;
+    
+    /**
+     @brief  Stores retained reference on object which should be stringified by writer.
+     */
+    CFTypeRef object;
+    
+    /**
+     @brief  Stores name of source file from which record has been logged (static storage).
+     */
+    const char *file;
+    
+    /**
+     @brief  Stores name of function from which record has been logged (static storage).
+     */
+    const char *function;
+    
+    /**
+     @brief  Stores record creation date.
+     */
+    CFAbsoluteTime timestamp;
+} PNLogRecord;
+
+/**
+ @brief      Single-producer / single-consumer ring buffer which is created for each thread which
+             log records.
+ @discussion Only owning thread change \c head and only writer change \c tail, so records can be
+             passed between them with memory barriers only.
+ 
+ @since 4.1.0
+ */
+typedef struct PNLogRingBuffer {
+    
+    /**
+     @brief  Stores records storage with \c kPNLogRingBufferCapacity capacity.
+     */
+    PNLogRecord *records;
+    
+    /**
+     @brief  Stores number of records which has been written by owning thread.
+     */
+    volatile int64_t head;
+    
+    /**
+     @brief  Stores number of records which has been read by writer.
+     */
+    volatile int64_t tail;
+    
+    /**
+     @brief  Stores number of records which has been dropped because buffer was full.
+     */
+    volatile int32_t dropped;
+    
+    /**
+     @brief  Stores whether owning thread exited and buffer should be released by writer.
+     */
+    volatile int32_t abandoned;
+    
+    /**
+     @brief  Stores number of records which has been passed to sampling for each log flag bit.
+     */
+    uint32_t samplingCounters[64];
+    
+    /**
+     @brief  Stores reference on next registered buffer.
+     */
+    struct PNLogRingBuffer *next;
+} PNLogRingBuffer;
+
+
+#pragma mark - Shared state
+
+/**
+ @brief  Stores reference on list of ring buffers which has been created by threads.
+ 
+ @since 4.1.0
+ */
+static PNLogRingBuffer *_buffers = NULL;
+
+/**
+ @brief  Stores lock which is used to guard ring buffers list modification.
+ 
+ @since 4.1.0
+ */
+static OSSpinLock _buffersLock = OS_SPINLOCK_INIT;
+
+/**
+ @brief  Stores key which is used to store ring buffer in thread-specific data.
+ 
+ @since 4.1.0
+ */
+static pthread_key_t _bufferKey;
+
+/**
+ @brief      Stores sampling interval for each log flag bit.
+ @discussion \b 0 and \b 1 mean what all records should be logged, \c UINT32_MAX mean what records
+             shouldn't be logged at all.
+ 
+ @since 4.1.0
+ */
+static volatile uint32_t _samplingIntervals[64];
+
+/**
+ @brief  Stores whether writer already has been scheduled to drain buffers.
+ 
+ @since 4.1.0
+ */
+static volatile int32_t _drainScheduled = 0;
+
+
+#pragma mark - Externs
+
+/**
+ @brief  Retrieve reference on queue on which writer drain ring buffers.
+ 
+ @return Serial queue for writer.
+ 
+ @since 4.1.0
+ */
+static dispatch_queue_t PNLogWriterQueue(void);
+
+/**
+ @brief  Schedule writer to drain ring buffers (if it hasn't been scheduled yet).
+ 
+ @since 4.1.0
+ */
+static void PNLogScheduleDrain(void);
+
+/**
+ @brief  Mark ring buffer as abandoned when it's owning thread exit.
+ 
+ @param buffer Reference on ring buffer which has been created for exiting thread.
+ 
+ @since 4.1.0
+ */
+static void PNLogRingBufferAbandon(void *buffer) {
+    
+    OSAtomicCompareAndSwap32Barrier(0, 1, &((PNLogRingBuffer *)buffer)->abandoned);
+    PNLogScheduleDrain();
+}
+
+/**
+ @brief  Retrieve reference on ring buffer of calling thread (create if required).
+ 
+ @return Ring buffer for calling thread.
+ 
+ @since 4.1.0
+ */
+static PNLogRingBuffer *PNLogRingBufferForCurrentThread(void) {
+    
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        pthread_key_create(&_bufferKey, PNLogRingBufferAbandon);
+    });
+    
+    PNLogRingBuffer *buffer = pthread_getspecific(_bufferKey);
+    if (!buffer) {
+        
+        buffer = calloc(1, sizeof(PNLogRingBuffer));
+        buffer->records = calloc((size_t)kPNLogRingBufferCapacity, sizeof(PNLogRecord));
+        pthread_setspecific(_bufferKey, buffer);
+        OSSpinLockLock(&_buffersLock);
+        buffer->next = _buffers;
+        _buffers = buffer;
+        OSSpinLockUnlock(&_buffersLock);
+    }
+    
+    return buffer;
+}
+
+/**
+ @brief  Pass records from all ring buffers to Cocoa Lumberjack and release abandoned buffers.
+ @note   Function should be called only from writer queue.
+ 
+ @since 4.1.0
+ */
+static void PNLogDrain(void) {
+    
+    OSAtomicCompareAndSwap32Barrier(1, 0, &_drainScheduled);
+    
+    // New buffers only prepended to the list, so it can be walked without lock.
+    OSSpinLockLock(&_buffersLock);
+    PNLogRingBuffer *buffer = _buffers;
+    OSSpinLockUnlock(&_buffersLock);
+    while (buffer) {
+        
+        // Thread mark buffer as abandoned after last write, so all it's records will be visible.
+        BOOL isAbandoned = (buffer->abandoned == 1);
+        OSMemoryBarrier();
+        int64_t head = buffer->head;
+        OSMemoryBarrier();
+        for (int64_t recordIdx = buffer->tail; recordIdx < head; recordIdx++) {
+            
+            PNLogRecord record = buffer->records[recordIdx % kPNLogRingBufferCapacity];
+            OSMemoryBarrier();
+            buffer->tail = (recordIdx + 1);
+            
+            @autoreleasepool {
+                
+                // Formatting performed only here, on writer's queue.
+                id object = CFBridgingRelease(record.object);
+                NSString *representation = nil;
+                if ([object respondsToSelector:@selector(stringifiedRepresentation)]) {
+                    
+                    representation = [(PNResult *)object stringifiedRepresentation];
+                }
+                representation = (representation?: [object description]);
+                CFAbsoluteTime recordDate = record.timestamp;
+                NSDate *timestamp = [NSDate dateWithTimeIntervalSinceReferenceDate:recordDate];
+                NSString *text = [kPNLogMessagePrefix stringByAppendingString:representation];
+                DDLogLevel level = (DDLogLevel)record.flag;
+                DDLogMessage *message = [[DDLogMessage alloc] initWithMessage:text level:level
+                                                                         flag:record.flag
+                                                                      context:kPNLogContext
+                                                                         file:@(record.file)
+                                                                     function:@(record.function)
+                                                                         line:0 tag:nil
+                                                                      options:(DDLogMessageOptions)0
+                                                                    timestamp:timestamp];
+                [DDLog log:NO message:message];
+            }
+        }
+        
+        int32_t dropped = buffer->dropped;
+        if (dropped > 0) {
+            
+            OSAtomicAdd32Barrier(-dropped, &buffer->dropped);
+            DDLogClientInfo((DDLogLevel)PNInfoLogLevel, @"<PubNub> %@ log records dropped.",
+                            @(dropped));
+        }
+        
+        PNLogRingBuffer *nextBuffer = buffer->next;
+        if (isAbandoned) {
+            
+            // Owning thread exited and won't write anymore, so buffer can be unlinked.
+            OSSpinLockLock(&_buffersLock);
+            PNLogRingBuffer **link = &_buffers;
+            while (*link && *link != buffer) {
+                
+                link = &(*link)->next;
+            }
+            if (*link) {
+                
+                *link = buffer->next;
+            }
+            OSSpinLockUnlock(&_buffersLock);
+            free(buffer->records);
+            free(buffer);
+        }
+        buffer = nextBuffer;
+    }
+}
+
+static dispatch_queue_t PNLogWriterQueue(void) {
+    
+    static dispatch_queue_t _writerQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _writerQueue = dispatch_queue_create("com.pubnub.logger.writer", DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(_writerQueue,
+                                  dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+    });
+    
+    return _writerQueue;
+}
+
+static void PNLogScheduleDrain(void) {
+    
+    if (OSAtomicCompareAndSwap32Barrier(0, 1, &_drainScheduled)) {
+        
+        dispatch_async(PNLogWriterQueue(), ^{
+            
+            PNLogDrain();
+        });
+    }
+}
+
+
+#pragma mark - Interface implementation
+
+@implementation PNStructuredLogger
+
+
+#pragma mark - Sampling
+
++ (void)setSamplingRate:(double)rate forFlag:(DDLogFlag)flag {
+    
+    uint32_t interval = UINT32_MAX;
+    if (rate > 0.0f) {
+        
+        interval = (uint32_t)MAX(round(1.0f / MIN(rate, 1.0f)), 1.0f);
+    }
+    for (NSUInteger slotIdx = 0; slotIdx < kPNLogSamplingSlotsCount; slotIdx++) {
+        
+        if (flag & ((DDLogFlag)1 << slotIdx)) {
+            
+            _samplingIntervals[slotIdx] = interval;
+        }
+    }
+}
+
+
+#pragma mark - Logging
+
++ (void)logObject:(id)object withFlag:(DDLogFlag)flag file:(const char *)file
+         function:(const char *)function {
+    
+    if (!object || !flag) {
+        
+        return;
+    }
+    
+    PNLogRingBuffer *buffer = PNLogRingBufferForCurrentThread();
+    NSUInteger slotIdx = (NSUInteger)__builtin_ctzl((unsigned long)flag);
+    uint32_t interval = _samplingIntervals[slotIdx];
+    if (interval == UINT32_MAX ||
+        (interval > 1 && (buffer->samplingCounters[slotIdx]++ % interval) != 0)) {
+        
+        return;
+    }
+    
+    if ((buffer->head - buffer->tail) >= kPNLogRingBufferCapacity) {
+        
+        OSAtomicIncrement32Barrier(&buffer->dropped);
+    }
+    else {
+        
+        PNLogRecord *record = &buffer->records[buffer->head % kPNLogRingBufferCapacity];
+        record->flag = flag;
+        record->object = CFBridgingRetain(object);
+        record->file = file;
+        record->function = function;
+        record->timestamp = CFAbsoluteTimeGetCurrent();
+        
+        // Record should be completely written before writer will be able to see it.
+        OSMemoryBarrier();
+        buffer->head++;
+    }
+    PNLogScheduleDrain();
+}
+
++ (void)flush {
+    
+    dispatch_sync(PNLogWriterQueue(), ^{
+        
+        PNLogDrain();
+    });
+}
+
+#pragma mark -
+
+
+@end
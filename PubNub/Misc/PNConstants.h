@@ -6,6 +6,7 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import <Foundation/Foundation.h>
+#import "PNStructures.h"
 
 
 #ifndef PNConstants_h
@@ -33,10 +34,19 @@ static NSString * const kPNDefaultOrigin = @"pubsub.pubnub.com";
 
 static NSTimeInterval const kPNDefaultSubscribeMaximumIdleTime = 310.0f;
 static NSTimeInterval const kPNDefaultNonSubscribeRequestTimeout = 10.0f;
+static NSTimeInterval const kPNDefaultConnectionIdleDeadline = 0.0f;
+static NSTimeInterval const kPNDefaultKeepWarmInterval = 0.0f;
+static NSInteger const kPNDefaultHedgeBudget = 0;
+static NSUInteger const kPNDefaultCircuitBreakerThreshold = 0;
+static NSTimeInterval const kPNDefaultCircuitBreakerOpenInterval = 10.0f;
+static NSTimeInterval const kPNDefaultPresenceEventsAggregationWindow = 0.0f;
+static PNTransport const kPNDefaultTransport = PNHTTPTransport;
 
 static BOOL const kPNDefaultIsTLSEnabled = YES;
 static BOOL const kPNDefaultShouldKeepTimeTokenOnListChange = YES;
 static BOOL const kPNDefaultShouldRestoreSubscription = YES;
 static BOOL const kPNDefaultShouldTryCatchUpOnSubscriptionRestore = YES;
+static BOOL const kPNDefaultShouldWarmUpConnections = NO;
+static BOOL const kPNDefaultShouldTraceRequests = NO;
 
 #endif // PNConstants_h
@@ -0,0 +1,94 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Host-driven event loop.
+ @discussion Event loop attached to GCD queue which is used by \b PubNub client as callback and
+             response processing queue. Blocks which has been scheduled on this queue with
+             \c pn_dispatch_async() won't be executed by GCD and stored by event loop till host
+             application will call \c -pumpWithTimeout: from it's own thread. Event loop expose
+             file descriptor which become readable as soon as there is pending blocks, so it can
+             be added to host's reactor (\c epoll, \c kqueue or \c select).
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNEventLoop : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores file descriptor which become readable when event loop has pending blocks.
+ @note   Host application shouldn't read from this descriptor, it will be drained during
+         \c -pumpWithTimeout: call.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) int fileDescriptor;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief      Construct serial queue with attached event loop.
+ @discussion Event loop retained by queue and will be released along with it.
+ 
+ @return Constructed and ready to use serial queue.
+ 
+ @since 4.1.0
+ */
++ (dispatch_queue_t)queueWithEventLoop;
+
+/**
+ @brief  Retrieve reference on event loop which is attached to \c queue.
+ 
+ @param queue Reference on queue for which event loop should be found.
+ 
+ @return Event loop instance or \c nil in case if \c queue hasn't been created with
+         \c +queueWithEventLoop.
+ 
+ @since 4.1.0
+ */
++ (PNEventLoop *)eventLoopForQueue:(dispatch_queue_t)queue;
+
+
+///------------------------------------------------
+/// @name Events processing
+///------------------------------------------------
+
+/**
+ @brief  Store \c block till next \c -pumpWithTimeout: call.
+ 
+ @param block Reference on block which should be executed on host's thread.
+ 
+ @since 4.1.0
+ */
+- (void)enqueueBlock:(dispatch_block_t)block;
+
+/**
+ @brief      Wait for pending blocks and execute them on calling thread.
+ @discussion Only blocks which has been scheduled before pump started will be executed, blocks
+             scheduled by them will wait for next call. This allow host application to bound time
+             which is spent inside of event loop.
+ @warning    Method should be called from single thread.
+ 
+ @param timeout Maximum number of seconds which should be spent waiting for pending blocks. \b 0
+                can be passed to execute only already pending blocks and negative value to wait
+                till any block will be scheduled.
+ 
+ @return Number of blocks which has been executed.
+ 
+ @since 4.1.0
+ */
+- (NSUInteger)pumpWithTimeout:(NSTimeInterval)timeout;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,204 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNEventLoop.h"
+#import <unistd.h>
+#import <fcntl.h>
+#import <poll.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores key which is used to attach event loop to GCD queue.
+ 
+ @since 4.1.0
+ */
+static char kPNEventLoopKey;
+
+
+#pragma mark - Externs
+
+/**
+ @brief  Release event loop which has been attached to GCD queue (called when queue deallocated).
+ 
+ @param context Reference on event loop which has been retained by queue.
+ 
+ @since 4.1.0
+ */
+static void pn_event_loop_release(void *context) {
+    
+    CFRelease(context);
+}
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNEventLoop ()
+
+
+#pragma mark - Information
+
+@property (nonatomic, assign) int fileDescriptor;
+
+/**
+ @brief  Stores descriptor which is used to signal pending blocks.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) int signalDescriptor;
+
+/**
+ @brief  Stores reference on list of blocks which wait for next pump.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *blocks;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to pending blocks list.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Read all signal bytes from descriptor.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @since 4.1.0
+ */
+- (void)drainFileDescriptor;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNEventLoop
+
+
+#pragma mark - Initialization and Configuration
+
++ (dispatch_queue_t)queueWithEventLoop {
+    
+    dispatch_queue_t queue = dispatch_queue_create("com.pubnub.event-loop", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(queue, &kPNEventLoopKey, (__bridge_retained void *)[self new],
+                                pn_event_loop_release);
+    
+    return queue;
+}
+
++ (PNEventLoop *)eventLoopForQueue:(dispatch_queue_t)queue {
+    
+    return (queue ? (__bridge PNEventLoop *)dispatch_queue_get_specific(queue, &kPNEventLoopKey) :
+            nil);
+}
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        int descriptors[2] = {-1, -1};
+        if (pipe(descriptors) == 0) {
+            
+            for (int descriptorIdx = 0; descriptorIdx < 2; descriptorIdx++) {
+                
+                fcntl(descriptors[descriptorIdx], F_SETFL,
+                      fcntl(descriptors[descriptorIdx], F_GETFL) | O_NONBLOCK);
+                fcntl(descriptors[descriptorIdx], F_SETFD, FD_CLOEXEC);
+            }
+        }
+        _fileDescriptor = descriptors[0];
+        _signalDescriptor = descriptors[1];
+        _blocks = [NSMutableArray new];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.event-loop.resources",
+                                                     DISPATCH_QUEUE_CONCURRENT);
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    if (_fileDescriptor >= 0) {
+        
+        close(_fileDescriptor);
+        close(_signalDescriptor);
+    }
+}
+
+
+#pragma mark - Events processing
+
+- (void)enqueueBlock:(dispatch_block_t)block {
+    
+    if (block) {
+        
+        dispatch_barrier_async(self.resourceAccessQueue, ^{
+            
+            // Host should be woken up only once for series of scheduled blocks.
+            BOOL shouldSignal = ![self.blocks count];
+            [self.blocks addObject:[block copy]];
+            if (shouldSignal && self.signalDescriptor >= 0) {
+                
+                char signal = 1;
+                write(self.signalDescriptor, &signal, sizeof(signal));
+            }
+        });
+    }
+}
+
+- (NSUInteger)pumpWithTimeout:(NSTimeInterval)timeout {
+    
+    __block BOOL hasPendingBlocks = NO;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        hasPendingBlocks = ([self.blocks count] > 0);
+    });
+    if (!hasPendingBlocks && timeout != 0.0f && self.fileDescriptor >= 0) {
+        
+        struct pollfd descriptor = {.fd = self.fileDescriptor, .events = POLLIN, .revents = 0};
+        poll(&descriptor, 1, (timeout > 0.0f ? (int)(timeout * 1000.0f) : -1));
+    }
+    
+    __block NSArray *blocks = nil;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        blocks = [self.blocks copy];
+        [self.blocks removeAllObjects];
+        [self drainFileDescriptor];
+    });
+    for (dispatch_block_t block in blocks) {
+        
+        block();
+    }
+    
+    return [blocks count];
+}
+
+
+#pragma mark - Misc
+
+- (void)drainFileDescriptor {
+    
+    if (self.fileDescriptor >= 0) {
+        
+        char buffer[32];
+        while (read(self.fileDescriptor, buffer, sizeof(buffer)) > 0) {}
+    }
+}
+
+#pragma mark -
+
+
+@end
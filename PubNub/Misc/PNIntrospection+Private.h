@@ -0,0 +1,36 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNIntrospection.h"
+
+
+#pragma mark Class forward
+
+@class PubNub;
+
+
+#pragma mark - Private interface declaration
+
+@interface PNIntrospection (Private)
+
+
+///------------------------------------------------
+/// @name Clients
+///------------------------------------------------
+
+/**
+ @brief      Add \c client to the list of clients which is included into snapshot.
+ @discussion Clients stored with weak references, so there is no need to remove them.
+
+ @param client Reference on client which has been created.
+
+ @since 4.1.0
+ */
++ (void)registerClient:(PubNub *)client;
+
+#pragma mark -
+
+
+@end
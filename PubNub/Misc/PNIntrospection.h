@@ -0,0 +1,77 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Process-wide introspection server for live \b PubNub clients.
+ @discussion Server listen on Unix domain socket and for each connection write JSON snapshot of all
+             live clients in process: subscriber, state cache, listeners, heartbeat schedule, both
+             network managers (in-flight requests and queue depths) and shared timers schedule.
+             Connection closed right after snapshot has been written, so it can be read with any
+             tool which is able to connect to Unix domain socket (\c scripts/introspection contains
+             small CLI for this).
+ @note       Each component snapshot taken on component's own resources access queue, so clients
+             continue their work while snapshot is collected and each part reflect consistent state
+             between two modifications.
+ @warning    Server is disabled by default. Socket file created with access only for current user,
+             but snapshot contain channel names and client state, so it should be started only for
+             debugging.
+
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNIntrospection : NSObject
+
+
+///------------------------------------------------
+/// @name Server
+///------------------------------------------------
+
+/**
+ @brief      Start introspection server.
+ @discussion If server already running, it will be stopped and started at new \c path.
+
+ @param path Full path to Unix domain socket file which should be created by server. Existing file
+             at this path will be removed.
+
+ @return \c YES in case if server has been started or \c NO if socket can't be created at \c path.
+
+ @since 4.1.0
+ */
++ (BOOL)startServerAtPath:(NSString *)path;
+
+/**
+ @brief  Stop introspection server and remove it's socket file.
+
+ @since 4.1.0
+ */
++ (void)stopServer;
+
+/**
+ @brief  Check whether introspection server is running or not.
+
+ @return \c YES in case if server accept connections at this moment.
+
+ @since 4.1.0
+ */
++ (BOOL)isServerRunning;
+
+
+///------------------------------------------------
+/// @name Snapshot
+///------------------------------------------------
+
+/**
+ @brief      Collect snapshot of all live clients.
+ @discussion Same data is written by server into each accepted connection.
+
+ @return JSON data with \c process, \c timers and \c clients keys.
+
+ @since 4.1.0
+ */
++ (NSData *)snapshotData;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,318 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNIntrospection+Private.h"
+#import "PubNub+CorePrivate.h"
+#import "PNTimingWheel.h"
+#import "PNConstants.h"
+#import <sys/socket.h>
+#import <sys/stat.h>
+#import <sys/time.h>
+#import <sys/un.h>
+#import <unistd.h>
+#import <fcntl.h>
+#import <errno.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of pending connections which can wait for snapshot.
+ 
+ @since 4.1.0
+ */
+static int const kPNIntrospectionBacklog = 8;
+
+/**
+ @brief      Stores maximum time (in seconds) during which snapshot write may wait for client.
+ @discussion Connection is blocking, so client which connected and never read snapshot would hold
+             writing thread forever without this timeout.
+ 
+ @since 4.1.0
+ */
+static time_t const kPNIntrospectionSendTimeout = 5;
+
+/**
+ @brief      Stores flags which is used to send snapshot to connected client.
+ @discussion Client may close connection before snapshot will be written. Darwin suppress
+             \c SIGPIPE for this case with \c SO_NOSIGPIPE socket option, on other platforms same
+             can be done only for each \c send() call.
+ 
+ @since 4.1.0
+ */
+#ifdef MSG_NOSIGNAL
+static int const kPNIntrospectionSendFlags = MSG_NOSIGNAL;
+#else
+static int const kPNIntrospectionSendFlags = 0;
+#endif
+
+
+#pragma mark - Private interface declaration
+
+@interface PNIntrospection ()
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve reference on queue which is used to serialize access to server and clients list.
+ 
+ @return Serial queue reference.
+ 
+ @since 4.1.0
+ */
++ (dispatch_queue_t)resourceAccessQueue;
+
+/**
+ @brief  Retrieve reference on list of registered clients.
+ @note   This method should be called only from resource access queue.
+ 
+ @return Hash table with weak references on clients.
+ 
+ @since 4.1.0
+ */
++ (NSHashTable *)clients;
+
+/**
+ @brief  Write \c data into connection's file descriptor and close it.
+ @note   Write interrupted if client doesn't read data for \c kPNIntrospectionSendTimeout seconds.
+ 
+ @param data             Reference on snapshot which should be written.
+ @param socketDescriptor Descriptor of accepted connection.
+ 
+ @since 4.1.0
+ */
++ (void)writeData:(NSData *)data toSocket:(int)socketDescriptor;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNIntrospection
+
+
+#pragma mark - Server
+
+/**
+ @brief  Stores reference on source which accept connections to server socket.
+ 
+ @since 4.1.0
+ */
+static dispatch_source_t _serverSource;
+
+/**
+ @brief  Stores path to socket file which has been created by server.
+ 
+ @since 4.1.0
+ */
+static NSString *_serverPath;
+
++ (BOOL)startServerAtPath:(NSString *)path {
+    
+    [self stopServer];
+    const char *socketPath = [path fileSystemRepresentation];
+    struct sockaddr_un address;
+    if (!socketPath || strlen(socketPath) >= sizeof(address.sun_path)) {
+        
+        return NO;
+    }
+    
+    int serverDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverDescriptor < 0) {
+        
+        return NO;
+    }
+    
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    unlink(socketPath);
+    
+    // Socket file access limited to owner, because snapshot contain client state. Process-wide
+    // umask not changed, because other threads may create files at the same time.
+    BOOL bound = (bind(serverDescriptor, (struct sockaddr *)&address, sizeof(address)) == 0);
+    if (!bound || chmod(socketPath, (S_IRUSR | S_IWUSR)) != 0 ||
+        listen(serverDescriptor, kPNIntrospectionBacklog) != 0) {
+        
+        close(serverDescriptor);
+        if (bound) {
+            
+            unlink(socketPath);
+        }
+        
+        return NO;
+    }
+    fcntl(serverDescriptor, F_SETFL, fcntl(serverDescriptor, F_GETFL) | O_NONBLOCK);
+    fcntl(serverDescriptor, F_SETFD, FD_CLOEXEC);
+    
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ,
+                                                      (uintptr_t)serverDescriptor, 0,
+                                                      [self resourceAccessQueue]);
+    dispatch_source_set_event_handler(source, ^{
+        
+        int connectionDescriptor = accept(serverDescriptor, NULL, NULL);
+        if (connectionDescriptor >= 0) {
+            
+            // Connection may inherit non-blocking mode from server socket.
+            fcntl(connectionDescriptor, F_SETFL,
+                  fcntl(connectionDescriptor, F_GETFL) & ~O_NONBLOCK);
+            struct timeval sendTimeout = {.tv_sec = kPNIntrospectionSendTimeout, .tv_usec = 0};
+            setsockopt(connectionDescriptor, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout,
+                       sizeof(sendTimeout));
+#ifdef SO_NOSIGPIPE
+            int noSignal = 1;
+            setsockopt(connectionDescriptor, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+            
+            // Snapshot collected outside of server queue, so slow component won't block other
+            // connections.
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+                
+                [self writeData:[self snapshotData] toSocket:connectionDescriptor];
+            });
+        }
+    });
+    dispatch_source_set_cancel_handler(source, ^{
+        
+        close(serverDescriptor);
+    });
+    dispatch_sync([self resourceAccessQueue], ^{
+        
+        _serverSource = source;
+        _serverPath = [path copy];
+    });
+    dispatch_resume(source);
+    
+    return YES;
+}
+
++ (void)stopServer {
+    
+    dispatch_sync([self resourceAccessQueue], ^{
+        
+        if (_serverSource) {
+            
+            dispatch_source_cancel(_serverSource);
+            unlink([_serverPath fileSystemRepresentation]);
+            _serverSource = nil;
+            _serverPath = nil;
+        }
+    });
+}
+
++ (BOOL)isServerRunning {
+    
+    __block BOOL isRunning = NO;
+    dispatch_sync([self resourceAccessQueue], ^{
+        
+        isRunning = (_serverSource != nil);
+    });
+    
+    return isRunning;
+}
+
+
+#pragma mark - Snapshot
+
++ (NSData *)snapshotData {
+    
+    __block NSArray *clients = nil;
+    dispatch_sync([self resourceAccessQueue], ^{
+        
+        clients = [[self clients] allObjects];
+    });
+    
+    NSMutableArray *clientSnapshots = [NSMutableArray new];
+    for (PubNub *client in clients) {
+        
+        [clientSnapshots addObject:[client introspectionSnapshot]];
+    }
+    NSProcessInfo *processInfo = [NSProcessInfo processInfo];
+    NSDictionary *snapshot = @{
+        @"process": @{@"pid": @(processInfo.processIdentifier), @"name": processInfo.processName,
+                      @"sdk": kPNLibraryVersion, @"date": @([[NSDate date] timeIntervalSince1970])},
+        @"timers": [[PNTimingWheel sharedWheel] introspectionSnapshot], @"clients": clientSnapshots
+    };
+    
+    NSError *error = nil;
+    NSData *data = [NSJSONSerialization dataWithJSONObject:snapshot
+                                                   options:NSJSONWritingPrettyPrinted error:&error];
+    if (error) {
+        
+        data = [NSJSONSerialization dataWithJSONObject:@{@"error": error.localizedDescription}
+                                               options:(NSJSONWritingOptions)0 error:nil];
+    }
+    
+    return data;
+}
+
+
+#pragma mark - Clients
+
++ (void)registerClient:(PubNub *)client {
+    
+    dispatch_async([self resourceAccessQueue], ^{
+        
+        [[self clients] addObject:client];
+    });
+}
+
+
+#pragma mark - Misc
+
++ (dispatch_queue_t)resourceAccessQueue {
+    
+    static dispatch_queue_t _resourceAccessQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.introspection",
+                                                     DISPATCH_QUEUE_SERIAL);
+    });
+    
+    return _resourceAccessQueue;
+}
+
++ (NSHashTable *)clients {
+    
+    static NSHashTable *_clients;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _clients = [NSHashTable weakObjectsHashTable];
+    });
+    
+    return _clients;
+}
+
++ (void)writeData:(NSData *)data toSocket:(int)socketDescriptor {
+    
+    const uint8_t *bytes = data.bytes;
+    NSUInteger written = 0;
+    while (written < data.length) {
+        
+        ssize_t count = send(socketDescriptor, (bytes + written), (data.length - written),
+                             kPNIntrospectionSendFlags);
+        if (count < 0 && errno == EINTR) {
+            
+            continue;
+        }
+        if (count <= 0) {
+            
+            break;
+        }
+        written += (NSUInteger)count;
+    }
+    close(socketDescriptor);
+}
+
+#pragma mark -
+
+
+@end
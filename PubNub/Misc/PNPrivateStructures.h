@@ -12,80 +12,355 @@
 #define PNPrivateStructures_h
 
 /**
- @brief  Helper to stringify operation type in result and status objects.
+ @brief  Network lanes which is used to process operations.
 
- @since 4.0
+ @since 4.1.0
  */
-static NSString * const PNOperationTypeStrings[22] = {
-    [PNSubscribeOperation] = @"Subscribe",
-    [PNUnsubscribeOperation] = @"Unsubscribe",
-    [PNPublishOperation] = @"Publish",
-    [PNHistoryOperation] = @"History",
-    [PNWhereNowOperation] = @"Where Now",
-    [PNHereNowGlobalOperation] = @"Global Here Now",
-    [PNHereNowForChannelOperation] = @"Here Now for Channel",
-    [PNHereNowForChannelGroupOperation] = @"Here Now for Channel Group",
-    [PNHeartbeatOperation] = @"Heartbeat",
-    [PNSetStateOperation] = @"Set State",
-    [PNStateForChannelOperation] = @"Get State for Channel",
-    [PNStateForChannelGroupOperation] = @"Get State for Channel Group",
-    [PNAddChannelsToGroupOperation] = @"Add Channels To Group",
-    [PNRemoveChannelsFromGroupOperation] = @"Remove Channels From Group",
-    [PNChannelGroupsOperation] = @"Get Groups",
-    [PNRemoveGroupOperation] = @"Remove Channel Group",
-    [PNChannelsForGroupOperation] = @"Get Channels For Group",
-    [PNPushNotificationEnabledChannelsOperation] = @"Get Push Notification Enabled Channels",
-    [PNAddPushNotificationsOnChannelsOperation] = @"Enable Push Notifications On Channels",
-    [PNRemovePushNotificationsFromChannelsOperation] = @"Remove Push Notifications From Channels",
-    [PNRemoveAllPushNotificationsOperation] = @"Remove All Push Notifications",
-    [PNTimeOperation] = @"Time",
-};
+typedef NS_ENUM(NSInteger, PNOperationLane) {
+    
+    /**
+     @brief  Operation processed by network manager which is used for long-poll requests.
+     
+     @since 4.1.0
+     */
+    PNSubscriptionOperationLane,
+    
+    /**
+     @brief  Operation processed by network manager which is used for 'non-subscription' API.
 
-static NSString * const PNOperationResultClasses[22] = {
-    [PNHistoryOperation] = @"PNHistoryResult",
-    [PNWhereNowOperation] = @"PNPresenceWhereNowResult",
-    [PNHereNowGlobalOperation] = @"PNPresenceGlobalHereNowResult",
-    [PNHereNowForChannelOperation] = @"PNPresenceChannelHereNowResult",
-    [PNHereNowForChannelGroupOperation] = @"PNPresenceChannelGroupHereNowResult",
-    [PNStateForChannelOperation] = @"PNChannelClientStateResult",
-    [PNStateForChannelGroupOperation] = @"PNChannelGroupClientStateResult",
-    [PNChannelGroupsOperation] = @"PNChannelGroupsResult",
-    [PNChannelsForGroupOperation] = @"PNChannelGroupChannelsResult",
-    [PNPushNotificationEnabledChannelsOperation] = @"PNAPNSEnabledChannelsResult",
-    [PNTimeOperation] = @"PNTimeResult",
+     @since 4.1.0
+     */
+    PNServiceOperationLane
 };
 
-static NSString * const PNOperationStatusClasses[22] = {
-    [PNSubscribeOperation] = @"PNSubscribeStatus",
-    [PNUnsubscribeOperation] = @"PNAcknowledgmentStatus",
-    [PNPublishOperation] = @"PNPublishStatus",
-    [PNHistoryOperation] = @"PNErrorStatus",
-    [PNWhereNowOperation] = @"PNErrorStatus",
-    [PNHereNowGlobalOperation] = @"PNErrorStatus",
-    [PNHereNowForChannelOperation] = @"PNErrorStatus",
-    [PNHereNowForChannelGroupOperation] = @"PNErrorStatus",
-    [PNHeartbeatOperation] = @"PNAcknowledgmentStatus",
-    [PNSetStateOperation] = @"PNClientStateUpdateStatus",
-    [PNStateForChannelOperation] = @"PNErrorStatus",
-    [PNStateForChannelGroupOperation] = @"PNErrorStatus",
-    [PNAddChannelsToGroupOperation] = @"PNAcknowledgmentStatus",
-    [PNRemoveChannelsFromGroupOperation] = @"PNAcknowledgmentStatus",
-    [PNChannelGroupsOperation] = @"PNErrorStatus",
-    [PNRemoveGroupOperation] = @"PNAcknowledgmentStatus",
-    [PNChannelsForGroupOperation] = @"PNErrorStatus",
-    [PNPushNotificationEnabledChannelsOperation] = @"PNErrorStatus",
-    [PNAddPushNotificationsOnChannelsOperation] = @"PNAcknowledgmentStatus",
-    [PNRemovePushNotificationsFromChannelsOperation] = @"PNAcknowledgmentStatus",
-    [PNRemoveAllPushNotificationsOperation] = @"PNAcknowledgmentStatus",
-    [PNTimeOperation] = @"PNErrorStatus",
+/**
+ @brief      Description of operation which is used by network layer to build requests and process
+             responses.
+ @discussion Classes stored by names, because class references can't be used in static
+             initializers. Network manager resolve them once and cache in table with same layout.
+ 
+ @since 4.1.0
+ */
+typedef struct PNOperationDescriptor {
+    
+    /**
+     @brief  Stores human-readable operation name which is used in logs and objects description.
+     */
+    __unsafe_unretained NSString *name;
+    
+    /**
+     @brief  Stores short operation tag which is used to mark operation requests in logs.
+     */
+    __unsafe_unretained NSString *logTag;
+    
+    /**
+     @brief  Stores API endpoint template with path placeholders.
+     */
+    __unsafe_unretained NSString *requestTemplate;
+    
+    /**
+     @brief  Stores name of class which conforms to \b PNParser protocol and process responses.
+     */
+    __unsafe_unretained NSString *parser;
+    
+    /**
+     @brief  Stores name of class which represent request processing results (\c nil for
+             operations which doesn't expect result).
+     */
+    __unsafe_unretained NSString *resultClass;
+    
+    /**
+     @brief  Stores name of class which represent request processing status.
+     */
+    __unsafe_unretained NSString *statusClass;
+    
+    /**
+     @brief  Stores whether operation completion block expect result and status objects or status
+             only.
+     */
+    BOOL expectResult;
+    
+    /**
+     @brief  Stores network lane which should be used to process operation.
+     */
+    PNOperationLane lane;
+    
+    /**
+     @brief  Stores whether operation is idempotent read, so duplicate (hedged) request can be sent
+             for it.
+     */
+    BOOL idempotent;
+    
+    /**
+     @brief  Stores name of operations group which share circuit breaker for each origin (\c nil
+             for operations which never guarded by breaker).
+     */
+    __unsafe_unretained NSString *breakerGroup;
+} PNOperationDescriptor;
+
+/**
+ @brief  Operations description indexed by \b PNOperationType.
+ 
+ @since 4.1.0
+ */
+static PNOperationDescriptor const PNOperationDescriptors[] = {
+    [PNSubscribeOperation] = {
+        .name = @"Subscribe",
+        .logTag = @"subscribe",
+        .requestTemplate = @"/subscribe/{sub-key}/{channels}/0/{tt}",
+        .parser = @"PNSubscribeParser",
+        .statusClass = @"PNSubscribeStatus",
+        .expectResult = NO,
+        .lane = PNSubscriptionOperationLane
+    },
+    [PNUnsubscribeOperation] = {
+        .name = @"Unsubscribe",
+        .logTag = @"leave",
+        .requestTemplate = @"/v2/presence/sub_key/{sub-key}/channel/{channels}/leave",
+        .parser = @"PNLeaveParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNSubscriptionOperationLane
+    },
+    [PNPublishOperation] = {
+        .name = @"Publish",
+        .logTag = @"publish",
+        .requestTemplate = @"/publish/{pub-key}/{sub-key}/0/{channel}/0/{message}",
+        .parser = @"PNMessagePublishParser",
+        .statusClass = @"PNPublishStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"publish"
+    },
+    [PNHistoryOperation] = {
+        .name = @"History",
+        .logTag = @"history",
+        .requestTemplate = @"/v2/history/sub-key/{sub-key}/channel/{channel}",
+        .parser = @"PNHistoryParser",
+        .resultClass = @"PNHistoryResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"history"
+    },
+    [PNWhereNowOperation] = {
+        .name = @"Where Now",
+        .logTag = @"where-now",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}/uuid/{uuid}",
+        .parser = @"PNPresenceWhereNowParser",
+        .resultClass = @"PNPresenceWhereNowResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"presence"
+    },
+    [PNHereNowGlobalOperation] = {
+        .name = @"Global Here Now",
+        .logTag = @"here-now-global",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}",
+        .parser = @"PNPresenceHereNowParser",
+        .resultClass = @"PNPresenceGlobalHereNowResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"presence"
+    },
+    [PNHereNowForChannelOperation] = {
+        .name = @"Here Now for Channel",
+        .logTag = @"here-now-channel",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}/channel/{channel}",
+        .parser = @"PNPresenceHereNowParser",
+        .resultClass = @"PNPresenceChannelHereNowResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"presence"
+    },
+    [PNHereNowForChannelGroupOperation] = {
+        .name = @"Here Now for Channel Group",
+        .logTag = @"here-now-group",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}/channel/{channel}",
+        .parser = @"PNPresenceHereNowParser",
+        .resultClass = @"PNPresenceChannelGroupHereNowResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"presence"
+    },
+    [PNHeartbeatOperation] = {
+        .name = @"Heartbeat",
+        .logTag = @"heartbeat",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}/channel/{channels}/heartbeat",
+        .parser = @"PNHeartbeatParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"presence"
+    },
+    [PNSetStateOperation] = {
+        .name = @"Set State",
+        .logTag = @"set-state",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}/channel/{channel}/uuid/{uuid}/data",
+        .parser = @"PNClientStateParser",
+        .statusClass = @"PNClientStateUpdateStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"presence"
+    },
+    [PNStateForChannelOperation] = {
+        .name = @"Get State for Channel",
+        .logTag = @"state-channel",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}/channel/{channel}/uuid/{uuid}",
+        .parser = @"PNClientStateParser",
+        .resultClass = @"PNChannelClientStateResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"presence"
+    },
+    [PNStateForChannelGroupOperation] = {
+        .name = @"Get State for Channel Group",
+        .logTag = @"state-group",
+        .requestTemplate = @"/v2/presence/sub-key/{sub-key}/channel/{channel}/uuid/{uuid}",
+        .parser = @"PNClientStateParser",
+        .resultClass = @"PNChannelGroupClientStateResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"presence"
+    },
+    [PNAddChannelsToGroupOperation] = {
+        .name = @"Add Channels To Group",
+        .logTag = @"group-add",
+        .requestTemplate = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}",
+        .parser = @"PNChannelGroupModificationParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"channel-groups"
+    },
+    [PNRemoveChannelsFromGroupOperation] = {
+        .name = @"Remove Channels From Group",
+        .logTag = @"group-remove-channels",
+        .requestTemplate = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}",
+        .parser = @"PNChannelGroupModificationParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"channel-groups"
+    },
+    [PNChannelGroupsOperation] = {
+        .name = @"Get Groups",
+        .logTag = @"groups",
+        .requestTemplate = @"/v1/channel-registration/sub-key/{sub-key}/channel-group",
+        .parser = @"PNChannelGroupAuditionParser",
+        .resultClass = @"PNChannelGroupsResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"channel-groups"
+    },
+    [PNRemoveGroupOperation] = {
+        .name = @"Remove Channel Group",
+        .logTag = @"group-remove",
+        .requestTemplate = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}/remove",
+        .parser = @"PNChannelGroupModificationParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"channel-groups"
+    },
+    [PNChannelsForGroupOperation] = {
+        .name = @"Get Channels For Group",
+        .logTag = @"group-channels",
+        .requestTemplate = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}",
+        .parser = @"PNChannelGroupAuditionParser",
+        .resultClass = @"PNChannelGroupChannelsResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"channel-groups"
+    },
+    [PNPushNotificationEnabledChannelsOperation] = {
+        .name = @"Get Push Notification Enabled Channels",
+        .logTag = @"push-audit",
+        .requestTemplate = @"/v1/push/sub-key/{sub-key}/devices/{token}",
+        .parser = @"PNPushNotificationsAuditParser",
+        .resultClass = @"PNAPNSEnabledChannelsResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane,
+        .idempotent = YES,
+        .breakerGroup = @"push"
+    },
+    [PNAddPushNotificationsOnChannelsOperation] = {
+        .name = @"Enable Push Notifications On Channels",
+        .logTag = @"push-add",
+        .requestTemplate = @"/v1/push/sub-key/{sub-key}/devices/{token}",
+        .parser = @"PNPushNotificationsStateModificationParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"push"
+    },
+    [PNRemovePushNotificationsFromChannelsOperation] = {
+        .name = @"Remove Push Notifications From Channels",
+        .logTag = @"push-remove",
+        .requestTemplate = @"/v1/push/sub-key/{sub-key}/devices/{token}",
+        .parser = @"PNPushNotificationsStateModificationParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"push"
+    },
+    [PNRemoveAllPushNotificationsOperation] = {
+        .name = @"Remove All Push Notifications",
+        .logTag = @"push-remove-all",
+        .requestTemplate = @"/v1/push/sub-key/{sub-key}/devices/{token}/remove",
+        .parser = @"PNPushNotificationsStateModificationParser",
+        .statusClass = @"PNAcknowledgmentStatus",
+        .expectResult = NO,
+        .lane = PNServiceOperationLane,
+        .breakerGroup = @"push"
+    },
+    [PNTimeOperation] = {
+        .name = @"Time",
+        .logTag = @"time",
+        .requestTemplate = @"/time/0",
+        .parser = @"PNTimeParser",
+        .resultClass = @"PNTimeResult",
+        .statusClass = @"PNErrorStatus",
+        .expectResult = YES,
+        .lane = PNServiceOperationLane
+    },
 };
 
+/**
+ @brief      Number of entries in \b PNOperationDescriptors table.
+ @discussion Table size derived from designated initializers, so descriptor for new (last)
+             \b PNOperationType field won't be silently missed.
+ 
+ @since 4.1.0
+ */
+#define PNOperationDescriptorsCount (sizeof(PNOperationDescriptors) / sizeof(PNOperationDescriptor))
+_Static_assert(PNOperationDescriptorsCount == (PNTimeOperation + 1),
+               "PNOperationDescriptors should describe every PNOperationType field.");
+
 /**
  @brief  Helper to stringify status category.
 
  @since 4.0
  */
-static NSString * const PNStatusCategoryStrings[15] = {
+static NSString * const PNStatusCategoryStrings[17] = {
     [PNUnknownCategory] = @"Unknown",
     [PNAcknowledgmentCategory] = @"Acknowledgment",
     [PNAccessDeniedCategory] = @"Access Denied",
@@ -100,7 +375,9 @@ static NSString * const PNStatusCategoryStrings[15] = {
     [PNMalformedResponseCategory] = @"Malformed Response",
     [PNDecryptionErrorCategory] = @"Decryption Error",
     [PNTLSConnectionFailedCategory] = @"TLS Connection Failed",
-    [PNTLSUntrustedCertificateCategory] = @"Untrusted TLS Certificate"
+    [PNTLSUntrustedCertificateCategory] = @"Untrusted TLS Certificate",
+    [PNServiceUnavailableCategory] = @"Service Unavailable",
+    [PNCircuitBreakerStateChangedCategory] = @"Circuit Breaker State Changed"
 };
 
 /**
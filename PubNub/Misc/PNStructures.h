@@ -95,6 +95,13 @@ typedef NS_OPTIONS(NSUInteger, PNLogLevel){
      */
     PNAESErrorLogLevel = (NSUIntegerMax ^ (NSUIntegerMax >> 9 | (NSUIntegerMax ^ (NSUIntegerMax >> 8)))),
     
+    /**
+     @brief  \b PNLog level which allow to print out circuit breaker state changes.
+     
+     @since 4.1.0
+     */
+    PNCircuitBreakerLogLevel = (NSUIntegerMax ^ (NSUIntegerMax >> 10 | (NSUIntegerMax ^ (NSUIntegerMax >> 9)))),
+    
     /**
      @brief  Log every message from \b PubNub client.
      
@@ -102,7 +109,7 @@ typedef NS_OPTIONS(NSUInteger, PNLogLevel){
      */
     PNVerboseLogLevel = (PNInfoLogLevel|PNReachabilityLogLevel|PNRequestLogLevel|PNResultLogLevel|
                          PNStatusLogLevel|PNFailureStatusLogLevel|PNAPICallLogLevel|
-                         PNAESErrorLogLevel)
+                         PNAESErrorLogLevel|PNCircuitBreakerLogLevel)
 };
 
 /**
@@ -275,7 +282,29 @@ typedef NS_ENUM(NSInteger, PNStatusCategory) {
                  "nslookup pubsub.pubnub.com" status object debug description and mail to
                  support@pubnub.com
     */
-    PNTLSUntrustedCertificateCategory
+    PNTLSUntrustedCertificateCategory,
+    
+    /**
+     @brief      Status is sent in case if request hasn't been sent because circuit breaker for
+                 target origin is open.
+     @discussion Circuit breaker opens after series of timeouts, network issues or server errors
+                 and prevent client from sending requests to origin which is unable to process
+                 them. Request can be retried later.
+     
+     @since 4.1.0
+     */
+    PNServiceUnavailableCategory,
+    
+    /**
+     @brief      Status is sent to listeners when circuit breaker for one of origins change it's
+                 state.
+     @discussion \c errorData.information contain human-readable description and
+                 \c errorData.data contain dictionary with \c origin, \c operations (requests
+                 kind) and \c state (\c closed, \c open or \c half-open) keys.
+     
+     @since 4.1.0
+     */
+    PNCircuitBreakerStateChangedCategory
 };
 
 /**
@@ -310,6 +339,103 @@ typedef NS_ENUM(NSInteger, PNHereNowVerbosityLevel) {
     PNHereNowState
 };
 
+/**
+ @brief  Definition for transport which is used by client to deliver requests to \b PubNub service.
+ 
+ @since 4.1.0
+ */
+typedef NS_ENUM(NSInteger, PNTransport) {
+    
+    /**
+     @brief  Requests sent to \b PubNub network over HTTP(S).
+     
+     @since 4.1.0
+     */
+    PNHTTPTransport,
+    
+    /**
+     @brief  Requests processed by in-process broker which emulate \b PubNub service for clients
+             which use same subscribe key.
+     
+     @since 4.1.0
+     */
+    PNLoopbackTransport,
+    
+    /**
+     @brief  Requests answered with responses from traffic trace which has been loaded into
+             \b PNTrafficReplayer (responses delivered with recorded timings).
+     
+     @since 4.1.0
+     */
+    PNReplayTransport
+};
+
+/**
+ @brief  Definition for request lifecycle stages which is recorded by \b PNRequestTrace.
+ 
+ @since 4.1.0
+ */
+typedef NS_ENUM(NSInteger, PNRequestTraceStage) {
+    
+    /**
+     @brief  Request has been passed to network manager.
+     
+     @since 4.1.0
+     */
+    PNRequestEnqueuedStage,
+    
+    /**
+     @brief  Request has been passed to \a NSURLSession (or loopback broker).
+     
+     @since 4.1.0
+     */
+    PNRequestSentStage,
+    
+    /**
+     @brief  Response has been delivered by \a NSURLSession.
+     @note   Requests use completion handlers, so session deliver response when whole body has
+             been loaded.
+     
+     @since 4.1.0
+     */
+    PNResponseDeliveredStage,
+    
+    /**
+     @brief  Response body has been de-serialized on processing queue.
+     
+     @since 4.1.0
+     */
+    PNResponseDeserializedStage,
+    
+    /**
+     @brief  Service response has been processed by parser (including decryption).
+     
+     @since 4.1.0
+     */
+    PNResponseParsedStage,
+    
+    /**
+     @brief  Result and/or status objects has been created.
+     
+     @since 4.1.0
+     */
+    PNResultCreatedStage,
+    
+    /**
+     @brief  Real-time events from response has been passed to listeners queue.
+     
+     @since 4.1.0
+     */
+    PNListenerEnqueuedStage,
+    
+    /**
+     @brief  Completion block or listeners has been called on callback queue.
+     
+     @since 4.1.0
+     */
+    PNCallbackInvokedStage
+};
+
 /**
  @brief  Base block structure used by client for all API endpoints to handle request processing
          completion.
@@ -0,0 +1,100 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief  Opaque reference on timer scheduled with \b PNTimingWheel.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNTimingWheelTimer : NSObject
+
+
+#pragma mark -
+
+
+@end
+
+
+/**
+ @brief      Hierarchical timing wheel which is used by all \b PubNub client components for delayed
+             and periodic tasks.
+ @discussion Timers from all client instances stored in two level wheel which is served by single
+             dedicated thread. Timer schedule and cancel performed in constant time and all timers
+             which expire during same tick fired with single thread wake up. Thread sleep till
+             closest non-empty wheel slot and doesn't wake up at all when there is no timers.
+ @note       Timer blocks called on wheel's private concurrent queue (never on main thread or wheel
+             thread), so slow block doesn't delay timers of other clients. Block of same timer never
+             called concurrently: periodic timer fire skipped if previous call still running.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNTimingWheel : NSObject
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Retrieve reference on timing wheel which is shared by all clients in process.
+ 
+ @return Shared timing wheel.
+ 
+ @since 4.1.0
+ */
++ (instancetype)sharedWheel;
+
+
+///------------------------------------------------
+/// @name Timers
+///------------------------------------------------
+
+/**
+ @brief  Schedule \c block call after specified \c delay.
+ 
+ @param delay    Number of seconds after which \c block should be called first time.
+ @param interval Number of seconds between subsequent \c block calls. Timer will fire only once
+                 if \c 0 passed.
+ @param block    Reference on block which should be called when timer fire.
+ 
+ @return Reference on timer which can be used to cancel it.
+ 
+ @since 4.1.0
+ */
+- (PNTimingWheelTimer *)scheduleTimerWithDelay:(NSTimeInterval)delay
+                                      interval:(NSTimeInterval)interval
+                                         block:(dispatch_block_t)block;
+
+/**
+ @brief  Cancel previously scheduled timer.
+ @note   Block of cancelled timer won't be called, unless it's call already started.
+ 
+ @param timer Reference on timer which should be cancelled (can be \c nil).
+ 
+ @since 4.1.0
+ */
+- (void)cancelTimer:(PNTimingWheelTimer *)timer;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Retrieve wheel schedule information for introspection.
+ 
+ @return Dictionary with \c timers (number of scheduled timers), \c resolution and \c nextFire
+         (seconds till wheel thread wake up, not set if there is no timers) keys.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)introspectionSnapshot;
+
+#pragma mark -
+
+
+@end
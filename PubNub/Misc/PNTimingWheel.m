@@ -0,0 +1,545 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNTimingWheel.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores reference on wheel resolution (in seconds). Timers which expire during same tick
+         fired together.
+ 
+ @since 4.1.0
+ */
+static NSTimeInterval const kPNTimingWheelTickInterval = 0.1f;
+
+/**
+ @brief  Stores reference on number of bits which is used to address slot on each wheel level.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNTimingWheelLevelBits = 8;
+
+/**
+ @brief  Stores reference on number of slots on each wheel level.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNTimingWheelLevelSize = (1 << kPNTimingWheelLevelBits);
+
+/**
+ @brief  Stores reference on mask which is used to find slot on each wheel level.
+ 
+ @since 4.1.0
+ */
+static uint64_t const kPNTimingWheelLevelMask = (kPNTimingWheelLevelSize - 1);
+
+
+#pragma mark - Timer protected interface declaration
+
+@interface PNTimingWheelTimer ()
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores reference on wheel tick at which timer should fire.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) uint64_t expirationTick;
+
+/**
+ @brief  Stores reference on number of ticks between timer fires (\c 0 for one-shot timers).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) uint64_t intervalTicks;
+
+/**
+ @brief  Stores reference on block which should be called when timer fire.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) dispatch_block_t block;
+
+/**
+ @brief  Stores reference on wheel slot in which timer currently stored.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, weak) NSMutableSet *slot;
+
+/**
+ @brief  Stores whether timer has been cancelled or not.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign, getter = isCancelled) BOOL cancelled;
+
+/**
+ @brief  Stores whether timer's block is running at this moment or not.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign, getter = isFiring) BOOL firing;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNTimingWheel ()
+
+
+#pragma mark - Information
+
+/**
+ @brief      Stores reference on first wheel level slots.
+ @discussion Each slot represent single tick.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSArray *innerWheel;
+
+/**
+ @brief      Stores reference on second wheel level slots.
+ @discussion Each slot represent full rotation of \c innerWheel. Timers from this level cascade to
+             \c innerWheel when it complete rotation.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSArray *outerWheel;
+
+/**
+ @brief  Stores reference on last processed wheel tick.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) uint64_t currentTick;
+
+/**
+ @brief  Stores reference on system uptime at which wheel has been created.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval startTime;
+
+/**
+ @brief  Stores reference on number of timers which is stored in wheel.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger timersCount;
+
+/**
+ @brief  Stores reference on tick till which wheel thread sleep at this moment.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) uint64_t wakeUpTick;
+
+/**
+ @brief  Stores reference on condition which is used to protect wheel data and put wheel thread
+         to sleep.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSCondition *condition;
+
+/**
+ @brief      Stores reference on dedicated thread which serve timers.
+ @discussion Thread created and started with first scheduled timer.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSThread *thread;
+
+/**
+ @brief  Stores reference on queue on which timer blocks is called.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t callbackQueue;
+
+
+#pragma mark - Wheel
+
+/**
+ @brief  Calculate wheel tick which correspond to current time.
+ 
+ @return Current wheel tick.
+ 
+ @since 4.1.0
+ */
+- (uint64_t)tickForCurrentTime;
+
+/**
+ @brief  Place timer into wheel slot which correspond to it's expiration tick.
+ @note   This method should be called only while \c condition is locked.
+ 
+ @param timer Reference on timer which should be stored in wheel.
+ 
+ @since 4.1.0
+ */
+- (void)placeTimer:(PNTimingWheelTimer *)timer;
+
+/**
+ @brief  Find closest tick at which wheel thread should wake up.
+ @note   This method should be called only while \c condition is locked.
+ 
+ @return Closest tick at which non-empty slot or outer wheel cascade is located.
+ 
+ @since 4.1.0
+ */
+- (uint64_t)nextWakeUpTick;
+
+/**
+ @brief  Advance wheel to specified tick and collect all expired timers.
+ @note   This method should be called only while \c condition is locked.
+ 
+ @param tick Reference on tick to which wheel should be advanced.
+ 
+ @return List of expired timers.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)advanceToTick:(uint64_t)tick;
+
+/**
+ @brief      Call expired timer's block.
+ @discussion Cancelled flag checked under lock right before call, so timer which has been
+             cancelled before this moment won't fire.
+ 
+ @param timer Reference on timer which should fire.
+ 
+ @since 4.1.0
+ */
+- (void)fireTimer:(PNTimingWheelTimer *)timer;
+
+
+#pragma mark - Handlers
+
+/**
+ @brief  Wheel thread entry point.
+ 
+ @since 4.1.0
+ */
+- (void)handleThreadStart;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Timer interface implementation
+
+@implementation PNTimingWheelTimer
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNTimingWheel
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sharedWheel {
+    
+    static PNTimingWheel *_sharedWheel;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _sharedWheel = [self new];
+    });
+    
+    return _sharedWheel;
+}
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        NSMutableArray *innerWheel = [NSMutableArray arrayWithCapacity:kPNTimingWheelLevelSize];
+        NSMutableArray *outerWheel = [NSMutableArray arrayWithCapacity:kPNTimingWheelLevelSize];
+        for (NSUInteger slotIdx = 0; slotIdx < kPNTimingWheelLevelSize; slotIdx++) {
+            
+            [innerWheel addObject:[NSMutableSet new]];
+            [outerWheel addObject:[NSMutableSet new]];
+        }
+        _innerWheel = [innerWheel copy];
+        _outerWheel = [outerWheel copy];
+        _startTime = [[NSProcessInfo processInfo] systemUptime];
+        _wakeUpTick = UINT64_MAX;
+        _condition = [NSCondition new];
+        _callbackQueue = dispatch_queue_create("com.pubnub.timing-wheel.callbacks",
+                                               DISPATCH_QUEUE_CONCURRENT);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Timers
+
+- (PNTimingWheelTimer *)scheduleTimerWithDelay:(NSTimeInterval)delay
+                                      interval:(NSTimeInterval)interval
+                                         block:(dispatch_block_t)block {
+    
+    PNTimingWheelTimer *timer = [PNTimingWheelTimer new];
+    timer.block = block;
+    timer.intervalTicks = (uint64_t)ceil(MAX(interval, 0.0f) / kPNTimingWheelTickInterval);
+    uint64_t delayTicks = (uint64_t)ceil(MAX(delay, 0.0f) / kPNTimingWheelTickInterval);
+    
+    [self.condition lock];
+    if (!self.thread) {
+        
+        self.thread = [[NSThread alloc] initWithTarget:self selector:@selector(handleThreadStart)
+                                                object:nil];
+        self.thread.name = @"com.pubnub.timing-wheel";
+        [self.thread start];
+    }
+    if (!self.timersCount) {
+        
+        // Empty wheel can be moved to current time without processing of skipped ticks.
+        self.currentTick = MAX(self.currentTick, [self tickForCurrentTime]);
+    }
+    timer.expirationTick = (MAX(self.currentTick, [self tickForCurrentTime]) + MAX(delayTicks, 1));
+    [self placeTimer:timer];
+    self.timersCount++;
+    
+    // Wake up wheel thread only if new timer should fire before it planned to wake up.
+    if (timer.expirationTick < self.wakeUpTick) {
+        
+        [self.condition signal];
+    }
+    [self.condition unlock];
+    
+    return timer;
+}
+
+- (void)cancelTimer:(PNTimingWheelTimer *)timer {
+    
+    if (timer) {
+        
+        [self.condition lock];
+        if (!timer.isCancelled) {
+            
+            timer.cancelled = YES;
+            timer.block = nil;
+            if (timer.slot) {
+                
+                [timer.slot removeObject:timer];
+                timer.slot = nil;
+                self.timersCount--;
+            }
+        }
+        [self.condition unlock];
+    }
+}
+
+
+#pragma mark - Information
+
+- (NSDictionary *)introspectionSnapshot {
+    
+    NSMutableDictionary *snapshot = [NSMutableDictionary new];
+    [self.condition lock];
+    snapshot[@"timers"] = @(self.timersCount);
+    snapshot[@"resolution"] = @(kPNTimingWheelTickInterval);
+    if (self.timersCount && self.wakeUpTick != UINT64_MAX) {
+        
+        uint64_t tick = [self tickForCurrentTime];
+        uint64_t ticksTillWakeUp = (self.wakeUpTick > tick ? (self.wakeUpTick - tick) : 0);
+        snapshot[@"nextFire"] = @(ticksTillWakeUp * kPNTimingWheelTickInterval);
+    }
+    [self.condition unlock];
+    
+    return [snapshot copy];
+}
+
+
+#pragma mark - Wheel
+
+- (uint64_t)tickForCurrentTime {
+    
+    NSTimeInterval elapsed = ([[NSProcessInfo processInfo] systemUptime] - self.startTime);
+    
+    return (uint64_t)(elapsed / kPNTimingWheelTickInterval);
+}
+
+- (void)placeTimer:(PNTimingWheelTimer *)timer {
+    
+    uint64_t ticksLeft = (timer.expirationTick - self.currentTick);
+    NSMutableSet *slot = nil;
+    if (ticksLeft < kPNTimingWheelLevelSize) {
+        
+        slot = self.innerWheel[(NSUInteger)(timer.expirationTick & kPNTimingWheelLevelMask)];
+    }
+    else {
+        
+        // Timers which is too far in future stored in last outer slot and re-placed on each
+        // cascade till they will fit into wheel.
+        uint64_t rotation = (timer.expirationTick >> kPNTimingWheelLevelBits);
+        uint64_t lastRotation = ((self.currentTick >> kPNTimingWheelLevelBits) +
+                                 kPNTimingWheelLevelMask);
+        rotation = MIN(rotation, lastRotation);
+        slot = self.outerWheel[(NSUInteger)(rotation & kPNTimingWheelLevelMask)];
+    }
+    [slot addObject:timer];
+    timer.slot = slot;
+}
+
+- (uint64_t)nextWakeUpTick {
+    
+    uint64_t wakeUpTick = UINT64_MAX;
+    if (self.timersCount) {
+        
+        // Wheel thread should wake up at least on inner wheel rotation end to cascade outer slot.
+        wakeUpTick = ((self.currentTick | kPNTimingWheelLevelMask) + 1);
+        for (uint64_t tick = self.currentTick + 1; tick < wakeUpTick; tick++) {
+            
+            if ([self.innerWheel[(NSUInteger)(tick & kPNTimingWheelLevelMask)] count]) {
+                
+                wakeUpTick = tick;
+                break;
+            }
+        }
+    }
+    
+    return wakeUpTick;
+}
+
+- (NSArray *)advanceToTick:(uint64_t)tick {
+    
+    NSMutableArray *expiredTimers = [NSMutableArray new];
+    while (self.currentTick < tick && self.timersCount) {
+        
+        self.currentTick++;
+        if ((self.currentTick & kPNTimingWheelLevelMask) == 0) {
+            
+            // Inner wheel completed rotation, move timers from outer slot into inner wheel.
+            NSUInteger outerSlotIdx = (NSUInteger)((self.currentTick >> kPNTimingWheelLevelBits) &
+                                                   kPNTimingWheelLevelMask);
+            NSMutableSet *outerSlot = self.outerWheel[outerSlotIdx];
+            NSArray *cascadingTimers = [outerSlot allObjects];
+            [outerSlot removeAllObjects];
+            for (PNTimingWheelTimer *timer in cascadingTimers) {
+                
+                [self placeTimer:timer];
+            }
+        }
+        
+        NSUInteger slotIdx = (NSUInteger)(self.currentTick & kPNTimingWheelLevelMask);
+        NSMutableSet *slot = self.innerWheel[slotIdx];
+        if ([slot count]) {
+            
+            for (PNTimingWheelTimer *timer in slot) {
+                
+                timer.slot = nil;
+            }
+            [expiredTimers addObjectsFromArray:[slot allObjects]];
+            self.timersCount -= [slot count];
+            [slot removeAllObjects];
+        }
+    }
+    
+    self.currentTick = MAX(self.currentTick, tick);
+    
+    return [expiredTimers copy];
+}
+
+- (void)fireTimer:(PNTimingWheelTimer *)timer {
+    
+    dispatch_block_t block = nil;
+    [self.condition lock];
+    if (!timer.isCancelled && !timer.isFiring) {
+        
+        block = timer.block;
+        timer.firing = (block != nil);
+    }
+    [self.condition unlock];
+    
+    if (block) {
+        
+        block();
+        [self.condition lock];
+        timer.firing = NO;
+        [self.condition unlock];
+    }
+}
+
+
+#pragma mark - Handlers
+
+- (void)handleThreadStart {
+    
+    [self.condition lock];
+    while (YES) {
+        
+        @autoreleasepool {
+            
+            uint64_t wakeUpTick = [self nextWakeUpTick];
+            uint64_t tick = [self tickForCurrentTime];
+            if (wakeUpTick > tick) {
+                
+                self.wakeUpTick = wakeUpTick;
+                if (wakeUpTick == UINT64_MAX) {
+                    
+                    [self.condition wait];
+                }
+                else {
+                    
+                    NSTimeInterval delay = ((wakeUpTick - tick) * kPNTimingWheelTickInterval);
+                    [self.condition waitUntilDate:[NSDate dateWithTimeIntervalSinceNow:delay]];
+                }
+                self.wakeUpTick = UINT64_MAX;
+                tick = [self tickForCurrentTime];
+            }
+            
+            NSArray *expiredTimers = [self advanceToTick:tick];
+            if ([expiredTimers count]) {
+                
+                // Re-schedule periodic timers before their blocks will be called, so they can be
+                // cancelled from inside of the block.
+                for (PNTimingWheelTimer *timer in expiredTimers) {
+                    
+                    if (timer.intervalTicks > 0) {
+                        
+                        timer.expirationTick = (self.currentTick + timer.intervalTicks);
+                        [self placeTimer:timer];
+                        self.timersCount++;
+                    }
+                }
+                
+                // Blocks called on concurrent queue, so slow block doesn't delay wheel thread and
+                // timers of other clients.
+                for (PNTimingWheelTimer *timer in expiredTimers) {
+                    
+                    dispatch_async(self.callbackQueue, ^{
+                        
+                        [self fireTimer:timer];
+                    });
+                }
+            }
+        }
+    }
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,106 @@
+/**
+ @brief      Static tracepoints which is placed across request and event lifecycle.
+ @discussion Probes registered for \b pubnub provider with \c sys/sdt.h (USDT) and compiled into
+             single \c nop instruction which is patched only while tracer (bpftrace, perf, SystemTap
+             or DTrace) attached to the process. Probe arguments limited to integers and C strings.
+             Scripts which build latency breakdowns from these probes can be found in
+             \c scripts/tracing.
+ @note       On Linux probes enabled by default when \c sys/sdt.h is available. On Darwin probes
+             registered with DTrace provider (\c scripts/tracing/pubnub.d) and enabled when
+             \c PNTraceProvider.h has been generated from it with
+             \c scripts/tracing/generate_provider.sh (\c dtrace \c -h); each probe check whether
+             it is enabled before arguments evaluated. Otherwise all probe macros (and their
+             arguments) removed by preprocessor.
+ 
+ Probes:
+ @code
+ request__enqueue(operation, bodyBytes)
+ request__send(operation, bodyBytes, hedgeDelayMs)
+ request__done(operation, statusCode, receivedBytes, durationUs)
+ request__fail(operation, errorCode, statusCode, durationUs)
+ parse__start(parser, isAsynchronous)
+ parse__end(parser, isSuccess)
+ subscribe__start(isInitial, timetoken, objectsCount)
+ subscribe__end(category, isError, eventsCount)
+ timetoken__advance(previousTimetoken, timetoken)
+ listener__start(kind, listenersCount)
+ listener__end(kind, listenersCount)
+ aes__start(operation, inputBytes)
+ aes__end(operation, outputBytes, status)
+ @endcode
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#ifndef PNTrace_h
+#define PNTrace_h
+
+#if !defined(PN_TRACE_PROBES_ENABLED) && defined(__has_include)
+    #if defined(__linux__) && __has_include(<sys/sdt.h>)
+        #define PN_TRACE_PROBES_ENABLED 1
+    #elif defined(__APPLE__) && __has_include("PNTraceProvider.h")
+        #define PN_TRACE_PROBES_ENABLED 1
+        #define PN_TRACE_DTRACE_PROVIDER 1
+    #endif // defined(__linux__) && __has_include(<sys/sdt.h>)
+#endif // !defined(PN_TRACE_PROBES_ENABLED) && defined(__has_include)
+
+
+#pragma mark Probe macro declaration
+
+#if PN_TRACE_PROBES_ENABLED && PN_TRACE_DTRACE_PROVIDER
+    #import "PNTraceProvider.h"
+    
+    // Header generated by dtrace declare separate upper-case macros for each probe.
+    #define PNTraceProbe_request__enqueue PUBNUB_REQUEST_ENQUEUE
+    #define PNTraceProbe_request__send PUBNUB_REQUEST_SEND
+    #define PNTraceProbe_request__done PUBNUB_REQUEST_DONE
+    #define PNTraceProbe_request__fail PUBNUB_REQUEST_FAIL
+    #define PNTraceProbe_parse__start PUBNUB_PARSE_START
+    #define PNTraceProbe_parse__end PUBNUB_PARSE_END
+    #define PNTraceProbe_subscribe__start PUBNUB_SUBSCRIBE_START
+    #define PNTraceProbe_subscribe__end PUBNUB_SUBSCRIBE_END
+    #define PNTraceProbe_timetoken__advance PUBNUB_TIMETOKEN_ADVANCE
+    #define PNTraceProbe_listener__start PUBNUB_LISTENER_START
+    #define PNTraceProbe_listener__end PUBNUB_LISTENER_END
+    #define PNTraceProbe_aes__start PUBNUB_AES_START
+    #define PNTraceProbe_aes__end PUBNUB_AES_END
+    #define PNTraceEnabled_request__enqueue PUBNUB_REQUEST_ENQUEUE_ENABLED
+    #define PNTraceEnabled_request__send PUBNUB_REQUEST_SEND_ENABLED
+    #define PNTraceEnabled_request__done PUBNUB_REQUEST_DONE_ENABLED
+    #define PNTraceEnabled_request__fail PUBNUB_REQUEST_FAIL_ENABLED
+    #define PNTraceEnabled_parse__start PUBNUB_PARSE_START_ENABLED
+    #define PNTraceEnabled_parse__end PUBNUB_PARSE_END_ENABLED
+    #define PNTraceEnabled_subscribe__start PUBNUB_SUBSCRIBE_START_ENABLED
+    #define PNTraceEnabled_subscribe__end PUBNUB_SUBSCRIBE_END_ENABLED
+    #define PNTraceEnabled_timetoken__advance PUBNUB_TIMETOKEN_ADVANCE_ENABLED
+    #define PNTraceEnabled_listener__start PUBNUB_LISTENER_START_ENABLED
+    #define PNTraceEnabled_listener__end PUBNUB_LISTENER_END_ENABLED
+    #define PNTraceEnabled_aes__start PUBNUB_AES_START_ENABLED
+    #define PNTraceEnabled_aes__end PUBNUB_AES_END_ENABLED
+    
+    #define PNTraceDTrace(name, ...) \
+        do { if (PNTraceEnabled_##name()) { PNTraceProbe_##name(__VA_ARGS__); } } while(0)
+    #define PNTrace2(name, a1, a2) PNTraceDTrace(name, a1, a2)
+    #define PNTrace3(name, a1, a2, a3) PNTraceDTrace(name, a1, a2, a3)
+    #define PNTrace4(name, a1, a2, a3, a4) PNTraceDTrace(name, a1, a2, a3, a4)
+#elif PN_TRACE_PROBES_ENABLED
+    #import <sys/sdt.h>
+    
+    #define PNTrace2(name, a1, a2) DTRACE_PROBE2(pubnub, name, a1, a2)
+    #define PNTrace3(name, a1, a2, a3) DTRACE_PROBE3(pubnub, name, a1, a2, a3)
+    #define PNTrace4(name, a1, a2, a3, a4) DTRACE_PROBE4(pubnub, name, a1, a2, a3, a4)
+#else
+    #define PNTrace2(name, a1, a2) do {} while(0)
+    #define PNTrace3(name, a1, a2, a3) do {} while(0)
+    #define PNTrace4(name, a1, a2, a3, a4) do {} while(0)
+#endif // PN_TRACE_PROBES_ENABLED && PN_TRACE_DTRACE_PROVIDER
+
+/**
+ @brief  Convert time interval (in seconds) to integer number of microseconds for probe argument.
+ 
+ @since 4.1.0
+ */
+#define PNTraceMicroseconds(interval) ((int64_t)((interval) * 1000000.0f))
+
+#endif // PNTrace_h
@@ -4,7 +4,8 @@
 
 #pragma mark Class forward
 
-@class PNPresenceEventResult, PNSubscribeStatus, PNMessageResult, PNErrorStatus;
+@class PNPresenceEventResult, PNPresenceDeltaResult, PNSubscribeStatus, PNMessageResult,
+       PNErrorStatus;
 
 
 /**
@@ -48,6 +49,22 @@
  */
 - (void)client:(PubNub *)client didReceivePresenceEvent:(PNPresenceEventResult *)event;
 
+/**
+ @brief      Notify listener about presence events which has been collapsed for one of remote data
+             object's presence live feed during aggregation window.
+ @discussion Callback called in addition to \c -client:didReceivePresenceEvent: (if listener
+             implement both of them). Server-side \c interval events (with joined, left and timed
+             out UUIDs lists) collapsed along with separate events. Aggregation window can be
+             configured with \b PNConfiguration \c presenceEventsAggregationWindow property.
+ 
+ @param client Reference on \b PubNub client which triggered this callback method call.
+ @param delta  Reference on \b PNResult instance which store joined / left UUIDs, occupancy and 
+               state changes in \c data property.
+ 
+ @since 4.1.0
+ */
+- (void)client:(PubNub *)client didReceivePresenceDelta:(PNPresenceDeltaResult *)delta;
+
 
 ///------------------------------------------------
 /// @name Status change handler.
@@ -5,8 +5,8 @@
 /**
  @brief      Interface delcaration for all classes which should be suitable for \b PubNub service
              response processing.
- @discussion Classes which conform to this protocol will be gathered at run-time and used when
-             response on corresponding operation will arrive.
+ @discussion Classes which conform to this protocol referenced by \b PNOperationDescriptors table
+             and used when response on corresponding operation will arrive.
  
  @author Sergey Mamontov
  @since 4.0
@@ -21,15 +21,6 @@
 /// @name Identification
 ///------------------------------------------------
 
-/**
- @brief  Allow to identify for what kind of operations this parser is suitable.
- 
- @return List of \b PNOperationType enum fields to represent operations.
- 
- @since 4.0
- */
-+ (NSArray *)operations;
-
 /**
  @brief  Allow to check whether corresponding parser require additional data from caller to process
          seevice response or not.
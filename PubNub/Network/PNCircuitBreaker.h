@@ -0,0 +1,179 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+/**
+ @brief  Circuit breaker states.
+ 
+ @since 4.1.0
+ */
+typedef NS_ENUM(NSInteger, PNCircuitBreakerState) {
+    
+    /**
+     @brief  Requests sent as usual and consecutive failures counted.
+     
+     @since 4.1.0
+     */
+    PNCircuitBreakerClosedState,
+    
+    /**
+     @brief  Requests fail right away without sending them to origin.
+     
+     @since 4.1.0
+     */
+    PNCircuitBreakerOpenState,
+    
+    /**
+     @brief  Single trial request allowed to check whether origin recovered or not.
+     
+     @since 4.1.0
+     */
+    PNCircuitBreakerHalfOpenState
+};
+
+/**
+ @brief  Helper to stringify circuit breaker state.
+ 
+ @since 4.1.0
+ */
+static NSString * const PNCircuitBreakerStateStrings[3] = {
+    [PNCircuitBreakerClosedState] = @"closed",
+    [PNCircuitBreakerOpenState] = @"open",
+    [PNCircuitBreakerHalfOpenState] = @"half-open"
+};
+
+/**
+ @brief  Circuit breaker state change handling block.
+ 
+ @param operation  One of \b PNOperationType enum fields which represent type of operation which
+                   caused state change.
+ @param origin     Host name (or address) of origin which is guarded by breaker.
+ @param operations Kind of operations which is guarded by breaker.
+ @param state      One of \b PNCircuitBreakerState enum fields which represent new breaker state.
+ 
+ @since 4.1.0
+ */
+typedef void(^PNCircuitBreakerStateChangeBlock)(PNOperationType operation, NSString *origin,
+                                                NSString *operations, PNCircuitBreakerState state);
+
+
+/**
+ @brief      Circuit breaker for \b PubNub service requests.
+ @discussion Breaker track consecutive failures (timeouts, network issues and server errors) of
+             requests for each origin and kind of operations (publish, history, presence, channel
+             groups and push notifications) separately. After configured number of failures
+             breaker opens and requests fail right away. When open interval expire, breaker
+             allow single trial request (half-open state) which decide whether breaker should be
+             closed or opened again.
+ @note       Subscribe and time requests never guarded, because they used by subscription and
+             reachability code with own retry logic.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNCircuitBreaker : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on block which is called each time when one of breakers change it's state.
+ @note   Block called on queue from which request has been sent or it's completion reported.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) PNCircuitBreakerStateChangeBlock stateChangeBlock;
+
+/**
+ @brief      Retrieve circuit breakers metrics.
+ @discussion Dictionary use \c "<origin>/<operations>" keys and dictionaries with \c state,
+             \c failures, \c opened (number of times when breaker has been opened) and
+             \c rejected (number of requests which failed right away) keys as values.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSDictionary *statistics;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Construct circuit breaker.
+ 
+ @param threshold    Number of consecutive failures after which breaker opens.
+ @param openInterval Number of seconds during which breaker stay open before trial request will be
+                     allowed.
+ 
+ @return Constructed and ready to use circuit breaker.
+ 
+ @since 4.1.0
+ */
++ (instancetype)breakerWithFailureThreshold:(NSUInteger)threshold
+                               openInterval:(NSTimeInterval)openInterval;
+
+
+///------------------------------------------------
+/// @name Requests guard
+///------------------------------------------------
+
+/**
+ @brief      Check whether request for \c operation can be sent to \c origin or not.
+ @discussion If breaker allow trial request in half-open state, caller should report it's
+             completion with one of handler methods.
+ 
+ @param operation One of \b PNOperationType enum fields which represent type of operation which
+                  will be sent.
+ @param origin    Host name (or address) of origin to which request will be sent.
+ 
+ @return \c NO in case if breaker is open and request should fail right away.
+ 
+ @since 4.1.0
+ */
+- (BOOL)allowRequestForOperation:(PNOperationType)operation toOrigin:(NSString *)origin;
+
+
+///------------------------------------------------
+/// @name Handlers
+///------------------------------------------------
+
+/**
+ @brief  Handle response received from \c origin (any response except server errors).
+ 
+ @param operation One of \b PNOperationType enum fields which represent type of completed
+                  operation.
+ @param origin    Host name (or address) of origin which sent response.
+ 
+ @since 4.1.0
+ */
+- (void)handleSuccessOfOperation:(PNOperationType)operation fromOrigin:(NSString *)origin;
+
+/**
+ @brief  Handle request failure because of timeout, network issues or server error.
+ 
+ @param operation One of \b PNOperationType enum fields which represent type of failed operation.
+ @param origin    Host name (or address) of origin to which request has been sent.
+ 
+ @since 4.1.0
+ */
+- (void)handleFailureOfOperation:(PNOperationType)operation fromOrigin:(NSString *)origin;
+
+/**
+ @brief  Handle request which has been completed without verdict about origin health (for example
+         cancelled request).
+ 
+ @param operation One of \b PNOperationType enum fields which represent type of operation.
+ @param origin    Host name (or address) of origin to which request has been sent.
+ 
+ @since 4.1.0
+ */
+- (void)handleCancellationOfOperation:(PNOperationType)operation fromOrigin:(NSString *)origin;
+
+#pragma mark -
+
+
+@end
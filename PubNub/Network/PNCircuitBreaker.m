@@ -0,0 +1,393 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNCircuitBreaker.h"
+#import "PNPrivateStructures.h"
+#import "PNLog.h"
+
+
+#pragma mark CocoaLumberjack logging support
+
+/**
+ @brief  Cocoa Lumberjack logging level configuration for circuit breaker.
+ 
+ @since 4.1.0
+ */
+static DDLogLevel ddLogLevel = (DDLogLevel)PNCircuitBreakerLogLevel;
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNCircuitBreaker ()
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores number of consecutive failures after which breaker opens.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger threshold;
+
+/**
+ @brief  Stores number of seconds during which breaker stay open.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval openInterval;
+
+/**
+ @brief      Stores reference on breakers information.
+ @discussion \c "<origin>/<operations>" is a key and mutable dictionary with \c state,
+             \c failures, \c opened, \c rejected, \c openDate and \c trial keys is a value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *breakers;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to breakers information.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize circuit breaker.
+ 
+ @param threshold    Number of consecutive failures after which breaker opens.
+ @param openInterval Number of seconds during which breaker stay open before trial request will be
+                     allowed.
+ 
+ @return Initialized and ready to use circuit breaker.
+ 
+ @since 4.1.0
+ */
+- (instancetype)initWithFailureThreshold:(NSUInteger)threshold
+                            openInterval:(NSTimeInterval)openInterval;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve name of operations kind which is guarded by same breaker.
+ 
+ @param operation One of \b PNOperationType enum fields for which kind should be found.
+ 
+ @return Kind name or \c nil in case if \c operation shouldn't be guarded.
+ 
+ @since 4.1.0
+ */
+- (NSString *)operationsForOperation:(PNOperationType)operation;
+
+/**
+ @brief  Retrieve (create if required) breaker information for \c origin and kind of operations.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @param operations Kind of operations which is guarded by breaker.
+ @param origin     Host name (or address) of origin which is guarded by breaker.
+ 
+ @return Mutable dictionary with breaker information.
+ 
+ @since 4.1.0
+ */
+- (NSMutableDictionary *)breakerForOperations:(NSString *)operations origin:(NSString *)origin;
+
+/**
+ @brief  Change state of breaker and report it with \c stateChangeBlock.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @param breaker    Reference on breaker information which should be changed.
+ @param state      One of \b PNCircuitBreakerState enum fields which should be applied.
+ @param operations Kind of operations which is guarded by breaker.
+ @param origin     Host name (or address) of origin which is guarded by breaker.
+ @param operation  One of \b PNOperationType enum fields which represent type of operation which
+                   caused state change.
+ 
+ @return Block which should be called outside of resource access queue to report state change.
+ 
+ @since 4.1.0
+ */
+- (dispatch_block_t)changeState:(PNCircuitBreakerState)state ofBreaker:(NSMutableDictionary *)breaker
+                  forOperations:(NSString *)operations origin:(NSString *)origin
+                      operation:(PNOperationType)operation;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNCircuitBreaker
+
+
+#pragma mark - Logger
+
+/**
+ @brief  Called by Cocoa Lumberjack during initialization.
+ 
+ @return Desired logger level for \b PubNub client main class.
+ 
+ @since 4.1.0
+ */
++ (DDLogLevel)ddLogLevel {
+    
+    return ddLogLevel;
+}
+
+/**
+ @brief  Allow modify logger level used by Cocoa Lumberjack with logging macros.
+ 
+ @param logLevel New log level which should be used by logger.
+ 
+ @since 4.1.0
+ */
++ (void)ddSetLogLevel:(DDLogLevel)logLevel {
+    
+    ddLogLevel = logLevel;
+}
+
+
+#pragma mark - Information
+
+- (NSDictionary *)statistics {
+    
+    NSMutableDictionary *statistics = [NSMutableDictionary new];
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        [self.breakers enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSDictionary *breaker,
+                                                           __unused BOOL *stop) {
+            
+            PNCircuitBreakerState state = (PNCircuitBreakerState)[breaker[@"state"] integerValue];
+            statistics[key] = @{@"state": PNCircuitBreakerStateStrings[state],
+                                @"failures": breaker[@"failures"], @"opened": breaker[@"opened"],
+                                @"rejected": breaker[@"rejected"]};
+        }];
+    });
+    
+    return [statistics copy];
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)breakerWithFailureThreshold:(NSUInteger)threshold
+                               openInterval:(NSTimeInterval)openInterval {
+    
+    return [[self alloc] initWithFailureThreshold:threshold openInterval:openInterval];
+}
+
+- (instancetype)initWithFailureThreshold:(NSUInteger)threshold
+                            openInterval:(NSTimeInterval)openInterval {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _threshold = MAX(threshold, (NSUInteger)1);
+        _openInterval = openInterval;
+        _breakers = [NSMutableDictionary new];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.circuit-breaker",
+                                                     DISPATCH_QUEUE_CONCURRENT);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Requests guard
+
+- (BOOL)allowRequestForOperation:(PNOperationType)operation toOrigin:(NSString *)origin {
+    
+    NSString *operations = [self operationsForOperation:operation];
+    if (!operations || !origin) {
+        
+        return YES;
+    }
+    
+    __block BOOL allowed = YES;
+    __block dispatch_block_t stateChangeReport = nil;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        NSMutableDictionary *breaker = [self breakerForOperations:operations origin:origin];
+        PNCircuitBreakerState state = (PNCircuitBreakerState)[breaker[@"state"] integerValue];
+        if (state == PNCircuitBreakerOpenState &&
+            -[breaker[@"openDate"] timeIntervalSinceNow] >= self.openInterval) {
+            
+            stateChangeReport = [self changeState:PNCircuitBreakerHalfOpenState ofBreaker:breaker
+                                    forOperations:operations origin:origin
+                                        operation:operation];
+            state = PNCircuitBreakerHalfOpenState;
+        }
+        
+        if (state == PNCircuitBreakerHalfOpenState) {
+            
+            // Only one trial request allowed at a time, all other fail right away.
+            allowed = ![breaker[@"trial"] boolValue];
+            breaker[@"trial"] = @YES;
+        }
+        else {
+            
+            allowed = (state == PNCircuitBreakerClosedState);
+        }
+        
+        if (!allowed) {
+            
+            breaker[@"rejected"] = @([breaker[@"rejected"] unsignedIntegerValue] + 1);
+        }
+    });
+    
+    if (stateChangeReport) {
+        
+        stateChangeReport();
+    }
+    
+    return allowed;
+}
+
+
+#pragma mark - Handlers
+
+- (void)handleSuccessOfOperation:(PNOperationType)operation fromOrigin:(NSString *)origin {
+    
+    NSString *operations = [self operationsForOperation:operation];
+    if (!operations || !origin) {
+        
+        return;
+    }
+    
+    __block dispatch_block_t stateChangeReport = nil;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        NSMutableDictionary *breaker = [self breakerForOperations:operations origin:origin];
+        PNCircuitBreakerState state = (PNCircuitBreakerState)[breaker[@"state"] integerValue];
+        breaker[@"failures"] = @0;
+        if (state == PNCircuitBreakerHalfOpenState) {
+            
+            stateChangeReport = [self changeState:PNCircuitBreakerClosedState ofBreaker:breaker
+                                    forOperations:operations origin:origin
+                                        operation:operation];
+        }
+    });
+    
+    if (stateChangeReport) {
+        
+        stateChangeReport();
+    }
+}
+
+- (void)handleFailureOfOperation:(PNOperationType)operation fromOrigin:(NSString *)origin {
+    
+    NSString *operations = [self operationsForOperation:operation];
+    if (!operations || !origin) {
+        
+        return;
+    }
+    
+    __block dispatch_block_t stateChangeReport = nil;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        NSMutableDictionary *breaker = [self breakerForOperations:operations origin:origin];
+        PNCircuitBreakerState state = (PNCircuitBreakerState)[breaker[@"state"] integerValue];
+        NSUInteger failures = ([breaker[@"failures"] unsignedIntegerValue] + 1);
+        breaker[@"failures"] = @(failures);
+        if (state == PNCircuitBreakerHalfOpenState ||
+            (state == PNCircuitBreakerClosedState && failures >= self.threshold)) {
+            
+            stateChangeReport = [self changeState:PNCircuitBreakerOpenState ofBreaker:breaker
+                                    forOperations:operations origin:origin
+                                        operation:operation];
+        }
+    });
+    
+    if (stateChangeReport) {
+        
+        stateChangeReport();
+    }
+}
+
+- (void)handleCancellationOfOperation:(PNOperationType)operation fromOrigin:(NSString *)origin {
+    
+    NSString *operations = [self operationsForOperation:operation];
+    if (!operations || !origin) {
+        
+        return;
+    }
+    
+    dispatch_barrier_async(self.resourceAccessQueue, ^{
+        
+        // Trial request didn't provide any information about origin, so next one should be
+        // allowed.
+        [[self breakerForOperations:operations origin:origin] removeObjectForKey:@"trial"];
+    });
+}
+
+
+#pragma mark - Misc
+
+- (NSString *)operationsForOperation:(PNOperationType)operation {
+    
+    NSString *operations = nil;
+    if (operation >= 0 && (NSUInteger)operation < PNOperationDescriptorsCount) {
+        
+        operations = PNOperationDescriptors[operation].breakerGroup;
+    }
+    
+    return operations;
+}
+
+- (NSMutableDictionary *)breakerForOperations:(NSString *)operations origin:(NSString *)origin {
+    
+    NSString *key = [NSString stringWithFormat:@"%@/%@", origin, operations];
+    NSMutableDictionary *breaker = self.breakers[key];
+    if (!breaker) {
+        
+        breaker = [@{@"state": @(PNCircuitBreakerClosedState), @"failures": @0, @"opened": @0,
+                     @"rejected": @0} mutableCopy];
+        self.breakers[key] = breaker;
+    }
+    
+    return breaker;
+}
+
+- (dispatch_block_t)changeState:(PNCircuitBreakerState)state ofBreaker:(NSMutableDictionary *)breaker
+                  forOperations:(NSString *)operations origin:(NSString *)origin
+                      operation:(PNOperationType)operation {
+    
+    breaker[@"state"] = @(state);
+    [breaker removeObjectForKey:@"trial"];
+    if (state == PNCircuitBreakerOpenState) {
+        
+        breaker[@"openDate"] = [NSDate date];
+        breaker[@"opened"] = @([breaker[@"opened"] unsignedIntegerValue] + 1);
+    }
+    else if (state == PNCircuitBreakerClosedState) {
+        
+        [breaker removeObjectForKey:@"openDate"];
+    }
+    DDLogCircuitBreaker([[self class] ddLogLevel], @"<PubNub> Circuit breaker for %@ requests to "
+                        "%@ is %@ (%@ failure(s) in a row).", operations, origin,
+                        PNCircuitBreakerStateStrings[state], breaker[@"failures"]);
+    
+    PNCircuitBreakerStateChangeBlock stateChangeBlock = self.stateChangeBlock;
+    
+    return ^{
+        
+        if (stateChangeBlock) {
+            
+            stateChangeBlock(operation, origin, operations, state);
+        }
+    };
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,83 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+/**
+ @brief      Hedged requests policy for idempotent read operations.
+ @discussion Policy track latency of recently completed read requests for each operation type and
+             calculate delay (95th percentile) after which duplicate request can be sent if there
+             is no response on original request yet. Number of duplicate requests limited with
+             budget: each read request earn fraction of hedge (configured percentage) and each
+             duplicate request spend whole hedge, so load rises by at most configured percentage.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNHedgingPolicy : NSObject
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Construct hedged requests policy.
+ 
+ @param budget Maximum percentage of additional requests which can be sent by policy.
+ 
+ @return Constructed and ready to use hedged requests policy.
+ 
+ @since 4.1.0
+ */
++ (instancetype)policyWithBudget:(NSInteger)budget;
+
+
+///------------------------------------------------
+/// @name Hedging
+///------------------------------------------------
+
+/**
+ @brief      Retrieve delay after which duplicate request can be sent for \c operation.
+ @discussion Call to this method also mean what new request will be sent and increase budget.
+ 
+ @param operation One of \b PNOperationType enum fields which represent type of operation which
+                  will be sent.
+ 
+ @return Number of seconds after which duplicate request can be sent or \b 0 if \c operation can't
+         be hedged (it is not idempotent read or there is not enough latency measurements).
+ 
+ @since 4.1.0
+ */
+- (NSTimeInterval)hedgeDelayForOperation:(PNOperationType)operation;
+
+/**
+ @brief  Try to spend budget on duplicate request.
+ 
+ @return \c YES in case if budget allow to send one more duplicate request.
+ 
+ @since 4.1.0
+ */
+- (BOOL)acquireHedge;
+
+
+///------------------------------------------------
+/// @name Handlers
+///------------------------------------------------
+
+/**
+ @brief  Handle response for one of read requests.
+ 
+ @param operation     One of \b PNOperationType enum fields which represent type of completed
+                      operation.
+ @param roundTripTime Number of seconds passed since request has been sent.
+ 
+ @since 4.1.0
+ */
+- (void)handleResponseForOperation:(PNOperationType)operation
+                 withRoundTripTime:(NSTimeInterval)roundTripTime;
+
+#pragma mark -
+
+
+@end
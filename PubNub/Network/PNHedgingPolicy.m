@@ -0,0 +1,237 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNHedgingPolicy.h"
+#import <libkern/OSAtomic.h>
+#import "PNPrivateStructures.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of latency measurements which is stored for each operation type.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNHedgingMaximumSamplesCount = 100;
+
+/**
+ @brief  Stores minimum number of latency measurements which is required to calculate hedge delay.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNHedgingMinimumSamplesCount = 20;
+
+/**
+ @brief  Stores percentile of latency measurements which is used as hedge delay.
+ 
+ @since 4.1.0
+ */
+static double const kPNHedgingDelayPercentile = 0.95f;
+
+/**
+ @brief  Stores maximum number of hedges which can be accumulated in budget (allow short bursts of
+         slow responses).
+ 
+ @since 4.1.0
+ */
+static double const kPNHedgingMaximumBudget = 10.0f;
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNHedgingPolicy ()
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores fraction of hedge which is earned with every read request.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double hedgePerRequest;
+
+/**
+ @brief  Stores number of hedges which currently available in budget.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double availableHedges;
+
+/**
+ @brief      Stores reference on hedge delays calculated from latency measurements.
+ @discussion Operation type is a key and number of seconds is a value. Delay re-calculated when new
+             measurement arrive, so requests only read it.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *hedgeDelays;
+
+/**
+ @brief  Stores reference on lock which is used to protect budget and hedge delays.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) OSSpinLock lock;
+
+/**
+ @brief      Stores reference on latency measurements.
+ @discussion Operation type is a key and mutable array with measurements (from oldest to newest) is
+             a value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *samples;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to latency measurements.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize hedged requests policy.
+ 
+ @param budget Maximum percentage of additional requests which can be sent by policy.
+ 
+ @return Initialized and ready to use hedged requests policy.
+ 
+ @since 4.1.0
+ */
+- (instancetype)initWithBudget:(NSInteger)budget;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Check whether specified operation is idempotent read and can be hedged or not.
+ 
+ @param operation Operation type against which check should be performed.
+ 
+ @return \c YES in case if duplicate request can be sent for \c operation.
+ 
+ @since 4.1.0
+ */
+- (BOOL)canHedgeOperation:(PNOperationType)operation;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNHedgingPolicy
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)policyWithBudget:(NSInteger)budget {
+    
+    return [[self alloc] initWithBudget:budget];
+}
+
+- (instancetype)initWithBudget:(NSInteger)budget {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _hedgePerRequest = ((double)MAX(budget, 0) / 100.0f);
+        _hedgeDelays = [NSMutableDictionary new];
+        _lock = OS_SPINLOCK_INIT;
+        _samples = [NSMutableDictionary new];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.hedging-policy",
+                                                     DISPATCH_QUEUE_CONCURRENT);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Hedging
+
+- (NSTimeInterval)hedgeDelayForOperation:(PNOperationType)operation {
+    
+    NSTimeInterval delay = 0.0f;
+    if (self.hedgePerRequest > 0.0f && [self canHedgeOperation:operation]) {
+        
+        OSSpinLockLock(&_lock);
+        _availableHedges = MIN(_availableHedges + _hedgePerRequest, kPNHedgingMaximumBudget);
+        delay = [_hedgeDelays[@(operation)] doubleValue];
+        OSSpinLockUnlock(&_lock);
+    }
+    
+    return delay;
+}
+
+- (BOOL)acquireHedge {
+    
+    BOOL acquired = NO;
+    OSSpinLockLock(&_lock);
+    if (_availableHedges >= 1.0f) {
+        
+        _availableHedges -= 1.0f;
+        acquired = YES;
+    }
+    OSSpinLockUnlock(&_lock);
+    
+    return acquired;
+}
+
+
+#pragma mark - Handlers
+
+- (void)handleResponseForOperation:(PNOperationType)operation
+                 withRoundTripTime:(NSTimeInterval)roundTripTime {
+    
+    if (self.hedgePerRequest > 0.0f && [self canHedgeOperation:operation]) {
+        
+        dispatch_barrier_async(self.resourceAccessQueue, ^{
+            
+            NSMutableArray *samples = self.samples[@(operation)];
+            if (!samples) {
+                
+                samples = [NSMutableArray new];
+                self.samples[@(operation)] = samples;
+            }
+            [samples addObject:@(roundTripTime)];
+            if ([samples count] > kPNHedgingMaximumSamplesCount) {
+                
+                [samples removeObjectAtIndex:0];
+            }
+            
+            // Delay re-calculated here, so requests only read it.
+            if ([samples count] >= kPNHedgingMinimumSamplesCount) {
+                
+                NSArray *sortedSamples = [samples sortedArrayUsingSelector:@selector(compare:)];
+                NSUInteger count = [sortedSamples count];
+                NSUInteger sampleIdx = MIN((NSUInteger)(count * kPNHedgingDelayPercentile),
+                                           count - 1);
+                OSSpinLockLock(&self->_lock);
+                self->_hedgeDelays[@(operation)] = sortedSamples[sampleIdx];
+                OSSpinLockUnlock(&self->_lock);
+            }
+        });
+    }
+}
+
+
+#pragma mark - Misc
+
+- (BOOL)canHedgeOperation:(PNOperationType)operation {
+    
+    return PNOperationDescriptors[operation].idempotent;
+}
+
+#pragma mark -
+
+
+@end
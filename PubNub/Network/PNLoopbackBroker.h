@@ -0,0 +1,96 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+#pragma mark Class forward
+
+@class PNRequestParameters;
+
+
+/**
+ @brief  Loopback request processing completion block.
+ 
+ @param response De-serialized service response (same as \b PubNub network would send) or \c nil in
+                 case of error.
+ @param error    Reference on request processing error (for example if request has been
+                 cancelled).
+ 
+ @since 4.1.0
+ */
+typedef void(^PNLoopbackCompletionBlock)(id response, NSError *error);
+
+
+/**
+ @brief      In-process \b PubNub service emulator.
+ @discussion Broker used by clients which configured with \b PNLoopbackTransport and process
+             requests which has been built for \b PubNub network (same path and query parameters)
+             without sending them over network. Broker keep separate storage for each subscribe
+             key and support: publish with time tokens, long-poll subscribe (with catch up from
+             time token), history, channel groups, presence (join, leave, timeout and state-change
+             events, here now and where now), client state and push notifications registration.
+ @note       Broker doesn't perform access rights validation and doesn't send push notifications.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNLoopbackBroker : NSObject
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Retrieve reference on broker which is shared by all clients in process.
+ 
+ @return Shared broker instance.
+ 
+ @since 4.1.0
+ */
++ (instancetype)sharedBroker;
+
+
+///------------------------------------------------
+/// @name Requests processing
+///------------------------------------------------
+
+/**
+ @brief      Process request for specified \c operation.
+ @discussion Subscribe requests held by broker till new events will be available for them or
+             \c timeout expire (in this case empty events list will be returned, same as
+             \b PubNub network do). All other requests completed right away.
+ @note       Completion block called on private broker queue.
+ 
+ @param operation  One of \b PNOperationType enum fields which describe what kind of request should
+                   be processed.
+ @param parameters Reference on request parameters (path components and query) which has been
+                   prepared for \b PubNub network request.
+ @param data       Reference on data which should be sent along with request (for example
+                   compressed publish message).
+ @param timeout    Maximum number of seconds during which subscribe request can be held.
+ @param block      Reference on block which should be called at the end of request processing.
+ 
+ @return Reference on opaque request object which can be used to cancel it.
+ 
+ @since 4.1.0
+ */
+- (id)processOperation:(PNOperationType)operation withParameters:(PNRequestParameters *)parameters
+                  data:(NSData *)data timeout:(NSTimeInterval)timeout
+            completion:(PNLoopbackCompletionBlock)block;
+
+/**
+ @brief      Cancel request which still waiting for response.
+ @discussion Request completion block will be called with \c NSURLErrorCancelled error.
+ 
+ @param request Reference on opaque request object which has been returned by
+                \c -processOperation:withParameters:data:timeout:completion:.
+ 
+ @since 4.1.0
+ */
+- (void)cancelRequest:(id)request;
+
+#pragma mark -
+
+
+@end
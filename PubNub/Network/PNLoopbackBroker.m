@@ -0,0 +1,1092 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNLoopbackBroker.h"
+#import "PNRequestParameters.h"
+#import "PNTimingWheel.h"
+#import "PNHelpers.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of events which is stored for each subscribe key to serve catch up
+         subscribe requests.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNLoopbackMaximumEventsCount = 1000;
+
+/**
+ @brief  Stores maximum number of messages which is stored in history for each channel.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNLoopbackMaximumHistoryCount = 1000;
+
+/**
+ @brief  Stores number of seconds after which client will be removed from channel presence if
+         subscribe request didn't specify \c heartbeat value.
+ 
+ @since 4.1.0
+ */
+static NSInteger const kPNLoopbackDefaultPresenceTimeout = 300;
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNLoopbackBroker ()
+
+
+#pragma mark - Information
+
+/**
+ @brief      Stores reference on storage for each subscribe key.
+ @discussion Subscribe key is a key and mutable dictionary with \c messages (history for each
+             channel), \c events (recent live feed events), \c groups (channels registered for
+             channel groups), \c presence (presence expiration dates for each channel),
+             \c states (client state for each channel), \c push (channels for each device push
+             token) and \c requests (pending subscribe requests) keys is a value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *keyspaces;
+
+/**
+ @brief  Stores last time token which has been issued by broker.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) unsigned long long timetoken;
+
+/**
+ @brief  Stores reference on timer which is used to expire clients presence.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNTimingWheelTimer *presenceTimer;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to broker storage.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+/**
+ @brief  Stores reference on queue which is used to call requests completion blocks in order in
+         which they has been completed.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t callbackQueue;
+
+
+#pragma mark - Requests processing
+
+/**
+ @brief  Process request which has been prepared for \b PubNub network.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @param request  Reference on opaque request object (stores operation type and completion block).
+ @param path     Reference on request path components.
+ @param query    Reference on request query parameters.
+ @param data     Reference on data which has been sent along with request.
+ @param keyspace Reference on storage for subscribe key which has been used for request.
+ 
+ @return De-serialized service response or \c nil in case if request should be held.
+ 
+ @since 4.1.0
+ */
+- (id)responseForRequest:(NSMutableDictionary *)request withPath:(NSDictionary *)path
+                   query:(NSDictionary *)query data:(NSData *)data
+                keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Store published message and deliver it to subscribers.
+ 
+ @return Publish acknowledgment response.
+ 
+ @since 4.1.0
+ */
+- (id)publishResponseWithPath:(NSDictionary *)path query:(NSDictionary *)query data:(NSData *)data
+                     keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Fetch messages from channel's history.
+ 
+ @return History response.
+ 
+ @since 4.1.0
+ */
+- (id)historyResponseWithPath:(NSDictionary *)path query:(NSDictionary *)query
+                     keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Update client presence and state and try to find events which is available since time token
+         from request.
+ 
+ @return Subscribe response or \c nil in case if request has been held.
+ 
+ @since 4.1.0
+ */
+- (id)subscribeResponseForRequest:(NSMutableDictionary *)request withPath:(NSDictionary *)path
+                            query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Compose presence information for channels, channel groups or whole subscribe key.
+ 
+ @return Here now response.
+ 
+ @since 4.1.0
+ */
+- (id)hereNowResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                            query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Update or fetch client state.
+ 
+ @return Client state response.
+ 
+ @since 4.1.0
+ */
+- (id)stateResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                          query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Modify or audit channel groups.
+ 
+ @return Channel group response.
+ 
+ @since 4.1.0
+ */
+- (id)channelGroupResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                                 query:(NSDictionary *)query
+                              keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Modify or audit channels on which push notifications enabled for device.
+ 
+ @return Push notifications response.
+ 
+ @since 4.1.0
+ */
+- (id)pushResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                         query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Complete request and call it's completion block.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @param request  Reference on opaque request object which should be completed.
+ @param response De-serialized service response.
+ @param error    Reference on request processing error.
+ 
+ @since 4.1.0
+ */
+- (void)completeRequest:(NSMutableDictionary *)request withResponse:(id)response
+                  error:(NSError *)error;
+
+
+#pragma mark - Events
+
+/**
+ @brief  Store live feed event and deliver it to subscribers which wait for it.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @param event    Reference on event payload (published message or presence event).
+ @param channel  Name of channel on which event has been generated.
+ @param keyspace Reference on storage for subscribe key in which event has been generated.
+ 
+ @return Time token which has been assigned to event.
+ 
+ @since 4.1.0
+ */
+- (unsigned long long)storeEvent:(id)event forChannel:(NSString *)channel
+                      inKeyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Compose subscribe response for events which arrived after time token used by request.
+ 
+ @param request  Reference on opaque subscribe request object.
+ @param keyspace Reference on storage for subscribe key which has been used for request.
+ 
+ @return Subscribe response or \c nil in case if there is no events for request.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)eventsForRequest:(NSDictionary *)request inKeyspace:(NSDictionary *)keyspace;
+
+/**
+ @brief  Find name of channel or channel group through which subscribe request receive events from
+         \c channel.
+ 
+ @return Channel or channel group name or \c nil in case if request not subscribed on \c channel.
+ 
+ @since 4.1.0
+ */
+- (NSString *)subscriptionForChannel:(NSString *)channel ofRequest:(NSDictionary *)request
+                          inKeyspace:(NSDictionary *)keyspace;
+
+
+#pragma mark - Presence
+
+/**
+ @brief  Extend client presence on specified channels and generate \c join event for channels on
+         which client wasn't present.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @since 4.1.0
+ */
+- (void)refreshPresenceOf:(NSString *)uuid onChannels:(NSArray *)channels
+              withTimeout:(NSInteger)timeout inKeyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Remove client presence from specified channels and generate presence \c action event.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @since 4.1.0
+ */
+- (void)removePresenceOf:(NSString *)uuid fromChannels:(NSArray *)channels
+              withAction:(NSString *)action inKeyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Generate presence event on presence channel of \c channel.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @since 4.1.0
+ */
+- (void)storePresenceEvent:(NSString *)action forUUID:(NSString *)uuid onChannel:(NSString *)channel
+                 withState:(NSDictionary *)state inKeyspace:(NSMutableDictionary *)keyspace;
+
+/**
+ @brief  Remove clients which didn't refresh their presence in time.
+ 
+ @since 4.1.0
+ */
+- (void)handlePresenceTimer;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve reference on storage for specified subscribe key (create if required).
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @since 4.1.0
+ */
+- (NSMutableDictionary *)keyspaceForSubscribeKey:(NSString *)subscribeKey;
+
+/**
+ @brief  Issue new time token which is larger than any previously issued time token.
+ @note   This method should be called only from resource access queue within barrier block.
+ 
+ @since 4.1.0
+ */
+- (unsigned long long)nextTimetoken;
+
+/**
+ @brief  Retrieve list of channels which should be used for presence of client subscribed on
+         specified channels and channel groups (presence channels and groups ignored).
+ 
+ @since 4.1.0
+ */
+- (NSArray *)presenceChannelsFrom:(NSArray *)channels groups:(NSArray *)groups
+                       inKeyspace:(NSDictionary *)keyspace;
+
+/**
+ @brief  Retrieve percent-decoded string from request parameter value.
+ 
+ @since 4.1.0
+ */
+- (NSString *)stringFrom:(id)value;
+
+/**
+ @brief  Retrieve list of percent-decoded names from comma-separated request parameter value.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)namesFrom:(id)value;
+
+/**
+ @brief  Retrieve de-serialized object from percent-encoded JSON string.
+ 
+ @since 4.1.0
+ */
+- (id)objectFrom:(id)value;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNLoopbackBroker
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sharedBroker {
+    
+    static PNLoopbackBroker *_sharedBroker;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _sharedBroker = [self new];
+    });
+    
+    return _sharedBroker;
+}
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _keyspaces = [NSMutableDictionary new];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.loopback-broker",
+                                                     DISPATCH_QUEUE_CONCURRENT);
+        _callbackQueue = dispatch_queue_create("com.pubnub.loopback-broker.callback",
+                                               DISPATCH_QUEUE_SERIAL);
+        __weak __typeof(self) weakSelf = self;
+        _presenceTimer = [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:1.0f interval:1.0f
+                                                                       block:^{
+            
+            [weakSelf handlePresenceTimer];
+        }];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    [[PNTimingWheel sharedWheel] cancelTimer:_presenceTimer];
+}
+
+
+#pragma mark - Requests processing
+
+- (id)processOperation:(PNOperationType)operation withParameters:(PNRequestParameters *)parameters
+                  data:(NSData *)data timeout:(NSTimeInterval)timeout
+            completion:(PNLoopbackCompletionBlock)block {
+    
+    NSMutableDictionary *request = [@{@"operation": @(operation), @"timeout": @(timeout)}
+                                    mutableCopy];
+    if (block) {
+        
+        request[@"block"] = [block copy];
+    }
+    NSDictionary *path = [parameters.pathComponents copy];
+    NSDictionary *query = [parameters.query copy];
+    dispatch_barrier_async(self.resourceAccessQueue, ^{
+        
+        NSString *subscribeKey = [self stringFrom:path[@"{sub-key}"]];
+        NSMutableDictionary *keyspace = [self keyspaceForSubscribeKey:subscribeKey];
+        id response = [self responseForRequest:request withPath:path query:query data:data
+                                      keyspace:keyspace];
+        if (response) {
+            
+            [self completeRequest:request withResponse:response error:nil];
+        }
+    });
+    
+    return request;
+}
+
+- (void)cancelRequest:(id)request {
+    
+    if (request) {
+        
+        dispatch_barrier_async(self.resourceAccessQueue, ^{
+            
+            NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled
+                                             userInfo:nil];
+            [self completeRequest:request withResponse:nil error:error];
+        });
+    }
+}
+
+- (id)responseForRequest:(NSMutableDictionary *)request withPath:(NSDictionary *)path
+                   query:(NSDictionary *)query data:(NSData *)data
+                keyspace:(NSMutableDictionary *)keyspace {
+    
+    id response = nil;
+    NSString *uuid = [self stringFrom:(path[@"{uuid}"]?: query[@"uuid"])];
+    PNOperationType operation = (PNOperationType)[request[@"operation"] integerValue];
+    switch (operation) {
+        case PNSubscribeOperation:
+            
+            response = [self subscribeResponseForRequest:request withPath:path query:query
+                                                keyspace:keyspace];
+            break;
+        case PNUnsubscribeOperation:
+        case PNHeartbeatOperation:
+            {
+                NSArray *groups = [self namesFrom:query[@"channel-group"]];
+                NSArray *channels = [self presenceChannelsFrom:[self namesFrom:path[@"{channels}"]]
+                                                        groups:groups inKeyspace:keyspace];
+                if (operation == PNUnsubscribeOperation) {
+                    
+                    [self removePresenceOf:uuid fromChannels:channels withAction:@"leave"
+                                inKeyspace:keyspace];
+                }
+                else {
+                    
+                    NSInteger timeout = [[self stringFrom:query[@"heartbeat"]] integerValue];
+                    [self refreshPresenceOf:uuid onChannels:channels
+                                withTimeout:(timeout?: kPNLoopbackDefaultPresenceTimeout)
+                                 inKeyspace:keyspace];
+                }
+                response = @{@"status": @200, @"message": @"OK", @"service": @"Presence"};
+            }
+            break;
+        case PNPublishOperation:
+            
+            response = [self publishResponseWithPath:path query:query data:data keyspace:keyspace];
+            break;
+        case PNHistoryOperation:
+            
+            response = [self historyResponseWithPath:path query:query keyspace:keyspace];
+            break;
+        case PNWhereNowOperation:
+            {
+                NSMutableArray *channels = [NSMutableArray new];
+                [keyspace[@"presence"] enumerateKeysAndObjectsUsingBlock:^(NSString *channel,
+                                                                           NSDictionary *uuids,
+                                                                           __unused BOOL *stop) {
+                    
+                    if (uuids[uuid]) {
+                        
+                        [channels addObject:channel];
+                    }
+                }];
+                response = @{@"status": @200, @"payload": @{@"channels": channels},
+                             @"service": @"Presence"};
+            }
+            break;
+        case PNHereNowGlobalOperation:
+        case PNHereNowForChannelOperation:
+        case PNHereNowForChannelGroupOperation:
+            
+            response = [self hereNowResponseForOperation:operation withPath:path query:query
+                                                keyspace:keyspace];
+            break;
+        case PNSetStateOperation:
+        case PNStateForChannelOperation:
+        case PNStateForChannelGroupOperation:
+            
+            response = [self stateResponseForOperation:operation withPath:path query:query
+                                              keyspace:keyspace];
+            break;
+        case PNAddChannelsToGroupOperation:
+        case PNRemoveChannelsFromGroupOperation:
+        case PNChannelGroupsOperation:
+        case PNRemoveGroupOperation:
+        case PNChannelsForGroupOperation:
+            
+            response = [self channelGroupResponseForOperation:operation withPath:path query:query
+                                                     keyspace:keyspace];
+            break;
+        case PNPushNotificationEnabledChannelsOperation:
+        case PNAddPushNotificationsOnChannelsOperation:
+        case PNRemovePushNotificationsFromChannelsOperation:
+        case PNRemoveAllPushNotificationsOperation:
+            
+            response = [self pushResponseForOperation:operation withPath:path query:query
+                                             keyspace:keyspace];
+            break;
+        case PNTimeOperation:
+            
+            response = @[@([self nextTimetoken])];
+            break;
+        default:
+            
+            response = @{@"status": @400, @"error": @YES, @"message": @"Invalid Arguments"};
+            break;
+    }
+    
+    return response;
+}
+
+- (id)publishResponseWithPath:(NSDictionary *)path query:(NSDictionary *)query data:(NSData *)data
+                     keyspace:(NSMutableDictionary *)keyspace {
+    
+    // Compressed messages sent in request body and doesn't require percent-decoding.
+    NSString *messageString = [self stringFrom:path[@"{message}"]];
+    if ([data length]) {
+        
+        NSData *messageData = ([PNGZIP GZIPInflatedData:data]?: data);
+        messageString = [[NSString alloc] initWithData:messageData encoding:NSUTF8StringEncoding];
+    }
+    NSString *channel = [self stringFrom:path[@"{channel}"]];
+    id message = ([PNJSON JSONObjectFrom:messageString withError:NULL]?: messageString);
+    if (![channel length] || !message) {
+        
+        return @{@"status": @400, @"error": @YES, @"message": @"Invalid Message"};
+    }
+    
+    unsigned long long timetoken = [self storeEvent:message forChannel:channel inKeyspace:keyspace];
+    if (![[self stringFrom:query[@"store"]] isEqualToString:@"0"]) {
+        
+        NSMutableArray *messages = keyspace[@"messages"][channel];
+        if (!messages) {
+            
+            messages = [NSMutableArray new];
+            keyspace[@"messages"][channel] = messages;
+        }
+        [messages addObject:@{@"message": message, @"timetoken": @(timetoken)}];
+        if ([messages count] > kPNLoopbackMaximumHistoryCount) {
+            
+            [messages removeObjectAtIndex:0];
+        }
+    }
+    
+    return @[@1, @"Sent", [@(timetoken) stringValue]];
+}
+
+- (id)historyResponseWithPath:(NSDictionary *)path query:(NSDictionary *)query
+                     keyspace:(NSMutableDictionary *)keyspace {
+    
+    NSString *channel = [self stringFrom:path[@"{channel}"]];
+    NSString *start = [self stringFrom:query[@"start"]];
+    NSString *end = [self stringFrom:query[@"end"]];
+    NSInteger limit = [[self stringFrom:query[@"count"]] integerValue];
+    BOOL reverse = [[self stringFrom:query[@"reverse"]] isEqualToString:@"true"];
+    BOOL includeToken = [[self stringFrom:query[@"include_token"]] isEqualToString:@"true"];
+    
+    // Same as PubNub service, 'start' is exclusive and 'end' is inclusive time frame boundary.
+    NSMutableArray *entries = [NSMutableArray new];
+    for (NSDictionary *entry in keyspace[@"messages"][channel]) {
+        
+        unsigned long long timetoken = [entry[@"timetoken"] unsignedLongLongValue];
+        if ((!start || timetoken < strtoull([start UTF8String], NULL, 10)) &&
+            (!end || timetoken >= strtoull([end UTF8String], NULL, 10))) {
+            
+            [entries addObject:entry];
+        }
+    }
+    NSUInteger count = MIN([entries count], (NSUInteger)(limit > 0 ? limit : 100));
+    NSRange range = NSMakeRange((reverse ? 0 : [entries count] - count), count);
+    NSArray *messages = [entries subarrayWithRange:range];
+    
+    return @[(includeToken ? messages : [messages valueForKey:@"message"]),
+             ([messages firstObject][@"timetoken"]?: @0),
+             ([messages lastObject][@"timetoken"]?: @0)];
+}
+
+- (id)subscribeResponseForRequest:(NSMutableDictionary *)request withPath:(NSDictionary *)path
+                            query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace {
+    
+    NSString *uuid = [self stringFrom:query[@"uuid"]];
+    NSArray *channels = [self namesFrom:path[@"{channels}"]];
+    NSArray *groups = [self namesFrom:query[@"channel-group"]];
+    NSInteger timeout = [[self stringFrom:query[@"heartbeat"]] integerValue];
+    unsigned long long timetoken = strtoull([[self stringFrom:path[@"{tt}"]] UTF8String], NULL, 10);
+    [request addEntriesFromDictionary:@{@"channels": channels, @"groups": groups,
+                                        @"timetoken": @(timetoken),
+                                        @"keyspace": keyspace}];
+    
+    // Client state passed along with subscribe request for channels and channel groups.
+    NSDictionary *state = [self objectFrom:query[@"state"]];
+    if ([state isKindOfClass:[NSDictionary class]]) {
+        
+        [state enumerateKeysAndObjectsUsingBlock:^(NSString *object, NSDictionary *objectState,
+                                                   __unused BOOL *stop) {
+            
+            NSArray *objectChannels = ([groups containsObject:object] ?
+                                       keyspace[@"groups"][object] : @[object]);
+            for (NSString *channel in objectChannels) {
+                
+                if (!keyspace[@"states"][channel]) {
+                    
+                    keyspace[@"states"][channel] = [NSMutableDictionary new];
+                }
+                keyspace[@"states"][channel][uuid] = objectState;
+            }
+        }];
+    }
+    [self refreshPresenceOf:uuid
+                 onChannels:[self presenceChannelsFrom:channels groups:groups inKeyspace:keyspace]
+                withTimeout:(timeout?: kPNLoopbackDefaultPresenceTimeout) inKeyspace:keyspace];
+    
+    // Initial subscription receive only time token which should be used for next requests.
+    id response = nil;
+    if (timetoken == 0) {
+        
+        response = @[@[], [@([self nextTimetoken]) stringValue]];
+    }
+    else if (!(response = [self eventsForRequest:request inKeyspace:keyspace])) {
+        
+        [keyspace[@"requests"] addObject:request];
+        __weak __typeof(self) weakSelf = self;
+        NSTimeInterval holdInterval = [request[@"timeout"] doubleValue];
+        request[@"timer"] = [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:holdInterval
+                                                                       interval:0.0f block:^{
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            dispatch_barrier_async(strongSelf.resourceAccessQueue, ^{
+                
+                // Same as PubNub service, held request completed with empty events list.
+                unsigned long long lastTimetoken = MAX(strongSelf.timetoken, timetoken);
+                [strongSelf completeRequest:request
+                               withResponse:@[@[], [@(lastTimetoken) stringValue]] error:nil];
+            });
+        }];
+    }
+    
+    return response;
+}
+
+- (id)hereNowResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                            query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace {
+    
+    BOOL includeUUIDs = ![[self stringFrom:query[@"disable_uuids"]] isEqualToString:@"1"];
+    BOOL includeState = [[self stringFrom:query[@"state"]] isEqualToString:@"1"];
+    NSArray *channels = [[keyspace[@"presence"] allKeys] copy];
+    if (operation == PNHereNowForChannelOperation) {
+        
+        channels = [self namesFrom:path[@"{channel}"]];
+    }
+    else if (operation == PNHereNowForChannelGroupOperation) {
+        
+        channels = [self presenceChannelsFrom:nil groups:[self namesFrom:query[@"channel-group"]]
+                                   inKeyspace:keyspace];
+    }
+    
+    NSMutableDictionary *channelsData = [NSMutableDictionary new];
+    NSUInteger totalOccupancy = 0;
+    for (NSString *channel in channels) {
+        
+        NSArray *uuids = [keyspace[@"presence"][channel] allKeys];
+        NSMutableDictionary *channelData = [@{@"occupancy": @([uuids count])} mutableCopy];
+        if (includeUUIDs) {
+            
+            NSMutableArray *uuidsData = [NSMutableArray new];
+            for (NSString *uuid in uuids) {
+                
+                NSDictionary *state = keyspace[@"states"][channel][uuid];
+                [uuidsData addObject:(!includeState ? uuid :
+                                      (state ? @{@"uuid": uuid, @"state": state} :
+                                       @{@"uuid": uuid}))];
+            }
+            channelData[@"uuids"] = uuidsData;
+        }
+        totalOccupancy += [uuids count];
+        channelsData[channel] = channelData;
+    }
+    
+    // Single channel presence information returned without payload wrapper.
+    NSMutableDictionary *response = [@{@"status": @200, @"message": @"OK",
+                                       @"service": @"Presence"} mutableCopy];
+    if (operation == PNHereNowForChannelOperation && [channels count] == 1) {
+        
+        [response addEntriesFromDictionary:channelsData[channels[0]]];
+    }
+    else {
+        
+        response[@"payload"] = @{@"channels": channelsData,
+                                 @"total_channels": @([channelsData count]),
+                                 @"total_occupancy": @(totalOccupancy)};
+    }
+    
+    return response;
+}
+
+- (id)stateResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                          query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace {
+    
+    NSString *uuid = [self stringFrom:path[@"{uuid}"]];
+    NSArray *channels = [self namesFrom:path[@"{channel}"]];
+    NSArray *groups = [self namesFrom:query[@"channel-group"]];
+    NSArray *groupChannels = [self presenceChannelsFrom:nil groups:groups inKeyspace:keyspace];
+    NSArray *allChannels = [channels arrayByAddingObjectsFromArray:groupChannels];
+    NSMutableDictionary *response = [@{@"status": @200, @"message": @"OK",
+                                       @"service": @"Presence"} mutableCopy];
+    if (operation == PNSetStateOperation) {
+        
+        NSDictionary *state = [self objectFrom:query[@"state"]];
+        state = ([state isKindOfClass:[NSDictionary class]] ? state : @{});
+        for (NSString *channel in allChannels) {
+            
+            if (!keyspace[@"states"][channel]) {
+                
+                keyspace[@"states"][channel] = [NSMutableDictionary new];
+            }
+            keyspace[@"states"][channel][uuid] = ([state count] ? state : nil);
+            if (keyspace[@"presence"][channel][uuid]) {
+                
+                [self storePresenceEvent:@"state-change" forUUID:uuid onChannel:channel
+                               withState:state inKeyspace:keyspace];
+            }
+        }
+        response[@"payload"] = state;
+    }
+    else if (![groups count] && [channels count] == 1) {
+        
+        response[@"payload"] = (keyspace[@"states"][channels[0]][uuid]?: @{});
+    }
+    else {
+        
+        NSMutableDictionary *states = [NSMutableDictionary new];
+        for (NSString *channel in allChannels) {
+            
+            states[channel] = (keyspace[@"states"][channel][uuid]?: @{});
+        }
+        response[@"payload"] = @{@"channels": states};
+    }
+    
+    return response;
+}
+
+- (id)channelGroupResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                                 query:(NSDictionary *)query
+                              keyspace:(NSMutableDictionary *)keyspace {
+    
+    NSString *group = [self stringFrom:path[@"{channel-group}"]];
+    NSMutableArray *channels = keyspace[@"groups"][group];
+    NSMutableDictionary *response = [@{@"status": @200, @"message": @"OK", @"error": @NO,
+                                       @"service": @"channel-registry"} mutableCopy];
+    if (operation == PNAddChannelsToGroupOperation) {
+        
+        if (!channels) {
+            
+            channels = [NSMutableArray new];
+            keyspace[@"groups"][group] = channels;
+        }
+        for (NSString *channel in [self namesFrom:query[@"add"]]) {
+            
+            if (![channels containsObject:channel]) {
+                
+                [channels addObject:channel];
+            }
+        }
+    }
+    else if (operation == PNRemoveChannelsFromGroupOperation) {
+        
+        [channels removeObjectsInArray:[self namesFrom:query[@"remove"]]];
+    }
+    else if (operation == PNRemoveGroupOperation) {
+        
+        [keyspace[@"groups"] removeObjectForKey:group];
+    }
+    else if (operation == PNChannelGroupsOperation) {
+        
+        response[@"payload"] = @{@"groups": [keyspace[@"groups"] allKeys], @"namespace": @""};
+    }
+    else {
+        
+        response[@"payload"] = @{@"channels": (channels?: @[]), @"group": (group?: @"")};
+    }
+    
+    return response;
+}
+
+- (id)pushResponseForOperation:(PNOperationType)operation withPath:(NSDictionary *)path
+                         query:(NSDictionary *)query keyspace:(NSMutableDictionary *)keyspace {
+    
+    id response = @[@1, @"Modified Channels"];
+    NSString *token = [self stringFrom:path[@"{token}"]];
+    NSMutableArray *channels = keyspace[@"push"][token];
+    if (![token length]) {
+        
+        response = @{@"status": @400, @"error": @YES, @"message": @"Invalid device token"};
+    }
+    else if (operation == PNAddPushNotificationsOnChannelsOperation) {
+        
+        if (!channels) {
+            
+            channels = [NSMutableArray new];
+            keyspace[@"push"][token] = channels;
+        }
+        for (NSString *channel in [self namesFrom:query[@"add"]]) {
+            
+            if (![channels containsObject:channel]) {
+                
+                [channels addObject:channel];
+            }
+        }
+    }
+    else if (operation == PNRemovePushNotificationsFromChannelsOperation) {
+        
+        [channels removeObjectsInArray:[self namesFrom:query[@"remove"]]];
+    }
+    else if (operation == PNRemoveAllPushNotificationsOperation) {
+        
+        [keyspace[@"push"] removeObjectForKey:token];
+        response = @[@1, @"Removed Device"];
+    }
+    else {
+        
+        response = [(channels?: @[]) copy];
+    }
+    
+    return response;
+}
+
+- (void)completeRequest:(NSMutableDictionary *)request withResponse:(id)response
+                  error:(NSError *)error {
+    
+    // Request can be completed only once (for example cancelled request shouldn't be completed
+    // by hold timer).
+    PNLoopbackCompletionBlock block = request[@"block"];
+    BOOL isCompleted = [request[@"completed"] boolValue];
+    [[PNTimingWheel sharedWheel] cancelTimer:request[@"timer"]];
+    [request[@"keyspace"][@"requests"] removeObjectIdenticalTo:request];
+    [request removeObjectsForKeys:@[@"block", @"timer", @"keyspace"]];
+    request[@"completed"] = @YES;
+    if (!isCompleted && block) {
+        
+        dispatch_async(self.callbackQueue, ^{
+            
+            block(response, error);
+        });
+    }
+}
+
+
+#pragma mark - Events
+
+- (unsigned long long)storeEvent:(id)event forChannel:(NSString *)channel
+                      inKeyspace:(NSMutableDictionary *)keyspace {
+    
+    unsigned long long timetoken = [self nextTimetoken];
+    NSMutableArray *events = keyspace[@"events"];
+    [events addObject:@{@"payload": event, @"channel": channel, @"timetoken": @(timetoken)}];
+    if ([events count] > kPNLoopbackMaximumEventsCount) {
+        
+        [events removeObjectAtIndex:0];
+    }
+    
+    for (NSMutableDictionary *request in [keyspace[@"requests"] copy]) {
+        
+        NSArray *response = [self eventsForRequest:request inKeyspace:keyspace];
+        if (response) {
+            
+            [self completeRequest:request withResponse:response error:nil];
+        }
+    }
+    
+    return timetoken;
+}
+
+- (NSArray *)eventsForRequest:(NSDictionary *)request inKeyspace:(NSDictionary *)keyspace {
+    
+    unsigned long long timetoken = [request[@"timetoken"] unsignedLongLongValue];
+    NSMutableArray *payloads = [NSMutableArray new];
+    NSMutableArray *channels = [NSMutableArray new];
+    NSMutableArray *subscriptions = [NSMutableArray new];
+    NSNumber *lastTimetoken = nil;
+    for (NSDictionary *event in keyspace[@"events"]) {
+        
+        NSString *subscription = nil;
+        if ([event[@"timetoken"] unsignedLongLongValue] > timetoken &&
+            (subscription = [self subscriptionForChannel:event[@"channel"] ofRequest:request
+                                              inKeyspace:keyspace])) {
+            
+            [payloads addObject:event[@"payload"]];
+            [channels addObject:event[@"channel"]];
+            [subscriptions addObject:subscription];
+            lastTimetoken = event[@"timetoken"];
+        }
+    }
+    
+    return ([payloads count] ? @[payloads, [lastTimetoken stringValue],
+                                 [channels componentsJoinedByString:@","],
+                                 [subscriptions componentsJoinedByString:@","]] : nil);
+}
+
+- (NSString *)subscriptionForChannel:(NSString *)channel ofRequest:(NSDictionary *)request
+                          inKeyspace:(NSDictionary *)keyspace {
+    
+    NSString *subscription = ([request[@"channels"] containsObject:channel] ? channel : nil);
+    BOOL isPresenceEvent = [PNChannel isPresenceObject:channel];
+    NSString *eventChannel = (isPresenceEvent ? [PNChannel channelForPresence:channel] : channel);
+    for (NSString *group in request[@"groups"]) {
+        
+        // Presence events delivered only to presence channel groups.
+        BOOL isPresenceGroup = [PNChannel isPresenceObject:group];
+        NSString *groupName = (isPresenceGroup ? [PNChannel channelForPresence:group] : group);
+        if (!subscription && isPresenceGroup == isPresenceEvent &&
+            [keyspace[@"groups"][groupName] containsObject:eventChannel]) {
+            
+            subscription = group;
+        }
+    }
+    
+    return subscription;
+}
+
+
+#pragma mark - Presence
+
+- (void)refreshPresenceOf:(NSString *)uuid onChannels:(NSArray *)channels
+              withTimeout:(NSInteger)timeout inKeyspace:(NSMutableDictionary *)keyspace {
+    
+    NSDate *expirationDate = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    for (NSString *channel in channels) {
+        
+        NSMutableDictionary *uuids = keyspace[@"presence"][channel];
+        if (!uuids) {
+            
+            uuids = [NSMutableDictionary new];
+            keyspace[@"presence"][channel] = uuids;
+        }
+        BOOL isJoin = (uuids[uuid] == nil);
+        uuids[uuid] = expirationDate;
+        if (isJoin) {
+            
+            [self storePresenceEvent:@"join" forUUID:uuid onChannel:channel withState:nil
+                          inKeyspace:keyspace];
+        }
+    }
+}
+
+- (void)removePresenceOf:(NSString *)uuid fromChannels:(NSArray *)channels
+              withAction:(NSString *)action inKeyspace:(NSMutableDictionary *)keyspace {
+    
+    for (NSString *channel in channels) {
+        
+        NSMutableDictionary *uuids = keyspace[@"presence"][channel];
+        if (uuids[uuid]) {
+            
+            [uuids removeObjectForKey:uuid];
+            if (![uuids count]) {
+                
+                [keyspace[@"presence"] removeObjectForKey:channel];
+            }
+            [self storePresenceEvent:action forUUID:uuid onChannel:channel withState:nil
+                          inKeyspace:keyspace];
+        }
+    }
+}
+
+- (void)storePresenceEvent:(NSString *)action forUUID:(NSString *)uuid onChannel:(NSString *)channel
+                 withState:(NSDictionary *)state inKeyspace:(NSMutableDictionary *)keyspace {
+    
+    unsigned long long timestamp = (unsigned long long)[[NSDate date] timeIntervalSince1970];
+    NSMutableDictionary *event = [@{@"action": action, @"uuid": uuid,
+                                    @"occupancy": @([keyspace[@"presence"][channel] count]),
+                                    @"timestamp": @(timestamp)} mutableCopy];
+    if (state) {
+        
+        event[@"data"] = state;
+    }
+    [self storeEvent:event forChannel:[channel stringByAppendingString:@"-pnpres"]
+          inKeyspace:keyspace];
+}
+
+- (void)handlePresenceTimer {
+    
+    dispatch_barrier_async(self.resourceAccessQueue, ^{
+        
+        NSDate *date = [NSDate date];
+        for (NSMutableDictionary *keyspace in [self.keyspaces allValues]) {
+            
+            NSMutableDictionary *expiredUUIDs = [NSMutableDictionary new];
+            [keyspace[@"presence"] enumerateKeysAndObjectsUsingBlock:^(NSString *channel,
+                                                                       NSDictionary *uuids,
+                                                                       __unused BOOL *stop) {
+                
+                [uuids enumerateKeysAndObjectsUsingBlock:^(NSString *uuid, NSDate *expirationDate,
+                                                           __unused BOOL *uuidsStop) {
+                    
+                    if ([expirationDate compare:date] != NSOrderedDescending) {
+                        
+                        if (!expiredUUIDs[uuid]) {
+                            
+                            expiredUUIDs[uuid] = [NSMutableArray new];
+                        }
+                        [expiredUUIDs[uuid] addObject:channel];
+                    }
+                }];
+            }];
+            [expiredUUIDs enumerateKeysAndObjectsUsingBlock:^(NSString *uuid, NSArray *channels,
+                                                              __unused BOOL *stop) {
+                
+                [self removePresenceOf:uuid fromChannels:channels withAction:@"timeout"
+                            inKeyspace:keyspace];
+            }];
+        }
+    });
+}
+
+
+#pragma mark - Misc
+
+- (NSMutableDictionary *)keyspaceForSubscribeKey:(NSString *)subscribeKey {
+    
+    NSString *key = (subscribeKey?: @"");
+    NSMutableDictionary *keyspace = self.keyspaces[key];
+    if (!keyspace) {
+        
+        keyspace = [@{@"messages": [NSMutableDictionary new], @"events": [NSMutableArray new],
+                      @"groups": [NSMutableDictionary new], @"presence": [NSMutableDictionary new],
+                      @"states": [NSMutableDictionary new], @"push": [NSMutableDictionary new],
+                      @"requests": [NSMutableArray new]} mutableCopy];
+        self.keyspaces[key] = keyspace;
+    }
+    
+    return keyspace;
+}
+
+- (unsigned long long)nextTimetoken {
+    
+    // Same as PubNub service, time token is number of 100 nanoseconds intervals since 1970.
+    unsigned long long timetoken = (unsigned long long)([[NSDate date] timeIntervalSince1970] *
+                                                        10000000);
+    self.timetoken = MAX(timetoken, self.timetoken + 1);
+    
+    return self.timetoken;
+}
+
+- (NSArray *)presenceChannelsFrom:(NSArray *)channels groups:(NSArray *)groups
+                       inKeyspace:(NSDictionary *)keyspace {
+    
+    NSMutableOrderedSet *presenceChannels = [NSMutableOrderedSet new];
+    [presenceChannels addObjectsFromArray:[PNChannel objectsWithOutPresenceFrom:channels]];
+    for (NSString *group in [PNChannel objectsWithOutPresenceFrom:groups]) {
+        
+        [presenceChannels addObjectsFromArray:(keyspace[@"groups"][group]?: @[])];
+    }
+    
+    return [presenceChannels array];
+}
+
+- (NSString *)stringFrom:(id)value {
+    
+    NSString *string = ([value isKindOfClass:[NSString class]] ? value : [value description]);
+    
+    return ([string stringByRemovingPercentEncoding]?: string);
+}
+
+- (NSArray *)namesFrom:(id)value {
+    
+    NSMutableArray *names = [NSMutableArray new];
+    for (NSString *name in [PNChannel namesFromRequest:([value description]?: @"")]) {
+        
+        NSString *decodedName = [self stringFrom:name];
+        if ([decodedName length]) {
+            
+            [names addObject:decodedName];
+        }
+    }
+    
+    return [names copy];
+}
+
+- (id)objectFrom:(id)value {
+    
+    NSString *string = [self stringFrom:value];
+    
+    return ([string length] ? [PNJSON JSONObjectFrom:string withError:NULL] : nil);
+}
+
+#pragma mark -
+
+
+@end
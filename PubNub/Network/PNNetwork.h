@@ -41,6 +41,42 @@
               maximumConnections:(NSInteger)maximumConnections longPoll:(BOOL)longPollEnabled;
 
 
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of seconds passed since network manager creation till first publish
+         request acknowledgment.
+ @note   \b 0 will be returned till first publish request will be acknowledged.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) NSTimeInterval timeToFirstPublishAcknowledgment;
+
+/**
+ @brief      Stores reference on circuit breakers metrics.
+ @discussion Dictionary use \c "<origin>/<operations>" keys and dictionaries with \c state,
+             \c failures, \c opened and \c rejected keys as values.
+ @note       \c nil will be returned if circuit breaker is disabled.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSDictionary *circuitBreakerStatistics;
+
+/**
+ @brief      Stores reference on snapshot of network manager state for introspection.
+ @discussion Dictionary contains \c requests (list of in-flight requests with operation, state and
+             transferred bytes), \c loopbackRequests, \c queuedOperations (delegate queue depth),
+             \c requestTimeout, \c sinceLastRequest and \c circuitBreakers keys.
+ @note       List of in-flight requests provided by session asynchronously and if it won't be
+             received within short timeout \c requests key will be omitted.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSDictionary *introspectionSnapshot;
+
+
 ///------------------------------------------------
 /// @name Request processing
 ///------------------------------------------------
@@ -70,6 +106,15 @@
  */
 - (void)cancelAllRequests;
 
+/**
+ @brief      Open all connections which can be used by network manager.
+ @discussion Manager send maximum simultaneous number of lightweight \b time requests to set up
+             connections, so following requests won't spend time on DNS, TCP and TLS set up.
+ 
+ @since 4.1.0
+ */
+- (void)warmUpConnections;
+
 
 ///------------------------------------------------
 /// @name Operation information
@@ -7,15 +7,28 @@
 #import "PNNetworkResponseSerializer.h"
 #import "PNConfiguration+Private.h"
 #import "PNRequestParameters.h"
+#import "PNRequestTrace+Private.h"
 #import "PNPrivateStructures.h"
 #import "PubNub+CorePrivate.h"
 #import "PNResult+Private.h"
 #import "PNStatus+Private.h"
 #import <libkern/OSAtomic.h>
+#import <objc/runtime.h>
+#import "PNOriginSelector.h"
+#import "PNCircuitBreaker.h"
+#import "PNLoopbackBroker.h"
+#import "PNTrafficReplayer.h"
+#import "PNTrafficCapture.h"
+#import "PNClientPool+Private.h"
+#import "PNHedgingPolicy.h"
+#import "PNReachability.h"
+#import "PNTimingWheel.h"
+#import "PNEventLoop.h"
 #import "PNErrorStatus.h"
 #import "PNErrorParser.h"
 #import "PNURLBuilder.h"
 #import "PNConstants.h"
+#import "PNTrace.h"
 #import "PNHelpers.h"
 
 
@@ -29,6 +42,35 @@
 static DDLogLevel ddLogLevel;
 
 
+#pragma mark - Static
+
+/**
+ @brief  Stores name of \a NSURLProtocol request property which is used to store type of operation
+         for which request has been created (used by traffic capture).
+ 
+ @since 4.1.0
+ */
+static NSString * const kPNRequestOperationKey = @"PNRequestOperation";
+
+/**
+ @brief  Stores maximum number of seconds which introspection snapshot wait for list of session
+         tasks.
+ 
+ @since 4.1.0
+ */
+static NSTimeInterval const kPNIntrospectionTasksTimeout = 0.5f;
+
+/**
+ @brief  Stores names which is used for data task states in introspection snapshot.
+ 
+ @since 4.1.0
+ */
+static NSString * const PNNetworkTaskStateNames[4] = {
+    [NSURLSessionTaskStateRunning] = @"running", [NSURLSessionTaskStateSuspended] = @"suspended",
+    [NSURLSessionTaskStateCanceling] = @"canceling", [NSURLSessionTaskStateCompleted] = @"completed"
+};
+
+
 #pragma mark - Types
 
 /**
@@ -65,6 +107,53 @@ typedef void(^NSURLSessionDataTaskSuccess)(NSURLSessionDataTask *task, id respon
  */
 typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *error);
 
+/**
+ @brief  Classes which has been resolved from \b PNOperationDescriptors table.
+ 
+ @since 4.1.0
+ */
+typedef struct PNOperationClasses {
+    
+    __unsafe_unretained Class <PNParser> parser;
+    __unsafe_unretained Class resultClass;
+    __unsafe_unretained Class statusClass;
+} PNOperationClasses;
+
+
+#pragma mark - Externs
+
+/**
+ @brief      Retrieve classes which should be used to process response for operations.
+ @discussion Class names resolved only once (on first call) into table which use same layout as
+             \b PNOperationDescriptors, so subsequent lookups doesn't touch runtime.
+ 
+ @return Reference on table indexed by \b PNOperationType.
+ 
+ @since 4.1.0
+ */
+static PNOperationClasses const * PNOperationClassesTable(void) {
+    
+    static PNOperationClasses _classes[PNOperationDescriptorsCount];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        for (NSUInteger operationIdx = 0; operationIdx < PNOperationDescriptorsCount;
+             operationIdx++) {
+            
+            PNOperationDescriptor descriptor = PNOperationDescriptors[operationIdx];
+            _classes[operationIdx].parser = NSClassFromString(descriptor.parser);
+            _classes[operationIdx].resultClass = (descriptor.resultClass ?
+                                                  NSClassFromString(descriptor.resultClass) :
+                                                  [PNResult class]);
+            _classes[operationIdx].statusClass = (descriptor.statusClass ?
+                                                  NSClassFromString(descriptor.statusClass) :
+                                                  [PNStatus class]);
+        }
+    });
+    
+    return _classes;
+}
+
 
 #pragma mark - Protected interface declaration
 
@@ -115,9 +204,10 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
  */
 @property (nonatomic, assign) NSInteger maximumConnections;
 
-
 /**
- @brief  Stores reference on session instance which is used to send network requests.
+ @brief      Stores reference on session instance which is used to send network requests.
+ @discussion Session created with first request which should be sent to \b PubNub network, so
+             clients which never send requests (or use in-process transport) doesn't pay for it.
  
  @since 4.0.2
  */
@@ -131,12 +221,12 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
 @property (nonatomic) NSDictionary *additionalHeaders;
 
 /**
- @brief  Stores reference on base URL which should be appeanded with reasource path to perform 
-         network request.
+ @brief  Stores reference on base URLs (for each origin) which should be appeanded with reasource
+         path to perform network request.
  
- @since 4.0.2
+ @since 4.1.0
  */
-@property (nonatomic) NSURL *baseURL;
+@property (nonatomic) NSDictionary *baseURLs;
 
 /**
  @brief  Stores reference on serializer used to pre-process service responses.
@@ -173,6 +263,68 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
  */
 @property (nonatomic, assign) OSSpinLock lock;
 
+/**
+ @brief  Stores reference on date when network manager has been created.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSDate *creationDate;
+
+/**
+ @brief  Stores reference on date when last request has been sent.
+ 
+ @since 4.1.0
+ */
+@property (atomic, strong) NSDate *lastRequestDate;
+
+/**
+ @brief  Stores whether first publish request already has been acknowledged or not.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) int32_t publishAcknowledged;
+
+/**
+ @brief  Stores reference on timer which is used to keep idle connections open.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNTimingWheelTimer *keepWarmTimer;
+
+/**
+ @brief  Stores reference on policy which is used to hedge slow idempotent read requests.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNHedgingPolicy *hedgingPolicy;
+
+/**
+ @brief  Stores reference on circuit breaker which is used to stop sending requests to origins which
+         unable to process them.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNCircuitBreaker *circuitBreaker;
+
+/**
+ @brief      Stores reference on list of requests which is processed by in-process broker or traffic
+             replayer.
+ @discussion List created only if client configured to use \b PNLoopbackTransport or
+             \b PNReplayTransport.
+ @note       Access to list should be guarded by \c lock.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *loopbackRequests;
+
+/**
+ @brief      Stores reference on capture which record requests and responses.
+ @discussion Capture created only if \c trafficCapturePath specified in client configuration.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNTrafficCapture *trafficCapture;
+
 
 #pragma mark - Initialization and Configuration
 
@@ -213,13 +365,15 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
  @brief  Construct URL request suitable to send POST request (if required).
  
  @param requestURL Reference on complete remote resource URL which should be used for request.
+ @param origin     Reference on origin to which request should be sent.
  @param postData   Reference on data which should be sent as POST body (if passed).
  
  @return Constructed and ready to use request object.
  
  @since 4.0
  */
-- (NSURLRequest *)requestWithURL:(NSURL *)requestURL data:(NSData *)postData;
+- (NSURLRequest *)requestWithURL:(NSURL *)requestURL origin:(NSString *)origin
+                    forOperation:(PNOperationType)operation data:(NSData *)postData;
 
 /**
  @brief  Construct data task which should be used to process provided request.
@@ -238,6 +392,110 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
                                       success:(NSURLSessionDataTaskSuccess)success
                                       failure:(NSURLSessionDataTaskFailure)failure;
 
+/**
+ @brief      Send request and duplicate it if there is no response after \c delay.
+ @discussion Request which complete first is reported with passed blocks and another one is
+             cancelled. Failure reported only if there is no other request which still may succeed.
+             All requests cancelled when \c deadline expire and failure reported with timeout
+             error.
+ 
+ @param request  Reference on request which should be sent to \b PubNub network.
+ @param delay    Number of seconds after which duplicate request should be sent (if budget allow).
+                 Request won't be duplicated if \b 0 passed.
+ @param deadline Reference on date before which request should be completed (can be \c nil).
+ @param success  Reference on data task success handling block which will be called by network
+                 manager.
+ @param failure  Reference on data task processing failure handling block which will be called by
+                 network manager.
+ 
+ @since 4.1.0
+ */
+- (void)sendRequest:(NSURLRequest *)request hedgeAfter:(NSTimeInterval)delay
+           deadline:(NSDate *)deadline success:(NSURLSessionDataTaskSuccess)success
+            failure:(NSURLSessionDataTaskFailure)failure;
+
+/**
+ @brief  Construct error which is used to report requests with expired deadline.
+ 
+ @return Timeout error.
+ 
+ @since 4.1.0
+ */
+- (NSError *)deadlineExpiredError;
+
+/**
+ @brief      Process request using in-process broker.
+ @discussion Used when client configured with \b PNLoopbackTransport. Broker response handled same
+             way as response from \b PubNub network.
+ 
+ @param request    Reference on request which has been built for operation (passed to result and
+                   status objects).
+ @param operation  One of \b PNOperationType enum fields which describe what kind of request should
+                   be processed.
+ @param parameters Reference on request parameters which should be processed by broker.
+ @param data       Reference on data which should be sent along with request.
+ @param block      Depending on operation type it can be \b PNResultBlock, \b PNStatusBlock or
+                   \b PNCompletionBlock blocks.
+ 
+ @since 4.1.0
+ */
+- (void)processLoopbackRequest:(NSURLRequest *)request forOperation:(PNOperationType)operation
+                withParameters:(PNRequestParameters *)parameters data:(NSData *)data
+               completionBlock:(id)block;
+
+/**
+ @brief      Process request using traffic replayer.
+ @discussion Used when client configured with \b PNReplayTransport. Recorded response pass through
+             same serialization, parsing and results creation stages as response from \b PubNub
+             network.
+ 
+ @param request   Reference on request which has been built for operation.
+ @param operation One of \b PNOperationType enum fields which describe what kind of request should
+                  be processed.
+ @param block     Depending on operation type it can be \b PNResultBlock, \b PNStatusBlock or
+                  \b PNCompletionBlock blocks.
+ 
+ @since 4.1.0
+ */
+- (void)processReplayRequest:(NSURLRequest *)request forOperation:(PNOperationType)operation
+             completionBlock:(id)block;
+
+/**
+ @brief      Wrap completion block of request which is processed without data task.
+ @discussion There is no data task for in-process requests, so request (and it's trace) should be
+             passed to result and status objects explicitly (subscriber use it to find out time
+             token which has been used).
+ 
+ @param block     Depending on operation type it can be \b PNResultBlock, \b PNStatusBlock or
+                  \b PNCompletionBlock blocks.
+ @param operation Type of operation for which block has been passed.
+ @param request   Reference on request which should be passed to result and status objects.
+ 
+ @return Block with same signature as passed \c block.
+ 
+ @since 4.1.0
+ */
+- (id)completionBlock:(id)block forOperation:(PNOperationType)operation
+          withRequest:(NSURLRequest *)request;
+
+/**
+ @brief      Wrap completion block of request which has been sent on behalf of another client.
+ @discussion Network manager shared by \b PNClientPool clients fill result and status objects with
+             information of it's own client, so it replaced with information of client which
+             issued request.
+ 
+ @param block     Depending on operation type it can be \b PNResultBlock, \b PNStatusBlock or
+                  \b PNCompletionBlock blocks.
+ @param operation Type of operation for which block has been passed.
+ @param client    Reference on client on behalf of which request has been sent.
+ 
+ @return Block with same signature as passed \c block.
+ 
+ @since 4.1.0
+ */
+- (id)completionBlock:(id)block forOperation:(PNOperationType)operation
+             ofClient:(PubNub *)client;
+
 
 #pragma mark - Request processing
 
@@ -302,10 +560,30 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
        completion:(void(^)(NSDictionary *parsedData, BOOL parseError))block;
 
 
+#pragma mark - Connections
+
+/**
+ @brief  Start keep-warm timer if it has been requested by client configuration.
+ 
+ @since 4.1.0
+ */
+- (void)startKeepWarmTimerIfRequired;
+
+/**
+ @brief      Send \b time API request to origin which hasn't been measured for a while.
+ @discussion Client's requests always sent to selected origin, so other origins measured with
+             separate idempotent request and results passed to origins selection helper.
+ 
+ @since 4.1.0
+ */
+- (void)measureOriginIfRequired;
+
+
 #pragma mark - Session constructor
 
 /**
- @brief  Complete AFNetworking/NSURLSession instantiation and configuration.
+ @brief      Store configuration which should be used for NSURLSession instantiation.
+ @discussion Session itself created with first request by \c -prepareSession.
  
  @param timeout            Maximum time which manager should wait for response on request.
  @param maximumConnections Maximum simultaneously connections (requests) which can be opened.
@@ -315,6 +593,14 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
 - (void)prepareSessionWithRequesrTimeout:(NSTimeInterval)timeout
                       maximumConnections:(NSInteger)maximumConnections;
 
+/**
+ @brief  Complete NSURLSession instantiation using stored request timeout and connections limit.
+ @note   Method should be called while \c lock is held.
+ 
+ @since 4.1.0
+ */
+- (void)prepareSession;
+
 /**
  @brief  Construct base NSURL session configuration.
  
@@ -352,16 +638,18 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
 - (NSURLSession *)sessionWithConfiguration:(NSURLSessionConfiguration *)configuration;
 
 /**
- @brief  Allow to construct base URL basing on network configuraiton.
+ @brief  Allow to construct base URLs basing on network configuraiton.
  
- @return Ready to use service URL.
+ @return Dictionary where origin is a key and ready to use service URL is a value.
  
- @since 4.0.2
+ @since 4.1.0
  */
-- (NSURL *)requestBaseURL;
+- (NSDictionary *)requestBaseURLs;
 
 /**
- @brief  Allow to construct set of headers which should be used for network requests.
+ @brief      Allow to construct set of headers which should be used for network requests.
+ @discussion Headers depend only from device and OS version, so they composed once and shared by
+             all network managers in process.
  
  @return Dictionary with headers which should be added to each request.
  
@@ -372,6 +660,36 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
 
 #pragma mark - Handlers
 
+/**
+ @brief      Handle keep-warm timer fire event.
+ @discussion If there was no requests during keep-warm interval, connections will be warmed up.
+ 
+ @since 4.1.0
+ */
+- (void)handleKeepWarmTimer;
+
+/**
+ @brief  Handle successful publish request acknowledgment and report time to first publish
+         acknowledgment (only once).
+ 
+ @since 4.1.0
+ */
+- (void)handlePublishAcknowledgment;
+
+/**
+ @brief  Handle circuit breaker state change and notify listeners about it.
+ 
+ @param state      One of \b PNCircuitBreakerState enum fields which represent new breaker state.
+ @param operations Kind of operations which is guarded by breaker.
+ @param origin     Host name (or address) of origin which is guarded by breaker.
+ @param operation  One of \b PNOperationType enum fields which represent type of operation which
+                   caused state change.
+ 
+ @since 4.1.0
+ */
+- (void)handleCircuitBreakerState:(PNCircuitBreakerState)state forOperations:(NSString *)operations
+                           origin:(NSString *)origin operation:(PNOperationType)operation;
+
 /**
  @brief      Serialize service response or handle error.
  @discussion Depending on received metadata and data code will call passed success or failure blocks
@@ -505,7 +823,14 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
 + (instancetype)networkForClient:(PubNub *)client requestTimeout:(NSTimeInterval)timeout
               maximumConnections:(NSInteger)maximumConnections longPoll:(BOOL)longPollEnabled {
     
-    dispatch_queue_t queue = dispatch_queue_create("com.pubnub.network", DISPATCH_QUEUE_CONCURRENT);
+    // Host-driven client process service responses inside of event loop pump. Clients from pool
+    // share parsing queue.
+    dispatch_queue_t queue = client.callbackQueue;
+    if (![PNEventLoop eventLoopForQueue:queue]) {
+        
+        queue = (client.clientPool.processingQueue ?:
+                 dispatch_queue_create("com.pubnub.network", DISPATCH_QUEUE_CONCURRENT));
+    }
     return [[self alloc] initForClient:client requestTimeout:timeout
                     maximumConnections:maximumConnections longPoll:longPollEnabled
                           workingQueue:queue];
@@ -523,35 +848,137 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
         _forLongPollRequests = longPollEnabled;
         _processingQueue = queue;
         _serializer = [PNNetworkResponseSerializer new];
-        _baseURL = [self requestBaseURL];
+        _baseURLs = [self requestBaseURLs];
         _additionalHeaders = [self defaultHeaders];
         _lock = OS_SPINLOCK_INIT;
+        _creationDate = [NSDate date];
+        _lastRequestDate = _creationDate;
+        if (!longPollEnabled && client.configuration.hedgeBudget > 0) {
+            
+            _hedgingPolicy = [PNHedgingPolicy policyWithBudget:client.configuration.hedgeBudget];
+        }
+        if (!longPollEnabled && client.configuration.circuitBreakerThreshold > 0) {
+            
+            NSUInteger threshold = client.configuration.circuitBreakerThreshold;
+            NSTimeInterval openInterval = client.configuration.circuitBreakerOpenInterval;
+            _circuitBreaker = [PNCircuitBreaker breakerWithFailureThreshold:threshold
+                                                               openInterval:openInterval];
+            __weak __typeof(self) weakSelf = self;
+            _circuitBreaker.stateChangeBlock = ^(PNOperationType operation, NSString *origin,
+                                                 NSString *operations,
+                                                 PNCircuitBreakerState state) {
+                
+                [weakSelf handleCircuitBreakerState:state forOperations:operations origin:origin
+                                          operation:operation];
+            };
+        }
+        if (client.configuration.transport != PNHTTPTransport) {
+            
+            _loopbackRequests = [NSMutableArray new];
+        }
+        else if ([client.configuration.trafficCapturePath length]) {
+            
+            NSString *capturePath = client.configuration.trafficCapturePath;
+            _trafficCapture = [PNTrafficCapture captureWithPath:capturePath];
+        }
         [self prepareSessionWithRequesrTimeout:timeout maximumConnections:maximumConnections];
+        [self startKeepWarmTimerIfRequired];
     }
     
     return self;
 }
 
+- (void)dealloc {
+    
+    [[PNTimingWheel sharedWheel] cancelTimer:_keepWarmTimer];
+}
+
+
+#pragma mark - Information
+
+- (NSDictionary *)circuitBreakerStatistics {
+    
+    return self.circuitBreaker.statistics;
+}
+
+- (NSDictionary *)introspectionSnapshot {
+    
+    NSMutableDictionary *snapshot = [NSMutableDictionary new];
+    OSSpinLockLock(&_lock);
+    NSURLSession *session = _session;
+    snapshot[@"loopbackRequests"] = @([self.loopbackRequests count]);
+    OSSpinLockUnlock(&_lock);
+    snapshot[@"queuedOperations"] = @(self.delegateQueue.operationCount);
+    snapshot[@"requestTimeout"] = @(self.requestTimeout);
+    snapshot[@"sinceLastRequest"] = @(-[self.lastRequestDate timeIntervalSinceNow]);
+    if (self.circuitBreakerStatistics) {
+        
+        snapshot[@"circuitBreakers"] = self.circuitBreakerStatistics;
+    }
+    
+    // Session report tasks on it's own queue, so snapshot wait for them only limited amount of time
+    // and doesn't touch list which may be delivered after timeout.
+    __block NSArray *requests = @[];
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    if (!session) {
+        
+        dispatch_semaphore_signal(semaphore);
+    }
+    [session getTasksWithCompletionHandler:^(NSArray *dataTasks, __unused NSArray *uploadTasks,
+                                             __unused NSArray *downloadTasks) {
+        
+        NSMutableArray *requestsInformation = [NSMutableArray new];
+        for (NSURLSessionDataTask *task in dataTasks) {
+            
+            NSMutableDictionary *information = [@{
+                @"identifier": @(task.taskIdentifier), @"state": PNNetworkTaskStateNames[task.state],
+                @"sent": @(task.countOfBytesSent), @"received": @(task.countOfBytesReceived)
+            } mutableCopy];
+            PNRequestTrace *trace = [PNRequestTrace traceForObject:task];
+            if (trace) {
+                
+                information[@"operation"] = PNOperationDescriptors[trace.operation].name;
+                information[@"stages"] = [trace dictionaryRepresentation][@"Stages (ms)"];
+            }
+            [requestsInformation addObject:information];
+        }
+        requests = [requestsInformation copy];
+        dispatch_semaphore_signal(semaphore);
+    }];
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW,
+                                            (int64_t)(kPNIntrospectionTasksTimeout * NSEC_PER_SEC));
+    if (dispatch_semaphore_wait(semaphore, timeout) == 0) {
+        
+        snapshot[@"requests"] = requests;
+    }
+    
+    return [snapshot copy];
+}
+
 
 #pragma mark - Request helper
 
 - (void)appendRequierdParametersTo:(PNRequestParameters *)parameters {
     
+    // Identity fields taken from client which issued request (may differ for shared manager).
+    PNConfiguration *configuration = (parameters.client.configuration?: self.configuration);
     [parameters addPathComponents:@{@"{sub-key}": (self.configuration.subscribeKey?: @""),
                                     @"{pub-key}": (self.configuration.publishKey?: @"")}];
-    [parameters addQueryParameters:@{@"uuid": (self.configuration.uuid?: @""),
-                                     @"deviceid": self.configuration.deviceID,
+    [parameters addQueryParameters:@{@"uuid": (configuration.uuid?: @""),
+                                     @"deviceid": configuration.deviceID,
                                      @"pnsdk":[NSString stringWithFormat:@"PubNub-%@%%2F%@",
                                                kPNClientName, kPNLibraryVersion]}];
-    if ([self.configuration.authKey length]) {
+    if ([configuration.authKey length]) {
         
-        [parameters addQueryParameter:self.configuration.authKey forFieldName:@"auth"];
+        [parameters addQueryParameter:configuration.authKey forFieldName:@"auth"];
     }
 }
 
-- (NSURLRequest *)requestWithURL:(NSURL *)requestURL data:(NSData *)postData {
+- (NSURLRequest *)requestWithURL:(NSURL *)requestURL origin:(NSString *)origin
+                    forOperation:(PNOperationType)operation data:(NSData *)postData {
     
-    NSURL *fullURL = [NSURL URLWithString:[requestURL absoluteString] relativeToURL:self.baseURL];
+    NSURL *fullURL = [NSURL URLWithString:[requestURL absoluteString]
+                            relativeToURL:self.baseURLs[origin]];
     NSMutableURLRequest *httpRequest = [NSMutableURLRequest requestWithURL:fullURL];
     httpRequest.HTTPMethod = ([postData length] ? @"POST" : @"GET");
     httpRequest.cachePolicy = NSURLRequestReloadIgnoringCacheData;
@@ -566,18 +993,209 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
         httpRequest.allHTTPHeaderFields = allHeaders;
         [httpRequest setHTTPBody:postData];
     }
+    if (self.trafficCapture) {
+        
+        [NSURLProtocol setProperty:@(operation) forKey:kPNRequestOperationKey
+                         inRequest:httpRequest];
+    }
     
     return [httpRequest copy];
 }
 
+- (NSError *)deadlineExpiredError {
+    
+    return [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut
+                           userInfo:@{NSLocalizedDescriptionKey: @"Request deadline expired."}];
+}
+
+- (void)processLoopbackRequest:(NSURLRequest *)request forOperation:(PNOperationType)operation
+                withParameters:(PNRequestParameters *)parameters data:(NSData *)data
+               completionBlock:(id)block {
+    
+    id completionBlock = [self completionBlock:block forOperation:operation withRequest:request];
+    PNRequestTrace *trace = [PNRequestTrace traceForObject:request];
+    __block id loopbackRequest = nil;
+    __weak __typeof(self) weakSelf = self;
+    PNLoopbackCompletionBlock handler = ^(id response, NSError *error) {
+        
+        __strong __typeof(self) strongSelf = weakSelf;
+        if (strongSelf) {
+            
+            OSSpinLockLock(&strongSelf->_lock);
+            [strongSelf.loopbackRequests removeObjectIdenticalTo:loopbackRequest];
+            OSSpinLockUnlock(&strongSelf->_lock);
+            pn_dispatch_async(strongSelf.processingQueue, ^{
+                
+                if (!error) {
+                    
+                    if (operation == PNPublishOperation) {
+                        
+                        [strongSelf handlePublishAcknowledgment];
+                    }
+                    [strongSelf handleOperation:operation taskDidComplete:nil withData:response
+                                completionBlock:completionBlock];
+                }
+                else {
+                    
+                    // Broker report only cancellation errors which doesn't have service response.
+                    [strongSelf handleParsedData:nil loadedWithTask:nil forOperation:operation
+                                   parsedAsError:YES processingError:error
+                                 completionBlock:completionBlock];
+                }
+            });
+        }
+    };
+    
+    // Lock held till request will be stored, so completion won't try to remove it earlier.
+    [trace markStage:PNRequestSentStage];
+    OSSpinLockLock(&_lock);
+    loopbackRequest = [[PNLoopbackBroker sharedBroker] processOperation:operation
+                                                         withParameters:parameters data:data
+                                                                timeout:self.requestTimeout
+                                                             completion:handler];
+    [self.loopbackRequests addObject:loopbackRequest];
+    OSSpinLockUnlock(&_lock);
+}
+
+- (void)processReplayRequest:(NSURLRequest *)request forOperation:(PNOperationType)operation
+             completionBlock:(id)block {
+    
+    id completionBlock = [self completionBlock:block forOperation:operation withRequest:request];
+    PNRequestTrace *trace = [PNRequestTrace traceForObject:request];
+    __block id replayRequest = nil;
+    __weak __typeof(self) weakSelf = self;
+    PNTrafficReplayCompletionBlock handler = ^(NSHTTPURLResponse *response, NSData *data,
+                                               NSError *error) {
+        
+        __strong __typeof(self) strongSelf = weakSelf;
+        if (strongSelf) {
+            
+            [trace markStage:PNResponseDeliveredStage];
+            OSSpinLockLock(&strongSelf->_lock);
+            [strongSelf.loopbackRequests removeObjectIdenticalTo:replayRequest];
+            OSSpinLockUnlock(&strongSelf->_lock);
+            pn_dispatch_async(strongSelf.processingQueue, ^{
+                
+                NSError *serializationError = nil;
+                PNNetworkResponseSerializer *serializer = strongSelf.serializer;
+                id processedObject = nil;
+                if (response) {
+                    
+                    processedObject = [serializer serializedResponse:response withData:data
+                                                               error:&serializationError];
+                }
+                [trace markStage:PNResponseDeserializedStage];
+                NSError *processingError = (error?: serializationError);
+                if (!processingError) {
+                    
+                    if (operation == PNPublishOperation) {
+                        
+                        [strongSelf handlePublishAcknowledgment];
+                    }
+                    [strongSelf handleOperation:operation taskDidComplete:nil
+                                       withData:processedObject completionBlock:completionBlock];
+                }
+                else if (processingError.code == NSURLErrorCancelled) {
+                    
+                    [strongSelf handleParsedData:nil loadedWithTask:nil forOperation:operation
+                                   parsedAsError:YES processingError:processingError
+                                 completionBlock:completionBlock];
+                }
+                else {
+                    
+                    [strongSelf handleOperation:operation taskDidFail:nil
+                                      withError:processingError completionBlock:completionBlock];
+                }
+            });
+        }
+    };
+    
+    // Lock held till request will be stored, so completion won't try to remove it earlier.
+    [trace markStage:PNRequestSentStage];
+    OSSpinLockLock(&_lock);
+    replayRequest = [[PNTrafficReplayer sharedReplayer] processOperation:operation
+                                                             withRequest:request
+                                                                 timeout:self.requestTimeout
+                                                              completion:handler];
+    [self.loopbackRequests addObject:replayRequest];
+    OSSpinLockUnlock(&_lock);
+}
+
+- (id)completionBlock:(id)block forOperation:(PNOperationType)operation
+          withRequest:(NSURLRequest *)request {
+    
+    id completionBlock = block;
+    PNRequestTrace *trace = [PNRequestTrace traceForObject:request];
+    if (block && [self operationExpectResult:operation]) {
+        
+        completionBlock = ^(PNResult *result, PNStatus *status) {
+            
+            [trace markStage:PNResultCreatedStage];
+            result.clientRequest = request;
+            status.clientRequest = request;
+            result.trace = trace;
+            status.trace = trace;
+            ((PNCompletionBlock)block)(result, status);
+        };
+    }
+    else if (block) {
+        
+        completionBlock = ^(PNResult *resultOrStatus) {
+            
+            [trace markStage:PNResultCreatedStage];
+            resultOrStatus.clientRequest = request;
+            resultOrStatus.trace = trace;
+            ((void(^)(id))block)(resultOrStatus);
+        };
+    }
+    
+    return completionBlock;
+}
+
+- (id)completionBlock:(id)block forOperation:(PNOperationType)operation
+             ofClient:(PubNub *)client {
+    
+    id completionBlock = block;
+    if (block && [self operationExpectResult:operation]) {
+        
+        completionBlock = ^(PNResult *result, PNStatus *status) {
+            
+            [client appendClientInformation:result];
+            [client appendClientInformation:status];
+            ((PNCompletionBlock)block)(result, status);
+        };
+    }
+    else if (block) {
+        
+        completionBlock = ^(PNResult *resultOrStatus) {
+            
+            [client appendClientInformation:resultOrStatus];
+            ((void(^)(id))block)(resultOrStatus);
+        };
+    }
+    
+    return completionBlock;
+}
+
 - (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
                                       success:(NSURLSessionDataTaskSuccess)success
                                       failure:(NSURLSessionDataTaskFailure)failure {
     
     __block NSURLSessionDataTask *task = nil;
     __weak __typeof(self) weakSelf = self;
+    PNRequestTrace *trace = [PNRequestTrace traceForObject:request];
+    PNTrafficCapture *capture = self.trafficCapture;
+    NSNumber *operation = [NSURLProtocol propertyForKey:kPNRequestOperationKey inRequest:request];
+    NSTimeInterval startTime = [PNTrafficCapture currentTime];
     NSURLSessionDataTaskCompletion handler = ^(NSData *data, NSURLResponse *response, NSError *error) {
         
+        [trace markStage:PNResponseDeliveredStage];
+        if (capture && operation && (error?: task.error).code != NSURLErrorCancelled) {
+            
+            [capture recordOperation:(PNOperationType)operation.integerValue withRequest:request
+                            response:(NSHTTPURLResponse *)response data:data
+                               error:(error?: task.error) startTime:startTime];
+        }
         // Silence static analyzer warnings.
         // Code is aware about this case and at the end will simply call on 'nil' object method.
         // In most cases if referenced object become 'nil' it mean what there is no more need in
@@ -589,73 +1207,169 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
         #pragma clang diagnostic pop
     };
     OSSpinLockLock(&_lock);
-    task = [self.session dataTaskWithRequest:request completionHandler:[handler copy]];
+    if (!_session) {
+        
+        [self prepareSession];
+    }
+    task = [_session dataTaskWithRequest:request completionHandler:[handler copy]];
     OSSpinLockUnlock(&_lock);
+    [trace attachToObject:task];
     
     return task;
 }
 
 
-#pragma mark - Request processing
-
-- (BOOL)operationExpectResult:(PNOperationType)operation {
+- (void)sendRequest:(NSURLRequest *)request hedgeAfter:(NSTimeInterval)delay
+           deadline:(NSDate *)deadline success:(NSURLSessionDataTaskSuccess)success
+            failure:(NSURLSessionDataTaskFailure)failure {
     
-    static NSArray *_resultExpectingOperations;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
+    // Context shared by original and duplicate requests: list of active tasks, whether one of
+    // them already reported or expired and references on hedge and deadline timers.
+    NSMutableDictionary *context = [@{@"tasks": [NSMutableArray new], @"completed": @NO,
+                                      @"expired": @NO} mutableCopy];
+    NSError *expiredError = (deadline ? [self deadlineExpiredError] : nil);
+    void(^invalidateTimers)(void) = ^{
         
-        _resultExpectingOperations = @[
-                   @(PNHistoryOperation), @(PNWhereNowOperation), @(PNHereNowGlobalOperation),
-                   @(PNHereNowForChannelOperation), @(PNHereNowForChannelGroupOperation),
-                   @(PNStateForChannelOperation), @(PNStateForChannelGroupOperation),
-                   @(PNChannelGroupsOperation), @(PNChannelsForGroupOperation),
-                   @(PNPushNotificationEnabledChannelsOperation), @(PNTimeOperation)];
-    });
-    
-    return [_resultExpectingOperations containsObject:@(operation)];
-}
-
-- (Class <PNParser>)parserForOperation:(PNOperationType)operation {
-    
-    static NSDictionary *_parsers;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
+        // Timers and context reference each other, so they should be removed to break cycle.
+        [[PNTimingWheel sharedWheel] cancelTimer:context[@"timer"]];
+        [[PNTimingWheel sharedWheel] cancelTimer:context[@"deadlineTimer"]];
+        [context removeObjectsForKeys:@[@"timer", @"deadlineTimer"]];
+    };
+    NSURLSessionDataTaskSuccess hedgedSuccess = ^(NSURLSessionDataTask *task, id responseObject) {
         
-        NSMutableDictionary *parsers = [NSMutableDictionary new];
-        for (Class class in [PNClass classesConformingToProtocol:@protocol(PNParser)]) {
+        NSArray *tasksForCancel = nil;
+        @synchronized(context) {
             
-            NSArray *operations = [(Class<PNParser>)class operations];
-            for (NSNumber *operationType in operations) {
+            if (![context[@"completed"] boolValue]) {
                 
-                parsers[operationType] = class;
+                context[@"completed"] = @YES;
+                [context[@"tasks"] removeObject:task];
+                invalidateTimers();
+                tasksForCancel = [context[@"tasks"] copy];
             }
         }
-        _parsers = [parsers copy];
-    });
+        if (tasksForCancel) {
+            
+            [tasksForCancel makeObjectsPerformSelector:@selector(cancel)];
+            success(task, responseObject);
+        }
+    };
+    NSURLSessionDataTaskFailure hedgedFailure = ^(NSURLSessionDataTask *task, NSError *error) {
+        
+        BOOL shouldReport = NO;
+        @synchronized(context) {
+            
+            [context[@"tasks"] removeObject:task];
+            if (![context[@"completed"] boolValue] && ![context[@"tasks"] count]) {
+                
+                context[@"completed"] = @YES;
+                invalidateTimers();
+                shouldReport = YES;
+                
+                // Requests has been cancelled because of expired deadline.
+                if ([context[@"expired"] boolValue]) {
+                    
+                    error = expiredError;
+                }
+            }
+        }
+        if (shouldReport) {
+            
+            failure(task, error);
+        }
+    };
+    
+    NSURLSessionDataTask *task = [self dataTaskWithRequest:request success:hedgedSuccess
+                                                   failure:hedgedFailure];
+    @synchronized(context) {
+        
+        [context[@"tasks"] addObject:task];
+        
+        // Silence static analyzer warnings.
+        // Code is aware about this case and at the end will simply call on 'nil' object method.
+        // In most cases if referenced object become 'nil' it mean what there is no more need in
+        // it and probably whole client instance has been deallocated.
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+        __weak __typeof(self) weakSelf = self;
+        PNTimingWheel *wheel = [PNTimingWheel sharedWheel];
+        if (delay > 0.0f) {
+            
+            context[@"timer"] = [wheel scheduleTimerWithDelay:delay interval:0.0f block:^{
+                
+                __strong __typeof(self) strongSelf = weakSelf;
+                NSURLSessionDataTask *hedgeTask = nil;
+                @synchronized(context) {
+                    
+                    [context removeObjectForKey:@"timer"];
+                    BOOL active = (![context[@"completed"] boolValue] &&
+                                   ![context[@"expired"] boolValue]);
+                    if (strongSelf && active && [strongSelf.hedgingPolicy acquireHedge]) {
+                        
+                        hedgeTask = [strongSelf dataTaskWithRequest:request success:hedgedSuccess
+                                                            failure:hedgedFailure];
+                        [context[@"tasks"] addObject:hedgeTask];
+                    }
+                }
+                if (hedgeTask) {
+                    
+                    DDLogRequest([[strongSelf class] ddLogLevel], @"<PubNub> Hedge %@",
+                                 [request.URL absoluteString]);
+                    [hedgeTask resume];
+                }
+            }];
+        }
+        if (deadline) {
+            
+            NSTimeInterval timeout = MAX([deadline timeIntervalSinceNow], 0.0f);
+            context[@"deadlineTimer"] = [wheel scheduleTimerWithDelay:timeout interval:0.0f block:^{
+                
+                NSArray *tasksForCancel = nil;
+                @synchronized(context) {
+                    
+                    if (![context[@"completed"] boolValue]) {
+                        
+                        context[@"expired"] = @YES;
+                        invalidateTimers();
+                        tasksForCancel = [context[@"tasks"] copy];
+                    }
+                }
+                
+                // Cancelled tasks free connections and report through failure block.
+                if ([tasksForCancel count]) {
+                    
+                    DDLogRequest([[weakSelf class] ddLogLevel], @"<PubNub> Cancel expired %@",
+                                 [request.URL absoluteString]);
+                    [tasksForCancel makeObjectsPerformSelector:@selector(cancel)];
+                }
+            }];
+        }
+        #pragma clang diagnostic pop
+    }
+    [task resume];
+}
+
+
+#pragma mark - Request processing
+
+- (BOOL)operationExpectResult:(PNOperationType)operation {
     
-    return _parsers[@(operation)];
+    return PNOperationDescriptors[operation].expectResult;
 }
 
-- (Class)resultClassForOperation:(PNOperationType)operation {
+- (Class <PNParser>)parserForOperation:(PNOperationType)operation {
     
-    Class class = [PNResult class];
-    if (PNOperationResultClasses[operation]) {
-        
-        class = NSClassFromString(PNOperationResultClasses[operation]);
-    }
+    return PNOperationClassesTable()[operation].parser;
+}
+
+- (Class)resultClassForOperation:(PNOperationType)operation {
     
-    return class;
+    return PNOperationClassesTable()[operation].resultClass;
 }
 
 - (Class)statusClassForOperation:(PNOperationType)operation {
     
-    Class class = [PNStatus class];
-    if (PNOperationStatusClasses[operation]) {
-        
-        class = NSClassFromString(PNOperationStatusClasses[operation]);
-    }
-    
-    return class;
+    return PNOperationClassesTable()[operation].statusClass;
 }
 
 - (void)processOperation:(PNOperationType)operationType
@@ -668,6 +1382,11 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
     }
     
     [self appendRequierdParametersTo:parameters];
+    PubNub *client = parameters.client;
+    if (client && client != self.client) {
+        
+        block = [self completionBlock:block forOperation:operationType ofClient:client];
+    }
     // Silence static analyzer warnings.
     // Code is aware about this case and at the end will simply call on 'nil' object method.
     // In most cases if referenced object become 'nil' it mean what there is no more need in
@@ -675,23 +1394,168 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
     #pragma clang diagnostic push
     #pragma clang diagnostic ignored "-Wreceiver-is-weak"
     NSURL *requestURL = [PNURLBuilder URLForOperation:operationType withParameters:parameters];
-    if (requestURL) {
+    NSDate *deadline = parameters.deadline;
+    if (requestURL && deadline && [deadline timeIntervalSinceNow] <= 0.0f) {
+        
+        // Caller already not interested in response, so there is no need to occupy connection.
+        DDLogRequest([[self class] ddLogLevel], @"<PubNub> [%@] Drop expired %@",
+                     PNOperationDescriptors[operationType].logTag, [requestURL absoluteString]);
+        [self handleOperation:operationType taskDidFail:nil withError:[self deadlineExpiredError]
+              completionBlock:block];
+    }
+    else if (requestURL) {
         
-        DDLogRequest([[self class] ddLogLevel], @"<PubNub> %@ %@", ([data length] ? @"POST" : @"GET"),
-                     [requestURL absoluteString]);
+        DDLogRequest([[self class] ddLogLevel], @"<PubNub> [%@] %@ %@",
+                     PNOperationDescriptors[operationType].logTag,
+                     ([data length] ? @"POST" : @"GET"), [requestURL absoluteString]);
+        PNTrace2(request__enqueue, (int)operationType, (int64_t)[data length]);
         
         __weak __typeof(self) weakSelf = self;
-        [[self dataTaskWithRequest:[self requestWithURL:requestURL data:data]
-                           success:^(NSURLSessionDataTask *task, id responseObject) {
-                               
-               [weakSelf handleOperation:operationType taskDidComplete:task withData:responseObject
-                         completionBlock:block];
-           }
-           failure:^(NSURLSessionDataTask *task, id error) {
-               
-               [weakSelf handleOperation:operationType taskDidFail:task withError:error
-                         completionBlock:block];
-           }] resume];
+        NSDate *requestDate = [NSDate date];
+        self.lastRequestDate = requestDate;
+        NSString *origin = [self.client.originSelector originForOperation:operationType];
+        PNRequestTrace *trace = nil;
+        if (self.configuration.shouldTraceRequests) {
+            
+            trace = [PNRequestTrace traceForOperation:operationType];
+        }
+        if (self.loopbackRequests) {
+            
+            // Request never leave process, so there is no need to track origin health.
+            NSURLRequest *request = [self requestWithURL:requestURL origin:origin
+                                            forOperation:operationType data:data];
+            [trace attachToObject:request];
+            if (self.configuration.transport == PNReplayTransport) {
+                
+                [self processReplayRequest:request forOperation:operationType
+                           completionBlock:block];
+            }
+            else {
+                
+                [self processLoopbackRequest:request forOperation:operationType
+                              withParameters:parameters data:data completionBlock:block];
+            }
+            
+            return;
+        }
+        if (self.circuitBreaker &&
+            ![self.circuitBreaker allowRequestForOperation:operationType toOrigin:origin]) {
+            
+            // Origin unable to process requests of this kind, so there is no need to wait for
+            // another timeout.
+            DDLogRequest([[self class] ddLogLevel],
+                         @"<PubNub> [%@] Reject %@ (circuit breaker is open)",
+                         PNOperationDescriptors[operationType].logTag, [requestURL absoluteString]);
+            PNErrorStatus *unavailableStatus = [PNErrorStatus
+                                                statusForOperation:operationType
+                                                          category:PNServiceUnavailableCategory
+                                               withProcessingError:nil];
+            [unavailableStatus updateData:@{@"information": @"Service Unavailable"}];
+            [self handleOperation:operationType processingCompletedWithResult:nil
+                           status:unavailableStatus completionBlock:block];
+            
+            return;
+        }
+        NSURLRequest *request = [self requestWithURL:requestURL origin:origin
+                                        forOperation:operationType data:data];
+        if (!self.forLongPollRequests) {
+            
+            [self measureOriginIfRequired];
+        }
+        
+        // Data tasks created for request (including hedged) inherit trace from it.
+        [trace attachToObject:request];
+        NSURLSessionDataTaskSuccess success = ^(NSURLSessionDataTask *task, id responseObject) {
+            
+            NSTimeInterval roundTripTime = -[requestDate timeIntervalSinceNow];
+            PNTrace4(request__done, (int)operationType,
+                     (int)((NSHTTPURLResponse *)task.response).statusCode,
+                     (int64_t)task.countOfBytesReceived, PNTraceMicroseconds(roundTripTime));
+            [weakSelf.client.originSelector handleResponseFromOrigin:origin
+                                                        forOperation:operationType
+                                                   withRoundTripTime:roundTripTime];
+            [weakSelf.client.reachability handleResponseForOperation:operationType
+                                                   withRoundTripTime:roundTripTime];
+            [weakSelf.hedgingPolicy handleResponseForOperation:operationType
+                                             withRoundTripTime:roundTripTime];
+            [weakSelf.circuitBreaker handleSuccessOfOperation:operationType fromOrigin:origin];
+            if (operationType == PNPublishOperation) {
+                
+                [weakSelf handlePublishAcknowledgment];
+            }
+            [weakSelf handleOperation:operationType taskDidComplete:task withData:responseObject
+                      completionBlock:block];
+        };
+        NSURLSessionDataTaskFailure failure = ^(NSURLSessionDataTask *task, id error) {
+            
+            // Service error response also mean what connection with PubNub network is alive.
+            NSInteger statusCode = ((NSHTTPURLResponse *)task.response).statusCode;
+            PNTrace4(request__fail, (int)operationType, (int)((NSError *)error).code,
+                     (int)statusCode, PNTraceMicroseconds(-[requestDate timeIntervalSinceNow]));
+            if (task.response) {
+                
+                NSTimeInterval roundTripTime = -[requestDate timeIntervalSinceNow];
+                [weakSelf.client.reachability handleResponseForOperation:operationType
+                                                       withRoundTripTime:roundTripTime];
+            }
+            
+            // Origin which didn't respond or respond with server error shouldn't be used for
+            // next requests for a while (unless request has been cancelled because of deadline).
+            BOOL deadlineExpired = (deadline && [deadline timeIntervalSinceNow] <= 0.0f);
+            if ((!task.response && !deadlineExpired &&
+                 ((NSError *)error).code != NSURLErrorCancelled) || statusCode >= 500) {
+                
+                [weakSelf.client.originSelector handleFailureOfOrigin:origin];
+            }
+            else if (task.response) {
+                
+                NSTimeInterval roundTripTime = -[requestDate timeIntervalSinceNow];
+                [weakSelf.client.originSelector handleResponseFromOrigin:origin
+                                                            forOperation:operationType
+                                                       withRoundTripTime:roundTripTime];
+            }
+            if (weakSelf.circuitBreaker) {
+                
+                // Breaker driven by same categories which will be reported to the caller.
+                PNStatus *failureStatus = [PNStatus objectForOperation:operationType
+                                                     completedWithTaks:task processedData:nil
+                                                       processingError:error];
+                PNStatusCategory category = failureStatus.category;
+                BOOL isOriginFailure = (category == PNTimeoutCategory ||
+                                        category == PNNetworkIssuesCategory || statusCode >= 500);
+                if (isOriginFailure && !deadlineExpired) {
+                    
+                    [weakSelf.circuitBreaker handleFailureOfOperation:operationType
+                                                           fromOrigin:origin];
+                }
+                else if (task.response) {
+                    
+                    [weakSelf.circuitBreaker handleSuccessOfOperation:operationType
+                                                           fromOrigin:origin];
+                }
+                else {
+                    
+                    [weakSelf.circuitBreaker handleCancellationOfOperation:operationType
+                                                                fromOrigin:origin];
+                }
+            }
+            [weakSelf handleOperation:operationType taskDidFail:task withError:error
+                      completionBlock:block];
+        };
+        
+        NSTimeInterval hedgeDelay = [self.hedgingPolicy hedgeDelayForOperation:operationType];
+        PNTrace3(request__send, (int)operationType, (int64_t)[data length],
+                 (int64_t)(hedgeDelay * 1000.0f));
+        [trace markStage:PNRequestSentStage];
+        if (hedgeDelay > 0.0f || deadline) {
+            
+            [self sendRequest:request hedgeAfter:hedgeDelay deadline:deadline success:success
+                      failure:failure];
+        }
+        else {
+            
+            [[self dataTaskWithRequest:request success:success failure:failure] resume];
+        }
     }
     else {
         
@@ -739,7 +1603,10 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
 
     if (![parser requireAdditionalData]) {
         
-        parseCompletion([parser parsedServiceResponse:data]);
+        PNTrace2(parse__start, class_getName(parser), 0);
+        NSDictionary *parsedData = [parser parsedServiceResponse:data];
+        PNTrace2(parse__end, class_getName(parser), (parsedData != nil));
+        parseCompletion(parsedData);
     }
     else {
 
@@ -753,7 +1620,9 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
         // may be required and should temporary shift to background queue.
         dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
 
+            PNTrace2(parse__start, class_getName(parser), 1);
             NSDictionary *parsedData = [parser parsedServiceResponse:data withData:additionalData];
+            PNTrace2(parse__end, class_getName(parser), (parsedData != nil));
             pn_dispatch_async(self.processingQueue, ^{
                 
                 parseCompletion(parsedData);
@@ -765,8 +1634,30 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
 - (void)cancelAllRequests {
 
     OSSpinLockLock(&_lock);
-    [self.session getTasksWithCompletionHandler:^(NSArray *dataTasks, NSArray *uploadTasks,
-                                                  NSArray *downloadTasks) {
+    NSArray *loopbackRequests = [self.loopbackRequests copy];
+    [self.loopbackRequests removeAllObjects];
+    OSSpinLockUnlock(&_lock);
+    for (id loopbackRequest in loopbackRequests) {
+        
+        if (self.configuration.transport == PNReplayTransport) {
+            
+            [[PNTrafficReplayer sharedReplayer] cancelRequest:loopbackRequest];
+        }
+        else {
+            
+            [[PNLoopbackBroker sharedBroker] cancelRequest:loopbackRequest];
+        }
+    }
+    
+    OSSpinLockLock(&_lock);
+    if (!_session) {
+        
+        // Session not created yet, so there is no tasks which can be cancelled.
+        OSSpinLockUnlock(&_lock);
+        return;
+    }
+    [_session getTasksWithCompletionHandler:^(NSArray *dataTasks, NSArray *uploadTasks,
+                                              NSArray *downloadTasks) {
         
         [dataTasks makeObjectsPerformSelector:@selector(cancel)];
         [uploadTasks makeObjectsPerformSelector:@selector(cancel)];
@@ -775,6 +1666,97 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
     }];
 }
 
+- (void)warmUpConnections {
+    
+    DDLogRequest([[self class] ddLogLevel], @"<PubNub> Warm up %@ connection(s).",
+                 @(self.maximumConnections));
+    for (NSInteger connectionIdx = 0; connectionIdx < self.maximumConnections; connectionIdx++) {
+        
+        [self processOperation:PNTimeOperation withParameters:[PNRequestParameters new] data:nil
+               completionBlock:nil];
+    }
+}
+
+
+#pragma mark - Connections
+
+- (void)startKeepWarmTimerIfRequired {
+    
+    NSTimeInterval interval = self.configuration.keepWarmInterval;
+    if (!self.forLongPollRequests && interval > 0.0f) {
+        
+        // Silence static analyzer warnings.
+        // Code is aware about this case and at the end will simply call on 'nil' object method.
+        // In most cases if referenced object become 'nil' it mean what there is no more need in
+        // it and probably whole client instance has been deallocated.
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+        __weak __typeof(self) weakSelf = self;
+        PNTimingWheel *wheel = [PNTimingWheel sharedWheel];
+        _keepWarmTimer = [wheel scheduleTimerWithDelay:interval interval:interval block:^{
+            
+            [weakSelf handleKeepWarmTimer];
+        }];
+        #pragma clang diagnostic pop
+    }
+}
+
+
+- (void)measureOriginIfRequired {
+    
+    NSString *origin = [self.client.originSelector originForMeasurement];
+    NSURL *requestURL = nil;
+    if (origin) {
+        
+        PNRequestParameters *parameters = [PNRequestParameters new];
+        [self appendRequierdParametersTo:parameters];
+        requestURL = [PNURLBuilder URLForOperation:PNTimeOperation withParameters:parameters];
+    }
+    if (requestURL) {
+        
+        DDLogRequest([[self class] ddLogLevel], @"<PubNub> Measure %@", origin);
+        NSURLRequest *request = [self requestWithURL:requestURL origin:origin
+                                        forOperation:PNTimeOperation data:nil];
+        NSDate *requestDate = [NSDate date];
+        
+        // Silence static analyzer warnings.
+        // Code is aware about this case and at the end will simply call on 'nil' object method.
+        // In most cases if referenced object become 'nil' it mean what there is no more need in
+        // it and probably whole client instance has been deallocated.
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+        #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
+        __weak __typeof(self) weakSelf = self;
+        NSURLSessionDataTaskSuccess success = ^(__unused NSURLSessionDataTask *task,
+                                                __unused id responseObject) {
+            
+            NSTimeInterval roundTripTime = -[requestDate timeIntervalSinceNow];
+            [weakSelf.client.originSelector handleResponseFromOrigin:origin
+                                                        forOperation:PNTimeOperation
+                                                   withRoundTripTime:roundTripTime];
+        };
+        NSURLSessionDataTaskFailure failure = ^(NSURLSessionDataTask *task, id error) {
+            
+            // Same as for client's requests, service error response mean what origin is alive.
+            NSInteger statusCode = ((NSHTTPURLResponse *)task.response).statusCode;
+            if ((!task.response && ((NSError *)error).code != NSURLErrorCancelled) ||
+                statusCode >= 500) {
+                
+                [weakSelf.client.originSelector handleFailureOfOrigin:origin];
+            }
+            else if (task.response) {
+                
+                NSTimeInterval roundTripTime = -[requestDate timeIntervalSinceNow];
+                [weakSelf.client.originSelector handleResponseFromOrigin:origin
+                                                            forOperation:PNTimeOperation
+                                                       withRoundTripTime:roundTripTime];
+            }
+        };
+        #pragma clang diagnostic pop
+        [[self dataTaskWithRequest:request success:success failure:failure] resume];
+    }
+}
+
 
 #pragma mark - Operation information
 
@@ -786,7 +1768,10 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
     NSURL *requestURL = [PNURLBuilder URLForOperation:operationType withParameters:parameters];
     if (requestURL) {
         
-        size = [PNURLRequest packetSizeForRequest:[self requestWithURL:requestURL data:data]];
+        NSString *origin = [self.client.originSelector.origins firstObject];
+        NSURLRequest *request = [self requestWithURL:requestURL origin:origin
+                                        forOperation:operationType data:data];
+        size = [PNURLRequest packetSizeForRequest:request];
     }
     
     return size;
@@ -800,11 +1785,14 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
     
     _requestTimeout = timeout;
     _maximumConnections = maximumConnections;
-    NSURLSessionConfiguration *config = [self configurationWithRequestTimeout:timeout
-                                                           maximumConnections:maximumConnections];
+}
+
+- (void)prepareSession {
+    
+    NSURLSessionConfiguration *config = [self configurationWithRequestTimeout:_requestTimeout
+                                                           maximumConnections:_maximumConnections];
     _delegateQueue = [self operationQueueWithConfiguration:config];
     _session = [self sessionWithConfiguration:config];
-    
 }
 
 - (NSURLSessionConfiguration *)configurationWithRequestTimeout:(NSTimeInterval)timeout
@@ -839,55 +1827,119 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
     return session;
 }
 
-- (NSURL *)requestBaseURL {
+- (NSDictionary *)requestBaseURLs {
     
-    return [NSURL URLWithString:[NSString stringWithFormat:@"http%@://%@",
-                                 (_configuration.TLSEnabled ? @"s" : @""), _configuration.origin]];
+    NSMutableDictionary *baseURLs = [NSMutableDictionary new];
+    for (NSString *origin in _client.originSelector.origins) {
+        
+        baseURLs[origin] = [NSURL URLWithString:[NSString stringWithFormat:@"http%@://%@",
+                                                 (_configuration.TLSEnabled ? @"s" : @""), origin]];
+    }
+    
+    return [baseURLs copy];
 }
 
 - (NSDictionary *)defaultHeaders {
     
-    NSString *device = @"iPhone";
+    static NSDictionary *_sharedDefaultHeaders;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        NSString *device = @"iPhone";
 #if __IPHONE_OS_VERSION_MIN_REQUIRED
-    device = [[UIDevice currentDevice] model];
-    NSString *osVersion = [[UIDevice currentDevice] systemVersion];
+        device = [[UIDevice currentDevice] model];
+        NSString *osVersion = [[UIDevice currentDevice] systemVersion];
 #elif __MAC_OS_X_VERSION_MIN_REQUIRED
-    NSOperatingSystemVersion version = [[NSProcessInfo processInfo]operatingSystemVersion];
-    NSMutableString *osVersion = [NSMutableString stringWithFormat:@"%@.%@",
-                                  @(version.majorVersion), @(version.minorVersion)];
-    if (version.patchVersion > 0) {
-        
-        [osVersion appendFormat:@".%@", @(version.patchVersion)];
-    }
+        NSOperatingSystemVersion version = [[NSProcessInfo processInfo]operatingSystemVersion];
+        NSMutableString *osVersion = [NSMutableString stringWithFormat:@"%@.%@",
+                                      @(version.majorVersion), @(version.minorVersion)];
+        if (version.patchVersion > 0) {
+            
+            [osVersion appendFormat:@".%@", @(version.patchVersion)];
+        }
 #endif
-    NSString *userAgent = [NSString stringWithFormat:@"iPhone; CPU %@ OS %@ Version",
-                           device, osVersion];
+        NSString *userAgent = [NSString stringWithFormat:@"iPhone; CPU %@ OS %@ Version",
+                               device, osVersion];
+        _sharedDefaultHeaders = @{@"Accept":@"*/*", @"Accept-Encoding":@"gzip,deflate",
+                                  @"User-Agent":userAgent, @"Connection":@"keep-alive"};
+    });
     
-    return @{@"Accept":@"*/*", @"Accept-Encoding":@"gzip,deflate", @"User-Agent":userAgent,
-             @"Connection":@"keep-alive"};
+    return _sharedDefaultHeaders;
 }
 
 
 #pragma mark - Handlers
 
+- (void)handleKeepWarmTimer {
+    
+    NSTimeInterval idleTime = -[self.lastRequestDate timeIntervalSinceNow];
+    if (idleTime >= self.configuration.keepWarmInterval) {
+        
+        [self warmUpConnections];
+    }
+}
+
+- (void)handlePublishAcknowledgment {
+    
+    if (OSAtomicCompareAndSwap32Barrier(0, 1, &_publishAcknowledged)) {
+        
+        _timeToFirstPublishAcknowledgment = -[self.creationDate timeIntervalSinceNow];
+        DDLogClientInfo([[self class] ddLogLevel], @"<PubNub> Time to first publish "
+                        "acknowledgment: %@s.", @(_timeToFirstPublishAcknowledgment));
+    }
+}
+
 -(void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)error {
     
     OSSpinLockLock(&_lock);
-    // Replace invalidated session with new one which can be used for next requests.
-    [self prepareSessionWithRequesrTimeout:self.requestTimeout
-                        maximumConnections:self.maximumConnections];
+    // Drop invalidated session, new one will be created with next request.
+    if (_session == session) {
+        
+        _session = nil;
+    }
     OSSpinLockUnlock(&_lock);
 }
 
+- (void)handleCircuitBreakerState:(PNCircuitBreakerState)state forOperations:(NSString *)operations
+                           origin:(NSString *)origin operation:(PNOperationType)operation {
+    
+    NSString *stateString = PNCircuitBreakerStateStrings[state];
+    NSString *information = [NSString stringWithFormat:@"Circuit breaker for %@ requests to %@ is "
+                             "%@.", operations, origin, stateString];
+    
+    // Listeners receive statuses through subscribe status callback, so status should carry
+    // same information as other statuses delivered through it.
+    PNStatusCategory category = PNCircuitBreakerStateChangedCategory;
+    PNSubscribeStatus *status = [PNSubscribeStatus statusForOperation:operation category:category
+                                                  withProcessingError:nil];
+    [status updateData:@{@"information": information,
+                         @"data": @{@"origin": origin, @"operations": operations,
+                                    @"state": stateString}}];
+    status.error = (state != PNCircuitBreakerClosedState);
+    PNSubscriber *subscriberManager = self.client.subscriberManager;
+    NSArray *channels = [subscriberManager channels];
+    status.subscribedChannels = [channels arrayByAddingObjectsFromArray:
+                                 [subscriberManager presenceChannels]];
+    status.subscribedChannelGroups = [subscriberManager channelGroups];
+    [self.client appendClientInformation:status];
+    
+    PNStateListener *listenersManager = self.client.listenersManager;
+    [listenersManager notifyWithBlock:^{
+        
+        [listenersManager notifyStatusChange:status];
+    }];
+}
+
 - (void)handleData:(NSData *)data loadedWithTask:(NSURLSessionDataTask *)task
              error:(NSError *)requestError usingSuccess:(NSURLSessionDataTaskSuccess)success
            failure:(NSURLSessionDataTaskFailure)failure {
     
-    dispatch_async(self.processingQueue, ^{
+    pn_dispatch_async(self.processingQueue, ^{
         
         NSError *serializationError = nil;
         id processedObject = [self.serializer serializedResponse:(NSHTTPURLResponse *)task.response
                                                         withData:data error:&serializationError];
+        [[PNRequestTrace traceForObject:task] markStage:PNResponseDeserializedStage];
         NSError *error = (requestError?: serializationError);
         (!error ? success : failure)(task, (error?: processedObject));
     });
@@ -906,6 +1958,7 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
              // it and probably whole client instance has been deallocated.
              #pragma clang diagnostic push
              #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+             [[PNRequestTrace traceForObject:task] markStage:PNResponseParsedStage];
              [weakSelf handleParsedData:parsedData loadedWithTask:task forOperation:operation
                           parsedAsError:parseError processingError:task.error
                         completionBlock:[block copy]];
@@ -932,6 +1985,7 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
         [self parseData:errorDetails withParser:[PNErrorParser class]
              completion:^(NSDictionary *parsedData, __unused BOOL parseError) {
 
+                 [[PNRequestTrace traceForObject:task] markStage:PNResponseParsedStage];
                  [self handleParsedData:parsedData loadedWithTask:task forOperation:operation
                           parsedAsError:YES processingError:(error?: task.error)
                         completionBlock:[block copy]];
@@ -971,7 +2025,11 @@ typedef void(^NSURLSessionDataTaskFailure)(NSURLSessionDataTask *task, NSError *
     }
     
     if (result || status) {
-
+        
+        PNRequestTrace *trace = [PNRequestTrace traceForObject:task];
+        [trace markStage:PNResultCreatedStage];
+        result.trace = trace;
+        status.trace = trace;
         [self handleOperation:operation processingCompletedWithResult:result
                        status:status completionBlock:block];
     }
@@ -0,0 +1,123 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+#pragma mark Class forward
+
+@class PNConfiguration;
+
+
+/**
+ @brief      \b PubNub network origins selection helper.
+ @discussion Helper track latency and errors of requests sent to each origin from configured list
+             and pick origin which should be used for new requests: healthy origin with lowest
+             smoothed round trip time (origins order from configuration used till first
+             measurements). Origins which failed to respond moved to penalty box with exponential
+             back off and won't be used till it expire (unless all origins is in penalty box).
+             Rarely used origins re-measured from time to time with separate \b time API request
+             (client's requests always sent to selected origin).
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNOriginSelector : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on list of origins between which helper choose.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSArray *origins;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Construct origins selection helper.
+ 
+ @param configuration Reference on client configuration from which list of origins should be taken.
+ 
+ @return Constructed and ready to use origins selection helper.
+ 
+ @since 4.1.0
+ */
++ (instancetype)selectorForConfiguration:(PNConfiguration *)configuration;
+
+
+///------------------------------------------------
+/// @name Selection
+///------------------------------------------------
+
+/**
+ @brief  Retrieve origin which should be used to process \c operation.
+ 
+ @param operation One of \b PNOperationType enum fields which represent type of operation which
+                  will be sent.
+ 
+ @return Origin host name (or address).
+ 
+ @since 4.1.0
+ */
+- (NSString *)originForOperation:(PNOperationType)operation;
+
+/**
+ @brief      Retrieve origin which should be measured with \b time API request.
+ @discussion Origin which is not used by client and hasn't been measured for a while returned (it is
+             marked as measured right away, so only one caller will receive it).
+ 
+ @return Origin host name (or address) or \c nil in case if there is no origins which require
+         measurement.
+ 
+ @since 4.1.0
+ */
+- (NSString *)originForMeasurement;
+
+/**
+ @brief  Check whether failed request can be re-issued right away to another origin.
+ 
+ @return \c YES in case if more than one origin configured and at least one of them not in penalty
+         box.
+ 
+ @since 4.1.0
+ */
+- (BOOL)canFailOver;
+
+
+///------------------------------------------------
+/// @name Handlers
+///------------------------------------------------
+
+/**
+ @brief  Handle response received from \c origin.
+ 
+ @param origin        Host name (or address) of origin which sent response.
+ @param operation     One of \b PNOperationType enum fields which represent type of completed
+                      operation.
+ @param roundTripTime Number of seconds passed since request has been sent.
+ 
+ @since 4.1.0
+ */
+- (void)handleResponseFromOrigin:(NSString *)origin forOperation:(PNOperationType)operation
+               withRoundTripTime:(NSTimeInterval)roundTripTime;
+
+/**
+ @brief  Handle request failure because \c origin not responded or reported server error.
+ 
+ @param origin Host name (or address) of origin which failed to process request.
+ 
+ @since 4.1.0
+ */
+- (void)handleFailureOfOrigin:(NSString *)origin;
+
+#pragma mark -
+
+
+@end
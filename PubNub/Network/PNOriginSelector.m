@@ -0,0 +1,391 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNOriginSelector.h"
+#import "PNConfiguration.h"
+#import "PNConstants.h"
+#import "PNLog.h"
+
+
+#pragma mark CocoaLumberjack logging support
+
+/**
+ @brief  Cocoa Lumberjack logging level configuration for origins selection helper.
+ 
+ @since 4.1.0
+ */
+static DDLogLevel ddLogLevel = (DDLogLevel)PNReachabilityLogLevel;
+
+
+#pragma mark - Static
+
+/**
+ @brief  Stores number of seconds after which origin which isn't used by client will be measured
+         with \b time API request.
+ 
+ @since 4.1.0
+ */
+static NSTimeInterval const kPNOriginMeasurementInterval = 30.0f;
+
+/**
+ @brief  Stores maximum number of seconds for which failed origin can be placed into penalty box.
+ 
+ @since 4.1.0
+ */
+static NSTimeInterval const kPNOriginMaximumPenalty = 60.0f;
+
+/**
+ @brief  Stores how much lower (in percents) round trip time of another origin should be to switch
+         to it from currently used origin.
+ 
+ @since 4.1.0
+ */
+static double const kPNOriginSwitchThreshold = 0.2f;
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNOriginSelector ()
+
+
+#pragma mark - Information
+
+@property (nonatomic, copy) NSArray *origins;
+
+/**
+ @brief      Stores reference on per-origin statistics.
+ @discussion Origin is a key and mutable dictionary with \c latency, \c failures, \c penaltyDate and
+             \c measureDate keys is a value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSDictionary *statistics;
+
+/**
+ @brief  Stores reference on origin which has been used for recent requests.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, copy) NSString *preferredOrigin;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to origins statistics.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize origins selection helper.
+ 
+ @param origins List of origins between which helper should choose.
+ 
+ @return Initialized and ready to use origins selection helper.
+ 
+ @since 4.1.0
+ */
+- (instancetype)initWithOrigins:(NSArray *)origins;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve list of origins which currently not in penalty box (in configured order).
+ @note   This method should be called only from resource access queue.
+ 
+ @param date Reference on date against which penalty expiration should be checked.
+ 
+ @return List of healthy origins.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)healthyOriginsForDate:(NSDate *)date;
+
+/**
+ @brief  Find origin with lowest smoothed round trip time.
+ @note   This method should be called only from resource access queue.
+ 
+ @param origins List of healthy origins from which choice should be made.
+ 
+ @return Origin with lowest latency or first origin from list, if there is no measurements yet.
+ 
+ @since 4.1.0
+ */
+- (NSString *)bestOriginFrom:(NSArray *)origins;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNOriginSelector
+
+
+#pragma mark - Logger
+
+/**
+ @brief  Called by Cocoa Lumberjack during initialization.
+ 
+ @return Desired logger level for \b PubNub client main class.
+ 
+ @since 4.1.0
+ */
++ (DDLogLevel)ddLogLevel {
+    
+    return ddLogLevel;
+}
+
+/**
+ @brief  Allow modify logger level used by Cocoa Lumberjack with logging macros.
+ 
+ @param logLevel New log level which should be used by logger.
+ 
+ @since 4.1.0
+ */
++ (void)ddSetLogLevel:(DDLogLevel)logLevel {
+    
+    ddLogLevel = logLevel;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)selectorForConfiguration:(PNConfiguration *)configuration {
+    
+    NSArray *origins = ([configuration.origins count] ? configuration.origins :
+                        @[(configuration.origin?: kPNDefaultOrigin)]);
+    
+    return [[self alloc] initWithOrigins:origins];
+}
+
+- (instancetype)initWithOrigins:(NSArray *)origins {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _origins = [origins copy];
+        NSMutableDictionary *statistics = [NSMutableDictionary new];
+        for (NSString *origin in origins) {
+            
+            statistics[origin] = [@{@"latency": @0, @"failures": @0} mutableCopy];
+        }
+        _statistics = [statistics copy];
+        _preferredOrigin = [origins firstObject];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.origin-selector",
+                                                     DISPATCH_QUEUE_CONCURRENT);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Selection
+
+- (NSString *)originForOperation:(PNOperationType)operation {
+    
+    if ([self.origins count] == 1) {
+        
+        return [self.origins firstObject];
+    }
+    
+    __block NSString *origin = nil;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        NSDate *date = [NSDate date];
+        NSArray *healthyOrigins = [self healthyOriginsForDate:date];
+        if (![healthyOrigins count]) {
+            
+            // All origins failed, so use the one which stay in penalty box for shortest time.
+            NSString *candidate = nil;
+            NSDate *closestPenaltyDate = nil;
+            for (NSString *targetOrigin in self.origins) {
+                
+                NSDate *penaltyDate = self.statistics[targetOrigin][@"penaltyDate"];
+                if (!closestPenaltyDate ||
+                    [penaltyDate compare:closestPenaltyDate] == NSOrderedAscending) {
+                    
+                    closestPenaltyDate = penaltyDate;
+                    candidate = targetOrigin;
+                }
+            }
+            origin = candidate;
+        }
+        else {
+            
+            NSString *bestOrigin = [self bestOriginFrom:healthyOrigins];
+            NSString *preferredOrigin = self.preferredOrigin;
+            if (![healthyOrigins containsObject:preferredOrigin]) {
+                
+                DDLogReachability([[self class] ddLogLevel], @"<PubNub> Fail over from %@ to %@.",
+                                  preferredOrigin, bestOrigin);
+                preferredOrigin = bestOrigin;
+            }
+            else if (![bestOrigin isEqualToString:preferredOrigin]) {
+                
+                NSDictionary *statistics = self.statistics;
+                double bestLatency = [statistics[bestOrigin][@"latency"] doubleValue];
+                double preferredLatency = [statistics[preferredOrigin][@"latency"] doubleValue];
+                if (bestLatency < preferredLatency * (1.0f - kPNOriginSwitchThreshold)) {
+                    
+                    DDLogReachability([[self class] ddLogLevel], @"<PubNub> Switch from %@ (%@s) "
+                                      "to %@ (%@s).", preferredOrigin, @(preferredLatency),
+                                      bestOrigin, @(bestLatency));
+                    preferredOrigin = bestOrigin;
+                }
+            }
+            self.preferredOrigin = preferredOrigin;
+            origin = preferredOrigin;
+        }
+    });
+    
+    return origin;
+}
+
+- (NSString *)originForMeasurement {
+    
+    if ([self.origins count] == 1) {
+        
+        return nil;
+    }
+    
+    __block NSString *origin = nil;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        // Other origins compared with origin which is used by client, so there is no need to
+        // measure them till it will be measured.
+        NSString *preferredOrigin = self.preferredOrigin;
+        if ([self.statistics[preferredOrigin][@"latency"] doubleValue] > 0.0f) {
+            
+            NSDate *date = [NSDate date];
+            for (NSString *targetOrigin in [self healthyOriginsForDate:date]) {
+                
+                NSMutableDictionary *originStatistics = self.statistics[targetOrigin];
+                NSDate *measureDate = originStatistics[@"measureDate"];
+                NSTimeInterval measureAge = (kPNOriginMeasurementInterval + 1.0f);
+                if (measureDate) {
+                    
+                    measureAge = [date timeIntervalSinceDate:measureDate];
+                }
+                if (![targetOrigin isEqualToString:preferredOrigin] &&
+                    measureAge > kPNOriginMeasurementInterval) {
+                    
+                    originStatistics[@"measureDate"] = date;
+                    origin = targetOrigin;
+                    break;
+                }
+            }
+        }
+    });
+    
+    return origin;
+}
+
+- (BOOL)canFailOver {
+    
+    __block BOOL canFailOver = NO;
+    if ([self.origins count] > 1) {
+        
+        dispatch_sync(self.resourceAccessQueue, ^{
+            
+            canFailOver = ([[self healthyOriginsForDate:[NSDate date]] count] > 0);
+        });
+    }
+    
+    return canFailOver;
+}
+
+
+#pragma mark - Handlers
+
+- (void)handleResponseFromOrigin:(NSString *)origin forOperation:(PNOperationType)operation
+               withRoundTripTime:(NSTimeInterval)roundTripTime {
+    
+    if (!self.statistics[origin]) {
+        
+        return;
+    }
+    
+    dispatch_barrier_async(self.resourceAccessQueue, ^{
+        
+        NSMutableDictionary *originStatistics = self.statistics[origin];
+        originStatistics[@"failures"] = @0;
+        [originStatistics removeObjectForKey:@"penaltyDate"];
+        
+        // Long-poll requests completion time depends from events rate and can't be used.
+        if (operation != PNSubscribeOperation) {
+            
+            double latency = [originStatistics[@"latency"] doubleValue];
+            latency = (latency > 0.0f ? (0.875f * latency + 0.125f * roundTripTime) :
+                       roundTripTime);
+            originStatistics[@"latency"] = @(latency);
+            originStatistics[@"measureDate"] = [NSDate date];
+        }
+    });
+}
+
+- (void)handleFailureOfOrigin:(NSString *)origin {
+    
+    if (!self.statistics[origin]) {
+        
+        return;
+    }
+    
+    dispatch_barrier_async(self.resourceAccessQueue, ^{
+        
+        NSMutableDictionary *originStatistics = self.statistics[origin];
+        NSUInteger failures = ([originStatistics[@"failures"] unsignedIntegerValue] + 1);
+        NSTimeInterval penalty = MIN(pow(2.0f, (double)(failures - 1)), kPNOriginMaximumPenalty);
+        originStatistics[@"failures"] = @(failures);
+        originStatistics[@"penaltyDate"] = [NSDate dateWithTimeIntervalSinceNow:penalty];
+        DDLogReachability([[self class] ddLogLevel], @"<PubNub> %@ failed %@ time(s) in a row. "
+                          "Don't use it for %@s.", origin, @(failures), @(penalty));
+    });
+}
+
+
+#pragma mark - Misc
+
+- (NSArray *)healthyOriginsForDate:(NSDate *)date {
+    
+    NSMutableArray *origins = [NSMutableArray new];
+    for (NSString *origin in self.origins) {
+        
+        NSDate *penaltyDate = self.statistics[origin][@"penaltyDate"];
+        if (!penaltyDate || [penaltyDate compare:date] != NSOrderedDescending) {
+            
+            [origins addObject:origin];
+        }
+    }
+    
+    return [origins copy];
+}
+
+- (NSString *)bestOriginFrom:(NSArray *)origins {
+    
+    NSString *bestOrigin = nil;
+    double bestLatency = 0.0f;
+    for (NSString *origin in origins) {
+        
+        double latency = [self.statistics[origin][@"latency"] doubleValue];
+        if (latency > 0.0f && (!bestOrigin || latency < bestLatency)) {
+            
+            bestOrigin = origin;
+            bestLatency = latency;
+        }
+    }
+    
+    return (bestOrigin?: [origins firstObject]);
+}
+
+#pragma mark -
+
+
+@end
@@ -1,4 +1,5 @@
 #import <Foundation/Foundation.h>
+#import "PNStructures.h"
 
 
 #pragma mark Class forward
@@ -7,11 +8,13 @@
 
 
 /**
- @brief      \b PubNub network reachability / ping utility.
+ @brief      \b PubNub network reachability / connection health utility.
  @discussion This class used by \b PubNub client to check whether current \b PubNub network state
              allow to send any requests to it or not.
-             Mostly this method used after unexpected disconnection (on network failure) to start
-             remote service ping process (at least ping once).
+             Helper passively track completion of all requests which has been sent by client to
+             derive connection liveness and smoothed round trip time. After unexpected
+             disconnection (on network failure) helper wait for any successful request and probe
+             \b PubNub service with \b time API only when there is no other traffic.
  
  @author Sergey Mamontov
  @since 4.0
@@ -20,6 +23,26 @@
 @interface PNReachability : NSObject
 
 
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Smoothed round trip time (in seconds) calculated from non-subscribe requests completion.
+ @note   \b 0 will be returned till first request will be completed.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) NSTimeInterval smoothedRoundTripTime;
+
+/**
+ @brief  Smoothed round trip time variation (in seconds).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) NSTimeInterval roundTripTimeVariance;
+
+
 ///------------------------------------------------
 /// @name Initialization and Configuration
 ///------------------------------------------------
@@ -45,9 +68,10 @@
 
 /**
  @brief      Launch process with remote service pinging.
- @discussion Ping process involves process with reachability state correlation to \b time API call
-             response. In case if \b time API will return valid response - mean what \b PubNub 
-             network service ready to process requests.
+ @discussion Helper wait for any request which will receive response from \b PubNub network
+             service. If there is no traffic, \b time API will be used to probe service. As soon
+             as any response will be received - \b PubNub network service ready to process
+             requests.
  @note       Ping process will remain active till \c -stopServicePing method will be called.
  
  @since 4.0
@@ -61,6 +85,23 @@
  */
 - (void)stopServicePing;
 
+
+///------------------------------------------------
+/// @name Handlers
+///------------------------------------------------
+
+/**
+ @brief  Handle response from \b PubNub network service for one of client's requests.
+ 
+ @param operation     One of \b PNOperationType enum fields which represent type of completed
+                      operation.
+ @param roundTripTime Number of seconds passed since request has been sent.
+ 
+ @since 4.1.0
+ */
+- (void)handleResponseForOperation:(PNOperationType)operation
+                 withRoundTripTime:(NSTimeInterval)roundTripTime;
+
 #pragma mark -
 
 
@@ -5,7 +5,9 @@
  */
 #import "PNReachability.h"
 #import "PubNub+CorePrivate.h"
+#import "PNRequestParameters.h"
 #import "PNConfiguration.h"
+#import "PNTimingWheel.h"
 #import "PubNub.h"
 
 
@@ -64,6 +66,32 @@ static DDLogLevel ddLogLevel = (DDLogLevel)PNReachabilityLogLevel;
  */
 @property (nonatomic, assign) BOOL reachable;
 
+/**
+ @brief  Stores reference on date when last response from \b PubNub network has been received.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSDate *lastActivityDate;
+
+/**
+ @brief      Stores reference on list of blocks which wait for results of probe request which is in
+             progress.
+ @discussion Only one probe request sent at once, so callers which request probe while it is in
+             progress receive results of the same request. List is \c nil while there is no probe
+             request in progress.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *probeCompletionBlocks;
+
+/**
+ @brief  Stores reference on timer which is used to check whether there is traffic between client
+         and \b PubNub network.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) PNTimingWheelTimer *idleTimer;
+
 
 #pragma mark - Initialization and Configuration
 
@@ -81,6 +109,57 @@ static DDLogLevel ddLogLevel = (DDLogLevel)PNReachabilityLogLevel;
 - (instancetype)initForClient:(PubNub *)client
                withPingStatus:(void(^)(BOOL pingSuccessful))block NS_DESIGNATED_INITIALIZER;
 
+
+#pragma mark - Probing
+
+/**
+ @brief      Schedule service probe after specified \c delay.
+ @discussion Probe request will be sent only if there was no responses from \b PubNub network
+             during \c delay.
+ 
+ @param delay Number of seconds after which helper should check traffic presence.
+ 
+ @since 4.1.0
+ */
+- (void)scheduleServiceProbeWithDelay:(NSTimeInterval)delay;
+
+/**
+ @brief      Send \b time API request to check whether \b PubNub network is available or not.
+ @discussion Request sent directly through client's service network and results processed on
+             network's processing queue (without hop to client's callback queue).
+ @note       If probe request already in progress, \c block will be called with it's results.
+ 
+ @param block Reference on block which will be called with probe results.
+ 
+ @since 4.1.0
+ */
+- (void)probeServiceWithCompletion:(void(^)(BOOL probeSuccessful))block;
+
+/**
+ @brief  Check whether there was any traffic during last \c interval seconds.
+ 
+ @param interval Number of seconds during which client should receive at least one response.
+ 
+ @return \c YES in case if during \c interval there was no responses from \b PubNub network.
+ 
+ @since 4.1.0
+ */
+- (BOOL)isIdleForInterval:(NSTimeInterval)interval;
+
+
+#pragma mark - Handlers
+
+/**
+ @brief      Handle idle timer fire.
+ @discussion If client subscribed on remote data objects and there is no traffic during configured
+             idle deadline, helper will probe \b PubNub service and re-issue subscribe request if
+             service responded (because long-poll request most likely stalled). Failed probe
+             handled by subscribe request failure and service ping.
+ 
+ @since 4.1.0
+ */
+- (void)handleIdleTimer;
+
 #pragma mark -
 
 
@@ -92,6 +171,8 @@ static DDLogLevel ddLogLevel = (DDLogLevel)PNReachabilityLogLevel;
 @implementation PNReachability
 
 @synthesize pingRemoteService = _pingRemoteService;
+@synthesize smoothedRoundTripTime = _smoothedRoundTripTime;
+@synthesize roundTripTimeVariance = _roundTripTimeVariance;
 
 
 #pragma mark - Logger
@@ -138,11 +219,29 @@ static DDLogLevel ddLogLevel = (DDLogLevel)PNReachabilityLogLevel;
         _resourceAccessQueue = dispatch_queue_create("com.pubnub.reachability",
                                                      DISPATCH_QUEUE_CONCURRENT);
         _reachable = YES;
+        _lastActivityDate = [NSDate date];
+        
+        NSTimeInterval idleDeadline = client.configuration.connectionIdleDeadline;
+        if (idleDeadline > 0.0f) {
+            
+            __weak __typeof(self) weakSelf = self;
+            _idleTimer = [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:idleDeadline
+                                                                    interval:idleDeadline
+                                                                       block:^{
+                
+                [weakSelf handleIdleTimer];
+            }];
+        }
     }
     
     return self;
 }
 
+- (void)dealloc {
+    
+    [[PNTimingWheel sharedWheel] cancelTimer:_idleTimer];
+}
+
 - (BOOL)pingingRemoteService {
     
     __block BOOL pingingRemoteService = NO;
@@ -162,14 +261,110 @@ static DDLogLevel ddLogLevel = (DDLogLevel)PNReachabilityLogLevel;
     });
 }
 
+- (NSTimeInterval)smoothedRoundTripTime {
+    
+    __block NSTimeInterval smoothedRoundTripTime = 0.0f;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        smoothedRoundTripTime = self->_smoothedRoundTripTime;
+    });
+    
+    return smoothedRoundTripTime;
+}
+
+- (NSTimeInterval)roundTripTimeVariance {
+    
+    __block NSTimeInterval roundTripTimeVariance = 0.0f;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        roundTripTimeVariance = self->_roundTripTimeVariance;
+    });
+    
+    return roundTripTimeVariance;
+}
+
 
 #pragma mark - Service ping
 
 - (void)startServicePing {
     
-    if (!self.pingingRemoteService) {
+    __block BOOL shouldStart = NO;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        shouldStart = !self->_pingRemoteService;
+        self->_pingRemoteService = YES;
+    });
+    
+    if (shouldStart) {
         
-        self.pingRemoteService = YES;
+        // Response on any request which will be sent by client during this time will be enough to
+        // complete ping.
+        [self scheduleServiceProbeWithDelay:1.0f];
+    }
+}
+
+- (void)stopServicePing {
+    
+    self.pingRemoteService = NO;
+}
+
+
+#pragma mark - Probing
+
+- (void)scheduleServiceProbeWithDelay:(NSTimeInterval)delay {
+    
+    __weak __typeof(self) weakSelf = self;
+    [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:delay interval:0.0f block:^{
+        
+        __strong __typeof(self) strongSelf = weakSelf;
+        if (strongSelf.pingingRemoteService && [strongSelf isIdleForInterval:delay]) {
+            
+            [strongSelf probeServiceWithCompletion:^(BOOL probeSuccessful) {
+                
+                // Successful probe handled along with other requests.
+                if (!probeSuccessful && strongSelf.pingingRemoteService) {
+                    
+                    __block BOOL wasReachable = NO;
+                    dispatch_barrier_sync(strongSelf.resourceAccessQueue, ^{
+                        
+                        wasReachable = strongSelf->_reachable;
+                        strongSelf->_reachable = NO;
+                    });
+                    if (wasReachable) {
+                        
+                        DDLogReachability([[strongSelf class] ddLogLevel],
+                                          @"<PubNub> Connection went down.");
+                    }
+                    NSTimeInterval nextDelay = (wasReachable ? 1.0f : 10.0f);
+                    if (strongSelf.pingCompleteBlock) {
+                        
+                        strongSelf.pingCompleteBlock(NO);
+                    }
+                    [strongSelf scheduleServiceProbeWithDelay:nextDelay];
+                }
+            }];
+        }
+        else if (strongSelf.pingingRemoteService) {
+            
+            [strongSelf scheduleServiceProbeWithDelay:delay];
+        }
+    }];
+}
+
+- (void)probeServiceWithCompletion:(void(^)(BOOL probeSuccessful))block {
+    
+    __block BOOL shouldProbe = NO;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        shouldProbe = (self->_probeCompletionBlocks == nil);
+        if (shouldProbe) {
+            
+            self->_probeCompletionBlocks = [NSMutableArray new];
+        }
+        [self->_probeCompletionBlocks addObject:[block copy]];
+    });
+    
+    if (shouldProbe) {
         
         // Silence static analyzer warnings.
         // Code is aware about this case and at the end will simply call on 'nil' object method.
@@ -177,44 +372,119 @@ static DDLogLevel ddLogLevel = (DDLogLevel)PNReachabilityLogLevel;
         // it and probably whole client instance has been deallocated.
         #pragma clang diagnostic push
         #pragma clang diagnostic ignored "-Wreceiver-is-weak"
-        #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
-        // Try to request 'time' API to ensure what network really available.
         __weak __typeof(self) weakSelf = self;
-        [self.client timeWithCompletion:^(PNTimeResult *result, __unused PNErrorStatus *status) {
+        dispatch_queue_t queue = self.resourceAccessQueue;
+        [self.client processOperation:PNTimeOperation withParameters:[PNRequestParameters new]
+                      completionBlock:^(PNResult *result, PNStatus *status) {
             
-            __strong __typeof(self) strongSelf = weakSelf;
-            BOOL successfulPing = (result.data != nil);
-            if (strongSelf.reachable && !successfulPing) {
+            BOOL isServiceAvailable = (result != nil && !status.isError);
+            __block NSArray *blocks = nil;
+            dispatch_barrier_sync(queue, ^{
                 
-                DDLogReachability([[strongSelf class] ddLogLevel], @"<PubNub> Connection went down.");
-            }
-            if (!strongSelf.reachable && successfulPing) {
+                __strong __typeof(self) strongSelf = weakSelf;
+                if (strongSelf) {
+                    
+                    blocks = [strongSelf->_probeCompletionBlocks copy];
+                    strongSelf->_probeCompletionBlocks = nil;
+                }
+            });
+            for (void(^probeBlock)(BOOL probeSuccessful) in blocks) {
                 
-                DDLogReachability([[strongSelf class] ddLogLevel], @"<PubNub> Connection restored.");
+                probeBlock(isServiceAvailable);
             }
-            if (strongSelf.pingCompleteBlock) {
+        }];
+        #pragma clang diagnostic pop
+    }
+}
+
+- (BOOL)isIdleForInterval:(NSTimeInterval)interval {
+    
+    __block NSDate *lastActivityDate = nil;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        lastActivityDate = self->_lastActivityDate;
+    });
+    
+    return (-[lastActivityDate timeIntervalSinceNow] >= interval);
+}
+
+
+#pragma mark - Handlers
+
+- (void)handleResponseForOperation:(PNOperationType)operation
+                 withRoundTripTime:(NSTimeInterval)roundTripTime {
+    
+    __block BOOL shouldReportRestore = NO;
+    __block BOOL wasReachable = YES;
+    dispatch_barrier_sync(self.resourceAccessQueue, ^{
+        
+        self->_lastActivityDate = [NSDate date];
+        
+        // Long-poll requests completion time depends from events rate and can't be used.
+        if (operation != PNSubscribeOperation) {
+            
+            if (self->_smoothedRoundTripTime == 0.0f) {
                 
-                strongSelf.pingCompleteBlock(successfulPing);
+                self->_smoothedRoundTripTime = roundTripTime;
+                self->_roundTripTimeVariance = (roundTripTime * 0.5f);
             }
-            if (strongSelf.pingingRemoteService) {
+            else {
                 
-                NSTimeInterval delay = ((strongSelf.reachable && !successfulPing) ? 1.f : 10.0f);
-                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
-                               dispatch_get_main_queue(), ^{
-                                   
-                                   strongSelf.pingRemoteService = NO;
-                                   [strongSelf startServicePing];
-                               });
+                NSTimeInterval deviation = fabs(self->_smoothedRoundTripTime - roundTripTime);
+                self->_roundTripTimeVariance = (0.75f * self->_roundTripTimeVariance +
+                                                0.25f * deviation);
+                self->_smoothedRoundTripTime = (0.875f * self->_smoothedRoundTripTime +
+                                                0.125f * roundTripTime);
             }
-            strongSelf.reachable = successfulPing;
-        }];
-        #pragma clang diagnostic pop
+        }
+        wasReachable = self->_reachable;
+        shouldReportRestore = self->_pingRemoteService;
+        self->_pingRemoteService = NO;
+        self->_reachable = YES;
+    });
+    
+    if (shouldReportRestore) {
+        
+        if (!wasReachable) {
+            
+            DDLogReachability([[self class] ddLogLevel], @"<PubNub> Connection restored.");
+        }
+        if (self.pingCompleteBlock) {
+            
+            self.pingCompleteBlock(YES);
+        }
     }
 }
 
-- (void)stopServicePing {
+- (void)handleIdleTimer {
     
-    self.pingRemoteService = NO;
+    // Silence static analyzer warnings.
+    // Code is aware about this case and at the end will simply call on 'nil' object method.
+    // In most cases if referenced object become 'nil' it mean what there is no more need in
+    // it and probably whole client instance has been deallocated.
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wreceiver-is-weak"
+    #pragma clang diagnostic ignored "-Warc-repeated-use-of-weak"
+    PubNub *client = self.client;
+    NSTimeInterval idleDeadline = client.configuration.connectionIdleDeadline;
+    if (!self.pingingRemoteService && [[client.subscriberManager allObjects] count] &&
+        [self isIdleForInterval:idleDeadline]) {
+        
+        __weak __typeof(self) weakSelf = self;
+        [self probeServiceWithCompletion:^(BOOL probeSuccessful) {
+            
+            // Service is reachable, but there is no events or long-poll timeout responses.
+            if (probeSuccessful) {
+                
+                DDLogReachability([[weakSelf class] ddLogLevel],
+                                  @"<PubNub> No traffic for %@ seconds. Re-issue subscribe request.",
+                                  @(idleDeadline));
+                PNSubscriber *subscriberManager = weakSelf.client.subscriberManager;
+                [subscriberManager continueSubscriptionCycleIfRequiredWithCompletion:nil];
+            }
+        }];
+    }
+    #pragma clang diagnostic pop
 }
 
 #pragma mark -
@@ -1,6 +1,11 @@
 #import <Foundation/Foundation.h>
 
 
+#pragma mark Class forward
+
+@class PubNub;
+
+
 /**
  @brief      Wrapper class around parameters which should be applied on resource path and query 
              string.
@@ -32,6 +37,24 @@
  */
 @property (nonatomic, readonly) NSDictionary *query;
 
+/**
+ @brief  Stores reference on date before which response on request should be received.
+ @note   Request will be completed with timeout status if it won't be completed before deadline.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSDate *deadline;
+
+/**
+ @brief      Stores reference on client on behalf of which request should be sent.
+ @discussion Network manager which is shared by clients from \b PNClientPool use this client's
+             \c uuid and \c authKey for request query and pass it's information to result and
+             status objects. Requests without client use network manager's client.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, weak) PubNub *client;
+
 
 ///------------------------------------------------
 /// @name Path components manipulation
@@ -0,0 +1,69 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNRequestTrace.h"
+
+
+#pragma mark Private interface declaration
+
+@interface PNRequestTrace (Private)
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Construct trace and record \c PNRequestEnqueuedStage for it.
+ 
+ @param operation One of \b PNOperationType enum fields which describe traced request.
+ 
+ @return Constructed and ready to use trace instance.
+ 
+ @since 4.1.0
+ */
++ (instancetype)traceForOperation:(PNOperationType)operation;
+
+/**
+ @brief  Retrieve reference on trace which has been attached to object.
+ 
+ @param object Reference on object (request or data task) to which trace has been attached.
+ 
+ @return Attached trace or \c nil in case if request isn't traced.
+ 
+ @since 4.1.0
+ */
++ (instancetype)traceForObject:(id)object;
+
+/**
+ @brief      Attach trace to object.
+ @discussion Trace passed along with request and data task which has been created for it.
+ 
+ @param object Reference on object (request or data task) to which trace should be attached.
+ 
+ @since 4.1.0
+ */
+- (void)attachToObject:(id)object;
+
+
+///------------------------------------------------
+/// @name Stages
+///------------------------------------------------
+
+/**
+ @brief      Record moment when processing reached specified \c stage.
+ @discussion Only first moment recorded for each stage (for example when hedged request completed
+             or few listeners notified with same trace).
+ 
+ @param stage One of \b PNRequestTraceStage enum fields which represent reached stage.
+ 
+ @since 4.1.0
+ */
+- (void)markStage:(PNRequestTraceStage)stage;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,83 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+/**
+ @brief      Class which is used to describe where time has been spent while request has been
+             processed.
+ @discussion Trace created by network manager for each request (if \c traceRequests enabled in
+             client configuration) and pass through all processing stages with it. Each stage
+             recorded with monotonic clock, so intervals between stages aren't affected by system
+             time change.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNRequestTrace : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores unique (within process) identifier of traced request.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) unsigned long long identifier;
+
+/**
+ @brief  Represent type of operation which has been traced.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, assign) PNOperationType operation;
+
+/**
+ @brief  Retrieve number of seconds which passed from request enqueue till specified \c stage.
+ 
+ @param stage One of \b PNRequestTraceStage enum fields which represent stage of interest.
+ 
+ @return Number of seconds or \b -1 in case if stage hasn't been reached (or skipped, like network
+         stages for request which failed before sending).
+ 
+ @since 4.1.0
+ */
+- (NSTimeInterval)intervalForStage:(PNRequestTraceStage)stage;
+
+/**
+ @brief  Convert trace to dictionary with stage names and number of milliseconds from request
+         enqueue.
+ 
+ @return Trace in dictionary representation.
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)dictionaryRepresentation;
+
+
+///------------------------------------------------
+/// @name Export
+///------------------------------------------------
+
+/**
+ @brief      Convert traces to Chrome trace-event format.
+ @discussion Each request represented by separate row with span for every pair of recorded stages.
+             Data can be loaded into \c chrome://tracing or any other tool which support this
+             format.
+ 
+ @param traces List of \b PNRequestTrace instances (can be collected from \c trace property of
+               results and statuses).
+ 
+ @return JSON data with \c traceEvents list.
+ 
+ @since 4.1.0
+ */
++ (NSData *)chromeTraceDataFromTraces:(NSArray *)traces;
+
+#pragma mark -
+
+
+@end
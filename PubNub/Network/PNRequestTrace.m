@@ -0,0 +1,237 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNRequestTrace+Private.h"
+#import "PNPrivateStructures.h"
+#import <libkern/OSAtomic.h>
+#import <mach/mach_time.h>
+#import <objc/runtime.h>
+#import <unistd.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores key which is used to attach trace to requests and data tasks.
+ 
+ @since 4.1.0
+ */
+static char kPNRequestTraceKey;
+
+/**
+ @brief  Stores number of stages which can be recorded by trace.
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNRequestTraceStagesCount = (PNCallbackInvokedStage + 1);
+
+/**
+ @brief  Stores names which is used for stages in dictionary representation.
+ 
+ @since 4.1.0
+ */
+static NSString * const PNRequestTraceStageNames[8] = {
+    [PNRequestEnqueuedStage] = @"enqueued", [PNRequestSentStage] = @"sent",
+    [PNResponseDeliveredStage] = @"delivered", [PNResponseDeserializedStage] = @"deserialized",
+    [PNResponseParsedStage] = @"parsed", [PNResultCreatedStage] = @"result-created",
+    [PNListenerEnqueuedStage] = @"listener-enqueued", [PNCallbackInvokedStage] = @"callback"
+};
+
+/**
+ @brief  Stores names which is used for spans between stages in Chrome trace-event format (span
+         named by stage at which it ends).
+ 
+ @since 4.1.0
+ */
+static NSString * const PNRequestTraceSpanNames[8] = {
+    [PNRequestEnqueuedStage] = @"", [PNRequestSentStage] = @"prepare",
+    [PNResponseDeliveredStage] = @"network", [PNResponseDeserializedStage] = @"deserialize",
+    [PNResponseParsedStage] = @"parse", [PNResultCreatedStage] = @"build result",
+    [PNListenerEnqueuedStage] = @"listener queue", [PNCallbackInvokedStage] = @"callback queue"
+};
+
+
+#pragma mark - Externs
+
+/**
+ @brief  Retrieve current value of monotonic clock.
+ 
+ @return Number of nanoseconds since system boot.
+ 
+ @since 4.1.0
+ */
+static uint64_t PNRequestTraceNow(void) {
+    
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        mach_timebase_info(&timebase);
+    });
+    
+    return (mach_absolute_time() * timebase.numer / timebase.denom);
+}
+
+
+#pragma mark - Protected interface declaration
+
+@interface PNRequestTrace () {
+    
+    /**
+     @brief  Stores monotonic timestamp (in nanoseconds) for each reached stage (\b 0 for stages
+             which hasn't been reached yet).
+     
+     @since 4.1.0
+     */
+    volatile int64_t _timestamps[8];
+}
+
+
+#pragma mark - Information
+
+@property (nonatomic, assign) unsigned long long identifier;
+@property (nonatomic, assign) PNOperationType operation;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Convert trace to list of Chrome trace-events.
+ 
+ @return List of complete ("X") events for each pair of recorded stages.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)chromeTraceEvents;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNRequestTrace
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)traceForOperation:(PNOperationType)operation {
+    
+    static volatile int64_t _lastIdentifier = 0;
+    PNRequestTrace *trace = [self new];
+    trace.identifier = (unsigned long long)OSAtomicIncrement64Barrier(&_lastIdentifier);
+    trace.operation = operation;
+    [trace markStage:PNRequestEnqueuedStage];
+    
+    return trace;
+}
+
++ (instancetype)traceForObject:(id)object {
+    
+    return (object ? objc_getAssociatedObject(object, &kPNRequestTraceKey) : nil);
+}
+
+- (void)attachToObject:(id)object {
+    
+    if (object) {
+        
+        objc_setAssociatedObject(object, &kPNRequestTraceKey, self,
+                                 OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+}
+
+
+#pragma mark - Stages
+
+- (void)markStage:(PNRequestTraceStage)stage {
+    
+    if ((NSUInteger)stage < kPNRequestTraceStagesCount) {
+        
+        OSAtomicCompareAndSwap64Barrier(0, (int64_t)PNRequestTraceNow(), &_timestamps[stage]);
+    }
+}
+
+- (NSTimeInterval)intervalForStage:(PNRequestTraceStage)stage {
+    
+    NSTimeInterval interval = -1.0f;
+    if ((NSUInteger)stage < kPNRequestTraceStagesCount && _timestamps[stage] > 0) {
+        
+        interval = ((_timestamps[stage] - _timestamps[PNRequestEnqueuedStage]) / 1000000000.0);
+    }
+    
+    return interval;
+}
+
+
+#pragma mark - Export
+
++ (NSData *)chromeTraceDataFromTraces:(NSArray *)traces {
+    
+    NSMutableArray *events = [NSMutableArray new];
+    for (PNRequestTrace *trace in traces) {
+        
+        [events addObjectsFromArray:[trace chromeTraceEvents]];
+    }
+    
+    return [NSJSONSerialization dataWithJSONObject:@{@"traceEvents": events,
+                                                     @"displayTimeUnit": @"ms"}
+                                           options:(NSJSONWritingOptions)0 error:NULL];
+}
+
+
+#pragma mark - Misc
+
+- (NSArray *)chromeTraceEvents {
+    
+    NSMutableArray *events = [NSMutableArray new];
+    NSString *operation = PNOperationDescriptors[self.operation].name;
+    int64_t previousTimestamp = _timestamps[PNRequestEnqueuedStage];
+    for (NSUInteger stageIdx = (PNRequestEnqueuedStage + 1); stageIdx < kPNRequestTraceStagesCount;
+         stageIdx++) {
+        
+        // Skipped stages (for example network stages for loopback requests) merged into span of
+        // next recorded stage.
+        int64_t timestamp = _timestamps[stageIdx];
+        if (timestamp > 0 && previousTimestamp > 0) {
+            
+            [events addObject:@{@"name": PNRequestTraceSpanNames[stageIdx], @"cat": @"pubnub",
+                                @"ph": @"X", @"ts": @(previousTimestamp / 1000.0),
+                                @"dur": @((timestamp - previousTimestamp) / 1000.0),
+                                @"pid": @(getpid()), @"tid": @(self.identifier),
+                                @"args": @{@"operation": operation}}];
+            previousTimestamp = timestamp;
+        }
+    }
+    
+    return [events copy];
+}
+
+- (NSDictionary *)dictionaryRepresentation {
+    
+    NSMutableDictionary *stages = [NSMutableDictionary new];
+    for (NSUInteger stageIdx = 0; stageIdx < kPNRequestTraceStagesCount; stageIdx++) {
+        
+        NSTimeInterval interval = [self intervalForStage:(PNRequestTraceStage)stageIdx];
+        if (interval >= 0.0f) {
+            
+            stages[PNRequestTraceStageNames[stageIdx]] = @(interval * 1000.0);
+        }
+    }
+    
+    return @{@"Identifier": @(self.identifier),
+             @"Operation": PNOperationDescriptors[self.operation].name, @"Stages (ms)": stages};
+}
+
+- (NSString *)debugDescription {
+    
+    return [[self dictionaryRepresentation] description];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,115 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+#pragma mark Externs
+
+/**
+ @brief  Keys which is used to store fields of record read from traffic trace.
+ 
+ @since 4.1.0
+ */
+extern NSString * const kPNTrafficRecordOperationKey;
+extern NSString * const kPNTrafficRecordOffsetKey;
+extern NSString * const kPNTrafficRecordDurationKey;
+extern NSString * const kPNTrafficRecordPathKey;
+extern NSString * const kPNTrafficRecordBodyKey;
+extern NSString * const kPNTrafficRecordStatusCodeKey;
+extern NSString * const kPNTrafficRecordMIMETypeKey;
+extern NSString * const kPNTrafficRecordDataKey;
+extern NSString * const kPNTrafficRecordErrorDomainKey;
+extern NSString * const kPNTrafficRecordErrorCodeKey;
+
+
+/**
+ @brief      Writer and reader of binary traffic traces.
+ @discussion Network manager pass to capture each request which has been sent over HTTP along with
+             response (or error) and timings. Trace file start with \c PNTRACE1 signature which
+             followed by records in order in which responses has been received. Each record has
+             fixed-size little-endian header (offset from capture start and duration in
+             microseconds, operation, status code, error code and length of each variable-size
+             field) which followed by request path with query, request body, response content
+             type, error domain and response body.
+ @note       Records written on private serial queue and flushed right away, so trace contain all
+             responses which has been received before process termination.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNTrafficCapture : NSObject
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief      Retrieve reference on capture which write into file at specified \c path.
+ @discussion Capture shared by all clients which use same path, so offsets of all records
+             calculated from same point in time. Existing file will be truncated when capture for
+             it created for the first time.
+ 
+ @param path Full path to file into which records should be written.
+ 
+ @return Shared capture instance or \c nil in case if file can't be opened for writing.
+ 
+ @since 4.1.0
+ */
++ (instancetype)captureWithPath:(NSString *)path;
+
+
+///------------------------------------------------
+/// @name Capture
+///------------------------------------------------
+
+/**
+ @brief  Retrieve current time which should be used as request start time.
+ 
+ @return Number of seconds since system boot (not affected by system time change).
+ 
+ @since 4.1.0
+ */
++ (NSTimeInterval)currentTime;
+
+/**
+ @brief  Write record for completed request.
+ 
+ @param operation One of \b PNOperationType enum fields which describe what kind of request has
+                  been sent.
+ @param request   Reference on request which has been sent to \b PubNub network.
+ @param response  Reference on response which has been received (\c nil in case of network
+                  error).
+ @param data      Reference on response body.
+ @param error     Reference on request processing error.
+ @param startTime Time (from \c +currentTime) when request has been sent.
+ 
+ @since 4.1.0
+ */
+- (void)recordOperation:(PNOperationType)operation withRequest:(NSURLRequest *)request
+               response:(NSHTTPURLResponse *)response data:(NSData *)data error:(NSError *)error
+              startTime:(NSTimeInterval)startTime;
+
+
+///------------------------------------------------
+/// @name Reading
+///------------------------------------------------
+
+/**
+ @brief  Read all records from traffic trace.
+ 
+ @param path  Full path to file which has been written by capture.
+ @param error Pointer into which reading error will be stored (for example if file doesn't have
+              trace signature or truncated in the middle of record).
+ 
+ @return List of dictionaries (with \c kPNTrafficRecord* keys) in order in which they has been
+         written or \c nil in case of error.
+ 
+ @since 4.1.0
+ */
++ (NSArray *)recordsFromFileAtPath:(NSString *)path error:(NSError **)error;
+
+#pragma mark -
+
+
+@end
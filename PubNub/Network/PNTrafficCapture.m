@@ -0,0 +1,383 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNTrafficCapture.h"
+#import <libkern/OSByteOrder.h>
+#import <stdio.h>
+
+
+#pragma mark Externs
+
+NSString * const kPNTrafficRecordOperationKey = @"operation";
+NSString * const kPNTrafficRecordOffsetKey = @"offset";
+NSString * const kPNTrafficRecordDurationKey = @"duration";
+NSString * const kPNTrafficRecordPathKey = @"path";
+NSString * const kPNTrafficRecordBodyKey = @"body";
+NSString * const kPNTrafficRecordStatusCodeKey = @"statusCode";
+NSString * const kPNTrafficRecordMIMETypeKey = @"MIMEType";
+NSString * const kPNTrafficRecordDataKey = @"data";
+NSString * const kPNTrafficRecordErrorDomainKey = @"errorDomain";
+NSString * const kPNTrafficRecordErrorCodeKey = @"errorCode";
+
+
+#pragma mark - Static
+
+/**
+ @brief  Stores signature which is written at the beginning of trace file.
+ 
+ @since 4.1.0
+ */
+static char const kPNTrafficCaptureSignature[8] = {'P', 'N', 'T', 'R', 'A', 'C', 'E', '1'};
+
+/**
+ @brief  Stores number of variable-size fields which follow record header (path, body, content
+         type, error domain and response body).
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNTrafficRecordFieldsCount = 5;
+
+/**
+ @brief  Stores size of fixed part of record: offset (8 bytes), duration (4 bytes), operation
+         (2 bytes), status code (2 bytes), error code (4 bytes) and length of each field (4 bytes).
+ 
+ @since 4.1.0
+ */
+static NSUInteger const kPNTrafficRecordHeaderSize = (20 + kPNTrafficRecordFieldsCount * 4);
+
+
+#pragma mark - Private functions
+
+/**
+ @brief  Append integer values in little-endian byte order.
+ 
+ @since 4.1.0
+ */
+static void PNTrafficAppendUInt64(NSMutableData *data, uint64_t value) {
+    
+    value = OSSwapHostToLittleInt64(value);
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void PNTrafficAppendUInt32(NSMutableData *data, uint32_t value) {
+    
+    value = OSSwapHostToLittleInt32(value);
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void PNTrafficAppendUInt16(NSMutableData *data, uint16_t value) {
+    
+    value = OSSwapHostToLittleInt16(value);
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+/**
+ @brief  Read little-endian integer values and move \c cursor behind them.
+ 
+ @since 4.1.0
+ */
+static uint64_t PNTrafficReadUInt64(const uint8_t **cursor) {
+    
+    uint64_t value = 0;
+    memcpy(&value, *cursor, sizeof(value));
+    *cursor += sizeof(value);
+    
+    return OSSwapLittleToHostInt64(value);
+}
+
+static uint32_t PNTrafficReadUInt32(const uint8_t **cursor) {
+    
+    uint32_t value = 0;
+    memcpy(&value, *cursor, sizeof(value));
+    *cursor += sizeof(value);
+    
+    return OSSwapLittleToHostInt32(value);
+}
+
+static uint16_t PNTrafficReadUInt16(const uint8_t **cursor) {
+    
+    uint16_t value = 0;
+    memcpy(&value, *cursor, sizeof(value));
+    *cursor += sizeof(value);
+    
+    return OSSwapLittleToHostInt16(value);
+}
+
+
+#pragma mark - Private interface declaration
+
+@interface PNTrafficCapture ()
+
+
+#pragma mark - Information
+
+/**
+ @brief  Stores reference on file into which records is written.
+ @note   File should be accessed only from \c writeQueue.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) FILE *file;
+
+/**
+ @brief  Stores time (from \c +currentTime) when capture has been created and from which records
+         offset calculated.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval startTime;
+
+/**
+ @brief  Stores reference on queue which is used to serialize writes into trace file.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize capture which will write into opened trace \c file.
+ 
+ @param file Reference on file which already has trace signature.
+ 
+ @return Initialized and ready to use capture.
+ 
+ @since 4.1.0
+ */
+- (instancetype)initWithFile:(FILE *)file;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct error which is used to report broken trace file.
+ 
+ @param path        Full path to file which has been read.
+ @param description Human-readable error description.
+ 
+ @return Error with \c NSCocoaErrorDomain domain.
+ 
+ @since 4.1.0
+ */
++ (NSError *)readingErrorForFileAtPath:(NSString *)path withDescription:(NSString *)description;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNTrafficCapture
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)captureWithPath:(NSString *)path {
+    
+    static NSMutableDictionary *_captures;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _captures = [NSMutableDictionary new];
+    });
+    
+    PNTrafficCapture *capture = nil;
+    NSString *standardizedPath = [path stringByStandardizingPath];
+    @synchronized(_captures) {
+        
+        capture = _captures[standardizedPath];
+        if (!capture && [standardizedPath length]) {
+            
+            FILE *file = fopen([standardizedPath fileSystemRepresentation], "wb");
+            if (file) {
+                
+                fwrite(kPNTrafficCaptureSignature, 1, sizeof(kPNTrafficCaptureSignature), file);
+                fflush(file);
+                capture = [[self alloc] initWithFile:file];
+                _captures[standardizedPath] = capture;
+            }
+        }
+    }
+    
+    return capture;
+}
+
+- (instancetype)initWithFile:(FILE *)file {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _file = file;
+        _startTime = [[self class] currentTime];
+        _writeQueue = dispatch_queue_create("com.pubnub.traffic-capture", DISPATCH_QUEUE_SERIAL);
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    if (_file) {
+        
+        fclose(_file);
+    }
+}
+
+
+#pragma mark - Capture
+
++ (NSTimeInterval)currentTime {
+    
+    return [[NSProcessInfo processInfo] systemUptime];
+}
+
+- (void)recordOperation:(PNOperationType)operation withRequest:(NSURLRequest *)request
+               response:(NSHTTPURLResponse *)response data:(NSData *)data error:(NSError *)error
+              startTime:(NSTimeInterval)startTime {
+    
+    NSTimeInterval duration = MAX([[self class] currentTime] - startTime, 0.0f);
+    NSTimeInterval offset = MAX(startTime - self.startTime, 0.0f);
+    
+    // Percent-encoded path and query stored as they has been sent, so replayer can restore
+    // parameters exactly.
+    NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL
+                                             resolvingAgainstBaseURL:YES];
+    NSString *path = (components.percentEncodedPath?: @"");
+    if ([components.percentEncodedQuery length]) {
+        
+        path = [path stringByAppendingFormat:@"?%@", components.percentEncodedQuery];
+    }
+    NSData *empty = [NSData data];
+    NSArray *fields = @[[path dataUsingEncoding:NSUTF8StringEncoding],
+                        (request.HTTPBody?: empty),
+                        ([response.MIMEType dataUsingEncoding:NSUTF8StringEncoding]?: empty),
+                        ([error.domain dataUsingEncoding:NSUTF8StringEncoding]?: empty),
+                        (data?: empty)];
+    NSMutableData *record = [NSMutableData dataWithCapacity:kPNTrafficRecordHeaderSize];
+    PNTrafficAppendUInt64(record, (uint64_t)(offset * 1000000.0f));
+    PNTrafficAppendUInt32(record, (uint32_t)MIN(duration * 1000000.0f, (double)UINT32_MAX));
+    PNTrafficAppendUInt16(record, (uint16_t)operation);
+    PNTrafficAppendUInt16(record, (uint16_t)response.statusCode);
+    PNTrafficAppendUInt32(record, (uint32_t)(int32_t)error.code);
+    for (NSData *field in fields) {
+        
+        PNTrafficAppendUInt32(record, (uint32_t)[field length]);
+    }
+    for (NSData *field in fields) {
+        
+        [record appendData:field];
+    }
+    
+    dispatch_async(self.writeQueue, ^{
+        
+        fwrite([record bytes], 1, [record length], self.file);
+        fflush(self.file);
+    });
+}
+
+
+#pragma mark - Reading
+
++ (NSArray *)recordsFromFileAtPath:(NSString *)path error:(NSError **)error {
+    
+    NSError *readingError = nil;
+    NSData *trace = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe
+                                             error:&readingError];
+    if (trace && ([trace length] < sizeof(kPNTrafficCaptureSignature) ||
+                  memcmp([trace bytes], kPNTrafficCaptureSignature,
+                         sizeof(kPNTrafficCaptureSignature)) != 0)) {
+        
+        readingError = [self readingErrorForFileAtPath:path
+                                       withDescription:@"File doesn't contain traffic trace."];
+    }
+    
+    NSMutableArray *records = [NSMutableArray new];
+    const uint8_t *bytes = [trace bytes];
+    const uint8_t *cursor = bytes + sizeof(kPNTrafficCaptureSignature);
+    const uint8_t *end = bytes + [trace length];
+    while (!readingError && cursor < end) {
+        
+        if ((NSUInteger)(end - cursor) < kPNTrafficRecordHeaderSize) {
+            
+            readingError = [self readingErrorForFileAtPath:path
+                                           withDescription:@"Traffic trace truncated."];
+            break;
+        }
+        uint64_t offset = PNTrafficReadUInt64(&cursor);
+        uint32_t duration = PNTrafficReadUInt32(&cursor);
+        uint16_t operation = PNTrafficReadUInt16(&cursor);
+        uint16_t statusCode = PNTrafficReadUInt16(&cursor);
+        int32_t errorCode = (int32_t)PNTrafficReadUInt32(&cursor);
+        uint32_t lengths[kPNTrafficRecordFieldsCount];
+        uint64_t fieldsLength = 0;
+        for (NSUInteger fieldIdx = 0; fieldIdx < kPNTrafficRecordFieldsCount; fieldIdx++) {
+            
+            lengths[fieldIdx] = PNTrafficReadUInt32(&cursor);
+            fieldsLength += lengths[fieldIdx];
+        }
+        if ((uint64_t)(end - cursor) < fieldsLength) {
+            
+            readingError = [self readingErrorForFileAtPath:path
+                                           withDescription:@"Traffic trace truncated."];
+            break;
+        }
+        
+        NSMutableArray *fields = [NSMutableArray new];
+        for (NSUInteger fieldIdx = 0; fieldIdx < kPNTrafficRecordFieldsCount; fieldIdx++) {
+            
+            [fields addObject:[trace subdataWithRange:NSMakeRange((NSUInteger)(cursor - bytes),
+                                                                  lengths[fieldIdx])]];
+            cursor += lengths[fieldIdx];
+        }
+        NSString *requestPath = [[NSString alloc] initWithData:fields[0]
+                                                      encoding:NSUTF8StringEncoding];
+        NSString *MIMEType = [[NSString alloc] initWithData:fields[2]
+                                                   encoding:NSUTF8StringEncoding];
+        NSString *errorDomain = [[NSString alloc] initWithData:fields[3]
+                                                      encoding:NSUTF8StringEncoding];
+        NSMutableDictionary *record = [@{
+            kPNTrafficRecordOperationKey: @(operation),
+            kPNTrafficRecordOffsetKey: @((double)offset / 1000000.0f),
+            kPNTrafficRecordDurationKey: @((double)duration / 1000000.0f),
+            kPNTrafficRecordPathKey: (requestPath?: @""), kPNTrafficRecordBodyKey: fields[1],
+            kPNTrafficRecordStatusCodeKey: @(statusCode), kPNTrafficRecordDataKey: fields[4],
+            kPNTrafficRecordErrorCodeKey: @(errorCode)
+        } mutableCopy];
+        if ([MIMEType length]) {
+            
+            record[kPNTrafficRecordMIMETypeKey] = MIMEType;
+        }
+        if ([errorDomain length]) {
+            
+            record[kPNTrafficRecordErrorDomainKey] = errorDomain;
+        }
+        [records addObject:[record copy]];
+    }
+    if (readingError && error) {
+        
+        *error = readingError;
+    }
+    
+    return (!readingError ? [records copy] : nil);
+}
+
+
+#pragma mark - Misc
+
++ (NSError *)readingErrorForFileAtPath:(NSString *)path withDescription:(NSString *)description {
+    
+    return [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError
+                           userInfo:@{NSLocalizedDescriptionKey: description,
+                                      NSFilePathErrorKey: (path?: @"")}];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,134 @@
+#import <Foundation/Foundation.h>
+#import "PNStructures.h"
+
+
+/**
+ @brief  Replayed request processing completion block.
+ 
+ @param response Reference on response which has been restored from trace record (\c nil in case
+                 of error).
+ @param data     Reference on recorded response body.
+ @param error    Reference on request processing error (recorded network error, cancellation or
+                 timeout of request for which trace doesn't have any records).
+ 
+ @since 4.1.0
+ */
+typedef void(^PNTrafficReplayCompletionBlock)(NSHTTPURLResponse *response, NSData *data,
+                                              NSError *error);
+
+
+/**
+ @brief      Traffic trace player.
+ @discussion Replayer used by clients which configured with \b PNReplayTransport and answer
+             requests with responses which has been recorded by \b PNTrafficCapture. Each request
+             receive next recorded response for same operation type. Response delivered at time
+             when it has been received during capture (relative to first replayed request and
+             scaled by replay speed) or right away if client requested it too late. Delay between
+             recorded and actual delivery time reported as schedule lag and show whether client
+             able to process traffic with recorded pace.
+ @note       Trace records matched by operation type only, so client should subscribe on same
+             channels as captured client to get same events.
+ 
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface PNTrafficReplayer : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores list of channels and channel groups which has been used by subscribe requests in
+         loaded trace (presence channels included).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, readonly, copy) NSArray *channels;
+@property (nonatomic, readonly, copy) NSArray *channelGroups;
+
+/**
+ @brief  Retrieve replay progress information.
+ 
+ @return Dictionary with number of loaded (\c records), \c replayed and \c missing (requests for
+         which trace doesn't have records) records, list of \c remaining records per operation
+         name, replayed response \c bytes, recorded traffic \c duration, \c elapsed time and
+         schedule lag percentiles (\c lag in milliseconds).
+ 
+ @since 4.1.0
+ */
+- (NSDictionary *)statistics;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Retrieve reference on replayer which is shared by all clients in process.
+ 
+ @return Shared replayer instance.
+ 
+ @since 4.1.0
+ */
++ (instancetype)sharedReplayer;
+
+/**
+ @brief      Load trace which should be replayed.
+ @discussion Replay clock start with first request which will be processed after trace load.
+ 
+ @param path  Full path to file which has been written by \b PNTrafficCapture.
+ @param speed Replay speed multiplier (\c 1 - recorded pace, \c 10 - ten times faster). In case if
+              \c 0 passed, responses delivered as soon as they has been requested.
+ @param error Pointer into which trace reading error will be stored.
+ 
+ @return \c YES in case if trace has been loaded.
+ 
+ @since 4.1.0
+ */
+- (BOOL)loadTraceAtPath:(NSString *)path speed:(double)speed error:(NSError **)error;
+
+
+///------------------------------------------------
+/// @name Requests processing
+///------------------------------------------------
+
+/**
+ @brief      Process request for specified \c operation.
+ @discussion Request which doesn't have recorded response complete right away with error, except
+             subscribe requests which held till \c timeout expire (same as \b PubNub network do
+             when there is no new events).
+ @note       Completion block called on private replayer queue.
+ 
+ @param operation One of \b PNOperationType enum fields which describe what kind of request should
+                  be processed.
+ @param request   Reference on request which has been built for \b PubNub network.
+ @param timeout   Maximum number of seconds during which request can be held.
+ @param block     Reference on block which should be called at the end of request processing.
+ 
+ @return Reference on opaque request object which can be used to cancel it.
+ 
+ @since 4.1.0
+ */
+- (id)processOperation:(PNOperationType)operation withRequest:(NSURLRequest *)request
+               timeout:(NSTimeInterval)timeout completion:(PNTrafficReplayCompletionBlock)block;
+
+/**
+ @brief      Cancel request which still waiting for response.
+ @discussion Request completion block will be called with \c NSURLErrorCancelled error. Record
+             which has been taken by request (if response not delivered yet) returned to queue and
+             will be delivered to next request for same operation.
+ 
+ @param request Reference on opaque request object which has been returned by
+                \c -processOperation:withRequest:timeout:completion:.
+ 
+ @since 4.1.0
+ */
+- (void)cancelRequest:(id)request;
+
+#pragma mark -
+
+
+@end
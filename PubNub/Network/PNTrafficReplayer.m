@@ -0,0 +1,455 @@
+/**
+ @author Sergey Mamontov
+ @since 4.1.0
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "PNTrafficReplayer.h"
+#import "PNPrivateStructures.h"
+#import "PNTrafficCapture.h"
+#import "PNHelpers.h"
+
+
+#pragma mark Protected interface declaration
+
+@interface PNTrafficReplayer ()
+
+
+#pragma mark - Information
+
+@property (nonatomic, copy) NSArray *channels;
+@property (nonatomic, copy) NSArray *channelGroups;
+
+/**
+ @brief  Stores replay speed multiplier (\c 0 - responses delivered right away).
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) double speed;
+
+/**
+ @brief      Stores reference on records which hasn't been replayed yet.
+ @discussion Operation type is key and list of records (in order in which they has been captured)
+             is value.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableDictionary *records;
+
+/**
+ @brief  Stores recorded time of first request in trace from which responses schedule calculated.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval traceStartTime;
+
+/**
+ @brief  Stores recorded time when last response has been received.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval traceEndTime;
+
+/**
+ @brief  Stores time (from \c +[PNTrafficCapture currentTime]) of first replayed request or \b 0
+         if replay not started yet.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSTimeInterval startTime;
+
+/**
+ @brief  Stores replay counters: number of loaded, replayed and missing records and number of
+         replayed response bytes.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, assign) NSUInteger loadedCount;
+@property (nonatomic, assign) NSUInteger replayedCount;
+@property (nonatomic, assign) NSUInteger missingCount;
+@property (nonatomic, assign) unsigned long long replayedBytes;
+
+/**
+ @brief  Stores list of intervals (in seconds) between recorded and actual response delivery time.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) NSMutableArray *lags;
+
+/**
+ @brief  Stores reference on queue which is used to serialize access to replayer state and call
+         requests completion blocks.
+ 
+ @since 4.1.0
+ */
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+
+#pragma mark - Requests processing
+
+/**
+ @brief  Deliver response from trace \c record to request.
+ @note   This method should be called only from resource access queue.
+ 
+ @param record  Reference on trace record which should be replayed.
+ @param request Reference on opaque request object (stores completion block and URL).
+ 
+ @since 4.1.0
+ */
+- (void)replayRecord:(NSDictionary *)record forRequest:(NSMutableDictionary *)request;
+
+/**
+ @brief  Complete request and call it's completion block (if request not completed yet).
+ @note   This method should be called only from resource access queue.
+ 
+ @param request  Reference on opaque request object which should be completed.
+ @param response Reference on restored HTTP response.
+ @param data     Reference on response body.
+ @param error    Reference on request processing error.
+ 
+ @since 4.1.0
+ */
+- (void)completeRequest:(NSMutableDictionary *)request withResponse:(NSHTTPURLResponse *)response
+                   data:(NSData *)data error:(NSError *)error;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Collect channels and channel groups which has been used by subscribe requests.
+ 
+ @param records List of subscribe records from trace.
+ 
+ @since 4.1.0
+ */
+- (void)updateSubscriptionFromRecords:(NSArray *)records;
+
+/**
+ @brief  Retrieve list of percent-decoded names from comma-separated request parameter value.
+ 
+ @since 4.1.0
+ */
+- (NSArray *)namesFrom:(NSString *)value;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation PNTrafficReplayer
+
+
+#pragma mark - Information
+
+- (NSDictionary *)statistics {
+    
+    __block NSDictionary *statistics = nil;
+    dispatch_sync(self.resourceAccessQueue, ^{
+        
+        NSMutableDictionary *remaining = [NSMutableDictionary new];
+        [self.records enumerateKeysAndObjectsUsingBlock:^(NSNumber *operation, NSArray *records,
+                                                          __unused BOOL *stop) {
+            
+            if ([records count]) {
+                
+                remaining[PNOperationDescriptors[operation.integerValue].name] = @([records count]);
+            }
+        }];
+        NSArray *lags = [self.lags sortedArrayUsingSelector:@selector(compare:)];
+        NSMutableDictionary *lag = [NSMutableDictionary new];
+        NSDictionary *percentiles = @{@"p50": @0.5f, @"p90": @0.9f, @"p99": @0.99f, @"max": @1.0f};
+        [percentiles enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSNumber *percentile,
+                                                         __unused BOOL *stop) {
+            
+            if ([lags count]) {
+                
+                NSUInteger sampleIdx = (NSUInteger)ceil([percentile doubleValue] * [lags count]);
+                double value = [lags[MIN(MAX(sampleIdx, 1), [lags count]) - 1] doubleValue];
+                lag[name] = @(value * 1000.0f);
+            }
+        }];
+        NSTimeInterval elapsed = 0.0f;
+        if (self.startTime > 0.0f) {
+            
+            elapsed = ([PNTrafficCapture currentTime] - self.startTime);
+        }
+        statistics = @{@"records": @(self.loadedCount), @"replayed": @(self.replayedCount),
+                       @"missing": @(self.missingCount), @"remaining": remaining,
+                       @"bytes": @(self.replayedBytes),
+                       @"duration": @(self.traceEndTime - self.traceStartTime),
+                       @"elapsed": @(elapsed), @"lag": lag};
+    });
+    
+    return statistics;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sharedReplayer {
+    
+    static PNTrafficReplayer *_sharedReplayer;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _sharedReplayer = [self new];
+    });
+    
+    return _sharedReplayer;
+}
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _records = [NSMutableDictionary new];
+        _lags = [NSMutableArray new];
+        _resourceAccessQueue = dispatch_queue_create("com.pubnub.traffic-replayer",
+                                                     DISPATCH_QUEUE_SERIAL);
+    }
+    
+    return self;
+}
+
+- (BOOL)loadTraceAtPath:(NSString *)path speed:(double)speed error:(NSError **)error {
+    
+    NSArray *records = [PNTrafficCapture recordsFromFileAtPath:path error:error];
+    if (records) {
+        
+        dispatch_sync(self.resourceAccessQueue, ^{
+            
+            [self.records removeAllObjects];
+            [self.lags removeAllObjects];
+            self.speed = MAX(speed, 0.0f);
+            self.startTime = 0.0f;
+            self.loadedCount = [records count];
+            self.replayedCount = 0;
+            self.missingCount = 0;
+            self.replayedBytes = 0;
+            self.traceStartTime = ([records count] ? DBL_MAX : 0.0f);
+            self.traceEndTime = 0.0f;
+            for (NSDictionary *record in records) {
+                
+                NSNumber *operation = record[kPNTrafficRecordOperationKey];
+                NSTimeInterval offset = [record[kPNTrafficRecordOffsetKey] doubleValue];
+                NSTimeInterval duration = [record[kPNTrafficRecordDurationKey] doubleValue];
+                self.traceStartTime = MIN(self.traceStartTime, offset);
+                self.traceEndTime = MAX(self.traceEndTime, offset + duration);
+                if (!self.records[operation]) {
+                    
+                    self.records[operation] = [NSMutableArray new];
+                }
+                [self.records[operation] addObject:record];
+            }
+            [self updateSubscriptionFromRecords:self.records[@(PNSubscribeOperation)]];
+        });
+    }
+    
+    return (records != nil);
+}
+
+
+#pragma mark - Requests processing
+
+- (id)processOperation:(PNOperationType)operation withRequest:(NSURLRequest *)request
+               timeout:(NSTimeInterval)timeout completion:(PNTrafficReplayCompletionBlock)block {
+    
+    NSMutableDictionary *replayRequest = [@{@"operation": @(operation)} mutableCopy];
+    if (block) {
+        
+        replayRequest[@"block"] = [block copy];
+    }
+    if (request.URL) {
+        
+        replayRequest[@"url"] = request.URL;
+    }
+    dispatch_async(self.resourceAccessQueue, ^{
+        
+        NSTimeInterval currentTime = [PNTrafficCapture currentTime];
+        if (self.startTime <= 0.0f) {
+            
+            self.startTime = currentTime;
+        }
+        NSMutableArray *records = self.records[@(operation)];
+        NSDictionary *record = [records firstObject];
+        if (record) {
+            
+            [records removeObjectAtIndex:0];
+            replayRequest[@"record"] = record;
+            NSTimeInterval delay = 0.0f;
+            if (self.speed > 0.0f) {
+                
+                // Response scheduled at time when it has been received during capture.
+                NSTimeInterval receiveTime = ([record[kPNTrafficRecordOffsetKey] doubleValue] +
+                                              [record[kPNTrafficRecordDurationKey] doubleValue]);
+                NSTimeInterval dueTime = (self.startTime +
+                                          (receiveTime - self.traceStartTime) / self.speed);
+                delay = MAX(dueTime - currentTime, 0.0f);
+                replayRequest[@"due"] = @(dueTime);
+            }
+            if (delay > 0.0f) {
+                
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                               self.resourceAccessQueue, ^{
+                    
+                    [self replayRecord:record forRequest:replayRequest];
+                });
+            }
+            else {
+                
+                [self replayRecord:record forRequest:replayRequest];
+            }
+        }
+        else if (operation == PNSubscribeOperation) {
+            
+            // There is no more events in trace, so long-poll request will be completed same way
+            // as PubNub network do when it doesn't receive response from service.
+            self.missingCount++;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)),
+                           self.resourceAccessQueue, ^{
+                
+                NSError *error = [NSError errorWithDomain:NSURLErrorDomain
+                                                     code:NSURLErrorTimedOut userInfo:nil];
+                [self completeRequest:replayRequest withResponse:nil data:nil error:error];
+            });
+        }
+        else {
+            
+            self.missingCount++;
+            NSError *error = [NSError errorWithDomain:NSURLErrorDomain
+                                                 code:NSURLErrorResourceUnavailable
+                                             userInfo:@{NSLocalizedDescriptionKey:
+                                                            @"Trace doesn't have response."}];
+            [self completeRequest:replayRequest withResponse:nil data:nil error:error];
+        }
+    });
+    
+    return replayRequest;
+}
+
+- (void)cancelRequest:(id)request {
+    
+    if (request) {
+        
+        dispatch_async(self.resourceAccessQueue, ^{
+            
+            // Response which hasn't been delivered yet should be received by next request (client
+            // cancel subscribe request each time when subscription list changes).
+            NSDictionary *record = request[@"record"];
+            if (record && request[@"block"]) {
+                
+                [self.records[request[@"operation"]] insertObject:record atIndex:0];
+            }
+            NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled
+                                             userInfo:nil];
+            [self completeRequest:request withResponse:nil data:nil error:error];
+        });
+    }
+}
+
+- (void)replayRecord:(NSDictionary *)record forRequest:(NSMutableDictionary *)request {
+    
+    // Request has been cancelled and record returned to queue.
+    if (!request[@"block"]) {
+        
+        return;
+    }
+    if (request[@"due"]) {
+        
+        NSTimeInterval lag = ([PNTrafficCapture currentTime] - [request[@"due"] doubleValue]);
+        [self.lags addObject:@(MAX(lag, 0.0f))];
+    }
+    self.replayedCount++;
+    NSHTTPURLResponse *response = nil;
+    NSError *error = nil;
+    NSData *data = record[kPNTrafficRecordDataKey];
+    NSInteger statusCode = [record[kPNTrafficRecordStatusCodeKey] integerValue];
+    NSString *errorDomain = record[kPNTrafficRecordErrorDomainKey];
+    if (statusCode == 0 && errorDomain) {
+        
+        error = [NSError errorWithDomain:errorDomain
+                                    code:[record[kPNTrafficRecordErrorCodeKey] integerValue]
+                                userInfo:nil];
+    }
+    else {
+        
+        NSURL *url = (request[@"url"]?: [NSURL URLWithString:record[kPNTrafficRecordPathKey]]);
+        NSDictionary *headers = nil;
+        if (record[kPNTrafficRecordMIMETypeKey]) {
+            
+            headers = @{@"Content-Type": record[kPNTrafficRecordMIMETypeKey]};
+        }
+        response = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:statusCode
+                                              HTTPVersion:@"HTTP/1.1" headerFields:headers];
+        self.replayedBytes += [data length];
+    }
+    [self completeRequest:request withResponse:response data:data error:error];
+}
+
+- (void)completeRequest:(NSMutableDictionary *)request withResponse:(NSHTTPURLResponse *)response
+                   data:(NSData *)data error:(NSError *)error {
+    
+    // Block removed from request, so it won't be called second time (for example if request has
+    // been cancelled while it's response was scheduled).
+    PNTrafficReplayCompletionBlock block = request[@"block"];
+    [request removeObjectForKey:@"block"];
+    if (block) {
+        
+        block(response, data, error);
+    }
+}
+
+
+#pragma mark - Misc
+
+- (void)updateSubscriptionFromRecords:(NSArray *)records {
+    
+    NSArray *templateComponents = [PNOperationDescriptors[PNSubscribeOperation].requestTemplate
+                                   componentsSeparatedByString:@"/"];
+    NSUInteger channelsIdx = [templateComponents indexOfObject:@"{channels}"];
+    NSMutableOrderedSet *channels = [NSMutableOrderedSet new];
+    NSMutableOrderedSet *groups = [NSMutableOrderedSet new];
+    for (NSDictionary *record in records) {
+        
+        NSURLComponents *components = [NSURLComponents
+                                       componentsWithString:record[kPNTrafficRecordPathKey]];
+        NSArray *pathComponents = [components.percentEncodedPath componentsSeparatedByString:@"/"];
+        if (channelsIdx < [pathComponents count]) {
+            
+            [channels addObjectsFromArray:[self namesFrom:pathComponents[channelsIdx]]];
+        }
+        for (NSString *field in [components.percentEncodedQuery componentsSeparatedByString:@"&"]) {
+            
+            if ([field hasPrefix:@"channel-group="]) {
+                
+                NSString *value = [field substringFromIndex:[@"channel-group=" length]];
+                [groups addObjectsFromArray:[self namesFrom:value]];
+            }
+        }
+    }
+    self.channels = [channels array];
+    self.channelGroups = [groups array];
+}
+
+- (NSArray *)namesFrom:(NSString *)value {
+    
+    NSMutableArray *names = [NSMutableArray new];
+    for (NSString *name in [PNChannel namesFromRequest:(value?: @"")]) {
+        
+        NSString *decodedName = ([name stringByRemovingPercentEncoding]?: name);
+        if ([decodedName length] && ![decodedName isEqualToString:@","]) {
+            
+            [names addObject:decodedName];
+        }
+    }
+    
+    return [names copy];
+}
+
+#pragma mark -
+
+
+@end
@@ -5,43 +5,11 @@
  */
 #import "PNURLBuilder.h"
 #import "PNRequestParameters.h"
+#import "PNPrivateStructures.h"
 #import "PNDictionary.h"
 
 
-#pragma mark Static
-
-/**
- @brief  API endpoints description basing on operation type.
- 
- @since 4.0
- */
-static NSString * const PNOperationRequestTemplate[22] = {
-    [PNSubscribeOperation] = @"/subscribe/{sub-key}/{channels}/0/{tt}",
-    [PNUnsubscribeOperation] = @"/v2/presence/sub_key/{sub-key}/channel/{channels}/leave",
-    [PNPublishOperation] = @"/publish/{pub-key}/{sub-key}/0/{channel}/0/{message}",
-    [PNHistoryOperation] = @"/v2/history/sub-key/{sub-key}/channel/{channel}",
-    [PNWhereNowOperation] = @"/v2/presence/sub-key/{sub-key}/uuid/{uuid}",
-    [PNHereNowGlobalOperation] = @"/v2/presence/sub-key/{sub-key}",
-    [PNHereNowForChannelOperation] = @"/v2/presence/sub-key/{sub-key}/channel/{channel}",
-    [PNHereNowForChannelGroupOperation] = @"/v2/presence/sub-key/{sub-key}/channel/{channel}",
-    [PNHeartbeatOperation] = @"/v2/presence/sub-key/{sub-key}/channel/{channels}/heartbeat",
-    [PNSetStateOperation] = @"/v2/presence/sub-key/{sub-key}/channel/{channel}/uuid/{uuid}/data",
-    [PNStateForChannelOperation] = @"/v2/presence/sub-key/{sub-key}/channel/{channel}/uuid/{uuid}",
-    [PNStateForChannelGroupOperation] = @"/v2/presence/sub-key/{sub-key}/channel/{channel}/uuid/{uuid}",
-    [PNAddChannelsToGroupOperation] = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}",
-    [PNRemoveChannelsFromGroupOperation] = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}",
-    [PNChannelGroupsOperation] = @"/v1/channel-registration/sub-key/{sub-key}/channel-group",
-    [PNRemoveGroupOperation] = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}/remove",
-    [PNChannelsForGroupOperation] = @"/v1/channel-registration/sub-key/{sub-key}/channel-group/{channel-group}",
-    [PNPushNotificationEnabledChannelsOperation] = @"/v1/push/sub-key/{sub-key}/devices/{token}",
-    [PNAddPushNotificationsOnChannelsOperation] = @"/v1/push/sub-key/{sub-key}/devices/{token}",
-    [PNRemovePushNotificationsFromChannelsOperation] = @"/v1/push/sub-key/{sub-key}/devices/{token}",
-    [PNRemoveAllPushNotificationsOperation] = @"/v1/push/sub-key/{sub-key}/devices/{token}/remove",
-    [PNTimeOperation] = @"/time/0",
-};
-
-
-#pragma mark - Inerface implementation
+#pragma mark Inerface implementation
 
 @implementation PNURLBuilder
 
@@ -52,7 +20,8 @@ static NSString * const PNOperationRequestTemplate[22] = {
             withParameters:(PNRequestParameters *)parameters {
     
     NSURL *requestURL = nil;
-    NSMutableString *requestURLString = [PNOperationRequestTemplate[operation] mutableCopy];
+    NSString *requestTemplate = PNOperationDescriptors[operation].requestTemplate;
+    NSMutableString *requestURLString = [requestTemplate mutableCopy];
     [parameters.pathComponents enumerateKeysAndObjectsUsingBlock:^(NSString *placeholder,
                                                                    NSString *component,
                                                                    __unused BOOL *componentsEnumeratorStop) {
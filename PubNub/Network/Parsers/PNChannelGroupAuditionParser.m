@@ -14,11 +14,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNChannelGroupsOperation), @(PNChannelsForGroupOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
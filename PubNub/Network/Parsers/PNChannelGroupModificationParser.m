@@ -13,12 +13,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNAddChannelsToGroupOperation), @(PNRemoveChannelsFromGroupOperation),
-             @(PNRemoveGroupOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -14,12 +14,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNSetStateOperation), @(PNStateForChannelOperation),
-             @(PNStateForChannelGroupOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -14,11 +14,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(-1)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -13,11 +13,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNHeartbeatOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
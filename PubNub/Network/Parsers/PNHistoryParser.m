@@ -54,11 +54,6 @@ static DDLogLevel ddLogLevel = (DDLogLevel)PNAESErrorLogLevel;
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNHistoryOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return YES;
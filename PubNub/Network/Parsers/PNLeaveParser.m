@@ -13,11 +13,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNUnsubscribeOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -12,11 +12,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNPublishOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
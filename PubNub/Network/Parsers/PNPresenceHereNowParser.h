@@ -88,6 +88,38 @@
 @interface PNPresenceHereNowParser : NSObject <PNParser>
 
 
+///------------------------------------------------
+/// @name Snapshot
+///------------------------------------------------
+
+/**
+ @brief      Compose compact snapshot of channel presence from parsed here now response.
+ @discussion Snapshot store list of subscribers unique identifiers sorted in ascending order and
+             list of their states aligned to identifiers list (\c NSNull used for subscribers w/o
+             state).
+ 
+ @param response Reference on channel here now data processed by \c -parsedServiceResponse:.
+ 
+ @return Snapshot dictionary with \c uuids and \c states keys.
+ 
+ @since 4.1.0
+ */
++ (NSDictionary *)snapshotFromParsedResponse:(NSDictionary *)response;
+
+/**
+ @brief      Calculate difference between two channel presence snapshots.
+ @discussion Because both snapshots store sorted subscriber identifiers, changes calculated with
+             single pass over both lists.
+ 
+ @param snapshot    Reference on previous snapshot (can be \c nil).
+ @param newSnapshot Reference on snapshot which should be compared with previous one.
+ 
+ @return Dictionary with \c join, \c leave lists and \c stateChanges dictionary.
+ 
+ @since 4.1.0
+ */
++ (NSDictionary *)changesFromSnapshot:(NSDictionary *)snapshot toSnapshot:(NSDictionary *)newSnapshot;
+
 #pragma mark -
 
 
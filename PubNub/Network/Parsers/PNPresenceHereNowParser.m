@@ -14,12 +14,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNHereNowGlobalOperation), @(PNHereNowForChannelOperation),
-             @(PNHereNowForChannelGroupOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -96,6 +90,96 @@
     return processedResponse;
 }
 
+
+#pragma mark - Snapshot
+
++ (NSDictionary *)snapshotFromParsedResponse:(NSDictionary *)response {
+    
+    NSMutableArray *entries = [NSMutableArray new];
+    for (id uuidData in response[@"uuids"]) {
+        
+        NSString *uuid = uuidData;
+        id state = [NSNull null];
+        if ([uuidData respondsToSelector:@selector(count)]) {
+            
+            uuid = uuidData[@"uuid"];
+            state = (uuidData[@"state"]?: state);
+        }
+        if ([uuid isKindOfClass:[NSString class]]) {
+            
+            [entries addObject:@[uuid, state]];
+        }
+    }
+    [entries sortUsingComparator:^NSComparisonResult(NSArray *entry1, NSArray *entry2) {
+        
+        return [(NSString *)entry1[0] compare:entry2[0]];
+    }];
+    
+    NSMutableArray *uuids = [NSMutableArray arrayWithCapacity:[entries count]];
+    NSMutableArray *states = [NSMutableArray arrayWithCapacity:[entries count]];
+    for (NSArray *entry in entries) {
+        
+        [uuids addObject:entry[0]];
+        [states addObject:entry[1]];
+    }
+    
+    return @{@"uuids":[uuids copy], @"states":[states copy]};
+}
+
++ (NSDictionary *)changesFromSnapshot:(NSDictionary *)snapshot toSnapshot:(NSDictionary *)newSnapshot {
+    
+    NSArray *uuids = (snapshot[@"uuids"]?: @[]);
+    NSArray *states = (snapshot[@"states"]?: @[]);
+    NSArray *newUUIDs = (newSnapshot[@"uuids"]?: @[]);
+    NSArray *newStates = (newSnapshot[@"states"]?: @[]);
+    NSMutableArray *join = [NSMutableArray new];
+    NSMutableArray *leave = [NSMutableArray new];
+    NSMutableDictionary *stateChanges = [NSMutableDictionary new];
+    NSUInteger uuidIdx = 0;
+    NSUInteger newUUIDIdx = 0;
+    
+    // Both lists sorted in ascending order, so walk them simultaneously and compare heads.
+    while (uuidIdx < [uuids count] || newUUIDIdx < [newUUIDs count]) {
+        
+        // Remaining new snapshot entries treated as joined, remaining old entries as left.
+        NSComparisonResult order = NSOrderedDescending;
+        if (uuidIdx < [uuids count]) {
+            
+            order = NSOrderedAscending;
+            if (newUUIDIdx < [newUUIDs count]) {
+                
+                order = [(NSString *)uuids[uuidIdx] compare:newUUIDs[newUUIDIdx]];
+            }
+        }
+        
+        if (order == NSOrderedAscending) {
+            
+            [leave addObject:uuids[uuidIdx]];
+            uuidIdx++;
+        }
+        else if (order == NSOrderedDescending) {
+            
+            [join addObject:newUUIDs[newUUIDIdx]];
+            if (![newStates[newUUIDIdx] isKindOfClass:[NSNull class]]) {
+                
+                stateChanges[newUUIDs[newUUIDIdx]] = newStates[newUUIDIdx];
+            }
+            newUUIDIdx++;
+        }
+        else {
+            
+            if (![states[uuidIdx] isEqual:newStates[newUUIDIdx]]) {
+                
+                stateChanges[newUUIDs[newUUIDIdx]] = newStates[newUUIDIdx];
+            }
+            uuidIdx++;
+            newUUIDIdx++;
+        }
+    }
+    
+    return @{@"join":[join copy], @"leave":[leave copy], @"stateChanges":[stateChanges copy]};
+}
+
 #pragma mark -
 
 
@@ -14,11 +14,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNWhereNowOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -14,11 +14,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNPushNotificationEnabledChannelsOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -13,13 +13,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNAddPushNotificationsOnChannelsOperation),
-             @(PNRemovePushNotificationsFromChannelsOperation),
-             @(PNRemoveAllPushNotificationsOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -132,11 +132,6 @@ static NSUInteger const kPNEventChannelsDetailsElementIndex = 3;
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNSubscribeOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return YES;
@@ -289,6 +284,15 @@ static NSUInteger const kPNEventChannelsDetailsElementIndex = 3;
         presence[@"presence"][@"state"] = data[@"data"];
     }
     
+    // 'interval' event carry lists of users which changed presence since previous interval.
+    for (NSString *field in @[@"join", @"leave", @"timeout"]) {
+        
+        if ([data[field] isKindOfClass:[NSArray class]]) {
+            
+            presence[@"presence"][field] = data[field];
+        }
+    }
+    
     return presence;
 }
 
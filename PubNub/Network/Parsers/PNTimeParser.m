@@ -14,11 +14,6 @@
 
 #pragma mark - Identification
 
-+ (NSArray *)operations {
-    
-    return @[@(PNTimeOperation)];
-}
-
 + (BOOL)requireAdditionalData {
     
     return NO;
@@ -6,6 +6,7 @@
 
 // Data objects
 #import "PNPresenceChannelGroupHereNowResult.h"
+#import "PNPresenceChannelHereNowChangesResult.h"
 #import "PNChannelGroupClientStateResult.h"
 #import "PNPresenceChannelHereNowResult.h"
 #import "PNPresenceGlobalHereNowResult.h"
@@ -23,11 +24,14 @@
 #import "PNServiceData.h"
 #import "PNErrorStatus.h"
 #import "PNTimeResult.h"
+#import "PNIntrospection.h"
+#import "PNRequestTrace.h"
 #import "PNResult.h"
 #import "PNStatus.h"
 
 // API
 #import "PubNub+Core.h"
+#import "PNClientPool.h"
 #import "PubNub+ChannelGroup.h"
 #import "PubNub+Subscribe.h"
 #import "PNConfiguration.h"
@@ -0,0 +1,41 @@
+//
+//  PNTestNetwork.h
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+#import <PubNub/PubNub.h>
+#import "PNNetwork.h"
+
+typedef void(^PNTestTaskSuccess)(NSURLSessionDataTask *task, id responseObject);
+typedef void(^PNTestTaskFailure)(NSURLSessionDataTask *task, NSError *error);
+
+// Allow tests to replace client's service network with stand-in.
+@interface PubNub (PNTestNetwork)
+
+@property (nonatomic, strong) PNNetwork *serviceNetwork;
+
+@end
+
+// Stand-in task which never hits network. It report 'resumeError' (if set) on resume and
+// cancellation error on cancel (like NSURLSession does).
+@interface PNTestTask : NSURLSessionDataTask
+
+@property (nonatomic, copy) PNTestTaskFailure failure;
+@property (nonatomic, strong) NSError *resumeError;
+@property (atomic, assign, getter = isCancelled) BOOL cancelled;
+
+@end
+
+// Network manager which create stand-in tasks and record all requests and tasks.
+@interface PNTestNetwork : PNNetwork
+
+// Error which should be reported by created tasks on resume. Tasks never complete if not set.
+@property (atomic, strong) NSError *resumeError;
+
+- (NSArray *)requests;
+- (NSArray *)createdTasks;
+- (NSArray *)queriesForRequestsWithPathSuffix:(NSString *)suffix;
+
+@end
@@ -0,0 +1,87 @@
+//
+//  PNTestNetwork.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+#import "PNTestNetwork.h"
+
+@implementation PNTestTask
+
+- (void)resume {
+    if (self.resumeError) {
+        [self reportError:self.resumeError];
+    }
+}
+
+- (void)cancel {
+    self.cancelled = YES;
+    [self reportError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled
+                                      userInfo:nil]];
+}
+
+- (void)reportError:(NSError *)error {
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        self.failure(self, error);
+    });
+}
+
+@end
+
+@interface PNTestNetwork ()
+
+@property (nonatomic, strong) NSMutableArray *recordedRequests;
+@property (nonatomic, strong) NSMutableArray *recordedTasks;
+
+@end
+
+@implementation PNTestNetwork
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                                      success:(PNTestTaskSuccess)success
+                                      failure:(PNTestTaskFailure)failure {
+    PNTestTask *task = [PNTestTask new];
+    task.failure = failure;
+    task.resumeError = self.resumeError;
+    @synchronized(self) {
+        if (!self.recordedRequests) {
+            self.recordedRequests = [NSMutableArray new];
+            self.recordedTasks = [NSMutableArray new];
+        }
+        [self.recordedRequests addObject:request];
+        [self.recordedTasks addObject:task];
+    }
+    return task;
+}
+
+- (NSArray *)requests {
+    @synchronized(self) {
+        return [self.recordedRequests copy];
+    }
+}
+
+- (NSArray *)createdTasks {
+    @synchronized(self) {
+        return [self.recordedTasks copy];
+    }
+}
+
+- (NSArray *)queriesForRequestsWithPathSuffix:(NSString *)suffix {
+    NSMutableArray *queries = [NSMutableArray new];
+    for (NSURLRequest *request in [self requests]) {
+        NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL
+                                                  resolvingAgainstBaseURL:YES];
+        if (![components.path hasSuffix:suffix]) {
+            continue;
+        }
+        NSMutableDictionary *query = [NSMutableDictionary new];
+        for (NSURLQueryItem *item in components.queryItems) {
+            query[item.name] = (item.value?: @"");
+        }
+        [queries addObject:query];
+    }
+    return queries;
+}
+
+@end
@@ -0,0 +1,129 @@
+//
+//  PNCircuitBreakerTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNCircuitBreaker.h"
+
+static NSString * const kPNTestOrigin = @"pubsub.pubnub.test";
+
+@interface PNCircuitBreakerTests : XCTestCase
+
+@property (nonatomic, strong) PNCircuitBreaker *breaker;
+@property (nonatomic, strong) NSMutableArray *states;
+
+@end
+
+@implementation PNCircuitBreakerTests
+
+- (void)setUp {
+    [super setUp];
+    self.states = [NSMutableArray new];
+    self.breaker = [PNCircuitBreaker breakerWithFailureThreshold:3 openInterval:0.1];
+    __weak __typeof(self) weakSelf = self;
+    self.breaker.stateChangeBlock = ^(PNOperationType operation, NSString *origin,
+                                      NSString *operations, PNCircuitBreakerState state) {
+        [weakSelf.states addObject:PNCircuitBreakerStateStrings[state]];
+    };
+}
+
+- (void)failOperation:(PNOperationType)operation times:(NSUInteger)times {
+    for (NSUInteger failureIdx = 0; failureIdx < times; failureIdx++) {
+        [self.breaker handleFailureOfOperation:operation fromOrigin:kPNTestOrigin];
+    }
+}
+
+- (BOOL)allowOperation:(PNOperationType)operation {
+    return [self.breaker allowRequestForOperation:operation toOrigin:kPNTestOrigin];
+}
+
+- (void)openBreakerAndWaitForTrial {
+    [self failOperation:PNHistoryOperation times:3];
+    [NSThread sleepForTimeInterval:0.15];
+}
+
+- (void)testClosedBreakerAllowRequests {
+    [self failOperation:PNHistoryOperation times:2];
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+    XCTAssertEqual([self.states count], 0);
+}
+
+- (void)testSuccessResetConsecutiveFailures {
+    [self failOperation:PNHistoryOperation times:2];
+    [self.breaker handleSuccessOfOperation:PNHistoryOperation fromOrigin:kPNTestOrigin];
+    [self failOperation:PNHistoryOperation times:2];
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+}
+
+- (void)testOpenAfterThresholdAndRejectRequests {
+    [self failOperation:PNHistoryOperation times:3];
+    XCTAssertEqualObjects(self.states, @[@"open"]);
+    XCTAssertFalse([self allowOperation:PNHistoryOperation]);
+    NSDictionary *statistics = self.breaker.statistics[@"pubsub.pubnub.test/history"];
+    XCTAssertEqualObjects(statistics[@"state"], @"open");
+    XCTAssertEqualObjects(statistics[@"opened"], @1);
+    XCTAssertEqualObjects(statistics[@"rejected"], @1);
+}
+
+- (void)testBreakersSeparatedByOriginAndOperations {
+    [self failOperation:PNHistoryOperation times:3];
+    XCTAssertTrue([self allowOperation:PNPublishOperation]);
+    XCTAssertTrue([self.breaker allowRequestForOperation:PNHistoryOperation
+                                                toOrigin:@"backup.pubnub.test"]);
+}
+
+- (void)testOperationsFromSameGroupShareBreaker {
+    [self failOperation:PNHereNowForChannelOperation times:2];
+    [self failOperation:PNHeartbeatOperation times:1];
+    XCTAssertFalse([self allowOperation:PNWhereNowOperation]);
+    XCTAssertEqualObjects(self.breaker.statistics[@"pubsub.pubnub.test/presence"][@"state"],
+                          @"open");
+}
+
+- (void)testSubscribeAndTimeNeverGuarded {
+    [self failOperation:PNSubscribeOperation times:3];
+    [self failOperation:PNTimeOperation times:3];
+    XCTAssertTrue([self allowOperation:PNSubscribeOperation]);
+    XCTAssertTrue([self allowOperation:PNTimeOperation]);
+    XCTAssertEqual([self.states count], 0);
+}
+
+- (void)testHalfOpenAllowSingleTrialRequest {
+    [self openBreakerAndWaitForTrial];
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+    XCTAssertFalse([self allowOperation:PNHistoryOperation]);
+    XCTAssertEqualObjects(self.states, (@[@"open", @"half-open"]));
+}
+
+- (void)testSuccessfulTrialCloseBreaker {
+    [self openBreakerAndWaitForTrial];
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+    [self.breaker handleSuccessOfOperation:PNHistoryOperation fromOrigin:kPNTestOrigin];
+    XCTAssertEqualObjects(self.states, (@[@"open", @"half-open", @"closed"]));
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+}
+
+- (void)testFailedTrialOpenBreakerAgain {
+    [self openBreakerAndWaitForTrial];
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+    [self.breaker handleFailureOfOperation:PNHistoryOperation fromOrigin:kPNTestOrigin];
+    XCTAssertEqualObjects(self.states, (@[@"open", @"half-open", @"open"]));
+    XCTAssertFalse([self allowOperation:PNHistoryOperation]);
+    XCTAssertEqualObjects(self.breaker.statistics[@"pubsub.pubnub.test/history"][@"opened"], @2);
+}
+
+- (void)testCancelledTrialAllowNextTrial {
+    [self openBreakerAndWaitForTrial];
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+    [self.breaker handleCancellationOfOperation:PNHistoryOperation fromOrigin:kPNTestOrigin];
+    XCTAssertTrue([self allowOperation:PNHistoryOperation]);
+    XCTAssertEqualObjects(self.states, (@[@"open", @"half-open"]));
+}
+
+@end
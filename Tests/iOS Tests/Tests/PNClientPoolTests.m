@@ -0,0 +1,100 @@
+//
+//  PNClientPoolTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNClientPool+Private.h"
+#import "PNTestNetwork.h"
+
+@interface PNClientPoolTests : XCTestCase
+
+@property (nonatomic, strong) PNClientPool *pool;
+@property (nonatomic, strong) PNTestNetwork *network;
+
+@end
+
+@implementation PNClientPoolTests
+
+- (void)setUp {
+    [super setUp];
+    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                     subscribeKey:@"demo"];
+    configuration.uuid = @"pool-uuid";
+    configuration.authKey = @"pool-auth";
+    self.pool = [PNClientPool poolWithConfiguration:configuration];
+    self.network = [PNTestNetwork networkForClient:self.pool.sharedClient requestTimeout:10.0
+                                maximumConnections:3 longPoll:NO];
+    self.network.resumeError = [NSError errorWithDomain:NSURLErrorDomain
+                                                   code:NSURLErrorCannotConnectToHost
+                                               userInfo:nil];
+    self.pool.sharedClient.serviceNetwork = self.network;
+}
+
+- (void)tearDown {
+    self.pool = nil;
+    self.network = nil;
+    [super tearDown];
+}
+
+- (void)testSameClientReturnedForSameIdentity {
+    PubNub *client = [self.pool clientWithUUID:@"user-1" authKey:@"token-1"];
+    XCTAssertEqual([self.pool clientWithUUID:@"user-1" authKey:@"token-1"], client);
+    XCTAssertNotEqual([self.pool clientWithUUID:@"user-1" authKey:@"token-2"], client);
+    XCTAssertEqual(self.pool.count, 2);
+}
+
+- (void)testClientsShareServiceNetwork {
+    PubNub *client1 = [self.pool clientWithUUID:@"user-1" authKey:@"token-1"];
+    PubNub *client2 = [self.pool clientWithUUID:@"user-2" authKey:nil];
+    XCTAssertEqual(client1.serviceNetwork, self.network);
+    XCTAssertEqual(client2.serviceNetwork, self.network);
+}
+
+- (void)testIdentityInjectedIntoRequestsAndStatuses {
+    PubNub *client1 = [self.pool clientWithUUID:@"user-1" authKey:@"token-1"];
+    PubNub *client2 = [self.pool clientWithUUID:@"user-2" authKey:nil];
+    XCTestExpectation *expectation1 = [self expectationWithDescription:@"user-1"];
+    XCTestExpectation *expectation2 = [self expectationWithDescription:@"user-2"];
+    [client1 timeWithCompletion:^(PNTimeResult *result, PNErrorStatus *status) {
+        XCTAssertTrue(status.isError);
+        XCTAssertEqualObjects(status.uuid, @"user-1");
+        XCTAssertEqualObjects(status.authKey, @"token-1");
+        [expectation1 fulfill];
+    }];
+    [client2 timeWithCompletion:^(PNTimeResult *result, PNErrorStatus *status) {
+        XCTAssertTrue(status.isError);
+        XCTAssertEqualObjects(status.uuid, @"user-2");
+        XCTAssertNil(status.authKey);
+        [expectation2 fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+    NSMutableDictionary *queries = [NSMutableDictionary new];
+    for (NSDictionary *query in [self.network queriesForRequestsWithPathSuffix:@"/time/0"]) {
+        queries[query[@"uuid"]] = query;
+    }
+    XCTAssertEqualObjects([[queries allKeys] sortedArrayUsingSelector:@selector(compare:)],
+                          (@[@"user-1", @"user-2"]));
+    XCTAssertEqualObjects(queries[@"user-1"][@"auth"], @"token-1");
+    XCTAssertNil(queries[@"user-2"][@"auth"]);
+}
+
+- (void)testSharedClientIdentityUsedWithoutIssuer {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Shared client"];
+    [self.pool.sharedClient timeWithCompletion:^(PNTimeResult *result, PNErrorStatus *status) {
+        XCTAssertEqualObjects(status.uuid, @"pool-uuid");
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    NSArray *queries = [self.network queriesForRequestsWithPathSuffix:@"/time/0"];
+    NSDictionary *query = [queries firstObject];
+    XCTAssertEqualObjects(query[@"uuid"], @"pool-uuid");
+    XCTAssertEqualObjects(query[@"auth"], @"pool-auth");
+}
+
+@end
@@ -0,0 +1,121 @@
+//
+//  PNDeadlineTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PubNub+CorePrivate.h"
+#import "PNHedgingPolicy.h"
+#import "PNTestNetwork.h"
+
+@interface PNNetwork (Tests)
+
+@property (nonatomic, strong) PNHedgingPolicy *hedgingPolicy;
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                                      success:(PNTestTaskSuccess)success
+                                      failure:(PNTestTaskFailure)failure;
+- (void)sendRequest:(NSURLRequest *)request hedgeAfter:(NSTimeInterval)delay
+           deadline:(NSDate *)deadline success:(PNTestTaskSuccess)success
+            failure:(PNTestTaskFailure)failure;
+
+@end
+
+@interface PNDeadlineTests : XCTestCase
+
+@property (nonatomic, strong) PubNub *client;
+@property (nonatomic, strong) PNTestNetwork *network;
+
+@end
+
+@implementation PNDeadlineTests
+
+- (void)setUp {
+    [super setUp];
+    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                     subscribeKey:@"demo"];
+    self.client = [PubNub clientWithConfiguration:configuration];
+    self.network = [PNTestNetwork networkForClient:self.client requestTimeout:10.0
+                                maximumConnections:3 longPoll:NO];
+    self.client.serviceNetwork = self.network;
+}
+
+- (void)tearDown {
+    self.client = nil;
+    self.network = nil;
+    [super tearDown];
+}
+
+- (void)testDeadlineRestoredWhenBlockThrows {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:10.0];
+    XCTAssertThrows([self.client performWithDeadline:deadline block:^{
+        XCTAssertEqualObjects([self.client requestDeadline], deadline);
+        @throw [NSException exceptionWithName:@"PNDeadlineTestException" reason:nil userInfo:nil];
+    }]);
+    XCTAssertNil([self.client requestDeadline]);
+}
+
+- (void)testNestedDeadlineRestoredWhenBlockThrows {
+    NSDate *outerDeadline = [NSDate dateWithTimeIntervalSinceNow:10.0];
+    NSDate *innerDeadline = [NSDate dateWithTimeIntervalSinceNow:5.0];
+    [self.client performWithDeadline:outerDeadline block:^{
+        XCTAssertThrows([self.client performWithDeadline:innerDeadline block:^{
+            XCTAssertEqualObjects([self.client requestDeadline], innerDeadline);
+            @throw [NSException exceptionWithName:@"PNDeadlineTestException" reason:nil
+                                         userInfo:nil];
+        }]);
+        XCTAssertEqualObjects([self.client requestDeadline], outerDeadline);
+    }];
+    XCTAssertNil([self.client requestDeadline]);
+}
+
+- (void)testExpiredDeadlineReportedWithoutSendingRequest {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Expired deadline"];
+    [self.client performWithDeadline:[NSDate dateWithTimeIntervalSinceNow:-1.0] block:^{
+        [self.client timeWithCompletion:^(PNTimeResult *result, PNErrorStatus *status) {
+            XCTAssertNil(result);
+            XCTAssertTrue(status.isError);
+            XCTAssertEqual(status.category, PNTimeoutCategory);
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual([self.network.createdTasks count], 0);
+}
+
+- (void)testDeadlineCancelsInFlightAndHedgedRequests {
+    // Budget allow to send one duplicate for each request.
+    self.network.hedgingPolicy = [PNHedgingPolicy policyWithBudget:100];
+    [self.network.hedgingPolicy hedgeDelayForOperation:PNHistoryOperation];
+    [self.network.hedgingPolicy hedgeDelayForOperation:PNHistoryOperation];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Deadline"];
+    __block NSUInteger failuresCount = 0;
+    NSURL *url = [NSURL URLWithString:@"http://pubsub.pubnub.test/time/0"];
+    NSURLRequest *request = [NSURLRequest requestWithURL:url];
+    [self.network sendRequest:request hedgeAfter:0.1
+                     deadline:[NSDate dateWithTimeIntervalSinceNow:0.5]
+                      success:^(NSURLSessionDataTask *task, id responseObject) {
+        XCTFail(@"Stand-in tasks never succeed.");
+    } failure:^(NSURLSessionDataTask *task, NSError *error) {
+        failuresCount++;
+        XCTAssertEqualObjects(error.domain, NSURLErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorTimedOut);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    // Give a chance to report more than once if cancellation handled incorrectly.
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.3]];
+    XCTAssertEqual(failuresCount, 1);
+    XCTAssertEqual([self.network.createdTasks count], 2);
+    for (PNTestTask *task in self.network.createdTasks) {
+        XCTAssertTrue(task.isCancelled);
+    }
+}
+
+@end
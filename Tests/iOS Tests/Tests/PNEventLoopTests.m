@@ -0,0 +1,88 @@
+//
+//  PNEventLoopTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import <poll.h>
+#import "PNEventLoop.h"
+#import "PNHelpers.h"
+
+@interface PNEventLoopTests : XCTestCase
+
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong) PNEventLoop *eventLoop;
+
+@end
+
+@implementation PNEventLoopTests
+
+- (void)setUp {
+    [super setUp];
+    self.queue = [PNEventLoop queueWithEventLoop];
+    self.eventLoop = [PNEventLoop eventLoopForQueue:self.queue];
+}
+
+- (BOOL)isDescriptorReadable {
+    struct pollfd descriptor = {.fd = self.eventLoop.fileDescriptor, .events = POLLIN};
+    return (poll(&descriptor, 1, 100) == 1 && (descriptor.revents & POLLIN));
+}
+
+- (void)testEventLoopAttachedOnlyToOwnQueue {
+    XCTAssertNotNil(self.eventLoop);
+    XCTAssertTrue(self.eventLoop.fileDescriptor >= 0);
+    XCTAssertNil([PNEventLoop eventLoopForQueue:dispatch_get_main_queue()]);
+    XCTAssertNil([PNEventLoop eventLoopForQueue:nil]);
+}
+
+- (void)testBlocksExecutedOnlyByPump {
+    __block NSUInteger calls = 0;
+    pn_dispatch_async(self.queue, ^{ calls++; });
+    pn_dispatch_async(self.queue, ^{ calls++; });
+    XCTAssertTrue([self isDescriptorReadable]);
+    XCTAssertEqual(calls, 0);
+    XCTAssertEqual([self.eventLoop pumpWithTimeout:0.0], 2);
+    XCTAssertEqual(calls, 2);
+}
+
+- (void)testPumpDrainDescriptor {
+    [self.eventLoop enqueueBlock:^{}];
+    XCTAssertEqual([self.eventLoop pumpWithTimeout:0.0], 1);
+    XCTAssertFalse([self isDescriptorReadable]);
+    XCTAssertEqual([self.eventLoop pumpWithTimeout:0.0], 0);
+}
+
+- (void)testBlocksScheduledDuringPumpWaitForNextPump {
+    __block NSUInteger calls = 0;
+    PNEventLoop *eventLoop = self.eventLoop;
+    [eventLoop enqueueBlock:^{
+        calls++;
+        [eventLoop enqueueBlock:^{ calls++; }];
+    }];
+    XCTAssertEqual([eventLoop pumpWithTimeout:0.0], 1);
+    XCTAssertEqual(calls, 1);
+    XCTAssertTrue([self isDescriptorReadable]);
+    XCTAssertEqual([eventLoop pumpWithTimeout:0.0], 1);
+    XCTAssertEqual(calls, 2);
+}
+
+- (void)testPumpWaitForBlockScheduledFromOtherThread {
+    PNEventLoop *eventLoop = self.eventLoop;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [eventLoop enqueueBlock:^{}];
+    });
+    XCTAssertEqual([eventLoop pumpWithTimeout:2.0], 1);
+}
+
+- (void)testPumpReturnAfterTimeout {
+    NSDate *start = [NSDate date];
+    XCTAssertEqual([self.eventLoop pumpWithTimeout:0.1], 0);
+    XCTAssertGreaterThanOrEqual(-[start timeIntervalSinceNow], 0.09);
+}
+
+@end
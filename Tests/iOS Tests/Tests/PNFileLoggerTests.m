@@ -0,0 +1,213 @@
+//
+//  PNFileLoggerTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import <sys/stat.h>
+#import "PNLogFileManager.h"
+#import "PNFileLogger.h"
+#import "PNGZIP.h"
+
+static unsigned long long const kPNTestSegmentSize = 128;
+
+@interface PNFileLogger (Tests)
+
+@property (nonatomic, assign) void *activeSegment;
+@property (nonatomic, assign) void * volatile spareSegment;
+@property (nonatomic, strong) dispatch_queue_t segmentsQueue;
+
+@end
+
+// Record content of rolled log files instead of compressing them.
+@interface PNFileLoggerTestFileManager : DDLogFileManagerDefault
+
+@property (atomic, strong) NSMutableArray *rolledContents;
+
+@end
+
+@implementation PNFileLoggerTestFileManager
+
+- (void)didRollAndArchiveLogFile:(NSString *)logFilePath {
+    NSString *content = [NSString stringWithContentsOfFile:logFilePath
+                                                  encoding:NSUTF8StringEncoding error:NULL];
+    @synchronized(self) {
+        if (!self.rolledContents) {
+            self.rolledContents = [NSMutableArray new];
+        }
+        [self.rolledContents addObject:(content ?: @"")];
+    }
+}
+
+- (NSArray *)contents {
+    @synchronized(self) {
+        return [self.rolledContents copy] ?: @[];
+    }
+}
+
+@end
+
+@interface PNFileLoggerTests : XCTestCase
+
+@property (nonatomic, copy) NSString *directory;
+@property (nonatomic, strong) PNFileLogger *logger;
+
+@end
+
+@implementation PNFileLoggerTests
+
+- (void)setUp {
+    [super setUp];
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:
+                      [[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:self.directory
+                              withIntermediateDirectories:YES attributes:nil error:NULL];
+}
+
+- (void)tearDown {
+    self.logger = nil;
+    [[NSFileManager defaultManager] removeItemAtPath:self.directory error:NULL];
+    [super tearDown];
+}
+
+- (BOOL)waitFor:(BOOL(^)(void))condition timeout:(NSTimeInterval)timeout {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (!condition() && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+    }
+    return condition();
+}
+
+- (void)startLoggerWithFileManager:(id <DDLogFileManager>)fileManager {
+    self.logger = [[PNFileLogger alloc] initWithLogFileManager:fileManager];
+    self.logger.maximumFileSize = kPNTestSegmentSize;
+    [self.logger didAddLogger];
+}
+
+- (BOOL)waitForSpareSegment {
+    PNFileLogger *logger = self.logger;
+    return [self waitFor:^BOOL{ return (logger.spareSegment != NULL); } timeout:2.0];
+}
+
+- (void)log:(NSString *)message {
+    DDLogMessage *logMessage = [[DDLogMessage alloc] initWithMessage:message
+                                                               level:DDLogLevelAll
+                                                                flag:DDLogFlagInfo
+                                                             context:0 file:@(__FILE__)
+                                                            function:@(__PRETTY_FUNCTION__)
+                                                                line:__LINE__ tag:nil
+                                                             options:0 timestamp:[NSDate date]];
+    [self.logger logMessage:logMessage];
+}
+
+- (NSArray *)filesWithExtension:(NSString *)extension {
+    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.directory
+                                                                         error:NULL];
+    return [files filteredArrayUsingPredicate:
+            [NSPredicate predicateWithFormat:@"SELF ENDSWITH %@", extension]];
+}
+
+- (void)testSegmentStoragePreallocated {
+    [self startLoggerWithFileManager:
+     [[PNFileLoggerTestFileManager alloc] initWithLogsDirectory:self.directory]];
+    XCTAssertTrue([self waitForSpareSegment]);
+    for (NSString *fileName in [self filesWithExtension:@".log"]) {
+        NSString *path = [self.directory stringByAppendingPathComponent:fileName];
+        struct stat info;
+        XCTAssertEqual(stat([path fileSystemRepresentation], &info), 0);
+        XCTAssertEqual(info.st_size, (off_t)kPNTestSegmentSize);
+        // Sparse file would report less blocks than it's size.
+        XCTAssertGreaterThanOrEqual((unsigned long long)info.st_blocks * 512, kPNTestSegmentSize);
+    }
+}
+
+- (void)testFullSegmentSwappedWithSpareAndTruncated {
+    PNFileLoggerTestFileManager *fileManager = nil;
+    fileManager = [[PNFileLoggerTestFileManager alloc] initWithLogsDirectory:self.directory];
+    [self startLoggerWithFileManager:fileManager];
+    XCTAssertTrue([self waitForSpareSegment]);
+    void *firstSegment = self.logger.activeSegment;
+
+    NSString *message = [@"" stringByPaddingToLength:61 withString:@"a" startingAtIndex:0];
+    [self log:message];
+    [self log:message];
+    XCTAssertEqual(self.logger.activeSegment, firstSegment);
+    [self log:@"next"];
+    XCTAssertNotEqual(self.logger.activeSegment, firstSegment);
+
+    NSString *expected = [NSString stringWithFormat:@"%@\n%@\n", message, message];
+    XCTAssertTrue([self waitFor:^BOOL{ return ([[fileManager contents] count] == 1); }
+                        timeout:2.0]);
+    XCTAssertEqualObjects([fileManager contents], @[expected]);
+
+    [self.logger willRemoveFromLogger];
+    XCTAssertTrue([self waitFor:^BOOL{ return ([[fileManager contents] count] == 2); }
+                        timeout:2.0]);
+    XCTAssertEqualObjects([fileManager contents][1], @"next\n");
+}
+
+- (void)testDroppedMessagesReportedInNextSegment {
+    PNFileLoggerTestFileManager *fileManager = nil;
+    fileManager = [[PNFileLoggerTestFileManager alloc] initWithLogsDirectory:self.directory];
+    self.logger = [[PNFileLogger alloc] initWithLogFileManager:fileManager];
+    self.logger.maximumFileSize = kPNTestSegmentSize;
+
+    // Spare segment can't be prepared while segments queue suspended.
+    dispatch_suspend(self.logger.segmentsQueue);
+    [self.logger didAddLogger];
+    NSString *message = [@"" stringByPaddingToLength:120 withString:@"a" startingAtIndex:0];
+    [self log:message];
+    [self log:@"dropped-1"];
+    [self log:@"dropped-2"];
+    [self log:@"dropped-3"];
+    dispatch_resume(self.logger.segmentsQueue);
+    XCTAssertTrue([self waitForSpareSegment]);
+    [self log:@"after"];
+    [self.logger willRemoveFromLogger];
+
+    XCTAssertTrue([self waitFor:^BOOL{ return ([[fileManager contents] count] == 2); }
+                        timeout:2.0]);
+    XCTAssertEqualObjects([fileManager contents][0], [message stringByAppendingString:@"\n"]);
+    XCTAssertEqualObjects([fileManager contents][1],
+                          @"<PubNub> 3 log messages dropped while log file has been rotated.\n"
+                          "after\n");
+}
+
+- (void)testRolledSegmentsCompressedWithinDiskQuota {
+    PNLogFileManager *fileManager = [[PNLogFileManager alloc] initWithLogsDirectory:self.directory];
+    fileManager.maximumNumberOfLogFiles = 100;
+    fileManager.logFilesDiskQuota = (kPNTestSegmentSize * 4);
+    [self startLoggerWithFileManager:fileManager];
+
+    // Each message fill whole segment.
+    NSString *message = [@"" stringByPaddingToLength:(NSUInteger)kPNTestSegmentSize - 1
+                                          withString:@"a" startingAtIndex:0];
+    for (NSUInteger segmentIdx = 0; segmentIdx < 20; segmentIdx++) {
+        XCTAssertTrue([self waitForSpareSegment]);
+        [self log:message];
+    }
+    [self.logger willRemoveFromLogger];
+
+    // Only spare segment can be left uncompressed.
+    XCTAssertTrue([self waitFor:^BOOL{
+        unsigned long long usedSpace = 0;
+        for (DDLogFileInfo *fileInfo in [fileManager unsortedLogFileInfos]) {
+            usedSpace += fileInfo.fileSize;
+        }
+        return ([[self filesWithExtension:@".txt"] count] <= 1 &&
+                [[self filesWithExtension:@".gz"] count] > 0 &&
+                usedSpace <= fileManager.logFilesDiskQuota);
+    } timeout:5.0]);
+    for (NSString *fileName in [self filesWithExtension:@".gz"]) {
+        NSString *path = [self.directory stringByAppendingPathComponent:fileName];
+        NSData *data = [PNGZIP GZIPInflatedData:[NSData dataWithContentsOfFile:path]];
+        XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding],
+                              [message stringByAppendingString:@"\n"]);
+    }
+}
+
+@end
@@ -0,0 +1,121 @@
+//
+//  PNHeartbeatSchedulerTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PubNub+CorePrivate.h"
+#import "PNHeartbeatScheduler.h"
+#import "PNClientState.h"
+#import "PNSubscriber.h"
+
+@interface PNHeartbeatScheduler (Tests)
+
+- (NSString *)groupForConfiguration:(PNConfiguration *)configuration;
+- (NSDictionary *)heartbeatPayloadForClients:(NSArray *)clients;
+
+@end
+
+@interface PNHeartbeatSchedulerTests : XCTestCase
+
+@property (nonatomic, strong) PNHeartbeatScheduler *scheduler;
+
+@end
+
+@implementation PNHeartbeatSchedulerTests
+
+- (void)setUp {
+    [super setUp];
+    self.scheduler = [PNHeartbeatScheduler new];
+}
+
+- (void)tearDown {
+    self.scheduler = nil;
+    [super tearDown];
+}
+
+- (PNConfiguration *)configurationWithAuthKey:(NSString *)authKey uuid:(NSString *)uuid {
+    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                     subscribeKey:@"demo"];
+    configuration.authKey = authKey;
+    configuration.uuid = uuid;
+    configuration.presenceHeartbeatValue = 60;
+    configuration.presenceHeartbeatInterval = 30;
+    return configuration;
+}
+
+- (PubNub *)clientWithAuthKey:(NSString *)authKey uuid:(NSString *)uuid {
+    return [PubNub clientWithConfiguration:[self configurationWithAuthKey:authKey uuid:uuid]];
+}
+
+// Subscriber store channels and groups in sets, so merged lists compared without order.
+- (NSSet *)setFrom:(NSArray *)objects {
+    return [NSSet setWithArray:objects];
+}
+
+- (void)testGroupComposedFromOriginKeysAndUUID {
+    PNConfiguration *configuration = [self configurationWithAuthKey:@"auth" uuid:@"bob"];
+    XCTAssertEqualObjects([self.scheduler groupForConfiguration:configuration],
+                          ([NSString stringWithFormat:@"%@|demo|auth|bob", configuration.origin]));
+    configuration.authKey = nil;
+    XCTAssertEqualObjects([self.scheduler groupForConfiguration:configuration],
+                          ([NSString stringWithFormat:@"%@|demo||bob", configuration.origin]));
+}
+
+- (void)testClientsGroupedBySameIdentity {
+    PubNub *client1 = [self clientWithAuthKey:@"auth" uuid:@"bob"];
+    PubNub *client2 = [self clientWithAuthKey:@"auth" uuid:@"bob"];
+    PubNub *client3 = [self clientWithAuthKey:@"auth" uuid:@"alice"];
+    PubNub *client4 = [self clientWithAuthKey:@"other-auth" uuid:@"bob"];
+    for (PubNub *client in @[client1, client2, client3, client4]) {
+        [self.scheduler scheduleHeartbeatForClient:client];
+    }
+    XCTAssertEqualObjects([self.scheduler scheduleInformationForClient:client1][@"groupSize"], @2);
+    XCTAssertEqualObjects([self.scheduler scheduleInformationForClient:client2][@"groupSize"], @2);
+    XCTAssertEqualObjects([self.scheduler scheduleInformationForClient:client3][@"groupSize"], @1);
+    XCTAssertEqualObjects([self.scheduler scheduleInformationForClient:client4][@"groupSize"], @1);
+    
+    [self.scheduler unscheduleHeartbeatForClient:client2];
+    XCTAssertEqualObjects([self.scheduler scheduleInformationForClient:client1][@"groupSize"], @1);
+    XCTAssertEqualObjects([self.scheduler scheduleInformationForClient:client2][@"scheduled"], @NO);
+}
+
+- (void)testChannelsGroupsAndStateMerged {
+    PubNub *client1 = [self clientWithAuthKey:nil uuid:@"bob"];
+    PNConfiguration *configuration = [self configurationWithAuthKey:nil uuid:@"bob"];
+    configuration.presenceHeartbeatValue = 120;
+    PubNub *client2 = [PubNub clientWithConfiguration:configuration];
+    [client1.subscriberManager addChannels:@[@"a", @"b", @"b-pnpres"]];
+    [client1.subscriberManager addChannelGroups:@[@"g1"]];
+    [client1.clientStateManager setState:@{@"mood": @"calm"} forObject:@"a"];
+    [client2.subscriberManager addChannels:@[@"b", @"c"]];
+    [client2.subscriberManager addChannelGroups:@[@"g1", @"g2"]];
+    [client2.clientStateManager setState:@{@"mood": @"busy"} forObject:@"c"];
+    
+    NSDictionary *payload = [self.scheduler heartbeatPayloadForClients:@[client1, client2]];
+    NSArray *channels = @[@"a", @"b", @"c"];
+    XCTAssertEqualObjects([self setFrom:payload[@"channels"]], [self setFrom:channels]);
+    XCTAssertEqualObjects([self setFrom:payload[@"groups"]], ([self setFrom:@[@"g1", @"g2"]]));
+    XCTAssertEqualObjects(payload[@"state"], (@{@"a": @{@"mood": @"calm"},
+                                                @"c": @{@"mood": @"busy"}}));
+    XCTAssertEqualObjects(payload[@"heartbeat"], @(client2.configuration.presenceHeartbeatValue));
+    XCTAssertEqual(payload[@"client"], client1);
+    XCTAssertEqual([payload[@"idleClients"] count], 0);
+}
+
+- (void)testClientsWithoutObjectsReportedIdle {
+    PubNub *client1 = [self clientWithAuthKey:nil uuid:@"bob"];
+    PubNub *client2 = [self clientWithAuthKey:nil uuid:@"bob"];
+    [client2.subscriberManager addChannels:@[@"a"]];
+    
+    NSDictionary *payload = [self.scheduler heartbeatPayloadForClients:@[client1, client2]];
+    XCTAssertEqualObjects(payload[@"idleClients"], @[client1]);
+    XCTAssertEqual(payload[@"client"], client2);
+    XCTAssertNil([self.scheduler heartbeatPayloadForClients:@[client1]][@"client"]);
+}
+
+@end
@@ -0,0 +1,88 @@
+//
+//  PNHedgingPolicyTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNHedgingPolicy.h"
+
+@interface PNHedgingPolicy (Tests)
+
+@property (nonatomic, strong) dispatch_queue_t resourceAccessQueue;
+
+@end
+
+@interface PNHedgingPolicyTests : XCTestCase
+
+@end
+
+@implementation PNHedgingPolicyTests
+
+- (void)recordSamples:(NSUInteger)count forOperation:(PNOperationType)operation
+             inPolicy:(PNHedgingPolicy *)policy {
+    for (NSUInteger sampleIdx = 1; sampleIdx <= count; sampleIdx++) {
+        [policy handleResponseForOperation:operation withRoundTripTime:(sampleIdx / 1000.0)];
+    }
+    // Wait till samples processed and delay re-calculated.
+    dispatch_barrier_sync(policy.resourceAccessQueue, ^{});
+}
+
+- (void)testNoDelayBeforeEnoughSamples {
+    PNHedgingPolicy *policy = [PNHedgingPolicy policyWithBudget:10];
+    [self recordSamples:19 forOperation:PNHistoryOperation inPolicy:policy];
+    XCTAssertEqual([policy hedgeDelayForOperation:PNHistoryOperation], 0.0);
+}
+
+- (void)testDelayIs95thPercentileOfRecentSamples {
+    PNHedgingPolicy *policy = [PNHedgingPolicy policyWithBudget:10];
+    [self recordSamples:100 forOperation:PNHistoryOperation inPolicy:policy];
+    XCTAssertEqualWithAccuracy([policy hedgeDelayForOperation:PNHistoryOperation], 0.096, 0.0001);
+
+    // Only last 100 samples used.
+    [self recordSamples:100 forOperation:PNHistoryOperation inPolicy:policy];
+    [self recordSamples:100 forOperation:PNHistoryOperation inPolicy:policy];
+    XCTAssertEqualWithAccuracy([policy hedgeDelayForOperation:PNHistoryOperation], 0.096, 0.0001);
+}
+
+- (void)testDelayTrackedPerOperation {
+    PNHedgingPolicy *policy = [PNHedgingPolicy policyWithBudget:10];
+    [self recordSamples:100 forOperation:PNHistoryOperation inPolicy:policy];
+    XCTAssertEqual([policy hedgeDelayForOperation:PNWhereNowOperation], 0.0);
+}
+
+- (void)testNonIdempotentOperationsNotHedged {
+    PNHedgingPolicy *policy = [PNHedgingPolicy policyWithBudget:10];
+    PNOperationType operations[] = {PNPublishOperation, PNSetStateOperation,
+                                    PNAddChannelsToGroupOperation, PNRemoveGroupOperation,
+                                    PNAddPushNotificationsOnChannelsOperation};
+    for (NSUInteger operationIdx = 0; operationIdx < 5; operationIdx++) {
+        [self recordSamples:100 forOperation:operations[operationIdx] inPolicy:policy];
+        XCTAssertEqual([policy hedgeDelayForOperation:operations[operationIdx]], 0.0);
+    }
+}
+
+- (void)testBudgetLimitsHedges {
+    PNHedgingPolicy *policy = [PNHedgingPolicy policyWithBudget:10];
+    for (NSUInteger requestIdx = 0; requestIdx < 9; requestIdx++) {
+        [policy hedgeDelayForOperation:PNHistoryOperation];
+    }
+    XCTAssertFalse([policy acquireHedge]);
+    // Fractions accumulated in floating point, so earn a bit more than one hedge.
+    [policy hedgeDelayForOperation:PNHistoryOperation];
+    [policy hedgeDelayForOperation:PNHistoryOperation];
+    XCTAssertTrue([policy acquireHedge]);
+    XCTAssertFalse([policy acquireHedge]);
+}
+
+- (void)testZeroBudgetDisablesHedging {
+    PNHedgingPolicy *policy = [PNHedgingPolicy policyWithBudget:0];
+    [self recordSamples:100 forOperation:PNHistoryOperation inPolicy:policy];
+    XCTAssertEqual([policy hedgeDelayForOperation:PNHistoryOperation], 0.0);
+    XCTAssertFalse([policy acquireHedge]);
+}
+
+@end
@@ -0,0 +1,111 @@
+//
+//  PNHereNowChangesTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNPresenceHereNowParser.h"
+#import "PNClientState.h"
+
+@interface PNHereNowChangesTests : XCTestCase
+
+@end
+
+@implementation PNHereNowChangesTests
+
+- (NSDictionary *)snapshotWithUUIDs:(NSArray *)uuids states:(NSArray *)states {
+    return @{@"uuids": uuids, @"states": states};
+}
+
+#pragma mark - Snapshot
+
+- (void)testSnapshotSortsSubscribersAndAlignsStates {
+    NSDictionary *response = @{@"uuids": @[@{@"uuid": @"c", @"state": @{@"age": @3}}, @"a",
+                                           @{@"uuid": @"b"}]};
+    NSDictionary *snapshot = [PNPresenceHereNowParser snapshotFromParsedResponse:response];
+    XCTAssertEqualObjects(snapshot[@"uuids"], (@[@"a", @"b", @"c"]));
+    XCTAssertEqualObjects(snapshot[@"states"], (@[[NSNull null], [NSNull null], @{@"age": @3}]));
+}
+
+#pragma mark - Changes
+
+- (void)testChangesFromEmptySnapshotReportAllAsJoined {
+    NSDictionary *snapshot = [self snapshotWithUUIDs:@[@"a", @"b"]
+                                              states:@[[NSNull null], @{@"age": @1}]];
+    NSDictionary *changes = [PNPresenceHereNowParser changesFromSnapshot:nil toSnapshot:snapshot];
+    XCTAssertEqualObjects(changes[@"join"], (@[@"a", @"b"]));
+    XCTAssertEqualObjects(changes[@"leave"], @[]);
+    XCTAssertEqualObjects(changes[@"stateChanges"], (@{@"b": @{@"age": @1}}));
+}
+
+- (void)testChangesToEmptySnapshotReportAllAsLeft {
+    NSDictionary *snapshot = [self snapshotWithUUIDs:@[@"a", @"b"]
+                                              states:@[[NSNull null], [NSNull null]]];
+    NSDictionary *empty = [self snapshotWithUUIDs:@[] states:@[]];
+    NSDictionary *changes = [PNPresenceHereNowParser changesFromSnapshot:snapshot toSnapshot:empty];
+    XCTAssertEqualObjects(changes[@"join"], @[]);
+    XCTAssertEqualObjects(changes[@"leave"], (@[@"a", @"b"]));
+    XCTAssertEqualObjects(changes[@"stateChanges"], @{});
+}
+
+- (void)testChangesInterleavedJoinLeaveAndStateChange {
+    NSDictionary *old = [self snapshotWithUUIDs:@[@"a", @"c", @"e", @"g"]
+                                         states:@[[NSNull null], @{@"v": @1}, @{@"v": @2},
+                                                  [NSNull null]]];
+    NSDictionary *new = [self snapshotWithUUIDs:@[@"b", @"c", @"e", @"h"]
+                                         states:@[[NSNull null], @{@"v": @1}, @{@"v": @3},
+                                                  @{@"v": @4}]];
+    NSDictionary *changes = [PNPresenceHereNowParser changesFromSnapshot:old toSnapshot:new];
+    XCTAssertEqualObjects(changes[@"join"], (@[@"b", @"h"]));
+    XCTAssertEqualObjects(changes[@"leave"], (@[@"a", @"g"]));
+    XCTAssertEqualObjects(changes[@"stateChanges"], (@{@"e": @{@"v": @3}, @"h": @{@"v": @4}}));
+}
+
+- (void)testChangesBetweenEqualSnapshotsAreEmpty {
+    NSDictionary *snapshot = [self snapshotWithUUIDs:@[@"a", @"b"]
+                                              states:@[@{@"v": @1}, [NSNull null]]];
+    NSDictionary *changes = [PNPresenceHereNowParser changesFromSnapshot:snapshot
+                                                              toSnapshot:[snapshot copy]];
+    XCTAssertEqualObjects(changes[@"join"], @[]);
+    XCTAssertEqualObjects(changes[@"leave"], @[]);
+    XCTAssertEqualObjects(changes[@"stateChanges"], @{});
+}
+
+#pragma mark - Stored snapshots
+
+- (void)testOverlappingCallersKeepOwnBaseSnapshot {
+    PNClientState *state = [PNClientState stateForClient:nil];
+    NSNumber *first = [state storeHereNowSnapshot:[self snapshotWithUUIDs:@[@"a"]
+                                                                   states:@[[NSNull null]]]
+                                       forChannel:@"channel"];
+    NSNumber *second = [state storeHereNowSnapshot:[self snapshotWithUUIDs:@[@"b"]
+                                                                    states:@[[NSNull null]]]
+                                        forChannel:@"channel"];
+    XCTAssertNotEqualObjects(first, second);
+    XCTAssertEqualObjects([state hereNowSnapshotWithIdentifier:first
+                                                    forChannel:@"channel"][@"uuids"], @[@"a"]);
+    XCTAssertEqualObjects([state hereNowSnapshotWithIdentifier:second
+                                                    forChannel:@"channel"][@"uuids"], @[@"b"]);
+    XCTAssertNil([state hereNowSnapshotWithIdentifier:first forChannel:@"other"]);
+}
+
+- (void)testLeastRecentlyUsedSnapshotEvicted {
+    PNClientState *state = [PNClientState stateForClient:nil];
+    NSDictionary *snapshot = [self snapshotWithUUIDs:@[@"a"] states:@[[NSNull null]]];
+    NSNumber *oldest = [state storeHereNowSnapshot:snapshot forChannel:@"channel"];
+    NSNumber *touched = [state storeHereNowSnapshot:snapshot forChannel:@"channel"];
+    for (NSUInteger snapshotIdx = 0; snapshotIdx < 8; snapshotIdx++) {
+        [state storeHereNowSnapshot:snapshot forChannel:@"channel"];
+    }
+    // Make 'oldest' most recently used, so 'touched' evicted instead of it.
+    XCTAssertNotNil([state hereNowSnapshotWithIdentifier:oldest forChannel:@"channel"]);
+    [state storeHereNowSnapshot:snapshot forChannel:@"channel"];
+    XCTAssertNotNil([state hereNowSnapshotWithIdentifier:oldest forChannel:@"channel"]);
+    XCTAssertNil([state hereNowSnapshotWithIdentifier:touched forChannel:@"channel"]);
+}
+
+@end
@@ -0,0 +1,200 @@
+//
+//  PNLoopbackBrokerTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNRequestParameters.h"
+#import "PNLoopbackBroker.h"
+
+// Record everything which has been delivered to client through listener callbacks.
+@interface PNLoopbackTestListener : NSObject <PNObjectEventListener>
+
+@property (nonatomic, strong) NSMutableArray *messages;
+@property (nonatomic, strong) NSMutableArray *presenceEvents;
+@property (nonatomic, strong) NSMutableArray *categories;
+
+@end
+
+@implementation PNLoopbackTestListener
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _messages = [NSMutableArray new];
+        _presenceEvents = [NSMutableArray new];
+        _categories = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)client:(PubNub *)client didReceiveMessage:(PNMessageResult *)message {
+    [self.messages addObject:message.data.message];
+}
+
+- (void)client:(PubNub *)client didReceivePresenceEvent:(PNPresenceEventResult *)event {
+    [self.presenceEvents addObject:[NSString stringWithFormat:@"%@:%@", event.data.presenceEvent,
+                                    event.data.presence.uuid]];
+}
+
+- (void)client:(PubNub *)client didReceiveStatus:(PNSubscribeStatus *)status {
+    [self.categories addObject:@(status.category)];
+}
+
+@end
+
+@interface PNLoopbackBrokerTests : XCTestCase
+
+@property (nonatomic, copy) NSString *subscribeKey;
+@property (nonatomic, strong) PubNub *alice;
+@property (nonatomic, strong) PubNub *bob;
+@property (nonatomic, strong) PNLoopbackTestListener *aliceListener;
+
+@end
+
+@implementation PNLoopbackBrokerTests
+
+- (void)setUp {
+    [super setUp];
+    // Broker is shared by all clients in process, so each test use own keyspace.
+    self.subscribeKey = [[NSUUID UUID] UUIDString];
+    self.alice = [self clientWithUUID:@"alice"];
+    self.bob = [self clientWithUUID:@"bob"];
+    self.aliceListener = [PNLoopbackTestListener new];
+    [self.alice addListener:self.aliceListener];
+}
+
+- (void)tearDown {
+    self.alice = nil;
+    self.bob = nil;
+    self.aliceListener = nil;
+    [super tearDown];
+}
+
+- (PubNub *)clientWithUUID:(NSString *)uuid {
+    NSString *subscribeKey = self.subscribeKey;
+    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                     subscribeKey:subscribeKey];
+    configuration.uuid = uuid;
+    configuration.transport = PNLoopbackTransport;
+    return [PubNub clientWithConfiguration:configuration];
+}
+
+- (BOOL)waitFor:(BOOL(^)(void))condition timeout:(NSTimeInterval)timeout {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (!condition() && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+    }
+    return condition();
+}
+
+- (void)subscribeAliceToChannels:(NSArray *)channels groups:(NSArray *)groups
+                    withPresence:(BOOL)withPresence {
+    if ([channels count]) {
+        [self.alice subscribeToChannels:channels withPresence:withPresence];
+    }
+    if ([groups count]) {
+        [self.alice subscribeToChannelGroups:groups withPresence:withPresence];
+    }
+    XCTAssertTrue([self waitFor:^BOOL{
+        return [self.aliceListener.categories containsObject:@(PNConnectedCategory)];
+    } timeout:5.0]);
+}
+
+- (void)publish:(id)message toChannel:(NSString *)channel {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Publish"];
+    [self.bob publish:message toChannel:channel withCompletion:^(PNPublishStatus *status) {
+        XCTAssertFalse(status.isError);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testPublishedMessageDeliveredToSubscriber {
+    [self subscribeAliceToChannels:@[@"chat"] groups:nil withPresence:NO];
+    [self publish:@{@"text": @"hello"} toChannel:@"chat"];
+    XCTAssertTrue([self waitFor:^BOOL{
+        return [self.aliceListener.messages count] > 0;
+    } timeout:5.0]);
+    XCTAssertEqualObjects(self.aliceListener.messages, (@[@{@"text": @"hello"}]));
+}
+
+- (void)testHistoryReturnPublishedMessagesInOrder {
+    for (NSNumber *message in @[@1, @2, @3]) {
+        [self publish:message toChannel:@"log"];
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"History"];
+    [self.alice historyForChannel:@"log"
+                   withCompletion:^(PNHistoryResult *result, PNErrorStatus *status) {
+        XCTAssertNil(status);
+        XCTAssertEqualObjects(result.data.messages, (@[@1, @2, @3]));
+        XCTAssertTrue([result.data.start compare:result.data.end] == NSOrderedAscending);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testChannelGroupMembershipAndGroupSubscription {
+    XCTestExpectation *addExpectation = [self expectationWithDescription:@"Add to group"];
+    [self.bob addChannels:@[@"a", @"b"] toGroup:@"group"
+           withCompletion:^(PNAcknowledgmentStatus *status) {
+        XCTAssertFalse(status.isError);
+        [addExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTestExpectation *auditExpectation = [self expectationWithDescription:@"Group channels"];
+    [self.alice channelsForGroup:@"group"
+                  withCompletion:^(PNChannelGroupChannelsResult *result, PNErrorStatus *status) {
+        XCTAssertEqualObjects([NSSet setWithArray:result.data.channels],
+                              ([NSSet setWithObjects:@"a", @"b", nil]));
+        [auditExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    [self subscribeAliceToChannels:nil groups:@[@"group"] withPresence:NO];
+    [self publish:@"via group" toChannel:@"b"];
+    [self publish:@"not in group" toChannel:@"c"];
+    [self publish:@"via group again" toChannel:@"a"];
+    XCTAssertTrue([self waitFor:^BOOL{
+        return [self.aliceListener.messages count] >= 2;
+    } timeout:5.0]);
+    XCTAssertEqualObjects(self.aliceListener.messages, (@[@"via group", @"via group again"]));
+}
+
+- (void)testJoinAndLeaveEventsDelivered {
+    [self subscribeAliceToChannels:@[@"room"] groups:nil withPresence:YES];
+    [self.bob subscribeToChannels:@[@"room"] withPresence:NO];
+    XCTAssertTrue([self waitFor:^BOOL{
+        return [self.aliceListener.presenceEvents containsObject:@"join:bob"];
+    } timeout:5.0]);
+    [self.bob unsubscribeFromChannels:@[@"room"] withPresence:NO];
+    XCTAssertTrue([self waitFor:^BOOL{
+        return [self.aliceListener.presenceEvents containsObject:@"leave:bob"];
+    } timeout:5.0]);
+}
+
+- (void)testTimeoutEventDeliveredWhenHeartbeatExpire {
+    [self subscribeAliceToChannels:@[@"room"] groups:nil withPresence:YES];
+    
+    // Client which sent single heartbeat with 1 second presence timeout and went away.
+    PNRequestParameters *parameters = [PNRequestParameters new];
+    [parameters addPathComponent:self.subscribeKey forPlaceholder:@"{sub-key}"];
+    [parameters addPathComponent:@"room" forPlaceholder:@"{channels}"];
+    [parameters addQueryParameter:@"ghost" forFieldName:@"uuid"];
+    [parameters addQueryParameter:@"1" forFieldName:@"heartbeat"];
+    [[PNLoopbackBroker sharedBroker] processOperation:PNHeartbeatOperation
+                                       withParameters:parameters data:nil timeout:0.0
+                                           completion:nil];
+    XCTAssertTrue([self waitFor:^BOOL{
+        return [self.aliceListener.presenceEvents containsObject:@"timeout:ghost"];
+    } timeout:5.0]);
+    NSUInteger joinIdx = [self.aliceListener.presenceEvents indexOfObject:@"join:ghost"];
+    NSUInteger timeoutIdx = [self.aliceListener.presenceEvents indexOfObject:@"timeout:ghost"];
+    XCTAssertTrue(joinIdx < timeoutIdx);
+}
+
+@end
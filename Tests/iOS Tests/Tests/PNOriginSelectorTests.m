@@ -0,0 +1,91 @@
+//
+//  PNOriginSelectorTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNOriginSelector.h"
+
+@interface PNOriginSelectorTests : XCTestCase
+
+@property (nonatomic, strong) PNOriginSelector *selector;
+
+@end
+
+@implementation PNOriginSelectorTests
+
+- (void)setUp {
+    [super setUp];
+    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                     subscribeKey:@"demo"];
+    configuration.origins = @[@"slow.pubnub.test", @"fast.pubnub.test"];
+    self.selector = [PNOriginSelector selectorForConfiguration:configuration];
+}
+
+// Stand-in origins respond with injected delays.
+- (void)respondFromOrigin:(NSString *)origin withDelay:(NSTimeInterval)delay times:(NSUInteger)times {
+    for (NSUInteger responseIdx = 0; responseIdx < times; responseIdx++) {
+        [self.selector handleResponseFromOrigin:origin forOperation:PNTimeOperation
+                              withRoundTripTime:delay];
+    }
+}
+
+- (void)testConfiguredOrderUsedBeforeMeasurements {
+    XCTAssertEqualObjects([self.selector originForOperation:PNPublishOperation], @"slow.pubnub.test");
+    XCTAssertNil([self.selector originForMeasurement]);
+}
+
+- (void)testSwitchToOriginWithLowerLatency {
+    [self respondFromOrigin:@"slow.pubnub.test" withDelay:0.2 times:5];
+    [self respondFromOrigin:@"fast.pubnub.test" withDelay:0.05 times:5];
+    XCTAssertEqualObjects([self.selector originForOperation:PNPublishOperation], @"fast.pubnub.test");
+}
+
+- (void)testStayOnOriginWhenLatencyDifferenceBelowThreshold {
+    [self respondFromOrigin:@"slow.pubnub.test" withDelay:0.2 times:5];
+    [self respondFromOrigin:@"fast.pubnub.test" withDelay:0.18 times:5];
+    XCTAssertEqualObjects([self.selector originForOperation:PNPublishOperation], @"slow.pubnub.test");
+}
+
+- (void)testLongPollRoundTripTimeIgnored {
+    [self respondFromOrigin:@"slow.pubnub.test" withDelay:0.2 times:5];
+    [self.selector handleResponseFromOrigin:@"fast.pubnub.test" forOperation:PNSubscribeOperation
+                          withRoundTripTime:0.01];
+    XCTAssertEqualObjects([self.selector originForOperation:PNPublishOperation], @"slow.pubnub.test");
+}
+
+- (void)testFailOverFromFailedOrigin {
+    [self.selector handleFailureOfOrigin:@"slow.pubnub.test"];
+    XCTAssertTrue([self.selector canFailOver]);
+    XCTAssertEqualObjects([self.selector originForOperation:PNPublishOperation], @"fast.pubnub.test");
+}
+
+- (void)testOriginWithShortestPenaltyUsedWhenAllFailed {
+    [self.selector handleFailureOfOrigin:@"slow.pubnub.test"];
+    [self.selector handleFailureOfOrigin:@"slow.pubnub.test"];
+    [self.selector handleFailureOfOrigin:@"fast.pubnub.test"];
+    XCTAssertFalse([self.selector canFailOver]);
+    XCTAssertEqualObjects([self.selector originForOperation:PNPublishOperation], @"fast.pubnub.test");
+}
+
+- (void)testRequestsNeverReroutedForMeasurement {
+    [self respondFromOrigin:@"slow.pubnub.test" withDelay:0.2 times:1];
+    PNOperationType operations[] = {PNPublishOperation, PNAddChannelsToGroupOperation,
+                                    PNAddPushNotificationsOnChannelsOperation, PNHistoryOperation};
+    for (NSUInteger operationIdx = 0; operationIdx < 4; operationIdx++) {
+        XCTAssertEqualObjects([self.selector originForOperation:operations[operationIdx]],
+                              @"slow.pubnub.test");
+    }
+}
+
+- (void)testUnmeasuredOriginReturnedForMeasurementOnce {
+    [self respondFromOrigin:@"slow.pubnub.test" withDelay:0.2 times:1];
+    XCTAssertEqualObjects([self.selector originForMeasurement], @"fast.pubnub.test");
+    XCTAssertNil([self.selector originForMeasurement]);
+}
+
+@end
@@ -0,0 +1,146 @@
+//
+//  PNPresenceDeltaTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PubNub+CorePrivate.h"
+#import "PNStateListener.h"
+#import "PNSubscriber.h"
+
+@interface PNSubscriber (Tests)
+
+@property (nonatomic, strong) NSMutableDictionary *aggregatedPresenceEvents;
+
+- (void)aggregatePresenceEvent:(NSDictionary *)event fromStatus:(PNSubscribeStatus *)status;
+
+@end
+
+@interface PNStateListener (Tests)
+
+@property (nonatomic, strong) NSHashTable *presenceEventListeners;
+@property (nonatomic, strong) NSHashTable *presenceDeltaListeners;
+
+@end
+
+// Listener which implement both presence callbacks.
+@interface PNPresenceDeltaTestListener : NSObject <PNObjectEventListener>
+@end
+
+@implementation PNPresenceDeltaTestListener
+
+- (void)client:(PubNub *)client didReceivePresenceEvent:(PNPresenceEventResult *)event {
+}
+
+- (void)client:(PubNub *)client didReceivePresenceDelta:(PNPresenceDeltaResult *)delta {
+}
+
+@end
+
+// Listener which implement only aggregated presence callback.
+@interface PNPresenceDeltaOnlyTestListener : NSObject <PNObjectEventListener>
+@end
+
+@implementation PNPresenceDeltaOnlyTestListener
+
+- (void)client:(PubNub *)client didReceivePresenceDelta:(PNPresenceDeltaResult *)delta {
+}
+
+@end
+
+@interface PNPresenceDeltaTests : XCTestCase
+
+@property (nonatomic, strong) PubNub *client;
+
+@end
+
+@implementation PNPresenceDeltaTests
+
+- (void)setUp {
+    [super setUp];
+    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                     subscribeKey:@"demo"];
+    configuration.presenceEventsAggregationWindow = 0.0f;
+    self.client = [PubNub clientWithConfiguration:configuration];
+}
+
+- (void)tearDown {
+    self.client = nil;
+    [super tearDown];
+}
+
+- (NSDictionary *)eventWithAction:(NSString *)action presence:(NSDictionary *)presence {
+    return @{@"subscribedChannel": @"lobby", @"actualChannel": @"lobby",
+             @"presenceEvent": action, @"presence": presence};
+}
+
+- (NSDictionary *)aggregate:(NSArray *)events {
+    PNSubscriber *subscriber = self.client.subscriberManager;
+    subscriber.aggregatedPresenceEvents = [NSMutableDictionary new];
+    for (NSDictionary *event in events) {
+        [subscriber aggregatePresenceEvent:event fromStatus:nil];
+    }
+    return subscriber.aggregatedPresenceEvents[@"lobby"];
+}
+
+// Listeners list modified asynchronously on serial queue which is used by -notifyWithBlock:.
+- (void)addListenerAndWait:(id <PNObjectEventListener>)listener {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Listener added"];
+    [self.client addListener:listener];
+    [self.client.listenersManager notifyWithBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testListenerReceiveBothEventsAndDeltas {
+    PNPresenceDeltaTestListener *listener = [PNPresenceDeltaTestListener new];
+    [self addListenerAndWait:listener];
+    XCTAssertTrue([self.client.listenersManager.presenceEventListeners containsObject:listener]);
+    XCTAssertTrue([self.client.listenersManager.presenceDeltaListeners containsObject:listener]);
+}
+
+- (void)testDeltaOnlyListenerNotRegisteredForEvents {
+    PNPresenceDeltaOnlyTestListener *listener = [PNPresenceDeltaOnlyTestListener new];
+    [self addListenerAndWait:listener];
+    XCTAssertFalse([self.client.listenersManager.presenceEventListeners containsObject:listener]);
+    XCTAssertTrue([self.client.listenersManager.presenceDeltaListeners containsObject:listener]);
+}
+
+- (void)testJoinAndLeaveCollapsedToNetChange {
+    NSDictionary *delta = [self aggregate:@[
+        [self eventWithAction:@"join" presence:@{@"uuid": @"bob", @"occupancy": @1}],
+        [self eventWithAction:@"join" presence:@{@"uuid": @"alice", @"occupancy": @2}],
+        [self eventWithAction:@"leave" presence:@{@"uuid": @"bob", @"occupancy": @1}],
+        [self eventWithAction:@"timeout" presence:@{@"uuid": @"carol", @"occupancy": @0}]]];
+    XCTAssertEqualObjects(delta[@"join"], [NSSet setWithObject:@"alice"]);
+    XCTAssertEqualObjects(delta[@"leave"], [NSSet setWithObject:@"carol"]);
+    XCTAssertEqualObjects(delta[@"occupancy"], @0);
+    XCTAssertEqualObjects(delta[@"eventsCount"], @4);
+}
+
+- (void)testStateKeptOnlyForPresentUUIDs {
+    NSDictionary *delta = [self aggregate:@[
+        [self eventWithAction:@"state-change" presence:@{@"uuid": @"bob", @"state": @{@"a": @1}}],
+        [self eventWithAction:@"state-change" presence:@{@"uuid": @"alice", @"state": @{@"b": @2}}],
+        [self eventWithAction:@"leave" presence:@{@"uuid": @"bob"}]]];
+    XCTAssertEqualObjects(delta[@"state"], (@{@"alice": @{@"b": @2}}));
+}
+
+- (void)testIntervalEventListsAggregated {
+    NSDictionary *delta = [self aggregate:@[
+        [self eventWithAction:@"join" presence:@{@"uuid": @"bob", @"occupancy": @11}],
+        [self eventWithAction:@"interval" presence:@{@"occupancy": @12,
+                                                      @"join": @[@"alice", @"dave"],
+                                                      @"leave": @[@"bob"],
+                                                      @"timeout": @[@"carol"]}]]];
+    XCTAssertEqualObjects(delta[@"join"], ([NSSet setWithObjects:@"alice", @"dave", nil]));
+    XCTAssertEqualObjects(delta[@"leave"], [NSSet setWithObject:@"carol"]);
+    XCTAssertEqualObjects(delta[@"occupancy"], @12);
+}
+
+@end
@@ -0,0 +1,193 @@
+//
+//  PNReachabilityTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNReachability.h"
+#import "PNRequestParameters.h"
+
+typedef void(^PNReachabilityTestCompletion)(PNResult *result, PNStatus *status);
+
+@interface PNReachability (Tests)
+
+- (void)probeServiceWithCompletion:(void(^)(BOOL probeSuccessful))block;
+- (void)handleIdleTimer;
+
+@end
+
+// Stands in for subscriber and count subscription cycle restarts.
+@interface PNReachabilityTestSubscriber : NSObject
+
+@property (atomic, assign) NSUInteger continueCount;
+
+@end
+
+@implementation PNReachabilityTestSubscriber
+
+- (NSArray *)allObjects {
+    return @[@"channel"];
+}
+
+- (void)continueSubscriptionCycleIfRequiredWithCompletion:(id)block {
+    self.continueCount++;
+}
+
+@end
+
+// Stands in for client and hold 'time' operation requests till test complete them.
+@interface PNReachabilityTestClient : NSObject
+
+@property (nonatomic, strong) NSMutableArray *timeRequests;
+@property (nonatomic, strong) PNConfiguration *configuration;
+@property (nonatomic, strong) PNReachabilityTestSubscriber *subscriberManager;
+
+- (void)processOperation:(PNOperationType)operationType
+          withParameters:(PNRequestParameters *)parameters
+         completionBlock:(PNReachabilityTestCompletion)block;
+- (void)completeTimeRequests;
+- (void)completeTimeRequestsSuccessfully;
+- (NSUInteger)timeRequestsCount;
+
+@end
+
+@implementation PNReachabilityTestClient
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _timeRequests = [NSMutableArray new];
+        _subscriberManager = [PNReachabilityTestSubscriber new];
+    }
+    return self;
+}
+
+- (void)processOperation:(PNOperationType)operationType
+          withParameters:(PNRequestParameters *)parameters
+         completionBlock:(PNReachabilityTestCompletion)block {
+    @synchronized(self.timeRequests) {
+        [self.timeRequests addObject:[block copy]];
+    }
+}
+
+- (void)completeTimeRequestsWithResult:(PNResult *)result {
+    NSArray *requests = nil;
+    @synchronized(self.timeRequests) {
+        requests = [self.timeRequests copy];
+        [self.timeRequests removeAllObjects];
+    }
+    for (PNReachabilityTestCompletion block in requests) {
+        block(result, nil);
+    }
+}
+
+- (void)completeTimeRequests {
+    [self completeTimeRequestsWithResult:nil];
+}
+
+- (void)completeTimeRequestsSuccessfully {
+    [self completeTimeRequestsWithResult:[PNTimeResult new]];
+}
+
+- (NSUInteger)timeRequestsCount {
+    @synchronized(self.timeRequests) {
+        return [self.timeRequests count];
+    }
+}
+
+@end
+
+@interface PNReachabilityTests : XCTestCase
+
+@property (nonatomic, strong) PNReachabilityTestClient *client;
+
+@end
+
+@implementation PNReachabilityTests
+
+- (void)setUp {
+    [super setUp];
+    self.client = [PNReachabilityTestClient new];
+}
+
+- (void)testOverlappingProbesShareRequestAndAllCompletionsCalled {
+    PNReachability *reachability = [PNReachability reachabilityForClient:(PubNub *)self.client
+                                                          withPingStatus:nil];
+    __block NSUInteger completionsCount = 0;
+    [reachability probeServiceWithCompletion:^(BOOL probeSuccessful) {
+        XCTAssertFalse(probeSuccessful);
+        completionsCount++;
+    }];
+    [reachability probeServiceWithCompletion:^(BOOL probeSuccessful) {
+        XCTAssertFalse(probeSuccessful);
+        completionsCount++;
+    }];
+    XCTAssertEqual([self.client timeRequestsCount], 1);
+    [self.client completeTimeRequests];
+    XCTAssertEqual(completionsCount, 2);
+
+    // Next probe should send new request.
+    [reachability probeServiceWithCompletion:^(BOOL probeSuccessful) {}];
+    XCTAssertEqual([self.client timeRequestsCount], 1);
+}
+
+- (void)testServicePingContinuesWhenItOverlapsWithInFlightProbe {
+    XCTestExpectation *pingExpectation = [self expectationWithDescription:@"ping"];
+    __block BOOL pingFulfilled = NO;
+    PNReachability *reachability = [PNReachability reachabilityForClient:(PubNub *)self.client
+                                                          withPingStatus:^(BOOL pingSuccessful) {
+        XCTAssertFalse(pingSuccessful);
+        if (!pingFulfilled) {
+            pingFulfilled = YES;
+            [pingExpectation fulfill];
+        }
+    }];
+
+    // Idle deadline probe still in flight when unexpected disconnect start service ping.
+    [reachability probeServiceWithCompletion:^(BOOL probeSuccessful) {}];
+    [reachability startServicePing];
+
+    // Service ping probe scheduled after 1 second should join in-flight probe.
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:2.5]];
+    XCTAssertEqual([self.client timeRequestsCount], 1);
+    [self.client completeTimeRequests];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    // Failed probe should schedule next one instead of stalling ping chain.
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:3.0];
+    while (![self.client timeRequestsCount] && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    }
+    XCTAssertEqual([self.client timeRequestsCount], 1);
+    [reachability stopServicePing];
+}
+
+- (PNReachability *)reachabilityWithIdleDeadline {
+    // Zero deadline disable idle timer, so test can trigger it manually and any interval is idle.
+    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:@"demo"
+                                                                     subscribeKey:@"demo"];
+    configuration.connectionIdleDeadline = 0.0f;
+    self.client.configuration = configuration;
+    return [PNReachability reachabilityForClient:(PubNub *)self.client withPingStatus:nil];
+}
+
+- (void)testIdleSubscriptionRestartedWhenServiceAvailable {
+    PNReachability *reachability = [self reachabilityWithIdleDeadline];
+    [reachability handleIdleTimer];
+    XCTAssertEqual([self.client timeRequestsCount], 1);
+    [self.client completeTimeRequestsSuccessfully];
+    XCTAssertEqual(self.client.subscriberManager.continueCount, 1);
+}
+
+- (void)testIdleSubscriptionNotRestartedWhenServiceUnavailable {
+    PNReachability *reachability = [self reachabilityWithIdleDeadline];
+    [reachability handleIdleTimer];
+    XCTAssertEqual([self.client timeRequestsCount], 1);
+    [self.client completeTimeRequests];
+    XCTAssertEqual(self.client.subscriberManager.continueCount, 0);
+}
+
+@end
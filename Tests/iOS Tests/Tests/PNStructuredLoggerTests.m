@@ -0,0 +1,168 @@
+//
+//  PNStructuredLoggerTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import <PubNub/PubNub.h>
+#import "PNStructuredLogger.h"
+
+static NSString * const kPNTestRecordPrefix = @"<PubNub> structured-logger-test-";
+
+// Collect records from PubNub context and can stall writer on specified record.
+@interface PNStructuredLoggerTestLogger : DDAbstractLogger
+
+@property (atomic, strong) NSMutableArray *messages;
+@property (atomic, copy) NSString *blockingMessage;
+@property (nonatomic, strong) dispatch_semaphore_t blockedSemaphore;
+@property (nonatomic, strong) dispatch_semaphore_t releaseSemaphore;
+
+@end
+
+@implementation PNStructuredLoggerTestLogger
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _messages = [NSMutableArray new];
+        _blockedSemaphore = dispatch_semaphore_create(0);
+        _releaseSemaphore = dispatch_semaphore_create(0);
+    }
+    return self;
+}
+
+- (void)logMessage:(DDLogMessage *)logMessage {
+    if (logMessage->_context != kPNLogContext) {
+        return;
+    }
+    @synchronized(self.messages) {
+        [self.messages addObject:logMessage->_message];
+    }
+    if ([logMessage->_message isEqualToString:self.blockingMessage]) {
+        dispatch_semaphore_signal(self.blockedSemaphore);
+        dispatch_semaphore_wait(self.releaseSemaphore, DISPATCH_TIME_FOREVER);
+    }
+}
+
+- (NSArray *)testRecords {
+    NSPredicate *filter = [NSPredicate predicateWithFormat:@"SELF BEGINSWITH %@",
+                           kPNTestRecordPrefix];
+    @synchronized(self.messages) {
+        return [self.messages filteredArrayUsingPredicate:filter];
+    }
+}
+
+- (NSArray *)droppedReports {
+    NSPredicate *filter = [NSPredicate predicateWithFormat:@"SELF ENDSWITH %@",
+                           @"log records dropped."];
+    @synchronized(self.messages) {
+        return [self.messages filteredArrayUsingPredicate:filter];
+    }
+}
+
+@end
+
+@interface PNStructuredLoggerTests : XCTestCase
+
+@property (nonatomic, strong) PNStructuredLoggerTestLogger *logger;
+
+@end
+
+@implementation PNStructuredLoggerTests
+
+- (void)setUp {
+    [super setUp];
+    self.logger = [PNStructuredLoggerTestLogger new];
+    [DDLog addLogger:self.logger withLevel:DDLogLevelAll];
+}
+
+- (void)tearDown {
+    dispatch_semaphore_signal(self.logger.releaseSemaphore);
+    [PNStructuredLogger flush];
+    [DDLog removeLogger:self.logger];
+    [PNStructuredLogger setSamplingRate:1.0 forFlag:(DDLogFlag)PNVerboseLogLevel];
+    [super tearDown];
+}
+
+// Each thread has own ring buffer and sampling counters, so records logged from new thread.
+- (void)onNewThread:(dispatch_block_t)block {
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    NSThread *thread = [[NSThread alloc] initWithTarget:[NSBlockOperation blockOperationWithBlock:^{
+        block();
+        dispatch_semaphore_signal(semaphore);
+    }] selector:@selector(start) object:nil];
+    [thread start];
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+}
+
+- (void)logRecords:(NSUInteger)count fromIndex:(NSUInteger)index {
+    for (NSUInteger recordIdx = index; recordIdx < (index + count); recordIdx++) {
+        NSString *record = [NSString stringWithFormat:@"structured-logger-test-%@", @(recordIdx)];
+        [PNStructuredLogger logObject:record withFlag:(DDLogFlag)PNResultLogLevel
+                                 file:__FILE__ function:__PRETTY_FUNCTION__];
+    }
+}
+
+- (void)testRecordsPassedToLoggersInOrder {
+    [self onNewThread:^{
+        [self logRecords:5 fromIndex:0];
+    }];
+    [PNStructuredLogger flush];
+    NSArray *expected = @[@"0", @"1", @"2", @"3", @"4"];
+    NSMutableArray *records = [NSMutableArray new];
+    for (NSString *message in [self.logger testRecords]) {
+        [records addObject:[message substringFromIndex:[kPNTestRecordPrefix length]]];
+    }
+    XCTAssertEqualObjects(records, expected);
+}
+
+- (void)testSamplingLogEveryNthRecord {
+    [PNStructuredLogger setSamplingRate:0.1 forFlag:(DDLogFlag)PNResultLogLevel];
+    [self onNewThread:^{
+        [self logRecords:25 fromIndex:0];
+    }];
+    [PNStructuredLogger flush];
+    NSArray *expected = @[[kPNTestRecordPrefix stringByAppendingString:@"0"],
+                          [kPNTestRecordPrefix stringByAppendingString:@"10"],
+                          [kPNTestRecordPrefix stringByAppendingString:@"20"]];
+    XCTAssertEqualObjects([self.logger testRecords], expected);
+}
+
+- (void)testZeroSamplingRateDisableRecords {
+    [PNStructuredLogger setSamplingRate:0.0 forFlag:(DDLogFlag)PNResultLogLevel];
+    [self onNewThread:^{
+        [self logRecords:10 fromIndex:0];
+    }];
+    [PNStructuredLogger flush];
+    XCTAssertEqual([[self.logger testRecords] count], 0);
+}
+
+- (void)testSamplingAppliedOnlyToSpecifiedFlag {
+    [PNStructuredLogger setSamplingRate:0.0 forFlag:(DDLogFlag)PNStatusLogLevel];
+    [self onNewThread:^{
+        [self logRecords:3 fromIndex:0];
+    }];
+    [PNStructuredLogger flush];
+    XCTAssertEqual([[self.logger testRecords] count], 3);
+}
+
+- (void)testFullRingBufferDropAndReportRecords {
+    // Writer stalled on first record, so ring buffer can't be drained while test fill it.
+    self.logger.blockingMessage = [kPNTestRecordPrefix stringByAppendingString:@"0"];
+    [self onNewThread:^{
+        [self logRecords:1 fromIndex:0];
+        dispatch_semaphore_wait(self.logger.blockedSemaphore, DISPATCH_TIME_FOREVER);
+        [self logRecords:1100 fromIndex:1];
+        dispatch_semaphore_signal(self.logger.releaseSemaphore);
+    }];
+    [PNStructuredLogger flush];
+    NSArray *records = [self.logger testRecords];
+    XCTAssertEqual([records count], 1025);
+    XCTAssertEqualObjects([records lastObject],
+                          [kPNTestRecordPrefix stringByAppendingString:@"1024"]);
+    XCTAssertEqualObjects([self.logger droppedReports], @[@"<PubNub> 76 log records dropped."]);
+}
+
+@end
@@ -0,0 +1,154 @@
+//
+//  PNTimingWheelTests.m
+//  PubNub Tests
+//
+//  Created by Sergey Mamontov on 10/17/15.
+//
+//
+
+#import <XCTest/XCTest.h>
+#import "PNTimingWheel.h"
+
+@interface PNTimingWheelTimer (Tests)
+
+@property (nonatomic, assign) uint64_t expirationTick;
+@property (nonatomic, assign) uint64_t intervalTicks;
+
+@end
+
+@interface PNTimingWheel (Tests)
+
+@property (nonatomic, assign) uint64_t currentTick;
+@property (nonatomic, assign) NSUInteger timersCount;
+@property (nonatomic, strong) NSCondition *condition;
+
+- (void)placeTimer:(PNTimingWheelTimer *)timer;
+- (uint64_t)nextWakeUpTick;
+- (NSArray *)advanceToTick:(uint64_t)tick;
+
+@end
+
+@interface PNTimingWheelTests : XCTestCase
+
+// Wheel which is never used to schedule timers, so it's thread isn't started and wheel can be
+// advanced manually.
+@property (nonatomic, strong) PNTimingWheel *wheel;
+
+@end
+
+@implementation PNTimingWheelTests
+
+- (void)setUp {
+    [super setUp];
+    self.wheel = [PNTimingWheel new];
+}
+
+- (PNTimingWheelTimer *)placeTimerExpiringAtTick:(uint64_t)tick {
+    PNTimingWheelTimer *timer = [PNTimingWheelTimer new];
+    timer.expirationTick = tick;
+    [self.wheel placeTimer:timer];
+    self.wheel.timersCount++;
+    return timer;
+}
+
+#pragma mark - Tick
+
+- (void)testTimerFiresAtExpirationTick {
+    PNTimingWheelTimer *timer = [self placeTimerExpiringAtTick:10];
+    XCTAssertEqual([self.wheel nextWakeUpTick], 10);
+    XCTAssertEqual([[self.wheel advanceToTick:9] count], 0);
+    XCTAssertEqualObjects([self.wheel advanceToTick:10], @[timer]);
+    XCTAssertEqual(self.wheel.timersCount, 0);
+}
+
+- (void)testTimersFromSameTickFiredTogether {
+    PNTimingWheelTimer *timer1 = [self placeTimerExpiringAtTick:5];
+    PNTimingWheelTimer *timer2 = [self placeTimerExpiringAtTick:5];
+    NSArray *expired = [self.wheel advanceToTick:20];
+    XCTAssertEqual([expired count], 2);
+    XCTAssertTrue([expired containsObject:timer1]);
+    XCTAssertTrue([expired containsObject:timer2]);
+}
+
+- (void)testCancelledTimerRemovedFromSlot {
+    PNTimingWheelTimer *timer = [self placeTimerExpiringAtTick:5];
+    [self.wheel cancelTimer:timer];
+    XCTAssertEqual(self.wheel.timersCount, 0);
+    XCTAssertEqual([[self.wheel advanceToTick:5] count], 0);
+}
+
+#pragma mark - Wrap
+
+- (void)testTimerAcrossInnerWheelWrap {
+    self.wheel.currentTick = 250;
+    PNTimingWheelTimer *timer = [self placeTimerExpiringAtTick:260];
+    XCTAssertEqual([[self.wheel advanceToTick:259] count], 0);
+    XCTAssertEqualObjects([self.wheel advanceToTick:260], @[timer]);
+}
+
+- (void)testWakeUpNotLaterThanRotationEnd {
+    self.wheel.currentTick = 10;
+    [self placeTimerExpiringAtTick:1000];
+    XCTAssertEqual([self.wheel nextWakeUpTick], 256);
+}
+
+#pragma mark - Cascade
+
+- (void)testOuterWheelTimerCascadesAndFiresOnTime {
+    PNTimingWheelTimer *timer = [self placeTimerExpiringAtTick:300];
+    XCTAssertEqual([[self.wheel advanceToTick:256] count], 0);
+    XCTAssertEqual([[self.wheel advanceToTick:299] count], 0);
+    XCTAssertEqualObjects([self.wheel advanceToTick:300], @[timer]);
+}
+
+- (void)testTimerOnRotationBoundaryFiresOnTime {
+    PNTimingWheelTimer *timer = [self placeTimerExpiringAtTick:512];
+    XCTAssertEqual([[self.wheel advanceToTick:511] count], 0);
+    XCTAssertEqualObjects([self.wheel advanceToTick:512], @[timer]);
+}
+
+- (void)testTimerBeyondOuterWheelRangeFiresOnTime {
+    uint64_t expiration = (256 * 256 * 3 + 17);
+    PNTimingWheelTimer *timer = [self placeTimerExpiringAtTick:expiration];
+    XCTAssertEqual([[self.wheel advanceToTick:expiration - 1] count], 0);
+    XCTAssertEqualObjects([self.wheel advanceToTick:expiration], @[timer]);
+}
+
+#pragma mark - Fire
+
+- (void)testScheduledTimerFires {
+    XCTestExpectation *fireExpectation = [self expectationWithDescription:@"fire"];
+    [[PNTimingWheel sharedWheel] scheduleTimerWithDelay:0.1 interval:0.0 block:^{
+        [fireExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testCancelledTimerDoesNotFire {
+    PNTimingWheel *wheel = [PNTimingWheel sharedWheel];
+    __block BOOL fired = NO;
+    PNTimingWheelTimer *timer = [wheel scheduleTimerWithDelay:0.2 interval:0.0 block:^{
+        fired = YES;
+    }];
+    [wheel cancelTimer:timer];
+    XCTestExpectation *waitExpectation = [self expectationWithDescription:@"wait"];
+    [wheel scheduleTimerWithDelay:0.5 interval:0.0 block:^{
+        [waitExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertFalse(fired);
+}
+
+- (void)testSlowTimerBlockDoesNotDelayOtherTimers {
+    PNTimingWheel *wheel = [PNTimingWheel sharedWheel];
+    XCTestExpectation *fastExpectation = [self expectationWithDescription:@"fast"];
+    [wheel scheduleTimerWithDelay:0.1 interval:0.0 block:^{
+        [NSThread sleepForTimeInterval:2.0];
+    }];
+    [wheel scheduleTimerWithDelay:0.3 interval:0.0 block:^{
+        [fastExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+@end
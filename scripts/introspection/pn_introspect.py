@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+"""Query PubNub client introspection server and print snapshot of live clients."""
+import argparse
+import json
+import socket
+import sys
+
+
+def read_snapshot(path, timeout):
+	connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+	connection.settimeout(timeout)
+	connection.connect(path)
+	chunks = []
+	while True:
+		chunk = connection.recv(65536)
+		if not chunk:
+			break
+		chunks.append(chunk)
+	connection.close()
+	return json.loads(b''.join(chunks).decode('utf-8'))
+
+
+def print_summary(snapshot):
+	process = snapshot['process']
+	print('%s (pid %d), SDK %s, %d timer(s)' % (process['name'], process['pid'], process['sdk'],
+											   snapshot['timers']['timers']))
+	for client in snapshot['clients']:
+		subscriber = client['subscriber']
+		print('')
+		print('client %s (%s)' % (client['uuid'], client['subscribeKey']))
+		print('  subscriber: %s, timetoken %s, %d channel(s), %d group(s)' % (
+			subscriber['state'], subscriber['timetoken'], len(subscriber['channels']),
+			len(subscriber['groups'])))
+		print('  state cache: %d object(s)' % len(client['state']['state']))
+		print('  listeners: %s' % ', '.join('%s=%d' % item
+											 for item in sorted(client['listeners'].items())))
+		heartbeat = client['heartbeat']
+		if heartbeat['scheduled']:
+			print('  heartbeat: every %ss, next in %.1fs' % (heartbeat['interval'],
+															 heartbeat['tillHeartbeat']))
+		for name in ('subscriptionNetwork', 'serviceNetwork'):
+			network = client[name]
+			requests = network.get('requests')
+			print('  %s: %s in-flight, %d queued' % (
+				name, '?' if requests is None else len(requests), network['queuedOperations']))
+			for request in requests or []:
+				print('    #%d %s %s (sent %d, received %d)' % (
+					request['identifier'], request.get('operation', '-'), request['state'],
+					request['sent'], request['received']))
+
+
+if __name__ == '__main__':
+	parser = argparse.ArgumentParser(description=__doc__)
+	parser.add_argument('socket', help='path to socket passed to +[PNIntrospection startServerAtPath:]')
+	parser.add_argument('--json', action='store_true', help='print raw JSON snapshot')
+	parser.add_argument('--timeout', type=float, default=5.0, help='socket timeout in seconds')
+	arguments = parser.parse_args()
+	try:
+		snapshot = read_snapshot(arguments.socket, arguments.timeout)
+	except (socket.error, ValueError) as error:
+		sys.exit('Unable to read snapshot: %s' % error)
+	if arguments.json:
+		print(json.dumps(snapshot, indent=2, sort_keys=True))
+	else:
+		print_summary(snapshot)
@@ -0,0 +1,17 @@
+#!/bin/sh
+# Generate DTrace provider header (PubNub/Misc/PNTraceProvider.h) from scripts/tracing/pubnub.d.
+# Probes compiled into client on Darwin only when this header exists.
+#
+# Usage: sh scripts/tracing/generate_provider.sh
+set -e
+
+ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+OUTPUT="$ROOT/PubNub/Misc/PNTraceProvider.h"
+
+if ! command -v dtrace >/dev/null 2>&1; then
+    echo "dtrace not found, PubNub tracepoints won't be compiled in." >&2
+    exit 0
+fi
+
+dtrace -h -s "$ROOT/scripts/tracing/pubnub.d" -o "$OUTPUT"
+echo "Generated $OUTPUT"